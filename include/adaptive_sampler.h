@@ -0,0 +1,166 @@
+#ifndef _ADAPTIVE_SAMPLER_H_
+#define _ADAPTIVE_SAMPLER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define ADAPTIVE_STABLE_SAMPLES 3 // столько стабильных отсчётов подряд — и интервал увеличивается
+#define ADAPTIVE_GROW_NUM 3       // множитель увеличения интервала (числитель): x1.5
+#define ADAPTIVE_GROW_DEN 2       // множитель увеличения интервала (знаменатель)
+#define ADAPTIVE_HISTORY 16       // глубина истории отсчётов для оценки скорости
+#define ADAPTIVE_SPAN_MS 900000   // скорость оценивается по самому старому отсчёту не старше 15 минут
+
+/// @brief пороги скорости изменения одной величины (в единицах величины)
+struct AdaptiveChannel_t
+{
+  int32_t deadband;        // изменение, не превышающее шум/дискретность датчика, не учитывается
+  int32_t fast_per_hour;   // скорость, начиная с которой интервал сокращается вдвое (единиц/час)
+  int32_t stable_per_hour; // скорость, ниже которой величина считается стабильной (единиц/час)
+};
+
+/**
+ * @brief Адаптивный интервал опроса по измеренной скорости изменения величин
+ *
+ * Скорость изменения каждой из N величин оценивается по разности с самым старым отсчётом
+ * истории не старше ADAPTIVE_SPAN_MS (не менее чем с предыдущим), за вычетом зоны
+ * нечувствительности: на длинной базе шум датчика не выглядит быстрым изменением даже
+ * при минимальном интервале, а резкий скачок всё равно даёт большую скорость. Если хотя бы одна величина меняется быстрее
+ * fast_per_hour — интервал сразу уменьшается вдвое (но не ниже минимума). Если все величины
+ * медленнее stable_per_hour в течение ADAPTIVE_STABLE_SAMPLES отсчётов подряд — интервал
+ * увеличивается в 1.5 раза (но не выше максимума). Между порогами интервал сохраняется.
+ *
+ * @tparam N количество величин (каналов)
+ */
+template <size_t N>
+class AdaptiveSampler
+{
+public:
+  /**
+   * @param ch Пороги величин (массив должен существовать всё время жизни объекта)
+   * @param initial_ms Начальный интервал (приводится к границам)
+   */
+  AdaptiveSampler(const AdaptiveChannel_t (&ch)[N], uint32_t min_ms, uint32_t max_ms, uint32_t initial_ms)
+      : channels(ch), interval(initial_ms), stable_run(0), count(0), head(0), trigger(-1)
+  {
+    for (size_t i = 0; i < N; ++i)
+      rate[i] = 0;
+    set_limits(min_ms, max_ms);
+  }
+
+  /** @brief Задать границы интервала (текущий интервал приводится к ним) */
+  void set_limits(uint32_t min_ms, uint32_t max_ms)
+  {
+    lo = min_ms;
+    hi = (max_ms < min_ms) ? min_ms : max_ms;
+    interval = clamp(interval);
+  }
+
+  /**
+   * @brief Учесть отсчёт и пересчитать интервал
+   * @param v Значения величин
+   * @param mono_us Монотонное время отсчёта (мкс)
+   * @return новый интервал опроса (мс)
+   */
+  uint32_t update(const int32_t (&v)[N], int64_t mono_us)
+  {
+    trigger = -1;
+    // опорный отсчёт: самый старый в пределах ADAPTIVE_SPAN_MS, иначе предыдущий
+    const Entry_t *ref = nullptr;
+    for (uint8_t k = count; k > 0; --k)
+    {
+      const Entry_t &e = history[(head + ADAPTIVE_HISTORY - k) % ADAPTIVE_HISTORY];
+      if (e.mono_us < mono_us && (mono_us - e.mono_us <= static_cast<int64_t>(ADAPTIVE_SPAN_MS) * 1000 || k == 1))
+      {
+        ref = &e;
+        break;
+      }
+    }
+    if (!ref)
+    {
+      remember(v, mono_us);
+      return interval;
+    }
+
+    const int64_t dt_us = mono_us - ref->mono_us;
+    bool stable = true;
+    for (size_t i = 0; i < N; ++i)
+    {
+      int64_t dv = static_cast<int64_t>(v[i]) - ref->values[i];
+      dv = (dv < 0) ? -dv : dv;
+      dv = (dv > channels[i].deadband) ? dv - channels[i].deadband : 0;
+      rate[i] = static_cast<int32_t>(dv * 3600000000LL / dt_us);
+      if (rate[i] >= channels[i].fast_per_hour && trigger < 0)
+        trigger = static_cast<int>(i);
+      if (rate[i] >= channels[i].stable_per_hour)
+        stable = false;
+    }
+    remember(v, mono_us);
+
+    if (trigger >= 0)
+    {
+      stable_run = 0;
+      interval = clamp(interval / 2);
+    }
+    else if (stable && ++stable_run >= ADAPTIVE_STABLE_SAMPLES)
+    {
+      stable_run = 0;
+      interval = clamp(static_cast<uint32_t>(static_cast<uint64_t>(interval) * ADAPTIVE_GROW_NUM / ADAPTIVE_GROW_DEN));
+    }
+    else if (!stable)
+      stable_run = 0;
+    return interval;
+  }
+
+  uint32_t interval_ms() const
+  {
+    return interval;
+  }
+
+  /** @brief Скорость изменения величины i по последнему отсчёту (единиц/час, без знака) */
+  int32_t rate_per_hour(size_t i) const
+  {
+    return (i < N) ? rate[i] : 0;
+  }
+
+  /** @brief Номер величины, вызвавшей сокращение интервала последним отсчётом (-1 — нет) */
+  int triggered_by() const
+  {
+    return trigger;
+  }
+
+private:
+  uint32_t clamp(uint32_t ms) const
+  {
+    return (ms < lo) ? lo : (ms > hi) ? hi : ms;
+  }
+
+  struct Entry_t
+  {
+    int64_t mono_us;   // время отсчёта (мкс)
+    int32_t values[N]; // значения величин
+  };
+
+  void remember(const int32_t (&v)[N], int64_t mono_us)
+  {
+    Entry_t &e = history[head];
+    e.mono_us = mono_us;
+    for (size_t i = 0; i < N; ++i)
+      e.values[i] = v[i];
+    head = (head + 1) % ADAPTIVE_HISTORY;
+    if (count < ADAPTIVE_HISTORY)
+      count++;
+  }
+
+  const AdaptiveChannel_t (&channels)[N]; // пороги величин
+  uint32_t lo;                            // минимальный интервал (мс)
+  uint32_t hi;                            // максимальный интервал (мс)
+  uint32_t interval;                      // текущий интервал (мс)
+  uint8_t stable_run;                     // стабильных отсчётов подряд
+  Entry_t history[ADAPTIVE_HISTORY];      // кольцевая история отсчётов
+  uint8_t count;                          // отсчётов в истории
+  uint8_t head;                           // индекс следующей записи истории
+  int32_t rate[N];                        // скорости изменения по последнему отсчёту (единиц/час)
+  int trigger;                            // величина, вызвавшая сокращение интервала (-1 — нет)
+};
+
+#endif // _ADAPTIVE_SAMPLER_H_
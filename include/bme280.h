@@ -0,0 +1,154 @@
+#ifndef _BME280_H_
+#define _BME280_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define BME280_ADDR_PRIMARY 0x76   // адрес BME280 при SDO = GND
+#define BME280_ADDR_SECONDARY 0x77 // адрес BME280 при SDO = VDDIO
+#define BME280_DATA_LEN 8          // длина блока данных измерения (регистры 0xF7..0xFE)
+
+/// @brief коэффициент передискретизации измерения (значения регистров osrs_x)
+enum Bme280Oversampling_t
+{
+  BME280_OSRS_SKIP = 0, // измерение отключено
+  BME280_OSRS_X1,
+  BME280_OSRS_X2,
+  BME280_OSRS_X4,
+  BME280_OSRS_X8,
+  BME280_OSRS_X16,
+};
+
+/// @brief коэффициент аппаратного IIR-фильтра (значения поля filter регистра config)
+enum Bme280Filter_t
+{
+  BME280_FILTER_OFF = 0,
+  BME280_FILTER_X2,
+  BME280_FILTER_X4,
+  BME280_FILTER_X8,
+  BME280_FILTER_X16,
+};
+
+/// @brief калибровочные коэффициенты (NVM 0x88..0xA1, 0xE1..0xE7)
+struct Bme280Calib_t
+{
+  uint16_t dig_T1; // температура, 0x88
+  int16_t dig_T2;  // температура, 0x8A
+  int16_t dig_T3;  // температура, 0x8C
+  uint16_t dig_P1; // давление, 0x8E
+  int16_t dig_P2;  // давление, 0x90
+  int16_t dig_P3;  // давление, 0x92
+  int16_t dig_P4;  // давление, 0x94
+  int16_t dig_P5;  // давление, 0x96
+  int16_t dig_P6;  // давление, 0x98
+  int16_t dig_P7;  // давление, 0x9A
+  int16_t dig_P8;  // давление, 0x9C
+  int16_t dig_P9;  // давление, 0x9E
+  uint8_t dig_H1;  // влажность, 0xA1
+  int16_t dig_H2;  // влажность, 0xE1..0xE2
+  uint8_t dig_H3;  // влажность, 0xE3
+  int16_t dig_H4;  // влажность, 0xE4 и 0xE5[3:0] (12 бит со знаком)
+  int16_t dig_H5;  // влажность, 0xE6 и 0xE5[7:4] (12 бит со знаком)
+  int8_t dig_H6;   // влажность, 0xE7
+};
+
+/// @brief результат измерения в целочисленном формате Bosch
+struct Bme280Reading_t
+{
+  int32_t temperature_centi; // температура, 0.01 °C
+  uint32_t pressure_q24_8;   // давление, Па в формате Q24.8 (Па * 256)
+  uint32_t humidity_q22_10;  // относительная влажность, % в формате Q22.10 (% * 1024)
+
+  float temperature_c() const
+  {
+    return temperature_centi / 100.0f;
+  }
+  float pressure_hpa() const
+  {
+    return pressure_q24_8 / 25600.0f;
+  }
+  float humidity_pct() const
+  {
+    return humidity_q22_10 / 1024.0f;
+  }
+};
+
+/**
+ * @brief Драйвер BME280 в принудительном (forced) режиме
+ *
+ * Одно измерение — запуск записью ctrl_meas, ожидание расчётного времени преобразования
+ * и чтение всех регистров данных одной I2C-транзакцией (burst read 0xF7..0xFE).
+ * Обмен идёт через I2cEngine: на время преобразования задача свободна (start() / read()).
+ * Компенсация — целочисленные процедуры Bosch (температура int32, давление int64,
+ * влажность int32) в bme280_compensate.cpp, без зависимостей от платформы. Сглаживание
+ * выполняет аппаратный IIR-фильтр датчика (его состояние сохраняется между принудительными
+ * измерениями) и передискретизация.
+ */
+class Bme280
+{
+public:
+  Bme280() = default;
+
+  /**
+   * @brief Найти датчик по адресу, прочитать калибровку и применить текущие настройки
+   * @return false если датчик не отвечает или идентификатор кристалла не 0x60
+   */
+  bool begin(uint8_t addr);
+
+  /**
+   * @brief Задать передискретизацию и IIR-фильтр (применяется сразу, если датчик инициализирован)
+   */
+  bool configure(Bme280Oversampling_t osrs_t, Bme280Oversampling_t osrs_p, Bme280Oversampling_t osrs_h,
+                 Bme280Filter_t filter);
+
+  /**
+   * @brief Выполнить одно принудительное измерение (start(), ожидание measure_time_ms(), read())
+   * @return false при ошибке обмена по I2C
+   */
+  bool measure(Bme280Reading_t &out);
+
+  /** @brief Запустить принудительное измерение (результат готов через measure_time_ms()) */
+  bool start();
+
+  /**
+   * @brief Прочитать результат запущенного измерения одной транзакцией
+   * @return false при ошибке обмена или если преобразование ещё не завершено
+   */
+  bool read(Bme280Reading_t &out);
+
+  /** @brief Максимальное время преобразования при текущих настройках (мс, по datasheet) */
+  uint32_t measure_time_ms() const;
+
+  /**
+   * @brief Компенсация сырых данных измерения (без обмена с датчиком)
+   * @param calib Калибровочные коэффициенты
+   * @param raw Блок регистров 0xF7..0xFE
+   */
+  static void compensate(const Bme280Calib_t &calib, const uint8_t raw[BME280_DATA_LEN], Bme280Reading_t &out);
+
+  /** @brief Разбор калибровочных коэффициентов из блоков NVM 0x88..0xA1 (26 байт) и 0xE1..0xE7 (7 байт) */
+  static void parse_calib(const uint8_t tp[26], const uint8_t h[7], Bme280Calib_t &calib);
+
+  bool initialized() const
+  {
+    return present;
+  }
+
+private:
+  Bme280(const Bme280 &) = delete;
+  Bme280 &operator=(const Bme280 &) = delete;
+
+  bool write_reg(uint8_t reg, uint8_t value);
+  bool read_regs(uint8_t reg, uint8_t *buf, size_t len);
+  bool apply_config();
+
+  bool present{false};                         // датчик найден и настроен
+  uint8_t addr{BME280_ADDR_PRIMARY};           // адрес датчика
+  Bme280Calib_t calib{};                       // калибровочные коэффициенты
+  Bme280Oversampling_t osrs_t{BME280_OSRS_X1}; // передискретизация температуры
+  Bme280Oversampling_t osrs_p{BME280_OSRS_X1}; // передискретизация давления
+  Bme280Oversampling_t osrs_h{BME280_OSRS_X1}; // передискретизация влажности
+  Bme280Filter_t filter{BME280_FILTER_OFF};    // коэффициент IIR-фильтра
+};
+
+#endif // _BME280_H_
@@ -0,0 +1,53 @@
+#ifndef _BOOT_CACHE_H_
+#define _BOOT_CACHE_H_
+
+#include "station_state.h"
+#include <time.h>
+
+#define BOOT_CACHE_MAGIC 0x48434342u                // "BCCH"
+#define BOOT_CACHE_VERSION 1                        // версия формата сохранённого состояния
+#define BOOT_CACHE_NVS_NAMESPACE "boot_cache"       // пространство имён NVS (не длиннее 15 символов)
+#define BOOT_CACHE_NVS_INTERVAL_MS (30 * 60 * 1000) // сохранение в NVS не чаще (износ флеш-памяти)
+
+/// @brief откуда восстановлено последнее известное состояние
+enum BootCacheSource_t
+{
+  BOOT_CACHE_NONE = 0, // сохранённого состояния нет (первый запуск, другая версия формата)
+  BOOT_CACHE_RTC,      // память RTC: программный сброс, сторожевой таймер, паника
+  BOOT_CACHE_NVS,      // NVS: после отключения питания
+};
+
+/**
+ * @brief Последнее известное состояние станции для мгновенного показа после перезапуска
+ *
+ * Копия снимка StationState (прогноз, индексы Kp, показания датчиков, населённый пункт) и
+ * оценка времени хранятся в памяти RTC (обновляется при каждом изменении состояния,
+ * переживает программный сброс) и в NVS (не чаще BOOT_CACHE_NVS_INTERVAL_MS, переживает
+ * отключение питания). При запуске поля восстанавливаются в StationState с пометкой
+ * `restored`: экран показывает их сразу как устаревшие, пока не придут свежие данные.
+ */
+class BootCache
+{
+public:
+  BootCache() = delete;
+
+  /** @brief Восстановить состояние в StationState (после StationState::init(), до создания задач) */
+  static void restore();
+
+  /** @brief Сохранить текущее состояние станции (в задаче, получающей NOTIFY_BIT_STATE) */
+  static void capture();
+
+  /**
+   * @brief Оценка местного времени, пока часы не синхронизированы
+   *
+   * Время последнего сохранения плюс время с запуска: после отключения питания оценка
+   * отстаёт на длительность отключения.
+   * @return false если часы синхронизированы или оценки нет
+   */
+  static bool clock_estimate(struct tm &out);
+
+  /** @brief Источник восстановленного состояния */
+  static BootCacheSource_t source();
+};
+
+#endif // _BOOT_CACHE_H_
@@ -0,0 +1,33 @@
+#ifndef _BOOT_TIMELINE_H_
+#define _BOOT_TIMELINE_H_
+
+#include <stdint.h>
+
+/// @brief этапы загрузки, видимые пользователю
+enum BootPhase_t
+{
+  BOOT_PHASE_FIRST_PIXEL = 0, // на экран выведен первый виджет
+  BOOT_PHASE_FULL_SCREEN,     // выведены часы, показания датчиков и прогноз (в том числе восстановленные)
+  BOOT_PHASE_FRESH_DATA,      // на экране свежие прогноз и показания комнатного датчика
+  _BOOT_PHASE_NUM_
+};
+
+/**
+ * @brief Хронология загрузки: время от запуска до каждого этапа
+ *
+ * Каждый этап отмечается один раз (повторные отметки игнорируются) и сразу пишется в лог.
+ * Когда отмечены все этапы, выводится сводка всей хронологии.
+ */
+class BootTimeline
+{
+public:
+  BootTimeline() = delete;
+
+  /** @brief Отметить этап (из любой задачи) */
+  static void mark(BootPhase_t phase);
+
+  /** @brief Время этапа от запуска, мс (0 — этап ещё не наступил) */
+  static uint32_t at_ms(BootPhase_t phase);
+};
+
+#endif // _BOOT_TIMELINE_H_
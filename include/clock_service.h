@@ -0,0 +1,50 @@
+#ifndef _CLOCK_SERVICE_H_
+#define _CLOCK_SERVICE_H_
+
+#include "common.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <time.h>
+
+#define CLOCK_MAX_SUBSCRIBERS 4          // максимальное количество задач, получающих события часов
+#define CLOCK_MIN_VALID_EPOCH 1577836800 // время ранее этой даты (2020-01-01 UTC) считается несинхронизированным
+
+/**
+ * @brief Единая служба времени станции
+ *
+ * Отслеживает синхронизацию по SNTP и рассылает задачам уведомления о смене минуты,
+ * часа и даты точно на границе (one-shot esp_timer перевзводится на следующую минуту).
+ * После каждой синхронизации рассылается NOTIFY_BIT_TIME_SYNC; события смены добавляются
+ * только если синхронизация перевела часы через границу (после первой — все события).
+ * Чтение локального времени не блокируется (в отличие от getLocalTime()).
+ */
+class ClockService
+{
+public:
+  ClockService() = delete;
+
+  /** @brief Создать таймер границ и подключиться к уведомлениям SNTP (вызывать до создания задач) */
+  static void init();
+
+  /**
+   * @brief Подписать задачу на события часов
+   * @param task Дескриптор задачи
+   * @param events Маска событий NOTIFY_BIT_MINUTE/HOUR/DATE/TIME_SYNC
+   * @return false если достигнут лимит подписчиков
+   */
+  static bool subscribe(TaskHandle_t task, uint32_t events);
+
+  /** @brief Время синхронизировано (по SNTP или установлено ранее) */
+  static bool is_synced();
+
+  /**
+   * @brief Текущее локальное время без ожидания
+   * @return false если время ещё не синхронизировано (`out` не изменяется)
+   */
+  static bool local_time(struct tm &out);
+
+  /** @brief Количество синхронизаций SNTP с момента загрузки */
+  static uint32_t sync_count();
+};
+
+#endif // _CLOCK_SERVICE_H_
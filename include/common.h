@@ -18,9 +18,9 @@
 #define NRF_SCK_PIN 6
 #define NRF_CSN_PIN 5
 #define NRF_CE_PIN 4
-
-#define DATA_QUEUE_SIZE 10
-#define DATA_QUEUE_ITEM_SIZE sizeof(QueDataItem_t)
+#define NRF_IRQ_PIN 7             // линия IRQ (активный низкий уровень); -1 — не подключена
+#define NRF_POLL_INTERVAL_MS 5000 // интервал опроса, если линия IRQ не подключена
+#define NRF_ACK_PAYLOADS 0        // обратный канал (ACK payload, динамическая длина на всех pipe); 1 — только если узлов версии 1 со статической длиной нет
 
 // Provide a simple LGFX wrapper type (common pattern used in LovyanGFX examples)
 class LGFX : public lgfx::LGFX_Device
@@ -124,6 +124,8 @@ public:
 #define PROTASK_NRF_RECEIVER_STACK_SIZE 4096   // размер стека задачи NRF_RECEIVER
 #define PROTASK_MQTT_PUBLISHER_STACK_SIZE 4096 // размер стека задачи MQTT_PUBLISHER
 #define PROTASK_OTA_STACK_SIZE 10240           // размер стека задачи OTA (увеличен для HTTPS)
+#define PROTASK_I2C_STACK_SIZE 2048            // размер стека задачи I2C (исполнитель транзакций I2cEngine)
+#define PROTASK_HISTORY_STACK_SIZE 4096        // размер стека задачи HISTORY (журнал показаний TsLog, сохранение агрегатов)
 
 #define METEO_POLL_INTERVAL_MS (60000 * 10)                      // интервал опроса метео-данных (10 минут)
 #define MAX_METEO_VALID_INTERVAL_MS (METEO_POLL_INTERVAL_MS * 3) // максимальный интервал валидности метео-данных (30 минут)
@@ -133,35 +135,26 @@ enum ProjectTasks_t
 {
   PROTASK_TFT = 0,        // задача обновления данных на TFT
   PROTASK_NETWORKING,     // задача работы с сетью (WiFi, MQTT и т.п.)
-  PROTASK_HOME_SENSOR,    // задача работы с "домашним" датчиком домашней метеостанции
+  PROTASK_HOME_SENSOR,    // задача опроса датчиков метеостанции (SensorScheduler, комнатный BME280 и др.)
   PROTASK_NRF_RECEIVER,   // задача приёма данных с наружнего датчика с помощью nRF24L01+
   PROTASK_MQTT_PUBLISHER, // задача публикации данных в MQTT
   PROTASK_OTA,            // задача обновления прошивки по OTA
+  PROTASK_I2C,            // задача-исполнитель асинхронных транзакций I2C
+  PROTASK_HISTORY,        // задача журнала показаний во флеш-памяти (TsLog)
   _PROTASK_NUM_
 };
 
-/// @brief типы данных в очереди
+/// @brief типы данных в очереди (они же топики шины данных DataBus)
 enum QueDataType_t
 {
-  QUE_DATATYPE_CFG = 0,         // конфигурационные данные (PrjCfgData)
-  QUE_DATATYPE_METEO,           // метеосводка (массив структуры MeteoData_t)
+  QUE_DATATYPE_METEO = 0,       // метеосводка (массив структуры MeteoData_t)
   QUE_DATATYPE_GEOMAGNETIC,     // геомагнитная обстановка (массив структуры GeoMagneticKpMax)
   QUE_DATATYPE_IN_SENSOR_DATA,  // данные с комнатного (in) датчика метеостанции (структура HomeSensorData_t)
   QUE_DATATYPE_OUT_SENSOR_DATA, // данные с наружнего датчика метеостанции (структура OutSensorData_t)
-  QUE_DATATYPE_CITYNAME,        // наименование населённого пункта (String*)
+  QUE_DATATYPE_CITYNAME,        // наименование населённого пункта (строка UTF-8)
   _QUE_DATATYPE_NUM_,
 };
 
-/// @brief элемент данных в очереди
-struct QueDataItem_t
-{
-  QueDataType_t type; // тип данных в очереди
-  void *data;         // указатель на данные
-};
-
-// Количество измерений для усреднения данных домашнего сенсора
-static const int HOME_SENSOR_AVG_SAMPLES = 5;
-
 /// @brief структура данных конфигурации проекта (конфигурируется через веб-портал)
 struct PrjCfgData
 {
@@ -175,6 +168,9 @@ struct PrjCfgData
   char latitude[8] = {"55.7522"};     // широта для open-meteo
   char longitude[8] = {"37.6155"};    // долгота для open-meteo
   char gmt_offset_sec[6] = {"10800"}; // смещение часового пояса в секундах (Москва +3 часа = 10800 секунд)
+  char sample_min_sec[6] = {"30"};    // минимальный интервал опроса комнатного датчика (быстрые изменения), с
+  char sample_max_sec[6] = {"600"};   // максимальный интервал опроса комнатного датчика (стабильные показания), с
+  char out_interval_sec[6] = {"60"};  // период передачи наружных датчиков (сообщается им по радио), с
 };
 
 /// @brief структура данных внутреннего датчика метеостанции
@@ -194,6 +190,13 @@ typedef struct __attribute__((packed))
   uint16_t bat_charge{0}; // заряд батареи в процентах // TODO: реализовать
 } OutSensorData_t;
 
+/// @brief метка времени получения образца данных (ставится в момент измерения/приёма)
+struct SampleStamp_t
+{
+  int64_t mono_us; // монотонное время (esp_timer_get_time(), мкс с момента загрузки)
+  time_t wall;     // время UTC (0 — часы ещё не синхронизированы)
+};
+
 /// @brief биты состояния системы
 #define BIT_WIFI_STATE_UP BIT1 // WiFi подключен
 #define BIT_MQTT_STATE_UP BIT3 // MQTT подключен
@@ -202,4 +205,15 @@ typedef struct __attribute__((packed))
 // Бит уведомления о процессе OTA-обновления (если установлен — показывать экран "обновление")
 #define BIT_OTA_UPDATE_BIT BIT9
 
+/// @brief биты уведомлений задач (xTaskNotify); младшие биты 0.._QUE_DATATYPE_NUM_-1 заняты топиками шины данных
+#define NOTIFY_BIT_STATE BIT16     // обновлено состояние станции (StationState)
+#define NOTIFY_BIT_SYSTEM BIT17    // изменились биты состояния системы (xEventGroup)
+#define NOTIFY_BIT_MINUTE BIT18    // смена минуты (ClockService)
+#define NOTIFY_BIT_HOUR BIT19      // смена часа (ClockService)
+#define NOTIFY_BIT_DATE BIT20      // смена даты (ClockService)
+#define NOTIFY_BIT_TIME_SYNC BIT21 // время синхронизировано по SNTP (ClockService)
+#define NOTIFY_BIT_I2C BIT22       // завершена транзакция I2C (I2cEngine::transfer)
+#define NOTIFY_BIT_NRF_IRQ BIT23   // прерывание nRF24L01+ (линия IRQ)
+#define NOTIFY_BIT_CONFIG BIT24    // сохранена новая конфигурация (ConfigService)
+
 #endif // _COMMON_H_
\ No newline at end of file
@@ -0,0 +1,33 @@
+#ifndef _CONFIG_API_H_
+#define _CONFIG_API_H_
+
+#include <esp_http_server.h>
+
+#define CONFIG_API_BODY_SIZE 512 // наибольшее тело запроса POST /api/config
+
+/*
+ * POST /api/config, тело application/x-www-form-urlencoded:
+ *
+ *   mqtt_server=...&mqtt_port=...&mqtt_user=...&mqtt_pass=...&mqtt_prefix=...
+ *   latitude=...&longitude=...&gmt_offset_sec=...
+ *   sample_min_sec=...&sample_max_sec=...&out_interval_sec=...
+ *
+ * Передаются только изменяемые параметры, остальные остаются прежними. Длина значения —
+ * как в веб-портале, числовые параметры — только цифры (смещение пояса может быть
+ * отрицательным). Ошибка в любом параметре — 400 без изменений. Ответ — версия
+ * конфигурации; подписанные задачи применяют изменения без перезагрузки.
+ */
+
+/**
+ * @brief Изменение конфигурации во время работы по локальному HTTP (после веб-портала)
+ */
+class ConfigApi
+{
+public:
+  ConfigApi() = delete;
+
+  /** @brief Зарегистрировать обработчик на запущенном HTTP-сервере */
+  static bool attach(httpd_handle_t server);
+};
+
+#endif // _CONFIG_API_H_
@@ -0,0 +1,63 @@
+#ifndef _CONFIG_SERVICE_H_
+#define _CONFIG_SERVICE_H_
+
+#include "common.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#define CONFIG_MAX_SUBSCRIBERS 4 // максимальное количество задач, получающих NOTIFY_BIT_CONFIG
+
+/// @brief группы параметров конфигурации (маска изменений ConfigService::diff)
+#define CONFIG_CHANGED_MQTT BIT0         // сервер, порт, логин, пароль или префикс MQTT
+#define CONFIG_CHANGED_LOCATION BIT1     // координаты для Open-Meteo и населённого пункта
+#define CONFIG_CHANGED_TIMEZONE BIT2     // смещение часового пояса
+#define CONFIG_CHANGED_SAMPLING BIT3     // границы интервала опроса комнатного датчика
+#define CONFIG_CHANGED_OUT_INTERVAL BIT4 // период передачи наружных датчиков
+
+/**
+ * @brief Конфигурация станции в памяти
+ *
+ * Параметры читаются из NVS один раз при запуске, дальше задачи получают копию из памяти.
+ * Сохранение (веб-портал при запуске, POST /api/config во время работы) записывает NVS, увеличивает версию и уведомляет подписанные
+ * задачи битом NOTIFY_BIT_CONFIG. Задача хранит версию своей копии: если версия службы
+ * другая — копия перечитывается, а изменившиеся группы параметров (diff) применяются
+ * без перезагрузки.
+ */
+class ConfigService
+{
+public:
+  ConfigService() = delete;
+
+  /** @brief Перенести config.json в NVS и загрузить конфигурацию (после монтирования LittleFS, до создания задач) */
+  static void init();
+
+  /**
+   * @brief Копия текущей конфигурации
+   * @param cfg Заполняется значениями из памяти
+   * @param version Если не nullptr — версия выданной копии
+   * @return false если конфигурация ещё не сохранялась (в `cfg` значения по умолчанию)
+   */
+  static bool get(PrjCfgData &cfg, uint32_t *version = nullptr);
+
+  /** @brief Версия конфигурации: увеличивается при каждом сохранении с изменениями */
+  static uint32_t version();
+
+  /**
+   * @brief Сохранить конфигурацию в NVS и разослать уведомления
+   *
+   * Без изменений запись в NVS не выполняется и версия не меняется.
+   * @return false если не удалось записать NVS (конфигурация в памяти не меняется)
+   */
+  static bool save(const PrjCfgData &cfg);
+
+  /**
+   * @brief Уведомлять задачу (бит NOTIFY_BIT_CONFIG) при каждом изменении конфигурации
+   * @return false если достигнут лимит подписчиков
+   */
+  static bool subscribe(TaskHandle_t task);
+
+  /** @brief Маска CONFIG_CHANGED_* групп, различающихся в `a` и `b` */
+  static uint32_t diff(const PrjCfgData &a, const PrjCfgData &b);
+};
+
+#endif // _CONFIG_SERVICE_H_
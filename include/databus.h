@@ -0,0 +1,263 @@
+#ifndef _DATABUS_H_
+#define _DATABUS_H_
+
+#include "common.h"
+#include "openmeteo.h"
+#include "spsc_channel.h"
+#include <atomic>
+#include <string.h>
+
+#define BUS_POOL_SIZE 32      // количество образцов в пуле (не более 32 — битовая карта занятости)
+#define BUS_INBOX_SIZE 16     // ёмкость входящего канала подписчика на один топик (степень двойки)
+#define BUS_MAX_SUBSCRIBERS 4 // максимальное количество подписчиков одного топика
+#define BUS_CITY_NAME_LEN 64  // максимальная длина наименования населённого пункта (UTF-8, с NUL)
+#define BUS_MAX_LISTENERS 4   // максимальное количество синхронных слушателей шины
+// бит уведомления задачи-подписчика о новом образце в топике
+#define BUS_NOTIFY_BIT(topic) (1UL << (topic))
+
+constexpr size_t bus_max_size(size_t a, size_t b)
+{
+  return (a > b) ? a : b;
+}
+
+// размер полезной нагрузки образца — максимум из всех типов данных, передаваемых по шине
+constexpr size_t BUS_PAYLOAD_SIZE = bus_max_size(bus_max_size(bus_max_size(sizeof(HomeSensorData_t), sizeof(OutSensorData_t)),
+                                                              bus_max_size(sizeof(OpenMeteoData), sizeof(GeoMagneticKpMax))),
+                                                 BUS_CITY_NAME_LEN);
+
+/**
+ * @brief Неизменяемый образец данных шины, разделяемый всеми подписчиками топика
+ *
+ * Образцы выделяются из статического пула, после публикации не изменяются и
+ * возвращаются в пул, когда последний подписчик освобождает ссылку.
+ */
+struct BusSample_t
+{
+  std::atomic<uint8_t> refs{0};                 // счётчик ссылок
+  QueDataType_t topic{QUE_DATATYPE_METEO};      // топик образца (задаётся в alloc)
+  uint32_t seq{0};                              // порядковый номер публикации в топике
+  uint8_t source{0};                            // источник внутри топика (номер узла наружного датчика)
+  SampleStamp_t stamp{0, 0};                    // время получения данных (измерения/приёма)
+  alignas(8) uint8_t payload[BUS_PAYLOAD_SIZE]; // данные образца (тип определяется топиком)
+
+  template <typename T>
+  const T &as() const
+  {
+    return *reinterpret_cast<const T *>(payload);
+  }
+
+  const char *c_str() const
+  {
+    return reinterpret_cast<const char *>(payload);
+  }
+};
+
+/// @brief входящий канал подписчика на один топик
+typedef SpscChannel<BusSample_t *, BUS_INBOX_SIZE> BusInbox_t;
+
+/// @brief синхронный слушатель шины (вызывается в контексте производителя для каждого образца)
+typedef void (*BusListener_t)(const BusSample_t &sample);
+
+/// @brief счётчики топика шины
+struct BusTopicStats_t
+{
+  uint32_t published; // опубликовано образцов
+  uint32_t delivered; // доставлено подписчикам (по одному на подписчика)
+  uint32_t dropped;   // потеряно (пул исчерпан или истекло ожидание места в канале подписчика)
+};
+
+/**
+ * @brief Топиковая шина данных "публикация/подписка"
+ *
+ * Производитель публикует образец один раз; каждый подписчик получает указатель на
+ * один и тот же образец через собственный SPSC-канал, поэтому разветвление не требует копий.
+ * Топиком является тип данных `QueDataType_t`, у каждого топика ровно один производитель.
+ */
+class DataBus
+{
+public:
+  DataBus() = delete;
+
+  /**
+   * @brief Выделить образец из пула для последующего заполнения и публикации
+   *
+   * Метка времени образца устанавливается в момент выделения; производитель может
+   * заменить её временем фактического измерения.
+   * @return указатель на образец со счётчиком ссылок 1 или nullptr при исчерпании пула
+   */
+  static BusSample_t *alloc(QueDataType_t topic);
+
+  /**
+   * @brief Опубликовать заполненный образец; ссылка производителя передаётся шине
+   * @return true если образец опубликован (даже при отсутствии подписчиков)
+   */
+  static bool publish(BusSample_t *sample);
+
+  /**
+   * @brief Скопировать данные в образец из пула и опубликовать его
+   */
+  template <typename T>
+  static bool publish(QueDataType_t topic, const T &data)
+  {
+    static_assert(sizeof(T) <= BUS_PAYLOAD_SIZE, "Bus payload is too small for this type");
+    BusSample_t *sample = alloc(topic);
+    if (!sample)
+      return false;
+    memcpy(sample->payload, &data, sizeof(T));
+    return publish(sample);
+  }
+
+  /**
+   * @brief Скопировать данные в образец из пула и опубликовать его с заданной меткой времени получения
+   * @param source Источник внутри топика (например, номер узла наружного датчика)
+   */
+  template <typename T>
+  static bool publish(QueDataType_t topic, const T &data, const SampleStamp_t &stamp, uint8_t source = 0)
+  {
+    static_assert(sizeof(T) <= BUS_PAYLOAD_SIZE, "Bus payload is too small for this type");
+    BusSample_t *sample = alloc(topic);
+    if (!sample)
+      return false;
+    memcpy(sample->payload, &data, sizeof(T));
+    sample->stamp = stamp;
+    sample->source = source;
+    return publish(sample);
+  }
+
+  /**
+   * @brief Опубликовать строку (усекается до BUS_CITY_NAME_LEN - 1 байт)
+   */
+  static bool publish_string(QueDataType_t topic, const char *str);
+
+  /**
+   * @brief Освободить ссылку на образец (возвращает образец в пул при обнулении счётчика)
+   */
+  static void release(BusSample_t *sample);
+
+  /**
+   * @brief Зарегистрировать входящий канал подписчика на топик
+   * @return false если достигнут лимит подписчиков топика
+   */
+  static bool subscribe(QueDataType_t topic, BusInbox_t *inbox);
+
+  /**
+   * @brief Зарегистрировать синхронного слушателя всех топиков (вызывать до создания задач)
+   * @return false если достигнут лимит слушателей
+   */
+  static bool add_listener(BusListener_t listener);
+
+  /**
+   * @brief Политика переполнения входящего канала по умолчанию для топика:
+   * комнатный датчик — только последнее значение, остальные топики — вытеснение старых.
+   * Ожидание производителя (CHANNEL_POLICY_BLOCK) задаётся подписчиком явно: производители
+   * шины — задачи датчиков и сети, их задержка ожиданием подписчика недопустима
+   */
+  static ChannelPolicy_t default_policy(QueDataType_t topic);
+
+  static void get_stats(QueDataType_t topic, BusTopicStats_t &stats);
+
+  /**
+   * @brief Счётчики входящего канала подписчика
+   * @param index Номер подписчика топика (в порядке подписки)
+   * @return false если подписчика с таким номером нет
+   */
+  static bool get_inbox_stats(QueDataType_t topic, uint8_t index, ChannelStats_t &stats);
+
+  static void log_stats();
+
+  /** @brief Счётчики топиков и входящих каналов в JSON для MQTT; false если буфер мал */
+  static bool to_json(char *buf, size_t size);
+};
+
+/**
+ * @brief RAII-ссылка на образец шины (только перемещение)
+ */
+class BusSampleRef
+{
+public:
+  BusSampleRef() = default;
+  explicit BusSampleRef(BusSample_t *s) : sample(s)
+  {
+  }
+  BusSampleRef(BusSampleRef &&other) : sample(other.sample)
+  {
+    other.sample = nullptr;
+  }
+  BusSampleRef &operator=(BusSampleRef &&other)
+  {
+    if (this != &other)
+    {
+      reset();
+      sample = other.sample;
+      other.sample = nullptr;
+    }
+    return *this;
+  }
+  ~BusSampleRef()
+  {
+    reset();
+  }
+
+  void reset(BusSample_t *s = nullptr)
+  {
+    if (sample)
+      DataBus::release(sample);
+    sample = s;
+  }
+
+  const BusSample_t *operator->() const
+  {
+    return sample;
+  }
+  const BusSample_t &operator*() const
+  {
+    return *sample;
+  }
+  explicit operator bool() const
+  {
+    return sample != nullptr;
+  }
+
+private:
+  BusSampleRef(const BusSampleRef &) = delete;
+  BusSampleRef &operator=(const BusSampleRef &) = delete;
+
+  BusSample_t *sample{nullptr}; // удерживаемый образец
+};
+
+/**
+ * @brief Подписчик шины: набор входящих каналов (по одному на топик) одной задачи
+ *
+ * subscribe() вызывается из задачи-подписчика: её дескриптор используется для уведомлений
+ * (бит BUS_NOTIFY_BIT(topic)).
+ */
+class BusSubscriber
+{
+public:
+  BusSubscriber() = default;
+
+  /** @brief Подписаться на топик с политикой переполнения по умолчанию (DataBus::default_policy) */
+  bool subscribe(QueDataType_t topic);
+  bool subscribe(QueDataType_t topic, ChannelPolicy_t policy);
+
+  /**
+   * @brief Извлечь очередной образец из любого подписанного топика
+   * @return true если образец получен (прежнее содержимое `ref` освобождается)
+   */
+  bool receive(BusSampleRef &ref);
+
+  /** @brief Маска битов уведомлений подписанных топиков */
+  uint32_t notify_mask() const
+  {
+    return mask;
+  }
+
+private:
+  BusSubscriber(const BusSubscriber &) = delete;
+  BusSubscriber &operator=(const BusSubscriber &) = delete;
+
+  BusInbox_t inbox[_QUE_DATATYPE_NUM_]; // входящие каналы по топикам
+  uint32_t mask{0};                     // маска подписанных топиков
+};
+
+#endif // _DATABUS_H_
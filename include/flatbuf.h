@@ -0,0 +1,73 @@
+#ifndef _FLATBUF_H_
+#define _FLATBUF_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Таблица FlatBuffers, читаемая на месте в принятом буфере
+ *
+ * Значения берутся прямо из буфера по смещениям из vtable, без разбора и копирования.
+ * Каждое смещение проверяется по границам буфера: у повреждённого или обрезанного ответа
+ * поля отсутствуют (таблица невалидна, скаляры — значения по умолчанию), чтения за
+ * пределами буфера нет. Порядок байт little-endian, как у ESP32. Схема не нужна: поле
+ * задаётся номером в таблице (порядок объявления в .fbs). Не зависит от платформы и
+ * собирается на хосте.
+ */
+class FbTable
+{
+public:
+  FbTable() : buf(nullptr), size(0), pos(0), vt(0), vt_size(0), tsize(0) {}
+
+  /**
+   * @brief Корневая таблица сообщения с префиксом длины (uint32 перед буфером)
+   * @param data Принятые данные
+   * @param len Длина принятых данных
+   * @param used Если не nullptr — длина сообщения вместе с префиксом (0 если сообщение неполное)
+   */
+  static FbTable size_prefixed_root(const uint8_t *data, size_t len, size_t *used = nullptr);
+
+  /** @brief Корневая таблица буфера без префикса длины */
+  static FbTable root(const uint8_t *data, size_t len);
+
+  /** @brief Таблица найдена и её vtable в пределах буфера */
+  bool valid() const { return buf != nullptr; }
+
+  /** @brief Поле присутствует в таблице */
+  bool has(uint16_t field) const { return field_pos(field, 1) != 0; }
+
+  int32_t get_i32(uint16_t field, int32_t def = 0) const;
+  int64_t get_i64(uint16_t field, int64_t def = 0) const;
+  float get_f32(uint16_t field, float def = 0.0f) const;
+
+  /** @brief Вложенная таблица (невалидна, если поля нет) */
+  FbTable table(uint16_t field) const;
+
+  /** @brief Длина вектора (0 если поля нет) */
+  uint32_t vector_size(uint16_t field) const;
+
+  /** @brief Элемент вектора таблиц (невалиден, если индекс вне вектора) */
+  FbTable vector_table(uint16_t field, uint32_t index) const;
+
+  /** @brief Элемент вектора float (`def`, если индекс вне вектора) */
+  float vector_f32(uint16_t field, uint32_t index, float def = 0.0f) const;
+
+private:
+  FbTable(const uint8_t *buf, uint32_t size, uint32_t pos);
+
+  // Положение данных поля в буфере (0 — поля нет или `bytes` не помещаются в таблицу)
+  uint32_t field_pos(uint16_t field, uint32_t bytes) const;
+  // Положение объекта по смещению uoffset_t, записанному в `at` (0 — вне буфера)
+  uint32_t deref(uint32_t at) const;
+  // Положение первого элемента вектора поля (0 — поля нет или вектор вне буфера)
+  uint32_t vector(uint16_t field, uint32_t elem_size, uint32_t &count) const;
+
+  const uint8_t *buf; // начало буфера FlatBuffers (после префикса длины)
+  uint32_t size;      // длина буфера
+  uint32_t pos;       // начало таблицы
+  uint32_t vt;        // начало vtable
+  uint16_t vt_size;   // длина vtable, байт
+  uint16_t tsize;     // длина таблицы, байт
+};
+
+#endif // _FLATBUF_H_
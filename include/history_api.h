@@ -0,0 +1,48 @@
+#ifndef _HISTORY_API_H_
+#define _HISTORY_API_H_
+
+#include <esp_http_server.h>
+#include <stdint.h>
+
+#define HISTORY_API_PORT 80            // порт HTTP-сервера выгрузки истории
+#define HISTORY_API_STACK_SIZE 6144    // стек задачи HTTP-сервера (обработчик читает страницы журнала)
+#define HISTORY_API_CHUNK_SIZE 1024    // буфер фрагмента ответа (Transfer-Encoding: chunked)
+#define HISTORY_API_ROLLUP_BATCH 16    // интервалов агрегатов за одно чтение уровня
+#define HISTORY_API_MAGIC 0x54534948u  // "HIST": двоичный ответ
+#define HISTORY_API_VERSION 1          // версия двоичного формата
+
+/*
+ * GET /api/history?from=<UTC, с>&to=<UTC, с>&metrics=<список>&res=<разрешение>&format=<формат>
+ *
+ *   from, to  интервал [from, to); по умолчанию — последние сутки
+ *   metrics   через запятую: in_t, in_h, in_p, out_t, out_h, out_p; по умолчанию — все
+ *   res       raw — минутные записи журнала TsLog; minute, hour, day — агрегаты Rollup
+ *   format    csv (по умолчанию) или bin
+ *
+ * CSV: строка заголовка, затем по строке на запись. Для raw — значения каналов
+ * (°C, %, гПа; пусто — нет данных), для агрегатов — <канал>_min, <канал>_avg, <канал>_max.
+ *
+ * bin (little-endian): заголовок 8 байт — magic HISTORY_API_MAGIC, версия, разрешение
+ * (0 raw, 1 minute, 2 hour, 3 day), маска каналов (бит = TsChannel_t), размер записи.
+ * Запись raw: время uint32 и по int16 на канал (фиксированная точка журнала, INT16_MIN — нет данных).
+ * Запись агрегата: начало интервала uint32 и на канал int16 min, int16 max, int32 сумма, uint16 количество.
+ *
+ * Ответ передаётся фрагментами по мере чтения: весь ответ в памяти не собирается.
+ */
+
+/**
+ * @brief Локальный HTTP API выгрузки истории показаний (esp_http_server)
+ */
+class HistoryApi
+{
+public:
+  HistoryApi() = delete;
+
+  /** @brief Запустить HTTP-сервер (после подключения к WiFi; повторный вызов ничего не делает) */
+  static bool start();
+
+  /** @brief Запущенный сервер (nullptr до start()): на нём же регистрируются другие локальные API */
+  static httpd_handle_t server();
+};
+
+#endif // _HISTORY_API_H_
@@ -2,6 +2,10 @@
 #define _HTTP_HELPERS_H_
 
 #include <Arduino.h>
+#include <WiFiClient.h>
+
+#define HTTP_BODY_BUFFER_SIZE 512  // порция чтения тела ответа из сокета, байт
+#define HTTP_BODY_TIMEOUT_MS 10000 // наибольшая пауза в получении тела ответа, мс
 
 /**
  * @brief Выполняет HTTP GET и возвращает тело ответа
@@ -20,4 +24,54 @@ String send_HTTP_GET_request(const char *serverName);
  */
 String send_HTTPS_GET_request(const char *serverName, const char *ca_cert, const String &user_agent = String(""));
 
+/**
+ * @brief Буферизованное чтение тела HTTP-ответа (источник для deserializeJson)
+ *
+ * Побайтовое чтение из TLS-сокета медленное, поэтому тело читается порциями по
+ * HTTP_BODY_BUFFER_SIZE байт. Конец тела — Content-Length, закрытие соединения или
+ * пауза дольше HTTP_BODY_TIMEOUT_MS.
+ */
+class HttpBodyReader
+{
+public:
+  HttpBodyReader(WiFiClient &client, int content_length);
+
+  /** @brief Следующий байт тела или -1 в конце */
+  int read();
+
+  /** @brief Прочитать до `length` байт; меньше — только в конце тела */
+  size_t readBytes(char *buffer, size_t length);
+
+  /** @brief Получено байт тела */
+  size_t received() const { return total; }
+
+private:
+  bool fill();
+
+  WiFiClient &client;
+  int remaining; // осталось по Content-Length (-1 — длина неизвестна)
+  size_t pos;    // позиция чтения в буфере
+  size_t len;    // заполнено в буфере
+  size_t total;  // получено байт тела
+  uint8_t buf[HTTP_BODY_BUFFER_SIZE];
+};
+
+/// @brief обработчик тела ответа; результат возвращается из send_HTTPS_GET_stream
+typedef bool (*HttpBodyHandler_t)(HttpBodyReader &body, void *ctx);
+
+/**
+ * @brief Выполняет HTTPS GET и передаёт тело ответа обработчику по мере получения
+ *
+ * Тело не собирается в памяти целиком. Запрос отправляется по HTTP/1.0, чтобы сервер
+ * не применял chunked-кодирование (обработчик получает тело без разметки фрагментов).
+ * @param serverName URL для запроса
+ * @param ca_cert PEM-строка корневого сертификата или nullptr
+ * @param handler Обработчик тела (вызывается только для ответа 200)
+ * @param ctx Параметр обработчика
+ * @param user_agent Заголовок User-Agent (опционально)
+ * @return результат обработчика; false при ошибке соединения или другом коде ответа
+ */
+bool send_HTTPS_GET_stream(const char *serverName, const char *ca_cert, HttpBodyHandler_t handler, void *ctx,
+                           const String &user_agent = String(""));
+
 #endif // _HTTP_HELPERS_H_
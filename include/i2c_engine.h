@@ -0,0 +1,96 @@
+#ifndef _I2C_ENGINE_H_
+#define _I2C_ENGINE_H_
+
+#include "common.h"
+#include <driver/i2c.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define I2C_ENGINE_QUEUE_LEN 8   // ёмкость очереди транзакций
+#define I2C_ENGINE_TX_MAX 8      // максимальная длина записываемых данных (копируются в транзакцию)
+#define I2C_ENGINE_TIMEOUT_MS 50 // таймаут выполнения одной транзакции на шине
+
+struct I2cTransaction_t;
+
+/// @brief обработчик завершения транзакции (вызывается в контексте задачи I2C, должен быть коротким)
+typedef void (*I2cCallback_t)(const I2cTransaction_t &t, esp_err_t result);
+
+/// @brief транзакция I2C: запись `tx` и/или чтение в `rx` (с повторным START между ними)
+struct I2cTransaction_t
+{
+  uint8_t addr;                  // 7-битный адрес устройства
+  uint8_t tx[I2C_ENGINE_TX_MAX]; // записываемые данные (обычно номер регистра и значение)
+  uint8_t tx_len;                // длина записываемых данных (0 — только чтение)
+  uint8_t *rx;                   // буфер чтения (должен быть действителен до завершения)
+  size_t rx_len;                 // длина чтения (0 — только запись)
+  I2cCallback_t callback;        // обработчик завершения (nullptr — не вызывать)
+  void *ctx;                     // пользовательский контекст обработчика
+  TaskHandle_t notify_task;      // задача, уведомляемая о завершении (nullptr — не уведомлять)
+  uint32_t notify_bit;           // бит уведомления задачи
+  volatile esp_err_t *result;    // куда записать результат (nullptr — не записывать)
+};
+
+/// @brief счётчики исполнителя транзакций
+struct I2cEngineStats_t
+{
+  uint32_t submitted;   // поставлено в очередь
+  uint32_t completed;   // выполнено успешно
+  uint32_t failed;      // завершено с ошибкой
+  uint32_t rejected;    // не поставлено (очередь заполнена)
+  uint32_t queue_hwm;   // максимальная заполненность очереди
+  uint64_t bus_busy_us; // суммарное время транзакций на шине (мкс)
+};
+
+/**
+ * @brief Асинхронный исполнитель транзакций I2C
+ *
+ * Задачи ставят транзакции в очередь и продолжают работу; задача I2C выполняет их по одной
+ * через командную последовательность драйвера ESP-IDF (i2c_master_cmd_begin — обмен ведёт
+ * обработчик прерывания контроллера, задача I2C в это время заблокирована, а не опрашивает шину).
+ * Завершение сообщается обработчиком и/или уведомлением задачи. Драйвер порта устанавливается
+ * Wire.begin(), поэтому оставшиеся вызовы Wire и транзакции исполнителя сериализуются драйвером.
+ * Это верно только для Arduino-ESP32 2.x (Wire поверх driver/i2c.h); ядро 3.x устанавливает
+ * драйвер нового API (i2c_master.h), с которым командная последовательность не работает, —
+ * версия платформы закреплена в platformio.ini.
+ */
+class I2cEngine
+{
+public:
+  I2cEngine() = delete;
+
+  /** @brief Создать очередь транзакций (вызывать до создания задач) */
+  static bool init(i2c_port_t port = I2C_NUM_0);
+
+  /**
+   * @brief Поставить транзакцию в очередь
+   * @param wait Сколько ждать места в очереди
+   * @return false если очередь заполнена или движок не инициализирован
+   */
+  static bool submit(const I2cTransaction_t &t, TickType_t wait = 0);
+
+  /**
+   * @brief Синхронная транзакция: поставить в очередь и дождаться завершения (NOTIFY_BIT_I2C)
+   *
+   * Ожидание не ограничено: каждая транзакция завершается не позже I2C_ENGINE_TIMEOUT_MS,
+   * поэтому буферы на стеке вызывающего остаются действительными. Прочие биты уведомлений,
+   * пришедшие во время ожидания, возвращаются задаче.
+   * @return результат выполнения (ESP_ERR_NO_MEM если очередь заполнена)
+   */
+  static esp_err_t transfer(uint8_t addr, const uint8_t *tx, uint8_t tx_len, uint8_t *rx, size_t rx_len);
+
+  /** @brief Записать значение в регистр устройства (синхронно) */
+  static esp_err_t write_reg(uint8_t addr, uint8_t reg, uint8_t value);
+
+  /** @brief Прочитать блок регистров устройства одной транзакцией (синхронно) */
+  static esp_err_t read_regs(uint8_t addr, uint8_t reg, uint8_t *buf, size_t len);
+
+  /** @brief Цикл задачи I2C: извлечение и выполнение транзакций */
+  static void run();
+
+  static void get_stats(I2cEngineStats_t &stats);
+  static void log_stats();
+};
+
+#endif // _I2C_ENGINE_H_
@@ -0,0 +1,80 @@
+#ifndef _LATENCY_TRACE_H_
+#define _LATENCY_TRACE_H_
+
+#include "common.h"
+#include <freertos/FreeRTOS.h>
+#include <stdint.h>
+
+#define LATENCY_BUCKETS 24 // количество корзин гистограммы: корзина b — задержки [2^b, 2^(b+1)) мкс, последняя — всё дольше
+
+/// @brief точки потребления данных, для которых измеряется задержка "получение образца → результат"
+enum LatencyPoint_t
+{
+  LATENCY_POINT_TFT = 0,  // данные выведены на экран
+  LATENCY_POINT_MQTT,     // данные опубликованы в MQTT
+  LATENCY_POINT_NARODMON, // данные отправлены на NarodMon
+  LATENCY_POINT_NRF_RX,   // пакет nRF24 прочитан задачей приёма (от прерывания RX_DR)
+  _LATENCY_POINT_NUM_
+};
+
+/// @brief снимок гистограммы задержек
+struct LatencyStats_t
+{
+  uint32_t buckets[LATENCY_BUCKETS]; // количество измерений по корзинам
+  uint32_t count;                    // всего измерений
+  uint32_t min_us;                   // минимальная задержка (мкс)
+  uint32_t max_us;                   // максимальная задержка (мкс)
+  uint64_t sum_us;                   // сумма задержек (мкс) для вычисления среднего
+};
+
+/**
+ * @brief Метка времени "сейчас" для образца данных (монотонное время и UTC)
+ */
+SampleStamp_t sample_stamp_now();
+
+/**
+ * @brief Гистограмма задержек с логарифмическими (по основанию 2) корзинами
+ *
+ * Запись и чтение защищены спинлоком, поэтому гистограммой могут пользоваться
+ * несколько задач на разных ядрах.
+ */
+class LatencyHistogram
+{
+public:
+  LatencyHistogram();
+
+  void record(uint32_t us);
+  void get_stats(LatencyStats_t &stats);
+  void reset();
+
+  /**
+   * @brief Оценка перцентиля по снимку гистограммы (верхняя граница корзины)
+   * @param p Перцентиль 0..100
+   * @return задержка в мкс (0 если измерений нет)
+   */
+  static uint32_t percentile(const LatencyStats_t &stats, uint8_t p);
+
+private:
+  LatencyHistogram(const LatencyHistogram &) = delete;
+  LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+  LatencyStats_t data; // накопленные значения
+  portMUX_TYPE mux;    // спинлок доступа к data
+};
+
+/**
+ * @brief Трассировка задержек от получения образца до его потребления по точкам LatencyPoint_t
+ */
+class LatencyTrace
+{
+public:
+  LatencyTrace() = delete;
+
+  /** @brief Учесть задержку от момента получения образца `stamp` до текущего момента */
+  static void record(LatencyPoint_t point, const SampleStamp_t &stamp);
+
+  static void get_stats(LatencyPoint_t point, LatencyStats_t &stats);
+  static void log_stats();
+};
+
+#endif // _LATENCY_TRACE_H_
@@ -42,6 +42,10 @@ public:
   {
     return WIDGET_FOR_H;
   }
+  static uint16_t getWidgetHomeInX()
+  {
+    return WIDGET_HOME_W - HOME_ICON_WH; // смещение виджета комнатного датчика от начала виджета дома
+  }
 
   /**
    * @brief Создать или вернуть единственный экземпляр `MeteoWidgets`.
@@ -174,6 +178,15 @@ public:
    */
   bool draw_update_processing_widget();
 
+  /**
+   * @brief Пометка "данные устарели" поверх уже выведенного виджета (восстановлены после перезапуска)
+   * Пометка исчезает при следующей отрисовке виджета со свежими данными.
+   * @param scr_x_pos Левый край виджета
+   * @param scr_y_pos Верхний край виджета
+   * @return true при успехе
+   */
+  bool draw_stale_mark(int scr_x_pos, int scr_y_pos);
+
 #if 0
   /**
    * @brief Рисование всех виджетов на экране (в тестовых целях с тестовыми данными)
@@ -324,6 +337,10 @@ private:
   static const uint16_t WIDGET_BG_COLOR = TFT_DARKGREY;
   /** @brief Цвет часов/даты */
   static const uint16_t DATETIME_COLOR = TFT_YELLOW;
+  /** @brief Цвет пометки устаревших данных */
+  static const uint16_t STALE_MARK_COLOR = TFT_ORANGE;
+  /** @brief Радиус пометки устаревших данных */
+  static const uint16_t STALE_MARK_R = 5;
 
   /**@brief Структура для информации о погоде */
   struct WeatherInfo
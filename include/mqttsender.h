@@ -2,26 +2,32 @@
 #define _MQTTSENDER_H_
 
 #include "common.h"
+#include "databus.h"
 #include <PubSubClient.h>
 #include <WiFi.h>
 
+#define MQTT_BUFFER_SIZE 768 // буфер пакета PubSubClient (по умолчанию 256 — мало для статистики шины и радиолинии)
+
 class MqttSender
 {
 public:
-  MqttSender(QueueHandle_t (&queue_array_ref)[_PROTASK_NUM_]);
+  MqttSender();
   ~MqttSender();
 
   void begin();
   bool connect(const PrjCfgData &cfg);
   void loop(const PrjCfgData &cfg);
+  // Разорвать соединение: следующий loop() сразу подключится с новыми параметрами
+  void reconnect();
   bool connected();
   bool publish(const char *topic, const String &payload);
-  void processing(const PrjCfgData &cfg, QueDataItem_t &qitem);
+  void processing(const PrjCfgData &cfg, const BusSample_t &sample);
+  // Показатели радиолинии nRF24 в топик {mqtt_user}/{mqtt_prefix}/link
+  void publishLink(const PrjCfgData &cfg);
+  // Счётчики шины данных в топик {mqtt_user}/{mqtt_prefix}/bus
+  void publishBus(const PrjCfgData &cfg);
 
 private:
-  // Ссылка на массив очередей проекта
-  QueueHandle_t (&xQueues)[_PROTASK_NUM_];
-
   // Network client and MQTT client
   WiFiClient wifiClient;
   PubSubClient mqttClient;
@@ -18,25 +18,20 @@ class NetProcessor
 public:
   /**
    * @brief Конструктор NetProcessor
-   * @param queue_array_ref Ссылка на массив очередей проекта
    * @param latitude Широта по умолчанию (строка)
    * @param longitude Долгота по умолчанию (строка)
    */
-  NetProcessor(QueueHandle_t (&queue_array_ref)[_PROTASK_NUM_],
-               const String &latitude = "55.7558", const String &longitude = "37.6173");
+  NetProcessor(const String &latitude = "55.7558", const String &longitude = "37.6173");
   ~NetProcessor();
-  /** @brief Ссылка на массив очередей проекта */
-  QueueHandle_t (&xQueues)[_PROTASK_NUM_];
   WiFiManager wm;        // WiFiManager instance (no dynamic allocation)
   WebConfig webConfig;   // WebConfig instance (constructed with wm)
   OpenMeteo openMeteo;   // OpenMeteo instance owned by NetProcessor (no heap)
   MqttSender mqttSender; // MqttSender instance owned by NetProcessor (no heap)
   /**
-   * @brief Выполнить обратное геокодирование и отправить название ближайшего города в очередь TFT
+   * @brief Выполнить обратное геокодирование и опубликовать название ближайшего города
    *
    * Метод читает координаты из конфигурации, запрашивает имя населённого пункта у сервиса
-   * обратного геокодирования и отправляет результат (новый выделенный `String*`) в очередь
-   * задачи `PROTASK_TFT`.
+   * обратного геокодирования и публикует результат в топик `QUE_DATATYPE_CITYNAME` шины данных.
    */
   void NearestCityProcessing();
   bool configureNTPFromConfig();
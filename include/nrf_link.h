@@ -0,0 +1,120 @@
+#ifndef _NRF_LINK_H_
+#define _NRF_LINK_H_
+
+#include "radio_proto.h"
+#include <freertos/FreeRTOS.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define NRF_INTERVAL_FLOOR_S 10               // минимальный период передачи узлов (с)
+#define NRF_SCAN_FIRST_CHANNEL 75             // первый радиоканал сетки сканирования
+#define NRF_SCAN_CHANNEL_STEP 4               // шаг сетки (домашний канал входит в сетку)
+#define NRF_SCAN_CHANNELS 13                  // радиоканалов в сетке (75..123)
+#define NRF_SCAN_PERIOD_MS 10000              // период сканирования в паузах между пакетами (мс)
+#define NRF_SCAN_GUARD_MS 2000                // минимальный запас до ожидаемого пакета для сканирования (мс)
+#define NRF_SCAN_DWELL_US 200                 // прослушивание радиоканала перед чтением RPD (мкс)
+#define NRF_LINK_MIN_SCANS 30                 // проходов сканирования до первой оценки радиоканала
+#define NRF_LINK_EVAL_MS (10 * 60 * 1000)     // период оценки радиоканала (мс)
+#define NRF_LINK_LOSS_PCT 5                   // потери пакетов, при которых ищется другой радиоканал (%)
+#define NRF_LINK_NOISY_PERMILLE 100           // занятость радиоканала, при которой ищется другой (‰ проходов с RPD)
+#define NRF_LINK_MIN_GAIN_PERMILLE 50         // минимальный выигрыш по занятости для перехода (‰)
+#define NRF_LINK_LEAD_INTERVALS 3             // интервалов узла между объявлением и переходом
+#define NRF_LINK_MAX_LEAD_MS (30 * 60 * 1000) // максимальное время объявления перехода (мс)
+#define NRF_LINK_FALLBACK_INTERVALS 3         // интервалов тишины узла до возврата на домашний канал
+#define NRF_LINK_MIN_SILENCE_MS 60000         // минимальная тишина до возврата на домашний канал (мс)
+#define NRF_LINK_HOLDOFF_MS (6 * 3600 * 1000) // неудачный радиоканал не выбирается столько времени (мс)
+
+static_assert((RADIO_HOME_CHANNEL - NRF_SCAN_FIRST_CHANNEL) % NRF_SCAN_CHANNEL_STEP == 0 &&
+                  RADIO_HOME_CHANNEL < NRF_SCAN_FIRST_CHANNEL + NRF_SCAN_CHANNELS * NRF_SCAN_CHANNEL_STEP,
+              "Home channel must be on the scan grid");
+
+/// @brief состояние выбора радиоканала
+enum NrfLinkState_t
+{
+  NRF_LINK_STABLE = 0, // работа на текущем радиоканале
+  NRF_LINK_ANNOUNCE,   // узлам рассылается команда перехода
+  NRF_LINK_VERIFY,     // переход выполнен, ожидаются пакеты всех узлов
+};
+
+/// @brief показатели радиолинии
+struct NrfLinkStats_t
+{
+  uint8_t channel;                   // текущий радиоканал
+  uint8_t target;                    // радиоканал объявленного перехода
+  NrfLinkState_t state;              // состояние выбора радиоканала
+  uint32_t scans;                    // проходов сканирования
+  uint32_t switches;                 // успешных переходов
+  uint32_t fallbacks;                // возвратов на домашний канал
+  uint32_t announces;                // отправленных команд перехода
+  uint16_t noise[NRF_SCAN_CHANNELS]; // занятость радиоканалов сетки (‰ проходов с RPD, EWMA)
+  uint32_t packets;                  // принято пакетов всеми узлами
+  uint32_t lost;                     // потеряно пакетов всеми узлами
+  uint32_t duplicates;               // повторно принятых пакетов
+  uint32_t retries;                  // повторов передачи (ARC, по данным узлов)
+  uint32_t rpd_strong;               // пакетов с уровнем выше -64 дБм
+};
+
+/**
+ * @brief Монитор радиолинии nRF24, выбор радиоканала и график передач узлов
+ *
+ * Собирает занятость радиоканалов сетки (RPD в паузах между пакетами узлов), по потерям
+ * из таблицы узлов решает о переходе и согласует его с узлами через обратный канал
+ * (ACK payload). Через тот же обратный канал узлы получают время, период передачи и свой
+ * слот: слоты разнесены по периоду равномерно по номеру узла. Работа с радиомодулем
+ * остаётся в задаче приёма: монитор говорит, когда сканировать, что загрузить в ACK payload
+ * и на какой радиоканал перестроиться.
+ * Все методы вызываются из задачи приёма, кроме get_stats/log_stats/to_json.
+ */
+class NrfLink
+{
+public:
+  NrfLink() = delete;
+
+  /** @brief Текущий радиоканал */
+  static uint8_t channel();
+
+  /** @brief Радиоканал сетки сканирования с индексом idx */
+  static uint8_t scan_channel(uint8_t idx)
+  {
+    return static_cast<uint8_t>(NRF_SCAN_FIRST_CHANNEL + idx * NRF_SCAN_CHANNEL_STEP);
+  }
+
+  /** @brief Пора сканировать: период истёк и ближайший ожидаемый пакет не раньше NRF_SCAN_GUARD_MS */
+  static bool scan_due(TickType_t now);
+
+  /**
+   * @brief Тиков до ближайшего сканирования или действия service()
+   * @return portMAX_DELAY если ждать нечего (узлов нет, перехода нет)
+   */
+  static TickType_t next_wait(TickType_t now);
+
+  /** @brief Учесть проход сканирования (busy[i] — RPD на радиоканале scan_channel(i)) */
+  static void record_scan(const bool busy[NRF_SCAN_CHANNELS], TickType_t now);
+
+  /** @brief Период передачи узлов (не меньше NRF_INTERVAL_FLOOR_S) */
+  static void set_interval_s(uint16_t interval_s);
+  static uint16_t interval_s();
+
+  /**
+   * @brief Пакет обратного канала для загрузки в ACK payload после пакета узла
+   * @param ref_seq Порядковый номер принятого пакета
+   * @param rx_mono_us Момент приёма пакета (монотонное время, мкс)
+   * @param rx_utc_ms Момент приёма пакета (UTC, мс; 0 — часы не синхронизированы)
+   */
+  static void downlink(uint8_t node, uint16_t ref_seq, int64_t rx_mono_us, int64_t rx_utc_ms, TickType_t now,
+                       RadioDownlink_t &out);
+
+  /**
+   * @brief Оценка радиоканала и продвижение перехода
+   * @return true если радиоканал сменился и приёмник нужно перестроить на channel()
+   */
+  static bool service(TickType_t now, bool ack_payloads);
+
+  static void get_stats(NrfLinkStats_t &out);
+  static void log_stats();
+
+  /** @brief Показатели в JSON для MQTT; false если буфер мал */
+  static bool to_json(char *buf, size_t size);
+};
+
+#endif // _NRF_LINK_H_
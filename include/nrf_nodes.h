@@ -0,0 +1,80 @@
+#ifndef _NRF_NODES_H_
+#define _NRF_NODES_H_
+
+#include "common.h"
+#include "radio_proto.h"
+#include "rolling_stats.h"
+#include <freertos/FreeRTOS.h>
+#include <stdint.h>
+
+#define NRF_PIPES 6                    // каналов приёма (pipe) nRF24L01+
+#define NRF_MAX_NODES 16               // узлов в таблице (номер узла — индекс, 0..NRF_MAX_NODES-1)
+#define NRF_PIPE0_ADDR 0xA337D135B1ULL // адрес pipe 0 (исходный адрес единственного датчика)
+#define NRF_PIPE1_ADDR 0xA337D135C1ULL // адрес pipe 1; pipe 2..5 отличаются младшим байтом (C2..C5)
+#define NRF_SEQ_MAX_GAP 1000           // больший скачок порядкового номера — перезапуск узла, а не потери
+
+/// @brief состояние узла (наружного датчика) в таблице приёмника
+struct NrfNode_t
+{
+  OutSensorData_t last;            // последние принятые данные
+  SampleStamp_t stamp;             // время приёма последних данных
+  TickType_t last_tick;            // время приёма последних данных (тики)
+  uint32_t packets;                // принято пакетов
+  uint32_t interval_ms;            // последний интервал между пакетами (мс)
+  Ewma<uint32_t, 3> interval_ewma; // сглаженный интервал между пакетами (мс, EWMA 1/8)
+  uint32_t max_interval;           // максимальный интервал между пакетами (мс)
+  uint8_t pipe;                    // канал приёма последнего пакета
+  uint8_t version;                 // версия формата последнего пакета
+  uint16_t last_seq;               // порядковый номер последнего пакета (версия 2)
+  bool has_seq;                    // last_seq действителен
+  uint32_t samples;                // принято измерений (пакет версии 2 несёт до RADIO_MAX_SAMPLES)
+  uint32_t lost;                   // потеряно пакетов (пропуски порядкового номера)
+  uint32_t duplicates;             // повторно принятых пакетов (подтверждение не дошло до узла)
+  uint32_t restarts;               // перезапусков узла (скачок порядкового номера)
+  uint32_t retries;                // повторов передачи по данным узла (ARC)
+  uint32_t rpd_strong;             // пакетов с уровнем выше -64 дБм (RPD)
+  bool active;                     // от узла были пакеты
+};
+
+/// @brief результат учёта пакета узла
+enum NrfUpdate_t
+{
+  NRF_UPDATE_OK = 0,    // пакет учтён
+  NRF_UPDATE_DUPLICATE, // повтор уже принятого пакета (тот же порядковый номер)
+  NRF_UPDATE_BAD_NODE,  // номер узла вне таблицы
+};
+
+/**
+ * @brief Таблица узлов многоканального приёмника nRF24
+ *
+ * Фиксированный массив, индексируемый номером узла: обновление и поиск — O(1), память
+ * не зависит от числа фактически работающих узлов. Пишет только задача приёма,
+ * читатели получают копию записи под спинлоком.
+ */
+class NrfNodes
+{
+public:
+  NrfNodes() = delete;
+
+  /** @brief Адрес канала приёма pipe (0..NRF_PIPES-1) */
+  static uint64_t pipe_address(uint8_t pipe);
+
+  /**
+   * @brief Учесть пакет узла (номер узла — frame.node)
+   * @param data Самое новое измерение пакета
+   * @param rpd Уровень сигнала пакета выше -64 дБм
+   * @return NRF_UPDATE_DUPLICATE — пакет уже принят, его измерения публиковать не нужно
+   */
+  static NrfUpdate_t update(const RadioFrame_t &frame, uint8_t pipe, const OutSensorData_t &data,
+                            const SampleStamp_t &stamp, bool rpd);
+
+  /** @brief Копия записи узла; false если номер вне таблицы или от узла ещё не было пакетов */
+  static bool get(uint8_t node, NrfNode_t &out);
+
+  /** @brief Количество узлов, от которых были пакеты */
+  static uint8_t active_count();
+
+  static void log_stats();
+};
+
+#endif // _NRF_NODES_H_
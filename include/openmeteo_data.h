@@ -0,0 +1,40 @@
+#ifndef _OPENMETEO_DATA_H_
+#define _OPENMETEO_DATA_H_
+
+// Записи метеоданных Open-Meteo и прогноза геомагнитной обстановки (без зависимостей от платформы)
+
+// индексы массива данных погоды
+enum OpenMeteoDataIndex_t
+{
+  METEO_DATA_CURRENT = 0,                // текущее состояние погоды
+  METEO_DATA_FORECAST_TODAY = 1,         // прогноз на сегодня
+  METEO_DATA_FORECAST_TOMORROW = 2,      // прогноз на завтра
+  METEO_DATA_FORECAST_AFTERTOMORROW = 3, // прогноз на послезавтра
+  _METEO_DATA_NUM_ = 4                   // количество записей
+};
+
+// структура данных погоды (от сервиса Open-Meteo)
+struct OpenMeteoData
+{
+  OpenMeteoDataIndex_t index;  // индекс записи (текущее состояние или прогноз на день)
+  float temperature{0.0f};     // температура в  градусах Цельсия
+  int pressure{0};             // давление в hPa
+  int relative_humidity{0};    // влажность в %
+  float temperature_max{0.0f}; // максимальная температура в  градусах Цельсия
+  float temperature_min{0.0f}; // минимальная температура в  градусах Цельсия
+  float precipitation{0.0f};   // осадки в мм
+  float wind_speed{0.0f};      // скорость ветра в м/с
+  int wind_direction{0};       // направление ветра в градусах
+  int weather_code{0};         // WMO код погоды
+  char date[11] = {0};         // дата в формате DD-MM-YYYY (10 chars + NUL)
+};
+
+// структура данных прогноза геомагнитной обстановки на 3 дня
+struct GeoMagneticKpMax
+{
+  float kpmax_today;     // максимальное значение индекса на сегодня
+  float kpmax_tomorrow;  // максимальное значение индекса на завтра
+  float kpmax_tomorrow2; // максимальное значение индекса на послезавтра
+};
+
+#endif // _OPENMETEO_DATA_H_
@@ -0,0 +1,51 @@
+#ifndef _OPENMETEO_FB_H_
+#define _OPENMETEO_FB_H_
+
+#include "openmeteo_data.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Переменные прогноза. В ответе FlatBuffers переменные идут в порядке запроса, поэтому
+// порядок имён в OPENMETEO_FORECAST_QUERY совпадает с перечислениями ниже
+#define OPENMETEO_FORECAST_QUERY \
+  "&current=weather_code,temperature_2m,precipitation,wind_speed_10m,wind_direction_10m,relative_humidity_2m,surface_pressure" \
+  "&daily=temperature_2m_max,temperature_2m_min,precipitation_sum,precipitation_probability_max,wind_speed_10m_max,wind_direction_10m_dominant,weather_code" \
+  "&forecast_days=3&wind_speed_unit=ms&timezone=Europe/Moscow&models=icon_seamless"
+
+enum MeteoCurrentVar_t
+{
+  METEO_CUR_WEATHER_CODE = 0,
+  METEO_CUR_TEMPERATURE,
+  METEO_CUR_PRECIPITATION,
+  METEO_CUR_WIND_SPEED,
+  METEO_CUR_WIND_DIRECTION,
+  METEO_CUR_HUMIDITY,
+  METEO_CUR_PRESSURE,
+  _METEO_CUR_NUM_
+};
+
+enum MeteoDailyVar_t
+{
+  METEO_DAY_TEMPERATURE_MAX = 0,
+  METEO_DAY_TEMPERATURE_MIN,
+  METEO_DAY_PRECIPITATION,
+  METEO_DAY_PRECIPITATION_PROBABILITY,
+  METEO_DAY_WIND_SPEED,
+  METEO_DAY_WIND_DIRECTION,
+  METEO_DAY_WEATHER_CODE,
+  _METEO_DAY_NUM_
+};
+
+/**
+ * @brief Ответ FlatBuffers (&format=flatbuffers) → записи OpenMeteoData без разбора
+ *
+ * Каждое значение читается по смещениям прямо в буфере (FbTable). Ответ с другим числом
+ * переменных, обрезанный или повреждённый отклоняется.
+ * @param data Ответ с префиксом длины
+ * @param len Длина принятых данных
+ * @param out Массив из _METEO_DATA_NUM_ записей
+ * @return true если ответ разобран
+ */
+bool meteo_fb_fill(const uint8_t *data, size_t len, OpenMeteoData *out);
+
+#endif // _OPENMETEO_FB_H_
@@ -0,0 +1,45 @@
+#ifndef _OPENMETEO_JSON_H_
+#define _OPENMETEO_JSON_H_
+
+#include "openmeteo_data.h"
+#include <ArduinoJson.h>
+#include <cstddef>
+
+/**
+ * @brief Распределитель памяти JsonDocument со счётчиком пикового объёма
+ *
+ * Перед каждым блоком хранится его размер: Allocator::deallocate() размер не получает.
+ */
+class PeakAllocator : public ArduinoJson::Allocator
+{
+public:
+  void *allocate(size_t size) override;
+  void deallocate(void *ptr) override;
+  void *reallocate(void *ptr, size_t new_size) override;
+
+  size_t peak_bytes() const { return peak; }
+
+private:
+  union Header_t
+  {
+    size_t size;
+    std::max_align_t align; // выравнивание блока для любых данных документа
+  };
+
+  void account(size_t old_size, size_t new_size);
+
+  size_t current = 0; // занято сейчас (без заголовков)
+  size_t peak = 0;    // наибольшее занятое
+};
+
+/**
+ * @brief Фильтр разбора ответа прогноза (DeserializationOption::Filter)
+ *
+ * В документ попадают только поля, нужные OpenMeteoData; строится при первом вызове.
+ */
+const JsonDocument &meteo_filter();
+
+/** @brief Разобранный документ → записи OpenMeteoData (массив из _METEO_DATA_NUM_ записей) */
+void meteo_fill(const JsonDocument &json, OpenMeteoData *out);
+
+#endif // _OPENMETEO_JSON_H_
@@ -0,0 +1,165 @@
+#ifndef _RADIO_PROTO_H_
+#define _RADIO_PROTO_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Формат радиопакета наружного датчика, версия 2 (32 байта — полный payload nRF24L01+,
+ * многобайтовые поля — little-endian):
+ *
+ *   байт  0      magic 0xB5
+ *   байт  1      версия формата (2)
+ *   байт  2      номер узла (0..NRF_MAX_NODES-1)
+ *   байты 3..4   порядковый номер пакета (uint16, растёт на 1 с каждой передачей, с переполнением)
+ *   байт  5      заряд батареи, %
+ *   байт  6      биты 0..3 — количество измерений в пакете (1..RADIO_MAX_SAMPLES),
+ *                биты 4..7 — число повторов предыдущей передачи (ARC из OBSERVE_TX, 0..15)
+ *   байты 7..30  измерения по 8 байт в хронологическом порядке (последнее — самое новое):
+ *                  uint16 возраст измерения на момент передачи, с
+ *                  int16  температура, 0.01 °C
+ *                  uint16 относительная влажность, 0.01 %
+ *                  uint16 давление, 0.1 гПа (0 — датчик давления отсутствует)
+ *                неиспользуемые слоты заполняются нулями
+ *   байт  31     CRC-8 (полином 0x07, начальное значение 0x00) по байтам 0..30
+ *
+ * Версия 1 — прежний формат без заголовка: упакованная структура из двух float
+ * (температура °C, влажность %) и двух uint16 (давление гПа, заряд батареи %), 12 байт.
+ * Пакет с magic и версией 2 принимается только при верной CRC; остальные пакеты
+ * разбираются как версия 1 (совпадение первых двух байт float с заголовком — 1/65536).
+ *
+ * Обратный канал — payload пакета подтверждения (ACK payload, требует динамической длины
+ * payload на обеих сторонах). Приёмник загружает его после пакета узла с номером ref_seq,
+ * и узел получает его в подтверждении своей следующей передачи по тому же pipe. Все моменты
+ * отсчитываются от приёма пакета ref_seq: узел помнит время своих двух последних передач
+ * и получает точную привязку без оценки задержки доставки:
+ *
+ *   байт  0      magic 0xB6
+ *   байт  1      версия формата (2)
+ *   байт  2      номер узла-адресата (узлы на общем pipe пропускают чужие команды)
+ *   байт  3      флаги полей (RADIO_DL_*)
+ *   байт  4      RADIO_DL_CHANNEL: новый канал
+ *   байты 5..6   RADIO_DL_CHANNEL: через сколько секунд после ref_seq перейти на канал (uint16)
+ *   байты 7..8   ref_seq — порядковый номер пакета узла, к приёму которого привязаны поля
+ *   байты 9..12  RADIO_DL_TIME: время UTC приёма пакета ref_seq, с (uint32)
+ *   байты 13..14 RADIO_DL_TIME: миллисекунды (0..999)
+ *   байты 15..18 RADIO_DL_SLOT: следующая передача через столько мс после ref_seq (uint32);
+ *                если момент уже прошёл, узел прибавляет interval_s до ближайшего будущего
+ *   байты 19..20 RADIO_DL_INTERVAL: период передачи, с (uint16)
+ *   байт  21     CRC-8 по байтам 0..20
+ *
+ * Слоты узлов разнесены по периоду равномерно по номеру узла: передачи не сталкиваются,
+ * а приёмник знает, когда ждать пакет. Узел, не получивший команду, сохраняет прежний
+ * график; приёмник без синхронизированных часов не выставляет RADIO_DL_TIME.
+ *
+ * Узел, не получивший подтверждений RADIO_FALLBACK_TRIES передач подряд на канале, отличном
+ * от домашнего (RADIO_HOME_CHANNEL), возвращается на домашний канал; приёмник при потере узлов
+ * после перехода поступает так же — домашний канал остаётся точкой встречи.
+ */
+
+#define RADIO_PAYLOAD_SIZE 32 // размер payload nRF24L01+ (максимальный)
+#define RADIO_MAGIC 0xB5      // первый байт пакета версии 2
+#define RADIO_VERSION 2       // текущая версия формата
+#define RADIO_HEADER_SIZE 7   // заголовок пакета версии 2
+#define RADIO_SAMPLE_SIZE 8   // одно измерение в пакете версии 2
+#define RADIO_MAX_SAMPLES 3   // измерений в одном пакете версии 2
+#define RADIO_LEGACY_SIZE 12  // пакет версии 1 (OutSensorData_t)
+#define RADIO_MAX_RETRIES 15  // максимум повторов передачи (поле ARC)
+
+#define RADIO_DL_MAGIC 0xB6    // первый байт пакета обратного канала
+#define RADIO_DL_SIZE 22       // пакет обратного канала
+#define RADIO_DL_CHANNEL 0x01  // флаг: переход на другой канал
+#define RADIO_DL_TIME 0x02     // флаг: время UTC приёма ref_seq
+#define RADIO_DL_SLOT 0x04     // флаг: момент следующей передачи
+#define RADIO_DL_INTERVAL 0x08 // флаг: период передачи
+#define RADIO_HOME_CHANNEL 103 // домашний канал (точка встречи при потере связи)
+#define RADIO_FALLBACK_TRIES 3 // передач без подтверждения до возврата на домашний канал
+
+/// @brief одно измерение наружного датчика в фиксированной точке
+struct RadioSample_t
+{
+  uint16_t age_s;            // возраст измерения на момент передачи, с
+  int16_t temperature_centi; // температура, 0.01 °C
+  uint16_t humidity_centi;   // относительная влажность, 0.01 %
+  uint16_t pressure_dhpa;    // давление, 0.1 гПа (0 — нет данных)
+};
+
+/// @brief разобранный радиопакет
+struct RadioFrame_t
+{
+  uint8_t version;                          // версия формата (1 — прежний, 2 — текущий)
+  uint8_t node;                             // номер узла (для версии 1 задаётся приёмником по каналу)
+  uint16_t seq;                             // порядковый номер пакета (только версия 2)
+  bool has_seq;                             // seq действителен
+  uint8_t battery;                          // заряд батареи, %
+  uint8_t retries;                          // повторов предыдущей передачи (только версия 2)
+  uint8_t count;                            // количество измерений
+  RadioSample_t samples[RADIO_MAX_SAMPLES]; // измерения, последнее — самое новое
+};
+
+/// @brief пакет обратного канала (ACK payload) узлу
+struct RadioDownlink_t
+{
+  uint8_t node;         // номер узла-адресата
+  uint8_t flags;        // флаги полей (RADIO_DL_*)
+  uint8_t channel;      // новый канал (RADIO_DL_CHANNEL)
+  uint16_t switch_in_s; // переход через столько секунд после ref_seq (RADIO_DL_CHANNEL)
+  uint16_t ref_seq;     // порядковый номер пакета узла, к приёму которого привязаны моменты
+  uint32_t ref_time;    // время UTC приёма ref_seq, с (RADIO_DL_TIME)
+  uint16_t ref_ms;      // миллисекунды времени приёма ref_seq (RADIO_DL_TIME)
+  uint32_t slot_ms;     // следующая передача через столько мс после ref_seq (RADIO_DL_SLOT)
+  uint16_t interval_s;  // период передачи, с (RADIO_DL_INTERVAL)
+};
+
+/// @brief результат разбора пакета
+enum RadioDecode_t
+{
+  RADIO_DECODE_OK = 0,    // пакет разобран
+  RADIO_DECODE_SHORT,     // длина меньше любого известного формата
+  RADIO_DECODE_BAD_CRC,   // заголовок версии 2 с неверной CRC
+  RADIO_DECODE_BAD_COUNT, // количество измерений вне 1..RADIO_MAX_SAMPLES
+  RADIO_DECODE_BAD_VALUE, // значения прежнего формата вне физического диапазона (не число)
+};
+
+/**
+ * @brief Кодек радиопакетов наружного датчика (без зависимостей от платформы — собирается на хосте)
+ */
+class RadioProto
+{
+public:
+  RadioProto() = delete;
+
+  /** @brief CRC-8, полином 0x07, начальное значение 0x00 */
+  static uint8_t crc8(const uint8_t *data, size_t len);
+
+  /**
+   * @brief Собрать пакет версии 2
+   * @param out Буфер RADIO_PAYLOAD_SIZE байт
+   * @return false если количество измерений вне 1..RADIO_MAX_SAMPLES
+   */
+  static bool encode(const RadioFrame_t &frame, uint8_t out[RADIO_PAYLOAD_SIZE]);
+
+  /**
+   * @brief Разобрать пакет версии 2 или прежнего формата
+   * @param legacy_node Номер узла для пакета прежнего формата (в нём номера нет)
+   */
+  static RadioDecode_t decode(const uint8_t *buf, size_t len, uint8_t legacy_node, RadioFrame_t &out);
+
+  /** @brief Собрать пакет обратного канала (RADIO_DL_SIZE байт) */
+  static void encode_downlink(const RadioDownlink_t &dl, uint8_t out[RADIO_DL_SIZE]);
+
+  /** @brief Разобрать пакет обратного канала (сторона узла) */
+  static RadioDecode_t decode_downlink(const uint8_t *buf, size_t len, RadioDownlink_t &out);
+
+  /**
+   * @brief Поле slot_ms: через сколько мс после приёма пакета узлу передавать
+   *
+   * Слот узла — фаза interval_ms * node / slots периода на монотонной оси приёмника. Команда
+   * дойдёт с подтверждением следующего пакета (через период), поэтому назначается слот
+   * не раньше полутора периодов после приёма.
+   * @param rx_ms Момент приёма пакета на монотонной оси приёмника, мс
+   */
+  static uint32_t slot_delay_ms(uint32_t interval_ms, uint8_t node, uint8_t slots, int64_t rx_ms);
+};
+
+#endif // _RADIO_PROTO_H_
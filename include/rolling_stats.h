@@ -0,0 +1,300 @@
+#ifndef _ROLLING_STATS_H_
+#define _ROLLING_STATS_H_
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Тип аккумулятора сумм для типа отсчёта (целые — точные суммы без дрейфа)
+ */
+template <typename T>
+struct RollingAcc
+{
+  typedef int64_t type;
+};
+template <>
+struct RollingAcc<uint32_t>
+{
+  typedef uint64_t type;
+};
+template <>
+struct RollingAcc<uint64_t>
+{
+  typedef uint64_t type;
+};
+template <>
+struct RollingAcc<float>
+{
+  typedef double type;
+};
+template <>
+struct RollingAcc<double>
+{
+  typedef double type;
+};
+
+/**
+ * @brief Преобразования чисел с фиксированной точкой Q(FRAC) в int32_t
+ * @tparam FRAC количество дробных бит (например, 8 — шаг 1/256)
+ */
+template <unsigned FRAC>
+struct FixedQ
+{
+  static_assert(FRAC < 31, "Too many fractional bits for int32_t");
+
+  static int32_t from_float(float v)
+  {
+    return static_cast<int32_t>(lroundf(v * static_cast<float>(1UL << FRAC)));
+  }
+  static float to_float(int32_t q)
+  {
+    return static_cast<float>(q) / static_cast<float>(1UL << FRAC);
+  }
+  static int32_t from_int(int32_t v)
+  {
+    return v * static_cast<int32_t>(1UL << FRAC);
+  }
+};
+
+/**
+ * @brief Скользящее окно из N последних отсчётов: среднее, минимум, максимум, дисперсия
+ *
+ * Суммы ведутся в аккумуляторе RollingAcc<T>: для целых (в т.ч. фиксированной точки —
+ * сотые градуса, Q-форматы) они точны и не дрейфуют, в отличие от вычитания float.
+ * Минимум и максимум — монотонные очереди индексов, O(1) амортизированно на отсчёт.
+ * Память — статическая, O(N).
+ *
+ * @tparam T тип отсчёта
+ * @tparam N длина окна (не менее 2)
+ */
+template <typename T, size_t N>
+class RollingWindow
+{
+  static_assert(N >= 2, "RollingWindow needs at least two samples");
+
+public:
+  typedef typename RollingAcc<T>::type acc_t;
+
+  RollingWindow()
+  {
+    reset();
+  }
+
+  void reset()
+  {
+    total = 0;
+    sum = 0;
+    sum_sq = 0;
+    min_head = min_tail = 0;
+    max_head = max_tail = 0;
+  }
+
+  /** @brief Добавить отсчёт (самый старый вытесняется при заполненном окне) */
+  void push(T v)
+  {
+    if (total >= N)
+    {
+      const T old = buf[total % N];
+      sum -= static_cast<acc_t>(old);
+      sum_sq -= static_cast<acc_t>(old) * static_cast<acc_t>(old);
+      // вытеснить устаревшие индексы из монотонных очередей
+      if (min_head != min_tail && min_idx[min_head % N] + N <= total)
+        min_head++;
+      if (max_head != max_tail && max_idx[max_head % N] + N <= total)
+        max_head++;
+    }
+    buf[total % N] = v;
+    sum += static_cast<acc_t>(v);
+    sum_sq += static_cast<acc_t>(v) * static_cast<acc_t>(v);
+
+    while (min_head != min_tail && !(buf[min_idx[(min_tail - 1) % N] % N] < v))
+      min_tail--;
+    min_idx[min_tail++ % N] = total;
+    while (max_head != max_tail && !(v < buf[max_idx[(max_tail - 1) % N] % N]))
+      max_tail--;
+    max_idx[max_tail++ % N] = total;
+
+    total++;
+  }
+
+  /** @brief Количество отсчётов в окне */
+  size_t count() const
+  {
+    return total < N ? static_cast<size_t>(total) : N;
+  }
+
+  /** @brief Всего добавлено отсчётов */
+  uint32_t pushed() const
+  {
+    return total;
+  }
+
+  bool full() const
+  {
+    return total >= N;
+  }
+
+  /** @brief Сумма отсчётов окна */
+  acc_t window_sum() const
+  {
+    return sum;
+  }
+
+  /** @brief Среднее (для целых — с округлением к ближайшему) */
+  T mean() const
+  {
+    const size_t n = count();
+    if (!n)
+      return T();
+    return div_round(sum, static_cast<acc_t>(n));
+  }
+
+  T min() const
+  {
+    return (min_head != min_tail) ? buf[min_idx[min_head % N] % N] : T();
+  }
+
+  T max() const
+  {
+    return (max_head != max_tail) ? buf[max_idx[max_head % N] % N] : T();
+  }
+
+  /** @brief Самый старый отсчёт окна */
+  T first() const
+  {
+    return total ? buf[(total - count()) % N] : T();
+  }
+
+  /** @brief Последний добавленный отсчёт */
+  T last() const
+  {
+    return total ? buf[(total - 1) % N] : T();
+  }
+
+  /** @brief Выборочная дисперсия (в квадратах единиц T) */
+  double variance() const
+  {
+    const size_t n = count();
+    if (n < 2)
+      return 0.0;
+    // n*Σx² - (Σx)² считается в аккумуляторе (для целых — точно), затем делится
+    const double num = static_cast<double>(static_cast<acc_t>(n) * sum_sq - sum * sum);
+    return num / (static_cast<double>(n) * static_cast<double>(n - 1));
+  }
+
+  double stddev() const
+  {
+    return sqrt(variance());
+  }
+
+private:
+  template <typename A>
+  static T div_round(A s, A n)
+  {
+    return static_cast<T>(s >= 0 ? (s + n / 2) / n : (s - n / 2) / n);
+  }
+  static T div_round(double s, double n)
+  {
+    return static_cast<T>(s / n);
+  }
+
+  T buf[N];            // кольцевой буфер отсчётов
+  uint32_t total;      // всего добавлено отсчётов (индекс следующего)
+  acc_t sum;           // сумма отсчётов окна
+  acc_t sum_sq;        // сумма квадратов отсчётов окна
+  uint32_t min_idx[N]; // монотонная (возрастающая) очередь индексов для минимума
+  uint32_t max_idx[N]; // монотонная (убывающая) очередь индексов для максимума
+  uint32_t min_head;   // голова очереди минимума
+  uint32_t min_tail;   // хвост очереди минимума
+  uint32_t max_head;   // голова очереди максимума
+  uint32_t max_tail;   // хвост очереди максимума
+};
+
+/**
+ * @brief Экспоненциальное скользящее среднее с коэффициентом alpha = 1 / 2^K в целых числах
+ *
+ * Состояние хранится с FRAC дополнительными дробными битами, поэтому малые приращения
+ * не теряются при сдвиге; первый отсчёт инициализирует среднее.
+ *
+ * @tparam T целочисленный тип отсчёта (в т.ч. фиксированная точка)
+ * @tparam K показатель сглаживания (alpha = 1/2^K)
+ * @tparam FRAC дробные биты внутреннего состояния
+ */
+template <typename T, unsigned K, unsigned FRAC = 8>
+class Ewma
+{
+  static_assert(K > 0 && K < 16, "EWMA shift out of range");
+
+public:
+  Ewma() : state(0), primed(false)
+  {
+  }
+
+  void reset()
+  {
+    state = 0;
+    primed = false;
+  }
+
+  void push(T v)
+  {
+    const int64_t x = static_cast<int64_t>(v) * (static_cast<int64_t>(1) << FRAC);
+    if (!primed)
+    {
+      state = x;
+      primed = true;
+      return;
+    }
+    // сдвигается модуль разности: округление к нулю одинаково для обоих знаков (без смещения вниз)
+    const int64_t d = x - state;
+    state += (d >= 0) ? (d >> K) : -((-d) >> K);
+  }
+
+  /** @brief Текущее значение (с округлением к ближайшему) */
+  T value() const
+  {
+    const int64_t half = (static_cast<int64_t>(1) << FRAC) >> 1;
+    return static_cast<T>(state >= 0 ? (state + half) >> FRAC : -((-state + half) >> FRAC));
+  }
+
+  /** @brief Текущее значение с дробной частью */
+  float value_f() const
+  {
+    return static_cast<float>(state) / static_cast<float>(static_cast<int64_t>(1) << FRAC);
+  }
+
+  bool valid() const
+  {
+    return primed;
+  }
+
+private:
+  int64_t state; // значение среднего в Q(FRAC)
+  bool primed;   // получен хотя бы один отсчёт
+};
+
+/**
+ * @brief Окно и EWMA одного потока отсчётов
+ */
+template <typename T, size_t N, unsigned K, unsigned FRAC = 8>
+class RollingStats
+{
+public:
+  void push(T v)
+  {
+    window.push(v);
+    ewma.push(v);
+  }
+
+  void reset()
+  {
+    window.reset();
+    ewma.reset();
+  }
+
+  RollingWindow<T, N> window; // скользящее окно N последних отсчётов
+  Ewma<T, K, FRAC> ewma;      // экспоненциальное среднее
+};
+
+#endif // _ROLLING_STATS_H_
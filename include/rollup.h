@@ -0,0 +1,80 @@
+#ifndef _ROLLUP_H_
+#define _ROLLUP_H_
+
+#include "rollup_tier.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#define ROLLUP_MINUTE_SLOTS 1440      // минутных интервалов (сутки)
+#define ROLLUP_HOUR_SLOTS (24 * 35)   // часовых интервалов (5 недель)
+#define ROLLUP_DAY_SLOTS 400          // суточных интервалов (больше года)
+#define ROLLUP_DIR "/rollup"          // каталог сохранённых уровней в LittleFS
+#define ROLLUP_FILE_MAGIC 0x4C4C5552u // "RULL"
+#define ROLLUP_FILE_VERSION 1         // версия формата файла уровня
+
+/// @brief уровни агрегации
+enum RollupLevel_t
+{
+  ROLLUP_MINUTE = 0, // 1 минута
+  ROLLUP_HOUR,       // 1 час
+  ROLLUP_DAY,        // 1 сутки (UTC)
+  ROLLUP_LEVELS
+};
+
+/// @brief показатели агрегации
+struct RollupStats_t
+{
+  uint32_t samples;     // принято значений каналов
+  uint32_t no_time;     // образцов без времени UTC (часы не синхронизированы)
+  uint32_t stale;       // значений старше вытеснившего их интервала
+  uint32_t saves;       // сохранений уровней
+  uint32_t save_errors; // ошибок сохранения
+  bool loaded;          // уровни восстановлены из LittleFS
+};
+
+/**
+ * @brief Агрегаты min/max/сумма/количество по уровням 1 минута, 1 час, 1 сутки
+ *
+ * Подключается к шине данных синхронным слушателем и обновляет все уровни при каждом
+ * образце комнатного и основного наружного датчика (каналы журнала TsLog). Кольца уровней
+ * лежат в PSRAM и раз в час сохраняются в LittleFS. Запрос за неделю читает несколько сотен
+ * агрегатов вместо сырых данных: полные сутки берутся из суточного уровня, остаток —
+ * из часового и минутного.
+ */
+class Rollup
+{
+public:
+  Rollup() = delete;
+
+  /** @brief Выделить кольца уровней и подключиться к шине (вызывать до создания задач) */
+  static bool init();
+
+  /** @brief Восстановить уровни из LittleFS; до вызова образцы не учитываются */
+  static void load();
+
+  /** @brief Сохранить уровни в LittleFS (в задаче с запасом стека: запись файлов) */
+  static bool save();
+
+  /** @brief Добавить значение канала во все уровни */
+  static void add(uint32_t time, uint8_t channel, int16_t value);
+
+  /** @brief Длительность интервала уровня, с */
+  static uint32_t period(RollupLevel_t level);
+
+  /**
+   * @brief Интервалы уровня, пересекающие [from, to), от старых к новым (пустые пропускаются)
+   * @return количество скопированных интервалов
+   */
+  static size_t query(RollupLevel_t level, uint32_t from, uint32_t to, RollupSlot_t *out, size_t max);
+
+  /**
+   * @brief Агрегаты всех каналов за [from, to) из самых крупных уровней, покрывающих интервал
+   * @param reads Сколько интервалов уровней прочитано (nullptr — не нужно)
+   */
+  static void summary(uint32_t from, uint32_t to, RollupSlot_t &out, uint32_t *reads = nullptr);
+
+  static void get_stats(RollupStats_t &out);
+  static void log_stats();
+};
+
+#endif // _ROLLUP_H_
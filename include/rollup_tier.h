@@ -0,0 +1,104 @@
+#ifndef _ROLLUP_TIER_H_
+#define _ROLLUP_TIER_H_
+
+#include "tslog_page.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/// @brief агрегат значений канала за интервал
+struct RollupAgg_t
+{
+  int32_t sum;    // сумма значений
+  int16_t min;    // минимум
+  int16_t max;    // максимум
+  uint16_t count; // количество значений (0 — данных нет)
+};
+
+/// @brief интервал уровня агрегации: агрегаты всех каналов
+struct RollupSlot_t
+{
+  uint32_t start;                 // начало интервала (UTC, с; 0 — интервал пуст)
+  RollupAgg_t ch[TSLOG_CHANNELS]; // агрегаты каналов (каналы журнала TsLog)
+};
+
+/** @brief Добавить значение в агрегат */
+void rollup_add(RollupAgg_t &agg, int16_t value);
+
+/** @brief Объединить агрегаты */
+void rollup_merge(RollupAgg_t &into, const RollupAgg_t &from);
+
+/**
+ * @brief Уровень агрегации: кольцо интервалов одной длительности
+ *
+ * Интервал с началом t лежит в ячейке (t / period) % slots; ячейка с другим началом
+ * (на оборот кольца старше) очищается при первом значении нового интервала. Значения
+ * обновляются по одному, без пересчёта. Память ячеек передаётся снаружи (PSRAM на ESP32),
+ * класс не зависит от платформы.
+ */
+class RollupTier
+{
+public:
+  /** @brief Подключить память ячеек и очистить её */
+  void init(uint32_t period, uint32_t count, RollupSlot_t *mem);
+
+  /**
+   * @brief Добавить значение канала в интервал, содержащий time
+   * @return false — значение старше содержимого ячейки (интервал уже вытеснен)
+   */
+  bool add(uint32_t time, uint8_t channel, int16_t value);
+
+  /** @brief Интервал, содержащий time; nullptr — интервала нет (пуст или вытеснен) */
+  const RollupSlot_t *find(uint32_t time) const;
+
+  /** @brief Интервал, содержащий time, ещё не вытеснен из кольца (есть ли в нём данные — find()) */
+  bool holds(uint32_t time) const;
+
+  /** @brief Начало последнего интервала с данными (0 — данных нет) */
+  uint32_t last() const
+  {
+    return newest;
+  }
+
+  /** @brief Пересчитать последний интервал после загрузки ячеек */
+  void rescan();
+
+  uint32_t period() const
+  {
+    return period_s;
+  }
+
+  uint32_t size() const
+  {
+    return slots;
+  }
+
+  /** @brief Ячейки (для сохранения и загрузки) */
+  RollupSlot_t *data()
+  {
+    return storage;
+  }
+
+private:
+  uint32_t period_s;     // длительность интервала, с
+  uint32_t slots;        // ячеек в кольце
+  RollupSlot_t *storage; // ячейки
+  uint32_t newest;       // начало последнего интервала (0 — данных не было)
+};
+
+/// @brief захват (lock = true) и освобождение уровней на время чтения одного интервала
+typedef void (*RollupLock_t)(bool lock);
+
+/**
+ * @brief Агрегаты всех каналов за [from, to) по уровням (tiers — от мелкого к крупному)
+ *
+ * Интервал крупного уровня берётся, если он целиком внутри [from, to); остальное покрывает
+ * самый мелкий уровень. Если интервал мелкого уровня уже вытеснен из кольца, берётся
+ * содержащий его интервал следующего уровня: крайние интервалы могут выходить за границы запроса.
+ * @param lock Если не nullptr — уровни захватываются на выбор и копирование каждого интервала
+ *             отдельно, а не на весь обход
+ * @return количество прочитанных интервалов
+ */
+uint32_t rollup_summary(const RollupTier *const *tiers, size_t count, uint32_t from, uint32_t to, RollupSlot_t &out,
+                        RollupLock_t lock = nullptr);
+
+#endif // _ROLLUP_TIER_H_
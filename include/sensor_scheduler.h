@@ -0,0 +1,130 @@
+#ifndef _SENSOR_SCHEDULER_H_
+#define _SENSOR_SCHEDULER_H_
+
+#include "common.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <stdint.h>
+
+#define SENSOR_SCHED_MAX_DRIVERS 6   // максимальное количество драйверов датчиков
+#define SENSOR_SCHED_BATCH_MS 200    // датчики со сроком в пределах окна запускаются одной пачкой
+#define SENSOR_SCHED_RETRY_MS 5000   // интервал повторного поиска отсутствующего датчика
+#define SENSOR_SCHED_BUSY_RETRIES 10 // сколько раз (по тику) дочитывать незавершённое преобразование
+
+/// @brief результат чтения датчика
+enum SensorResult_t
+{
+  SENSOR_OK = 0, // данные прочитаны и опубликованы
+  SENSOR_BUSY,   // преобразование ещё не завершено, прочитать позже
+  SENSOR_FAIL,   // ошибка обмена: датчик будет найден заново (probe)
+};
+
+/**
+ * @brief Драйвер датчика для планировщика SensorScheduler
+ *
+ * Цикл измерения разделён на запуск преобразования (start) и чтение результата (collect)
+ * через conversion_ms(): на время преобразования планировщик занимается другими датчиками
+ * или спит. Результат публикуется драйвером в шину данных (DataBus) в своём топике.
+ * Все методы вызываются только из задачи планировщика.
+ */
+class SensorDriver
+{
+public:
+  SensorDriver(const char *name, uint32_t period_ms) : drv_name(name), drv_period_ms(period_ms)
+  {
+  }
+  virtual ~SensorDriver()
+  {
+  }
+
+  const char *name() const
+  {
+    return drv_name;
+  }
+
+  /** @brief Период опроса (мс); драйвер может менять его после каждого измерения */
+  uint32_t period_ms() const
+  {
+    return drv_period_ms;
+  }
+
+  /** @brief Найти и настроить датчик; false — повторить через SENSOR_SCHED_RETRY_MS */
+  virtual bool probe() = 0;
+
+  /** @brief Запустить преобразование; false — ошибка обмена */
+  virtual bool start() = 0;
+
+  /** @brief Максимальное время преобразования при текущих настройках (мс) */
+  virtual uint32_t conversion_ms() const = 0;
+
+  /**
+   * @brief Прочитать результат и опубликовать его
+   * @param stamp Метка времени чтения (момент получения образца)
+   */
+  virtual SensorResult_t collect(const SampleStamp_t &stamp) = 0;
+
+protected:
+  /** @brief Сменить период опроса (вызывать из collect(): следующий срок считается по новому периоду) */
+  void set_period_ms(uint32_t period_ms)
+  {
+    drv_period_ms = period_ms;
+  }
+
+private:
+  SensorDriver(const SensorDriver &) = delete;
+  SensorDriver &operator=(const SensorDriver &) = delete;
+
+  const char *drv_name;   // имя датчика (для журнала)
+  uint32_t drv_period_ms; // период опроса (мс)
+};
+
+/// @brief счётчики одного датчика
+struct SensorDriverStats_t
+{
+  uint32_t samples;     // успешных измерений
+  uint32_t last_hour;   // успешных измерений за последний завершённый час
+  uint32_t busy;        // повторных чтений незавершённого преобразования
+  uint32_t failures;    // ошибок обмена (start/collect)
+  uint32_t probes;      // попыток поиска датчика
+  uint32_t max_late_ms; // максимальное опоздание запуска относительно срока (мс)
+  bool present;         // датчик найден
+};
+
+/**
+ * @brief Планировщик опроса датчиков в одной задаче
+ *
+ * Держит список драйверов с собственными периодами. Датчики, срок которых наступает
+ * в пределах SENSOR_SCHED_BATCH_MS, запускаются пачкой: их преобразования идут параллельно,
+ * задача просыпается один раз после самого долгого из них и читает результаты подряд,
+ * поэтому транзакции на шине I2C идут плотной серией, а не вразброс. Следующий срок
+ * отсчитывается от предыдущего (без накопления дрейфа, как vTaskDelayUntil) по периоду,
+ * действующему после чтения результата, поэтому драйвер может адаптировать частоту
+ * опроса к скорости изменения показаний. Добавление датчика —
+ * это объект драйвера, а не отдельная задача со своим стеком.
+ */
+class SensorScheduler
+{
+public:
+  SensorScheduler() = delete;
+
+  /**
+   * @brief Добавить драйвер (до вызова run() из задачи планировщика)
+   * @param first_delay_ms Задержка до первого измерения
+   * @return false если список драйверов заполнен
+   */
+  static bool add(SensorDriver &driver, uint32_t first_delay_ms = 0);
+
+  /**
+   * @brief Цикл задачи планировщика (не возвращает управление)
+   * @param tag Лог-тег задачи
+   * @param stack_size Размер стека задачи (для контроля high-water mark)
+   */
+  static void run(const char *tag, uint16_t stack_size);
+
+  /** @brief Счётчики драйвера по индексу регистрации; false если индекс вне списка */
+  static bool get_stats(uint8_t index, SensorDriverStats_t &stats);
+
+  static void log_stats();
+};
+
+#endif // _SENSOR_SCHEDULER_H_
@@ -0,0 +1,215 @@
+#ifndef _SPSC_CHANNEL_H_
+#define _SPSC_CHANNEL_H_
+
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// @brief политика канала при переполнении
+enum ChannelPolicy_t
+{
+  CHANNEL_POLICY_BLOCK = 0,       // ждать освобождения места (не дольше block_timeout), затем отбросить новый элемент
+  CHANNEL_POLICY_DROP_OLDEST,     // вытеснить самый старый элемент
+  CHANNEL_POLICY_COALESCE_LATEST, // вытеснить все непрочитанные элементы — в канале остаётся только последний
+};
+
+/// @brief счётчики канала
+struct ChannelStats_t
+{
+  uint32_t pushes;         // помещено элементов
+  uint32_t drops;          // отброшено элементов (вытеснены или не помещены)
+  uint32_t high_watermark; // максимальная наблюдавшаяся заполненность
+  uint32_t blocked_ticks;  // суммарное время ожидания производителя (тики)
+};
+
+/**
+ * @brief Lock-free кольцевой канал "один производитель — один потребитель"
+ *
+ * Тип элемента и ёмкость фиксируются на этапе компиляции. Производитель меняет только `head`,
+ * потребитель — только `tail`, поэтому push()/pop() обходятся без критических секций.
+ * После записи элемента задача-потребитель будится уведомлением (бит `notify_bit`),
+ * и ждёт данные через xTaskNotifyWait() вместо блокировки на очереди.
+ *
+ * Поведение при переполнении задаётся политикой ChannelPolicy_t. При вытеснении производитель
+ * забирает элемент со стороны потребителя, поэтому `tail` продвигается через CAS обеими сторонами;
+ * вытесненные элементы передаются утилизатору (например, для освобождения ссылки).
+ *
+ * @tparam T тип элемента (тривиально копируемый)
+ * @tparam N ёмкость канала (степень двойки)
+ */
+template <typename T, size_t N>
+class SpscChannel
+{
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscChannel capacity must be a power of two");
+
+public:
+  /// @brief утилизатор вытесненных/отброшенных элементов (вызывается в контексте производителя)
+  typedef void (*Disposer_t)(const T &item);
+
+  SpscChannel() = default;
+
+  /**
+   * @brief Задать политику переполнения (вызывать до начала обмена)
+   * @param p Политика
+   * @param timeout Максимальное время ожидания для CHANNEL_POLICY_BLOCK (тики)
+   */
+  void set_policy(ChannelPolicy_t p, TickType_t timeout = pdMS_TO_TICKS(100))
+  {
+    policy = p;
+    block_timeout = timeout;
+  }
+
+  ChannelPolicy_t get_policy() const
+  {
+    return policy;
+  }
+
+  /** @brief Задать утилизатор вытесненных/отброшенных элементов */
+  void set_disposer(Disposer_t d)
+  {
+    disposer = d;
+  }
+
+  /**
+   * @brief Назначить задачу-потребителя, которая будет уведомляться о новых элементах
+   * @param task Дескриптор задачи-потребителя
+   * @param bit Бит(ы) уведомления, выставляемые задаче при push()
+   */
+  void attach_consumer(TaskHandle_t task, uint32_t bit)
+  {
+    notify_bit = bit;
+    consumer.store(task, std::memory_order_release);
+  }
+
+  /**
+   * @brief Поместить элемент в канал согласно политике (вызывать только из задачи-производителя)
+   * @return true если элемент помещён, false если отброшен (ожидание CHANNEL_POLICY_BLOCK истекло);
+   *         отброшенный элемент утилизатору не передаётся — им владеет вызывающий
+   */
+  bool push(const T &item)
+  {
+    const uint32_t h = head.load(std::memory_order_relaxed);
+    uint32_t t = tail.load(std::memory_order_acquire);
+
+    if (policy == CHANNEL_POLICY_COALESCE_LATEST)
+    {
+      while (h != t)
+        evict(t);
+    }
+    else if (h - t >= N)
+    {
+      if (policy == CHANNEL_POLICY_DROP_OLDEST)
+      {
+        while (h - t >= N)
+          evict(t);
+      }
+      else
+      {
+        const TickType_t start = xTaskGetTickCount();
+        do
+        {
+          if ((xTaskGetTickCount() - start) >= block_timeout)
+          {
+            blocked_ticks.fetch_add(xTaskGetTickCount() - start, std::memory_order_relaxed);
+            drops.fetch_add(1, std::memory_order_relaxed);
+            return false;
+          }
+          vTaskDelay(1);
+          t = tail.load(std::memory_order_acquire);
+        } while (h - t >= N);
+        blocked_ticks.fetch_add(xTaskGetTickCount() - start, std::memory_order_relaxed);
+      }
+    }
+
+    buf[h & (N - 1)] = item;
+    head.store(h + 1, std::memory_order_release);
+    pushes.fetch_add(1, std::memory_order_relaxed);
+
+    const uint32_t depth = h + 1 - tail.load(std::memory_order_relaxed);
+    if (depth > high_watermark.load(std::memory_order_relaxed))
+      high_watermark.store(depth, std::memory_order_relaxed);
+
+    TaskHandle_t task = consumer.load(std::memory_order_acquire);
+    if (task)
+      xTaskNotify(task, notify_bit, eSetBits);
+    return true;
+  }
+
+  /**
+   * @brief Извлечь элемент из канала (вызывать только из задачи-потребителя)
+   * @return true если элемент извлечён, false если канал пуст
+   */
+  bool pop(T &item)
+  {
+    uint32_t t = tail.load(std::memory_order_acquire);
+    for (;;)
+    {
+      if (head.load(std::memory_order_acquire) == t)
+        return false;
+
+      item = buf[t & (N - 1)];
+      // производитель мог вытеснить этот элемент — тогда повторить со следующего
+      if (tail.compare_exchange_weak(t, t + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+        return true;
+    }
+  }
+
+  /** @brief Текущее количество элементов в канале (приблизительно при конкурентном доступе) */
+  size_t size() const
+  {
+    return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+  }
+
+  bool empty() const
+  {
+    return size() == 0;
+  }
+
+  static constexpr size_t capacity()
+  {
+    return N;
+  }
+
+  void get_stats(ChannelStats_t &stats) const
+  {
+    stats.pushes = pushes.load(std::memory_order_relaxed);
+    stats.drops = drops.load(std::memory_order_relaxed);
+    stats.high_watermark = high_watermark.load(std::memory_order_relaxed);
+    stats.blocked_ticks = blocked_ticks.load(std::memory_order_relaxed);
+  }
+
+private:
+  // запрет копирования/перемещения
+  SpscChannel(const SpscChannel &) = delete;
+  SpscChannel &operator=(const SpscChannel &) = delete;
+
+  /// @brief вытеснить элемент по индексу `t` (при гонке с потребителем `t` обновляется)
+  void evict(uint32_t &t)
+  {
+    const T victim = buf[t & (N - 1)];
+    if (tail.compare_exchange_strong(t, t + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+    {
+      drops.fetch_add(1, std::memory_order_relaxed);
+      if (disposer)
+        disposer(victim);
+      ++t;
+    }
+  }
+
+  T buf[N];                                     // кольцевой буфер элементов
+  std::atomic<uint32_t> head{0};                // счётчик записанных элементов (пишет производитель)
+  std::atomic<uint32_t> tail{0};                // счётчик прочитанных элементов (потребитель; производитель — при вытеснении)
+  std::atomic<TaskHandle_t> consumer{nullptr};  // задача-потребитель для уведомлений
+  uint32_t notify_bit{0};                       // бит уведомления задачи-потребителя
+  ChannelPolicy_t policy{CHANNEL_POLICY_BLOCK}; // политика при переполнении
+  TickType_t block_timeout{pdMS_TO_TICKS(100)}; // максимальное ожидание для CHANNEL_POLICY_BLOCK
+  Disposer_t disposer{nullptr};                 // утилизатор вытесненных элементов
+  std::atomic<uint32_t> pushes{0};              // счётчик помещённых элементов
+  std::atomic<uint32_t> drops{0};               // счётчик отброшенных элементов
+  std::atomic<uint32_t> high_watermark{0};      // максимальная заполненность
+  std::atomic<uint32_t> blocked_ticks{0};       // суммарное время ожидания производителя
+};
+
+#endif // _SPSC_CHANNEL_H_
@@ -0,0 +1,83 @@
+#ifndef _STATION_STATE_H_
+#define _STATION_STATE_H_
+
+#include "common.h"
+#include "databus.h"
+#include "openmeteo.h"
+
+#define STATE_MAX_WATCHERS 4                                  // максимальное количество задач, уведомляемых об обновлении состояния
+#define STATE_OUT_NODE_STALE_MS (MAX_METEO_VALID_INTERVAL_MS / 2) // основной наружный узел замолчал дольше — его заменяет следующий
+
+/// @brief поля состояния станции (у каждого поля своя версия)
+enum StateField_t
+{
+  STATE_FIELD_METEO = 0,   // метеосводка (текущая погода и прогноз)
+  STATE_FIELD_GEOMAGNETIC, // прогноз геомагнитной обстановки
+  STATE_FIELD_IN_SENSOR,   // данные комнатного датчика
+  STATE_FIELD_OUT_SENSOR,  // данные наружнего датчика
+  STATE_FIELD_CITYNAME,    // наименование населённого пункта
+  _STATE_FIELD_NUM_
+};
+
+/// @brief согласованный снимок последних значений всех данных станции
+struct StationSnapshot_t
+{
+  OpenMeteoData meteo[_METEO_DATA_NUM_];      // последние метеоданные по индексам OpenMeteoDataIndex_t
+  uint8_t meteo_mask;                         // битовая маска индексов meteo[], для которых есть данные
+  GeoMagneticKpMax geomag;                    // прогноз геомагнитной обстановки
+  HomeSensorData_t in;                        // данные комнатного датчика
+  OutSensorData_t out;                        // данные наружнего датчика (основной узел)
+  uint8_t out_node;                           // номер узла, данные которого в out
+  char city[BUS_CITY_NAME_LEN];               // наименование населённого пункта
+  uint32_t version[_STATE_FIELD_NUM_];        // версия поля (0 — данных ещё не было)
+  TickType_t updated_tick[_STATE_FIELD_NUM_]; // время последнего обновления поля (тики)
+  SampleStamp_t stamp[_STATE_FIELD_NUM_];     // время получения данных поля (метка образца шины)
+  uint8_t restored;                           // битовая маска полей, восстановленных после перезапуска (устарели до первых свежих данных)
+};
+
+/**
+ * @brief Центральное хранилище последних значений данных станции под sequence lock
+ *
+ * Производители обновляют поля (через шину данных — StationState подписан на неё
+ * синхронным слушателем), читатели получают согласованный снимок без блокировок и по
+ * версиям полей решают, что перерисовать или переопубликовать. Поле наружного датчика
+ * показывает основной узел: узел с наименьшим номером, данные которого не устарели
+ * (STATE_OUT_NODE_STALE_MS); остальные узлы доступны в таблице NrfNodes.
+ */
+class StationState
+{
+public:
+  StationState() = delete;
+
+  /** @brief Подключить хранилище к шине данных (вызывать до создания задач) */
+  static void init();
+
+  /** @brief Применить образец шины к соответствующему полю состояния */
+  static void apply(const BusSample_t &sample);
+
+  /**
+   * @brief Восстановить поля из сохранённого снимка (до появления производителей)
+   *
+   * Поля получают версию 1 и бит в `restored`: их можно показать сразу, но они не считаются
+   * свежими. Бит снимается первым образцом шины для поля.
+   * @param fields Битовая маска полей StateField_t
+   */
+  static void restore(const StationSnapshot_t &saved, uint8_t fields);
+
+  /** @brief Получить согласованный снимок состояния (lock-free, с повтором при конкурентной записи) */
+  static void snapshot(StationSnapshot_t &out);
+
+  /** @brief Текущая версия поля без снятия снимка */
+  static uint32_t version(StateField_t field);
+
+  /** @brief Номер основного наружного узла без снятия снимка */
+  static uint8_t out_node();
+
+  /**
+   * @brief Уведомлять задачу (бит NOTIFY_BIT_STATE) при каждом обновлении состояния
+   * @return false если достигнут лимит наблюдателей
+   */
+  static bool watch(TaskHandle_t task);
+};
+
+#endif // _STATION_STATE_H_
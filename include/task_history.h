@@ -0,0 +1,10 @@
+#ifndef _TASK_HISTORY_H_
+#define _TASK_HISTORY_H_
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// Entry point for the history task: one station reading per minute into TsLog
+void task_history_exec(void *pvParameters);
+
+#endif // _TASK_HISTORY_H_
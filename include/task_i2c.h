@@ -0,0 +1,10 @@
+#ifndef _TASK_I2C_H_
+#define _TASK_I2C_H_
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// Entry point for the I2C transaction engine task
+void task_i2c_exec(void *pvParameters);
+
+#endif // _TASK_I2C_H_
@@ -7,4 +7,7 @@
 // Entry point for the nRF24 receiver task
 void task_nrf24_exec(void *pvParameters);
 
+// Вывести счётчики приёма nRF24 (прерывания, пакеты, переполнения RX FIFO)
+void task_nrf24_log_stats();
+
 #endif // _TASK_NRF24_H_
@@ -1,8 +1,9 @@
 #ifndef _TASKS_COMMON_H_
 #define _TASKS_COMMON_H_
 
+#include "bme280.h"
 #include "common.h"
-#include <Adafruit_BME280.h>
+#include "databus.h"
 #include <LovyanGFX.hpp>
 #include <freertos/FreeRTOS.h>
 #include <freertos/event_groups.h>
@@ -11,14 +12,51 @@
 
 extern LGFX tft;
 extern TaskHandle_t xHandles[_PROTASK_NUM_];
-extern QueueHandle_t xQueue[_PROTASK_NUM_];
-extern StaticQueue_t xQueueBuffer[_PROTASK_NUM_];
-extern uint8_t xQueueStorage[_PROTASK_NUM_][DATA_QUEUE_SIZE * DATA_QUEUE_ITEM_SIZE];
 extern StaticEventGroup_t xEventGroupBuffer;
 extern EventGroupHandle_t xEventGroup;
-extern Adafruit_BME280 bme;
+extern Bme280 bme;
 
 // Мьютекс для синхронизации доступа к LittleFS между задачами
 extern SemaphoreHandle_t xLittleFSMutex;
 
+// Helper macro for LittleFS mutex protection
+#define LITTLEFS_LOCK()                              \
+  do                                                 \
+  {                                                  \
+    if (xLittleFSMutex)                              \
+      xSemaphoreTake(xLittleFSMutex, portMAX_DELAY); \
+  } while (0)
+
+#define LITTLEFS_UNLOCK()             \
+  do                                  \
+  {                                   \
+    if (xLittleFSMutex)               \
+      xSemaphoreGive(xLittleFSMutex); \
+  } while (0)
+
+// Уведомить задачу TFT об изменении битов состояния системы (отображаются на экране)
+static inline void system_bits_notify()
+{
+  if (xHandles[PROTASK_TFT])
+    xTaskNotify(xHandles[PROTASK_TFT], NOTIFY_BIT_SYSTEM, eSetBits);
+}
+
+// Установить биты состояния системы; TFT уведомляется только при фактическом изменении
+static inline void system_bits_set(EventBits_t bits)
+{
+  if (!xEventGroup || (xEventGroupGetBits(xEventGroup) & bits) == bits)
+    return;
+  xEventGroupSetBits(xEventGroup, bits);
+  system_bits_notify();
+}
+
+// Сбросить биты состояния системы; TFT уведомляется только при фактическом изменении
+static inline void system_bits_clear(EventBits_t bits)
+{
+  if (!xEventGroup || (xEventGroupGetBits(xEventGroup) & bits) == 0)
+    return;
+  xEventGroupClearBits(xEventGroup, bits);
+  system_bits_notify();
+}
+
 #endif // _TASKS_COMMON_H_
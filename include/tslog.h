@@ -0,0 +1,66 @@
+#ifndef _TSLOG_H_
+#define _TSLOG_H_
+
+#include "tslog_page.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#define TSLOG_PARTITION_LABEL "tslog" // раздел флеш-памяти журнала (таблица разделов partitions_16MB_tslog.csv)
+
+/// @brief показатели журнала
+struct TsLogStats_t
+{
+  uint32_t pages;        // страниц в разделе
+  uint32_t valid_pages;  // записанных страниц с верной CRC
+  uint32_t head_seq;     // порядковый номер заполняемой страницы
+  uint32_t open_records; // записей в заполняемой странице (в памяти RTC)
+  uint32_t records;      // записей во флеш-памяти
+  uint32_t first_time;   // время самой старой записи (0 — журнал пуст)
+  uint32_t last_time;    // время последней записи
+  uint32_t page_writes;  // записано страниц с момента загрузки
+  uint32_t write_errors; // ошибок стирания/записи
+  uint32_t rejected;     // отброшенных записей (время не растёт)
+  bool resumed;          // заполняемая страница восстановлена из памяти RTC после сброса
+};
+
+/// @brief обработчик записи при чтении журнала; false — прекратить чтение
+typedef bool (*TsLogVisitor_t)(const TsRecord_t &rec, void *ctx);
+
+/**
+ * @brief Журнал показаний в отдельном разделе флеш-памяти (не LittleFS)
+ *
+ * Кольцо страниц по 4 КБ: страница с порядковым номером seq лежит в секторе seq % страниц,
+ * каждый сектор стирается один раз за оборот кольца. Заполняемая страница живёт в памяти
+ * RTC (не очищается при программном сбросе, сторожевом таймере и панике) и записывается
+ * во флеш-память целиком, когда заполнится. При запуске разделы просматриваются: страницы
+ * с неверной CRC (запись прервана отключением питания) пропускаются, продолжение — после
+ * страницы с наибольшим номером. При отключении питания теряется только заполняемая страница.
+ * Диапазоны времени страниц держатся в индексе в ОЗУ: чтение интервала обращается к флеш-памяти
+ * только за страницами, которые его пересекают.
+ */
+class TsLog
+{
+public:
+  TsLog() = delete;
+
+  /**
+   * @brief Найти раздел, восстановить кольцо и заполняемую страницу; false — раздела нет
+   *
+   * Повторный вызов просматривает раздел заново, как после сброса.
+   */
+  static bool begin();
+
+  /** @brief Добавить запись (время должно расти); заполненная страница записывается во флеш-память */
+  static bool append(const TsRecord_t &rec);
+
+  /**
+   * @brief Обойти записи с временем в [from, to] от старых к новым (флеш-память, затем память RTC)
+   * @return количество переданных обработчику записей
+   */
+  static size_t read(uint32_t from, uint32_t to, TsLogVisitor_t visit, void *ctx);
+
+  static void get_stats(TsLogStats_t &out);
+  static void log_stats();
+};
+
+#endif // _TSLOG_H_
@@ -0,0 +1,170 @@
+#ifndef _TSLOG_PAGE_H_
+#define _TSLOG_PAGE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Страница журнала показаний (TsLog) — сектор флеш-памяти 4 КБ:
+ *
+ *   байт  0..3   magic TSLOG_MAGIC
+ *   байт  4..7   порядковый номер страницы (растёт на 1, место в разделе — seq % страниц)
+ *   байт  8..11  время первой записи (UTC, с)
+ *   байт 12..15  время последней записи (UTC, с)
+ *   байт 16..17  количество записей
+ *   байт 18      версия формата TSLOG_VERSION
+ *   байт 19      количество каналов TSLOG_CHANNELS
+ *   байт 20..23  CRC-32 страницы (поле CRC считается нулевым)
+ *   байт 24..    битовый поток записей (старший бит байта — первый)
+ *
+ * Первая запись хранится полностью: время 32 бита, каналы по 16 бит. Далее время —
+ * разность разностей (для записей раз в минуту почти всегда 0 — один бит), каналы —
+ * разность с предыдущим значением. Обе величины кодируются префиксом длины:
+ *   0         — ноль
+ *   10   + w1 — w1 бит со знаком
+ *   110  + w2 — w2 бит
+ *   1110 + w3 — w3 бит
+ *   1111 + w4 — полное значение (32 бита для времени, 16 бит для канала)
+ * Многобайтовые поля заголовка — little-endian.
+ */
+
+#define TSLOG_PAGE_SIZE 4096                                        // страница журнала = сектор флеш-памяти (единица стирания)
+#define TSLOG_HEADER_SIZE 24                                        // заголовок страницы
+#define TSLOG_BODY_BITS ((TSLOG_PAGE_SIZE - TSLOG_HEADER_SIZE) * 8) // ёмкость битового потока
+#define TSLOG_MAGIC 0x474C5354u                                     // "TSLG"
+#define TSLOG_VERSION 1                                             // версия формата страницы
+#define TSLOG_NO_VALUE INT16_MIN                                    // значения канала нет (датчик молчит)
+
+/// @brief каналы записи журнала (фиксированная точка)
+enum TsChannel_t
+{
+  TSLOG_IN_T = 0, // температура в помещении, 0.1 °C
+  TSLOG_IN_H,     // влажность в помещении, %
+  TSLOG_IN_P,     // давление в помещении, 0.1 гПа
+  TSLOG_OUT_T,    // температура снаружи (основной узел), 0.1 °C
+  TSLOG_OUT_H,    // влажность снаружи, %
+  TSLOG_OUT_P,    // давление снаружи, 0.1 гПа
+  TSLOG_CHANNELS
+};
+
+/// @brief запись журнала: показания станции на момент времени
+struct TsRecord_t
+{
+  uint32_t time;                 // время UTC, с
+  int16_t value[TSLOG_CHANNELS]; // значения каналов (TSLOG_NO_VALUE — нет данных)
+};
+
+/** @brief Значение в фиксированной точке с насыщением (TSLOG_NO_VALUE — только для отсутствующих данных) */
+static inline int16_t tslog_fixed(float value, float scale)
+{
+  const float v = value * scale + (value < 0 ? -0.5f : 0.5f);
+  if (!(v == v)) // NaN
+    return TSLOG_NO_VALUE;
+  return static_cast<int16_t>(v < TSLOG_NO_VALUE + 1 ? TSLOG_NO_VALUE + 1 : v > INT16_MAX ? INT16_MAX : v);
+}
+
+/// @brief заголовок страницы
+struct TsPageHeader_t
+{
+  uint32_t seq;        // порядковый номер страницы
+  uint32_t first_time; // время первой записи
+  uint32_t last_time;  // время последней записи
+  uint16_t count;      // количество записей
+};
+
+/**
+ * @brief Заполнение страницы журнала
+ *
+ * Тривиальный тип без конструктора: объект может лежать в памяти, не очищаемой при
+ * перезапуске (RTC_NOINIT), и продолжать заполнение после сброса. Страница записывается
+ * во флеш-память целиком, когда следующая запись в неё не помещается.
+ */
+class TsPageWriter
+{
+public:
+  /** @brief Начать пустую страницу с порядковым номером seq */
+  void begin(uint32_t seq);
+
+  /** @brief Добавить запись; false — страница заполнена (запись не добавлена) */
+  bool append(const TsRecord_t &rec);
+
+  /** @brief Записать заголовок и CRC — страница готова к записи во флеш-память */
+  void seal();
+
+  const uint8_t *data() const
+  {
+    return page;
+  }
+
+  uint32_t seq() const
+  {
+    return page_seq;
+  }
+
+  uint16_t count() const
+  {
+    return records;
+  }
+
+  /** @brief Время последней записи (0 — страница пуста) */
+  uint32_t last_time() const
+  {
+    return records ? prev.time : 0;
+  }
+
+  /** @brief Занято бит битового потока */
+  uint32_t used_bits() const
+  {
+    return bits;
+  }
+
+private:
+  void put(uint32_t value, uint8_t width);
+  void put_signed(int32_t value, const uint8_t *widths);
+
+  uint8_t page[TSLOG_PAGE_SIZE]; // содержимое страницы
+  uint32_t page_seq;             // порядковый номер страницы
+  uint32_t bits;                 // занято бит битового потока
+  uint32_t first_time;           // время первой записи
+  int32_t prev_delta;            // предыдущий шаг времени
+  TsRecord_t prev;               // предыдущая запись
+  uint16_t records;              // записей на странице
+};
+
+/**
+ * @brief Чтение записей страницы журнала
+ */
+class TsPageReader
+{
+public:
+  /**
+   * @brief Разобрать заголовок и проверить страницу (magic, версия, CRC)
+   * @return false — страница пуста, повреждена или другого формата
+   */
+  static bool check(const uint8_t *page, TsPageHeader_t &out);
+
+  /** @brief Разобрать заголовок без проверки CRC (отбор страниц по времени до чтения целиком) */
+  static bool peek(const uint8_t *header, TsPageHeader_t &out);
+
+  /** @brief Читать записи проверенной страницы (или заполняемой: count — её записей) */
+  void open(const uint8_t *page, uint16_t count);
+
+  /** @brief Следующая запись; false — записи кончились */
+  bool next(TsRecord_t &out);
+
+private:
+  uint32_t get(uint8_t width);
+  int32_t get_signed(const uint8_t *widths);
+
+  const uint8_t *page; // страница
+  uint32_t bits;       // прочитано бит
+  uint16_t left;       // осталось записей
+  uint16_t index;      // номер следующей записи
+  int32_t prev_delta;  // предыдущий шаг времени
+  TsRecord_t prev;     // предыдущая запись
+};
+
+/** @brief CRC-32 (IEEE 802.3) */
+uint32_t tslog_crc32(uint32_t crc, const uint8_t *data, size_t len);
+
+#endif // _TSLOG_PAGE_H_
@@ -0,0 +1,143 @@
+#ifndef _VIRTUAL_SOURCE_H_
+#define _VIRTUAL_SOURCE_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#ifndef VIRTUAL_SENSORS
+#define VIRTUAL_SENSORS 0 // 1 — датчики заменяются воспроизведением трасс (окружение *-virtual в platformio.ini)
+#endif
+
+#define VIRTUAL_SPEEDUP 1                            // ускорение воспроизведения (1 — реальное время)
+#define VIRTUAL_IN_TRACE "/littlefs/replay/in.csv"   // трасса комнатного датчика (путь VFS)
+#define VIRTUAL_OUT_TRACE "/littlefs/replay/out.csv" // трасса наружных узлов (путь VFS)
+#define VIRTUAL_SYNTH_NODES 6                        // узлов синтетического наружного источника
+#define VIRTUAL_SYNTH_INTERVAL_MS 60000              // период передачи синтетических узлов (мс)
+#define VIRTUAL_SYNTH_BURST_EVERY 10                 // каждый N-й период все узлы передают пачкой (0 — без пачек)
+#define VIRTUAL_SYNTH_SEED 12345                     // начальное значение генератора шума (повторяемые прогоны)
+
+/// @brief одно измерение виртуального источника
+struct VirtualSample_t
+{
+  uint32_t t_ms;     // момент от начала трассы (мс), не убывает
+  uint8_t node;      // номер узла (для комнатного датчика — 0)
+  float temperature; // температура, °C
+  float humidity;    // относительная влажность, %
+  float pressure;    // давление, гПа
+  uint8_t battery;   // заряд батареи, %
+};
+
+/**
+ * @brief Источник измерений вместо датчика
+ *
+ * Источник только выдаёт измерения по порядку времени; задача датчика выдерживает
+ * темп (VirtualPacer) и пропускает измерения через тот же путь, что и данные
+ * настоящего датчика. Без зависимостей от платформы — собирается на хосте.
+ */
+class VirtualSource
+{
+public:
+  virtual ~VirtualSource()
+  {
+  }
+
+  /** @brief Следующее измерение; false — трасса закончилась (rewind() начинает её заново) */
+  virtual bool next(VirtualSample_t &out) = 0;
+  virtual void rewind() = 0;
+
+  /**
+   * @brief Разобрать строку трассы CSV: t_ms,node,temperature,humidity,pressure,battery
+   * @return false для пустой строки, комментария (#) или заголовка
+   */
+  static bool parse_line(const char *line, VirtualSample_t &out);
+};
+
+/**
+ * @brief Трасса из файла CSV (записанная или подготовленная на хосте)
+ *
+ * Файл читается построчно через stdio (на ESP32 — VFS LittleFS), в памяти только
+ * текущая строка. Вызывающий отвечает за блокировку файловой системы.
+ */
+class VirtualFileSource : public VirtualSource
+{
+public:
+  explicit VirtualFileSource(const char *path);
+  ~VirtualFileSource();
+
+  /** @brief Файл открыт */
+  bool ok() const
+  {
+    return file != nullptr;
+  }
+
+  bool next(VirtualSample_t &out) override;
+  void rewind() override;
+
+private:
+  VirtualFileSource(const VirtualFileSource &) = delete;
+  VirtualFileSource &operator=(const VirtualFileSource &) = delete;
+
+  FILE *file; // открытая трасса (nullptr — файла нет)
+};
+
+/**
+ * @brief Синтетическая трасса: суточный ход температуры и влажности, медленный ход давления
+ *
+ * Узлы передают по очереди со сдвигом фазы node/nodes периода; каждый burst_every-й период
+ * все узлы передают пачкой с интервалом 2 мс (нагрузка на очередь приёма). Шум —
+ * детерминированный генератор: прогоны с одним seed повторяют друг друга.
+ */
+class VirtualSynthSource : public VirtualSource
+{
+public:
+  VirtualSynthSource(uint8_t nodes, uint32_t interval_ms, uint32_t burst_every, uint32_t seed);
+
+  bool next(VirtualSample_t &out) override;
+  void rewind() override;
+
+private:
+  float noise(float amplitude);
+
+  uint8_t nodes;        // количество узлов
+  uint32_t interval_ms; // период передачи узла
+  uint32_t burst_every; // период пачек (в периодах передачи, 0 — без пачек)
+  uint32_t seed;        // начальное значение генератора
+  uint32_t state;       // состояние генератора шума
+  uint32_t index;       // номер следующего измерения
+};
+
+/**
+ * @brief Темп воспроизведения: момент трассы → задержка до него с учётом ускорения
+ */
+class VirtualPacer
+{
+public:
+  explicit VirtualPacer(uint32_t factor) : speedup(factor ? factor : 1), base_ms(0), started(false)
+  {
+  }
+
+  /** @brief Начать отсчёт заново (трасса пошла по кругу) */
+  void restart()
+  {
+    started = false;
+  }
+
+  /** @brief Сколько ждать (мс) до момента трассы t_ms; первый вызов привязывает трассу к now_ms */
+  uint32_t delay_ms(uint32_t t_ms, uint64_t now_ms)
+  {
+    if (!started)
+    {
+      base_ms = now_ms - t_ms / speedup;
+      started = true;
+    }
+    const uint64_t target = base_ms + t_ms / speedup;
+    return target > now_ms ? static_cast<uint32_t>(target - now_ms) : 0;
+  }
+
+private:
+  uint32_t speedup; // ускорение воспроизведения
+  uint64_t base_ms; // момент, соответствующий началу трассы
+  bool started;     // отсчёт привязан
+};
+
+#endif // _VIRTUAL_SOURCE_H_
@@ -0,0 +1,28 @@
+#ifndef _WAKEUP_MONITOR_H_
+#define _WAKEUP_MONITOR_H_
+
+#include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+typedef struct
+{
+  const char *tag;         // лог-тег задачи
+  TickType_t window_start; // начало текущего минутного окна
+  uint32_t count;          // пробуждений в текущем окне
+  uint32_t last_rate;      // пробуждений за последнюю завершённую минуту
+} WakeupMonitor_t;
+
+static inline void wakeup_monitor_init(WakeupMonitor_t *mon, const char *tag)
+{
+  mon->tag = tag;
+  mon->window_start = xTaskGetTickCount();
+  mon->count = 0;
+  mon->last_rate = 0;
+  esp_log_level_set("WAKEUP", ESP_LOG_INFO);
+}
+
+// Учесть пробуждение задачи; раз в минуту логировать количество пробуждений за минуту
+void wakeup_monitor_tick(WakeupMonitor_t *mon);
+
+#endif // _WAKEUP_MONITOR_H_
@@ -31,6 +31,9 @@ private:
   WiFiManagerParameter custom_lat;
   WiFiManagerParameter custom_long;
   WiFiManagerParameter custom_gmt_offset;
+  WiFiManagerParameter custom_sample_min;
+  WiFiManagerParameter custom_sample_max;
+  WiFiManagerParameter custom_out_interval;
 };
 
 #endif // _WEBPORTAL_H_
\ No newline at end of file
@@ -0,0 +1,139 @@
+#include "bme280.h"
+#include "i2c_engine.h"
+#include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+static const char *TAG = "BME280";
+
+// Регистры BME280
+#define BME280_REG_CALIB_TP 0x88  // калибровка температуры/давления и dig_H1 (26 байт)
+#define BME280_REG_CHIP_ID 0xD0   // идентификатор кристалла
+#define BME280_REG_RESET 0xE0     // программный сброс
+#define BME280_REG_CALIB_H 0xE1   // калибровка влажности (7 байт)
+#define BME280_REG_CTRL_HUM 0xF2  // передискретизация влажности
+#define BME280_REG_STATUS 0xF3    // состояние (measuring, im_update)
+#define BME280_REG_CTRL_MEAS 0xF4 // передискретизация температуры/давления и режим
+#define BME280_REG_CONFIG 0xF5    // период standby, IIR-фильтр
+#define BME280_REG_DATA 0xF7      // данные измерения (8 байт)
+
+#define BME280_CHIP_ID 0x60
+#define BME280_RESET_CMD 0xB6
+#define BME280_MODE_FORCED 0x01
+#define BME280_STATUS_MEASURING 0x08
+#define BME280_STATUS_IM_UPDATE 0x01
+
+// количество преобразований для кода передискретизации (0 — измерение отключено)
+static inline uint32_t osrs_count(Bme280Oversampling_t osrs)
+{
+  return osrs == BME280_OSRS_SKIP ? 0 : (1u << (osrs - 1));
+}
+
+bool Bme280::begin(uint8_t address)
+{
+  present = false;
+  addr = address;
+
+  uint8_t id = 0;
+  if (!read_regs(BME280_REG_CHIP_ID, &id, 1) || id != BME280_CHIP_ID)
+    return false;
+
+  // сброс и ожидание копирования NVM в регистры калибровки
+  write_reg(BME280_REG_RESET, BME280_RESET_CMD);
+  vTaskDelay(pdMS_TO_TICKS(3));
+  for (int i = 0; i < 10; ++i)
+  {
+    uint8_t status = 0;
+    if (read_regs(BME280_REG_STATUS, &status, 1) && !(status & BME280_STATUS_IM_UPDATE))
+      break;
+    vTaskDelay(pdMS_TO_TICKS(2));
+  }
+
+  uint8_t tp[26];
+  uint8_t h[7];
+  if (!read_regs(BME280_REG_CALIB_TP, tp, sizeof(tp)) || !read_regs(BME280_REG_CALIB_H, h, sizeof(h)))
+    return false;
+  parse_calib(tp, h, calib);
+
+  if (!apply_config())
+    return false;
+  present = true;
+  ESP_LOGI(TAG, "BME280 found at 0x%02X", addr);
+  return true;
+}
+
+bool Bme280::configure(Bme280Oversampling_t t, Bme280Oversampling_t p, Bme280Oversampling_t h, Bme280Filter_t f)
+{
+  osrs_t = t;
+  osrs_p = p;
+  osrs_h = h;
+  filter = f;
+  return initialized() ? apply_config() : true;
+}
+
+bool Bme280::apply_config()
+{
+  // датчик в режиме sleep: config записывается только в нём, ctrl_hum вступает в силу после записи ctrl_meas
+  return write_reg(BME280_REG_CTRL_MEAS, 0) &&
+         write_reg(BME280_REG_CONFIG, static_cast<uint8_t>(filter << 2)) &&
+         write_reg(BME280_REG_CTRL_HUM, static_cast<uint8_t>(osrs_h)) &&
+         write_reg(BME280_REG_CTRL_MEAS, static_cast<uint8_t>((osrs_t << 5) | (osrs_p << 2)));
+}
+
+uint32_t Bme280::measure_time_ms() const
+{
+  // datasheet, приложение B: t_max = 1.25 + 2.3*T + (2.3*P + 0.575) + (2.3*H + 0.575) мс
+  uint32_t us = 1250 + 2300 * osrs_count(osrs_t);
+  if (osrs_p != BME280_OSRS_SKIP)
+    us += 2300 * osrs_count(osrs_p) + 575;
+  if (osrs_h != BME280_OSRS_SKIP)
+    us += 2300 * osrs_count(osrs_h) + 575;
+  return (us + 999) / 1000;
+}
+
+bool Bme280::measure(Bme280Reading_t &out)
+{
+  if (!start())
+    return false;
+
+  vTaskDelay(pdMS_TO_TICKS(measure_time_ms()) + 1);
+  for (int i = 0; i < 10; ++i)
+  {
+    if (read(out))
+      return true;
+    vTaskDelay(1);
+  }
+  return false;
+}
+
+bool Bme280::start()
+{
+  if (!initialized())
+    return false;
+  return write_reg(BME280_REG_CTRL_MEAS, static_cast<uint8_t>((osrs_t << 5) | (osrs_p << 2) | BME280_MODE_FORCED));
+}
+
+bool Bme280::read(Bme280Reading_t &out)
+{
+  if (!initialized())
+    return false;
+
+  // статус и данные одним чтением 0xF3..0xFE (регистры 0xF4..0xF6 пропускаются)
+  uint8_t buf[BME280_REG_DATA - BME280_REG_STATUS + BME280_DATA_LEN];
+  if (!read_regs(BME280_REG_STATUS, buf, sizeof(buf)))
+    return false;
+  if (buf[0] & BME280_STATUS_MEASURING)
+    return false;
+  compensate(calib, &buf[BME280_REG_DATA - BME280_REG_STATUS], out);
+  return true;
+}
+
+bool Bme280::write_reg(uint8_t reg, uint8_t value)
+{
+  return I2cEngine::write_reg(addr, reg, value) == ESP_OK;
+}
+
+bool Bme280::read_regs(uint8_t reg, uint8_t *buf, size_t len)
+{
+  return I2cEngine::read_regs(addr, reg, buf, len) == ESP_OK;
+}
@@ -0,0 +1,91 @@
+#include "bme280.h"
+
+// Разбор калибровки и компенсация Bosch: без обмена с датчиком, собирается на хосте
+
+static inline uint16_t le_u16(const uint8_t *p)
+{
+  return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+static inline int16_t le_s16(const uint8_t *p)
+{
+  return static_cast<int16_t>(le_u16(p));
+}
+
+void Bme280::parse_calib(const uint8_t tp[26], const uint8_t h[7], Bme280Calib_t &c)
+{
+  c.dig_T1 = le_u16(&tp[0]);
+  c.dig_T2 = le_s16(&tp[2]);
+  c.dig_T3 = le_s16(&tp[4]);
+  c.dig_P1 = le_u16(&tp[6]);
+  c.dig_P2 = le_s16(&tp[8]);
+  c.dig_P3 = le_s16(&tp[10]);
+  c.dig_P4 = le_s16(&tp[12]);
+  c.dig_P5 = le_s16(&tp[14]);
+  c.dig_P6 = le_s16(&tp[16]);
+  c.dig_P7 = le_s16(&tp[18]);
+  c.dig_P8 = le_s16(&tp[20]);
+  c.dig_P9 = le_s16(&tp[22]);
+  c.dig_H1 = tp[25];
+  c.dig_H2 = le_s16(&h[0]);
+  c.dig_H3 = h[2];
+  c.dig_H4 = static_cast<int16_t>((static_cast<int8_t>(h[3]) * 16) | (h[4] & 0x0F));
+  c.dig_H5 = static_cast<int16_t>((static_cast<int8_t>(h[5]) * 16) | (h[4] >> 4));
+  c.dig_H6 = static_cast<int8_t>(h[6]);
+}
+
+void Bme280::compensate(const Bme280Calib_t &c, const uint8_t raw[BME280_DATA_LEN], Bme280Reading_t &out)
+{
+  const int32_t adc_P = (static_cast<int32_t>(raw[0]) << 12) | (static_cast<int32_t>(raw[1]) << 4) | (raw[2] >> 4);
+  const int32_t adc_T = (static_cast<int32_t>(raw[3]) << 12) | (static_cast<int32_t>(raw[4]) << 4) | (raw[5] >> 4);
+  const int32_t adc_H = (static_cast<int32_t>(raw[6]) << 8) | raw[7];
+
+  // Температура (BME280_compensate_T_int32), разрешение 0.01 °C
+  int32_t var1 = ((((adc_T >> 3) - (static_cast<int32_t>(c.dig_T1) << 1))) * static_cast<int32_t>(c.dig_T2)) >> 11;
+  int32_t var2 = (((((adc_T >> 4) - static_cast<int32_t>(c.dig_T1)) * ((adc_T >> 4) - static_cast<int32_t>(c.dig_T1))) >> 12) *
+                  static_cast<int32_t>(c.dig_T3)) >>
+                 14;
+  const int32_t t_fine = var1 + var2;
+  out.temperature_centi = (t_fine * 5 + 128) >> 8;
+
+  // Давление (BME280_compensate_P_int64), Па в Q24.8
+  if (adc_P == 0x80000)
+    out.pressure_q24_8 = 0; // измерение давления отключено
+  else
+  {
+    int64_t p1 = static_cast<int64_t>(t_fine) - 128000;
+    int64_t p2 = p1 * p1 * static_cast<int64_t>(c.dig_P6);
+    p2 = p2 + ((p1 * static_cast<int64_t>(c.dig_P5)) << 17);
+    p2 = p2 + (static_cast<int64_t>(c.dig_P4) << 35);
+    p1 = ((p1 * p1 * static_cast<int64_t>(c.dig_P3)) >> 8) + ((p1 * static_cast<int64_t>(c.dig_P2)) << 12);
+    p1 = (((static_cast<int64_t>(1) << 47) + p1)) * static_cast<int64_t>(c.dig_P1) >> 33;
+    if (p1 == 0)
+      out.pressure_q24_8 = 0; // защита от деления на ноль
+    else
+    {
+      int64_t p = 1048576 - adc_P;
+      p = (((p << 31) - p2) * 3125) / p1;
+      p1 = (static_cast<int64_t>(c.dig_P9) * (p >> 13) * (p >> 13)) >> 25;
+      p2 = (static_cast<int64_t>(c.dig_P8) * p) >> 19;
+      p = ((p + p1 + p2) >> 8) + (static_cast<int64_t>(c.dig_P7) << 4);
+      out.pressure_q24_8 = static_cast<uint32_t>(p);
+    }
+  }
+
+  // Влажность (bme280_compensate_H_int32), % в Q22.10
+  if (adc_H == 0x8000)
+    out.humidity_q22_10 = 0; // измерение влажности отключено
+  else
+  {
+    int32_t v = t_fine - 76800;
+    v = (((((adc_H << 14) - (static_cast<int32_t>(c.dig_H4) << 20) - (static_cast<int32_t>(c.dig_H5) * v)) + 16384) >> 15) *
+         (((((((v * static_cast<int32_t>(c.dig_H6)) >> 10) * (((v * static_cast<int32_t>(c.dig_H3)) >> 11) + 32768)) >> 10) + 2097152) *
+               static_cast<int32_t>(c.dig_H2) +
+           8192) >>
+          14));
+    v = v - (((((v >> 15) * (v >> 15)) >> 7) * static_cast<int32_t>(c.dig_H1)) >> 4);
+    v = (v < 0) ? 0 : v;
+    v = (v > 419430400) ? 419430400 : v;
+    out.humidity_q22_10 = static_cast<uint32_t>(v >> 12);
+  }
+}
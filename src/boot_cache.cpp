@@ -0,0 +1,164 @@
+#include "boot_cache.h"
+#include "clock_service.h"
+#include "tslog_page.h"
+#include <Preferences.h>
+#include <esp_attr.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <stddef.h>
+#include <string.h>
+
+static const char *TAG = "BOOT_CACHE";
+static const char *kNvsKey = "state";
+
+/// @brief сохранённое состояние (память RTC и запись NVS); тривиальный тип — не инициализируется при запуске
+struct BootCacheData_t
+{
+  uint32_t magic;                           // BOOT_CACHE_MAGIC
+  uint16_t version;                         // BOOT_CACHE_VERSION
+  uint16_t size;                            // sizeof(StationSnapshot_t): структура снимка не изменилась
+  uint32_t wall;                            // время UTC сохранения (0 — часы не синхронизированы)
+  int32_t tz_offset;                        // смещение местного времени от UTC, с
+  uint8_t fields;                           // битовая маска полей StateField_t с данными
+  uint8_t state[sizeof(StationSnapshot_t)]; // снимок StationState
+  uint32_t crc;                             // CRC-32 всех предыдущих полей
+};
+
+static RTC_NOINIT_ATTR BootCacheData_t s_rtc;
+
+// Рабочие копии: restore() вызывается до создания задач, capture() — из одной задачи
+static BootCacheData_t s_work;
+static StationSnapshot_t s_snap;
+
+static BootCacheSource_t s_source = BOOT_CACHE_NONE;
+static uint32_t s_restored_wall = 0;  // время сохранения восстановленного состояния (UTC)
+static int32_t s_restored_tz = 0;     // смещение местного времени восстановленного состояния
+static TickType_t s_nvs_tick = 0;     // время последнего сохранения в NVS
+static bool s_nvs_saved = false;      // в NVS уже сохранялось после запуска
+static uint32_t s_nvs_versions = 0;   // сумма версий свежих полей при последнем сохранении в NVS
+
+static uint32_t data_crc(const BootCacheData_t &d)
+{
+  return tslog_crc32(0, reinterpret_cast<const uint8_t *>(&d), offsetof(BootCacheData_t, crc));
+}
+
+static bool data_valid(const BootCacheData_t &d)
+{
+  return d.magic == BOOT_CACHE_MAGIC && d.version == BOOT_CACHE_VERSION && d.size == sizeof(StationSnapshot_t) &&
+         d.fields != 0 && d.crc == data_crc(d);
+}
+
+// Смещение местного времени от UTC (часовой пояс задаётся при настройке SNTP)
+static int32_t local_offset(time_t now)
+{
+  struct tm lt, gt;
+  localtime_r(&now, &lt);
+  gmtime_r(&now, &gt);
+  gt.tm_isdst = lt.tm_isdst;
+  return static_cast<int32_t>(mktime(&lt) - mktime(&gt));
+}
+
+void BootCache::restore()
+{
+  // Память RTC свежее NVS: в ней состояние на момент сброса
+  const BootCacheData_t *found = nullptr;
+  if (data_valid(s_rtc))
+  {
+    found = &s_rtc;
+    s_source = BOOT_CACHE_RTC;
+  }
+  else
+  {
+    Preferences prefs;
+    if (prefs.begin(BOOT_CACHE_NVS_NAMESPACE, /*readOnly=*/true))
+    {
+      if (prefs.getBytes(kNvsKey, &s_work, sizeof(s_work)) == sizeof(s_work) && data_valid(s_work))
+      {
+        found = &s_work;
+        s_source = BOOT_CACHE_NVS;
+      }
+      prefs.end();
+    }
+  }
+  if (!found)
+  {
+    ESP_LOGI(TAG, "No saved state, starting empty");
+    return;
+  }
+
+  memcpy(&s_snap, found->state, sizeof(s_snap));
+  StationState::restore(s_snap, found->fields);
+  s_restored_wall = found->wall;
+  s_restored_tz = found->tz_offset;
+
+  const time_t now = time(nullptr);
+  if (ClockService::is_synced() && found->wall && now >= found->wall)
+    ESP_LOGI(TAG, "Restored fields 0x%02x from %s, saved %u s ago", found->fields,
+             s_source == BOOT_CACHE_RTC ? "RTC" : "NVS", static_cast<uint32_t>(now - found->wall));
+  else
+    ESP_LOGI(TAG, "Restored fields 0x%02x from %s", found->fields, s_source == BOOT_CACHE_RTC ? "RTC" : "NVS");
+}
+
+void BootCache::capture()
+{
+  StationState::snapshot(s_snap);
+  uint8_t fields = 0;
+  uint32_t versions = 0; // меняется только со свежими данными (версия восстановленного поля постоянна)
+  for (uint8_t f = 0; f < _STATE_FIELD_NUM_; ++f)
+  {
+    if (!s_snap.version[f])
+      continue;
+    fields |= static_cast<uint8_t>(1u << f);
+    if (!(s_snap.restored & (1u << f)))
+      versions += s_snap.version[f];
+  }
+  if (!fields)
+    return;
+
+  const time_t now = time(nullptr);
+  const bool synced = ClockService::is_synced();
+  s_work.magic = BOOT_CACHE_MAGIC;
+  s_work.version = BOOT_CACHE_VERSION;
+  s_work.size = sizeof(StationSnapshot_t);
+  // без синхронизации — продолжение оценки по восстановленному времени
+  s_work.wall = synced            ? static_cast<uint32_t>(now)
+                : s_restored_wall ? s_restored_wall + static_cast<uint32_t>(esp_timer_get_time() / 1000000)
+                                  : 0;
+  s_work.tz_offset = synced ? local_offset(now) : s_restored_tz;
+  s_work.fields = fields;
+  memcpy(s_work.state, &s_snap, sizeof(s_snap));
+  s_work.crc = data_crc(s_work);
+  memcpy(&s_rtc, &s_work, sizeof(s_rtc)); // сброс посреди копирования даст неверную CRC — останется NVS
+
+  const TickType_t tick = xTaskGetTickCount();
+  if (versions == s_nvs_versions || (s_nvs_saved && tick - s_nvs_tick < pdMS_TO_TICKS(BOOT_CACHE_NVS_INTERVAL_MS)))
+    return;
+  Preferences prefs;
+  bool ok = false;
+  if (prefs.begin(BOOT_CACHE_NVS_NAMESPACE, /*readOnly=*/false))
+  {
+    ok = prefs.putBytes(kNvsKey, &s_work, sizeof(s_work)) == sizeof(s_work);
+    prefs.end();
+  }
+  s_nvs_tick = tick;
+  s_nvs_saved = true;
+  s_nvs_versions = versions;
+  if (ok)
+    ESP_LOGI(TAG, "State saved to NVS (fields 0x%02x)", fields);
+  else
+    ESP_LOGW(TAG, "Failed to save state to NVS");
+}
+
+bool BootCache::clock_estimate(struct tm &out)
+{
+  if (!s_restored_wall || ClockService::is_synced())
+    return false;
+  const time_t est = static_cast<time_t>(s_restored_wall) + s_restored_tz + esp_timer_get_time() / 1000000;
+  gmtime_r(&est, &out);
+  return true;
+}
+
+BootCacheSource_t BootCache::source()
+{
+  return s_source;
+}
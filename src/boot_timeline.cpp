@@ -0,0 +1,35 @@
+#include "boot_timeline.h"
+#include <atomic>
+#include <esp_log.h>
+#include <esp_timer.h>
+
+static const char *TAG = "BOOT";
+
+static const char *const kPhaseNames[_BOOT_PHASE_NUM_] = {"first pixel", "full screen", "fresh data"};
+
+// Время этапа от запуска, мс (0 — не наступил)
+static std::atomic<uint32_t> s_at_ms[_BOOT_PHASE_NUM_];
+
+void BootTimeline::mark(BootPhase_t phase)
+{
+  if (phase >= _BOOT_PHASE_NUM_)
+    return;
+  const uint32_t ms = static_cast<uint32_t>(esp_timer_get_time() / 1000) + 1; // +1: 0 — признак "не наступил"
+  uint32_t expected = 0;
+  if (!s_at_ms[phase].compare_exchange_strong(expected, ms))
+    return;
+  ESP_LOGI(TAG, "+%u ms: %s", ms, kPhaseNames[phase]);
+
+  for (uint8_t i = 0; i < _BOOT_PHASE_NUM_; ++i)
+  {
+    if (!at_ms(static_cast<BootPhase_t>(i)))
+      return;
+  }
+  ESP_LOGI(TAG, "Timeline: first pixel %u ms, full screen %u ms, fresh data %u ms", at_ms(BOOT_PHASE_FIRST_PIXEL),
+           at_ms(BOOT_PHASE_FULL_SCREEN), at_ms(BOOT_PHASE_FRESH_DATA));
+}
+
+uint32_t BootTimeline::at_ms(BootPhase_t phase)
+{
+  return phase < _BOOT_PHASE_NUM_ ? s_at_ms[phase].load(std::memory_order_relaxed) : 0;
+}
@@ -0,0 +1,151 @@
+#include "clock_service.h"
+#include <atomic>
+#include <esp_log.h>
+#include <esp_sntp.h>
+#include <esp_timer.h>
+#include <sys/time.h>
+
+static const char *TAG = "CLOCK";
+
+// Запас после границы минуты, чтобы при срабатывании минута гарантированно сменилась (мкс)
+static const int64_t kBoundaryMarginUs = 5000;
+
+// Подписчики
+static TaskHandle_t s_subs[CLOCK_MAX_SUBSCRIBERS];
+static uint32_t s_sub_events[CLOCK_MAX_SUBSCRIBERS];
+static std::atomic<uint8_t> s_sub_count{0};
+static portMUX_TYPE s_sub_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static esp_timer_handle_t s_timer = nullptr;
+static std::atomic<bool> s_synced{false};
+static std::atomic<bool> s_resync{false}; // следующее срабатывание таймера — после синхронизации
+static std::atomic<uint32_t> s_sync_count{0};
+// Последняя обработанная граница (только в контексте таймера)
+static struct tm s_last_tm;
+static bool s_have_last = false;
+
+static void notify_subscribers(uint32_t events)
+{
+  const uint8_t count = s_sub_count.load(std::memory_order_acquire);
+  for (uint8_t i = 0; i < count; ++i)
+  {
+    const uint32_t bits = events & s_sub_events[i];
+    if (bits)
+      xTaskNotify(s_subs[i], bits, eSetBits);
+  }
+}
+
+// Взвести таймер на следующую границу минуты
+static void arm_next_minute()
+{
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  const int64_t us_in_minute = static_cast<int64_t>(tv.tv_sec % 60) * 1000000LL + tv.tv_usec;
+  esp_timer_stop(s_timer); // может быть не запущен — ошибка игнорируется
+  esp_timer_start_once(s_timer, 60000000LL - us_in_minute + kBoundaryMarginUs);
+}
+
+// События смены минуты, часа и даты относительно последней обработанной границы
+static uint32_t boundary_events(const struct tm &tm)
+{
+  if (!s_have_last)
+    return NOTIFY_BIT_MINUTE | NOTIFY_BIT_HOUR | NOTIFY_BIT_DATE;
+  const bool date = tm.tm_yday != s_last_tm.tm_yday || tm.tm_year != s_last_tm.tm_year;
+  const bool hour = date || tm.tm_hour != s_last_tm.tm_hour;
+  const bool minute = hour || tm.tm_min != s_last_tm.tm_min;
+  return (minute ? NOTIFY_BIT_MINUTE : 0) | (hour ? NOTIFY_BIT_HOUR : 0) | (date ? NOTIFY_BIT_DATE : 0);
+}
+
+static void boundary_timer_cb(void *arg)
+{
+  struct tm tm;
+  const time_t now = time(nullptr);
+  localtime_r(&now, &tm);
+
+  // после синхронизации — NOTIFY_BIT_TIME_SYNC и только те смены, что действительно произошли
+  // (повторная синхронизация SNTP, около раза в час, не должна выглядеть как смена даты)
+  uint32_t events = boundary_events(tm);
+  if (s_resync.exchange(false))
+    events |= NOTIFY_BIT_TIME_SYNC;
+  s_last_tm = tm;
+  s_have_last = true;
+
+  if (events)
+    notify_subscribers(events);
+  arm_next_minute();
+}
+
+static void sntp_sync_cb(struct timeval *tv)
+{
+  const uint32_t n = s_sync_count.fetch_add(1, std::memory_order_relaxed) + 1;
+  s_synced.store(true, std::memory_order_release);
+  ESP_LOGI(TAG, "Time synchronized (SNTP sync #%u)", n);
+
+  if (!s_timer)
+    return;
+  // все события рассылаются из контекста таймера — сразу после синхронизации
+  s_resync.store(true);
+  esp_timer_stop(s_timer);
+  esp_timer_start_once(s_timer, kBoundaryMarginUs);
+}
+
+void ClockService::init()
+{
+  esp_timer_create_args_t args = {};
+  args.callback = boundary_timer_cb;
+  args.arg = nullptr;
+  args.dispatch_method = ESP_TIMER_TASK;
+  args.name = "clock_boundary";
+  args.skip_unhandled_events = true;
+  if (esp_timer_create(&args, &s_timer) != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to create boundary timer");
+    return;
+  }
+  sntp_set_time_sync_notification_cb(sntp_sync_cb);
+
+  // Время могло быть установлено ещё до старта службы (например, сохранено в RTC)
+  if (time(nullptr) >= CLOCK_MIN_VALID_EPOCH)
+  {
+    s_synced.store(true, std::memory_order_release);
+    arm_next_minute();
+  }
+}
+
+bool ClockService::subscribe(TaskHandle_t task, uint32_t events)
+{
+  bool ok = false;
+  portENTER_CRITICAL(&s_sub_mux);
+  const uint8_t count = s_sub_count.load(std::memory_order_relaxed);
+  if (count < CLOCK_MAX_SUBSCRIBERS)
+  {
+    s_subs[count] = task;
+    s_sub_events[count] = events;
+    s_sub_count.store(count + 1, std::memory_order_release);
+    ok = true;
+  }
+  portEXIT_CRITICAL(&s_sub_mux);
+
+  if (!ok)
+    ESP_LOGE(TAG, "Too many clock subscribers");
+  return ok;
+}
+
+bool ClockService::is_synced()
+{
+  return s_synced.load(std::memory_order_acquire) || time(nullptr) >= CLOCK_MIN_VALID_EPOCH;
+}
+
+bool ClockService::local_time(struct tm &out)
+{
+  const time_t now = time(nullptr);
+  if (now < CLOCK_MIN_VALID_EPOCH)
+    return false;
+  localtime_r(&now, &out);
+  return true;
+}
+
+uint32_t ClockService::sync_count()
+{
+  return s_sync_count.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,177 @@
+#include "config_api.h"
+#include "config_service.h"
+#include <ctype.h>
+#include <esp_log.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "CONFIG_API";
+
+#define CONFIG_API_VALUE_SIZE 100 // значение параметра до декодирования (%XX — три байта на символ)
+
+/// @brief вид значения параметра
+enum ConfigApiKind_t
+{
+  CFG_KIND_TEXT = 0, // строка
+  CFG_KIND_UINT,     // целое без знака
+  CFG_KIND_INT,      // целое со знаком
+  CFG_KIND_LAT,      // широта, градусы
+  CFG_KIND_LON       // долгота, градусы
+};
+
+/// @brief параметр запроса и поле PrjCfgData
+struct ConfigApiField_t
+{
+  const char *name;     // имя параметра (как у поля структуры)
+  size_t offset;        // смещение поля в PrjCfgData
+  size_t size;          // размер поля вместе с завершающим нулём
+  ConfigApiKind_t kind; // проверка значения
+};
+
+#define CFG_FIELD(field, kind) {#field, offsetof(PrjCfgData, field), sizeof(PrjCfgData::field), kind}
+
+static const ConfigApiField_t kFields[] = {
+    CFG_FIELD(mqtt_server, CFG_KIND_TEXT),    CFG_FIELD(mqtt_port, CFG_KIND_UINT),
+    CFG_FIELD(mqtt_user, CFG_KIND_TEXT),      CFG_FIELD(mqtt_pass, CFG_KIND_TEXT),
+    CFG_FIELD(mqtt_prefix, CFG_KIND_TEXT),    CFG_FIELD(latitude, CFG_KIND_LAT),
+    CFG_FIELD(longitude, CFG_KIND_LON),       CFG_FIELD(gmt_offset_sec, CFG_KIND_INT),
+    CFG_FIELD(sample_min_sec, CFG_KIND_UINT), CFG_FIELD(sample_max_sec, CFG_KIND_UINT),
+    CFG_FIELD(out_interval_sec, CFG_KIND_UINT)};
+
+// Декодировать значение формы на месте: '+' — пробел, %XX — байт
+static bool url_decode(char *s)
+{
+  char *out = s;
+  for (const char *p = s; *p; ++p)
+  {
+    if (*p == '+')
+      *out++ = ' ';
+    else if (*p == '%')
+    {
+      if (!isxdigit(static_cast<unsigned char>(p[1])) || !isxdigit(static_cast<unsigned char>(p[2])))
+        return false;
+      const char hex[3] = {p[1], p[2], '\0'};
+      const char byte = static_cast<char>(strtoul(hex, nullptr, 16));
+      if (!byte)
+        return false;
+      *out++ = byte;
+      p += 2;
+    }
+    else
+      *out++ = *p;
+  }
+  *out = '\0';
+  return true;
+}
+
+static bool is_digits(const char *s)
+{
+  if (!*s)
+    return false;
+  for (; *s; ++s)
+  {
+    if (*s < '0' || *s > '9')
+      return false;
+  }
+  return true;
+}
+
+static bool value_valid(const ConfigApiField_t &f, const char *value)
+{
+  if (strlen(value) >= f.size)
+    return false;
+  switch (f.kind)
+  {
+  case CFG_KIND_UINT:
+    return is_digits(value);
+  case CFG_KIND_INT:
+    return is_digits(value[0] == '-' ? value + 1 : value);
+  case CFG_KIND_LAT:
+  case CFG_KIND_LON:
+  {
+    char *end;
+    const float deg = strtof(value, &end);
+    const float limit = f.kind == CFG_KIND_LAT ? 90.0f : 180.0f;
+    return end != value && *end == '\0' && deg >= -limit && deg <= limit;
+  }
+  default:
+    return true;
+  }
+}
+
+static esp_err_t config_post_handler(httpd_req_t *req)
+{
+  if (req->content_len == 0 || req->content_len > CONFIG_API_BODY_SIZE)
+  {
+    httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Expected form body up to 512 bytes");
+    return ESP_FAIL;
+  }
+  char body[CONFIG_API_BODY_SIZE + 1];
+  size_t len = 0;
+  while (len < req->content_len)
+  {
+    const int n = httpd_req_recv(req, body + len, req->content_len - len);
+    if (n == HTTPD_SOCK_ERR_TIMEOUT)
+      continue;
+    if (n <= 0)
+      return ESP_FAIL; // клиент отключился
+    len += n;
+  }
+  body[len] = '\0';
+
+  // Изменяются только переданные параметры; ошибка в любом — конфигурация не меняется
+  PrjCfgData cfg;
+  ConfigService::get(cfg);
+  char value[CONFIG_API_VALUE_SIZE];
+  uint8_t accepted = 0;
+  for (const ConfigApiField_t &f : kFields)
+  {
+    const esp_err_t found = httpd_query_key_value(body, f.name, value, sizeof(value));
+    if (found == ESP_ERR_NOT_FOUND)
+      continue;
+    if (found != ESP_OK || !url_decode(value) || !value_valid(f, value))
+    {
+      char msg[64];
+      snprintf(msg, sizeof(msg), "Invalid value of %s", f.name);
+      httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, msg);
+      return ESP_FAIL;
+    }
+    char *field = reinterpret_cast<char *>(&cfg) + f.offset;
+    memset(field, 0, f.size);
+    strncpy(field, value, f.size - 1);
+    accepted++;
+  }
+  if (!accepted)
+  {
+    httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "No known parameters");
+    return ESP_FAIL;
+  }
+  if (!ConfigService::save(cfg))
+  {
+    httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "NVS write failed");
+    return ESP_FAIL;
+  }
+
+  const uint32_t ver = ConfigService::version();
+  ESP_LOGI(TAG, "%u parameters received, config version %u", accepted, ver);
+  char resp[32];
+  snprintf(resp, sizeof(resp), "version %u\n", ver);
+  httpd_resp_set_type(req, "text/plain");
+  return httpd_resp_sendstr(req, resp);
+}
+
+bool ConfigApi::attach(httpd_handle_t server)
+{
+  if (!server)
+    return false;
+  static const httpd_uri_t uri = {"/api/config", HTTP_POST, config_post_handler, nullptr};
+  if (httpd_register_uri_handler(server, &uri) != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Handler registration failed");
+    return false;
+  }
+  ESP_LOGI(TAG, "POST /api/config");
+  return true;
+}
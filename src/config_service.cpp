@@ -0,0 +1,125 @@
+#include "config_service.h"
+#include "nvscfg.h"
+#include <atomic>
+#include <esp_log.h>
+#include <freertos/semphr.h>
+#include <string.h>
+
+static const char *TAG = "CONFIG";
+
+// Конфигурация в памяти; копирование ~190 байт под спин-блокировкой
+static PrjCfgData s_cfg;
+static bool s_stored = false;          // конфигурация есть в NVS (или сохранена после запуска)
+static std::atomic<uint32_t> s_version{1};
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+static SemaphoreHandle_t s_save_mutex = nullptr; // сохранения (веб-портал, HTTP API) выполняются по одному
+static StaticSemaphore_t s_save_mutex_buf;
+
+// Подписчики
+static TaskHandle_t s_subs[CONFIG_MAX_SUBSCRIBERS];
+static std::atomic<uint8_t> s_sub_count{0};
+
+// Поле различается (строки фиксированной длины сравниваются до завершающего нуля)
+#define CFG_FIELD_DIFFERS(a, b, field) (strncmp((a).field, (b).field, sizeof((a).field)) != 0)
+
+void ConfigService::init()
+{
+  // Миграция из LittleFS config.json (при первом запуске после обновления) — до первого чтения
+  NvsCfg::migrate(/*delete_old_file=*/true);
+  if (!s_save_mutex)
+    s_save_mutex = xSemaphoreCreateMutexStatic(&s_save_mutex_buf);
+
+  PrjCfgData cfg;
+  const bool stored = NvsCfg::load(cfg); // при первом запуске остаются значения по умолчанию
+  portENTER_CRITICAL(&s_mux);
+  s_cfg = cfg;
+  s_stored = stored;
+  portEXIT_CRITICAL(&s_mux);
+  ESP_LOGI(TAG, "Config %s, version %u", stored ? "loaded from NVS" : "defaults", version());
+}
+
+bool ConfigService::get(PrjCfgData &cfg, uint32_t *version)
+{
+  portENTER_CRITICAL(&s_mux);
+  cfg = s_cfg;
+  const bool stored = s_stored;
+  if (version)
+    *version = s_version.load(std::memory_order_relaxed);
+  portEXIT_CRITICAL(&s_mux);
+  return stored;
+}
+
+uint32_t ConfigService::version()
+{
+  return s_version.load(std::memory_order_acquire);
+}
+
+bool ConfigService::save(const PrjCfgData &cfg)
+{
+  // Сравнение с текущей конфигурацией и запись NVS — под мьютексом: сохранять могут
+  // веб-портал и задача HTTP-сервера
+  if (!s_save_mutex || xSemaphoreTake(s_save_mutex, portMAX_DELAY) != pdTRUE)
+    return false;
+  static PrjCfgData prev;
+  const bool stored = get(prev);
+  const uint32_t changed = diff(prev, cfg);
+  if (stored && !changed)
+  {
+    xSemaphoreGive(s_save_mutex);
+    ESP_LOGI(TAG, "Config unchanged, NVS write skipped");
+    return true;
+  }
+  if (!NvsCfg::save(cfg))
+  {
+    xSemaphoreGive(s_save_mutex);
+    return false;
+  }
+
+  portENTER_CRITICAL(&s_mux);
+  s_cfg = cfg;
+  s_stored = true;
+  const uint32_t ver = s_version.fetch_add(1, std::memory_order_release) + 1;
+  portEXIT_CRITICAL(&s_mux);
+  xSemaphoreGive(s_save_mutex);
+  ESP_LOGI(TAG, "Config version %u saved (changed 0x%02x)", ver, changed);
+
+  const uint8_t count = s_sub_count.load(std::memory_order_acquire);
+  for (uint8_t i = 0; i < count; ++i)
+    xTaskNotify(s_subs[i], NOTIFY_BIT_CONFIG, eSetBits);
+  return true;
+}
+
+bool ConfigService::subscribe(TaskHandle_t task)
+{
+  bool ok = false;
+  portENTER_CRITICAL(&s_mux);
+  const uint8_t count = s_sub_count.load(std::memory_order_relaxed);
+  if (count < CONFIG_MAX_SUBSCRIBERS)
+  {
+    s_subs[count] = task;
+    s_sub_count.store(count + 1, std::memory_order_release);
+    ok = true;
+  }
+  portEXIT_CRITICAL(&s_mux);
+
+  if (!ok)
+    ESP_LOGE(TAG, "Too many config subscribers");
+  return ok;
+}
+
+uint32_t ConfigService::diff(const PrjCfgData &a, const PrjCfgData &b)
+{
+  uint32_t changed = 0;
+  if (CFG_FIELD_DIFFERS(a, b, mqtt_server) || CFG_FIELD_DIFFERS(a, b, mqtt_port) || CFG_FIELD_DIFFERS(a, b, mqtt_user) ||
+      CFG_FIELD_DIFFERS(a, b, mqtt_pass) || CFG_FIELD_DIFFERS(a, b, mqtt_prefix))
+    changed |= CONFIG_CHANGED_MQTT;
+  if (CFG_FIELD_DIFFERS(a, b, latitude) || CFG_FIELD_DIFFERS(a, b, longitude))
+    changed |= CONFIG_CHANGED_LOCATION;
+  if (CFG_FIELD_DIFFERS(a, b, gmt_offset_sec))
+    changed |= CONFIG_CHANGED_TIMEZONE;
+  if (CFG_FIELD_DIFFERS(a, b, sample_min_sec) || CFG_FIELD_DIFFERS(a, b, sample_max_sec))
+    changed |= CONFIG_CHANGED_SAMPLING;
+  if (CFG_FIELD_DIFFERS(a, b, out_interval_sec))
+    changed |= CONFIG_CHANGED_OUT_INTERVAL;
+  return changed;
+}
@@ -0,0 +1,278 @@
+#include "databus.h"
+#include "latency_trace.h"
+#include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+static const char *TAG = "DATABUS";
+
+static_assert(BUS_POOL_SIZE <= 32, "Bus pool bitmap is 32 bits wide");
+static constexpr uint32_t kPoolMask = (BUS_POOL_SIZE == 32) ? 0xFFFFFFFFUL : ((1UL << (BUS_POOL_SIZE & 31)) - 1);
+
+// Пул образцов и битовая карта занятых слотов
+static BusSample_t s_pool[BUS_POOL_SIZE];
+static std::atomic<uint32_t> s_pool_used{0};
+
+// Реестр подписчиков: входящие каналы по топикам
+static BusInbox_t *s_subs[_QUE_DATATYPE_NUM_][BUS_MAX_SUBSCRIBERS];
+static std::atomic<uint8_t> s_sub_count[_QUE_DATATYPE_NUM_];
+static portMUX_TYPE s_sub_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// Синхронные слушатели всех топиков
+static BusListener_t s_listeners[BUS_MAX_LISTENERS];
+static std::atomic<uint8_t> s_listener_count{0};
+
+// Счётчики по топикам
+static std::atomic<uint32_t> s_published[_QUE_DATATYPE_NUM_];
+static std::atomic<uint32_t> s_delivered[_QUE_DATATYPE_NUM_];
+static std::atomic<uint32_t> s_dropped[_QUE_DATATYPE_NUM_];
+
+// Освобождение ссылки на образец, вытесненный из входящего канала подписчика
+static void inbox_dispose(BusSample_t *const &sample)
+{
+  DataBus::release(sample);
+}
+
+static const char *policy_name(ChannelPolicy_t policy)
+{
+  switch (policy)
+  {
+  case CHANNEL_POLICY_BLOCK:
+    return "block";
+  case CHANNEL_POLICY_DROP_OLDEST:
+    return "drop-oldest";
+  case CHANNEL_POLICY_COALESCE_LATEST:
+    return "latest";
+  default:
+    return "?";
+  }
+}
+
+static const char *topic_name(QueDataType_t topic)
+{
+  switch (topic)
+  {
+  case QUE_DATATYPE_METEO:
+    return "METEO";
+  case QUE_DATATYPE_GEOMAGNETIC:
+    return "GEOMAG";
+  case QUE_DATATYPE_IN_SENSOR_DATA:
+    return "IN";
+  case QUE_DATATYPE_OUT_SENSOR_DATA:
+    return "OUT";
+  case QUE_DATATYPE_CITYNAME:
+    return "CITY";
+  default:
+    return "?";
+  }
+}
+
+BusSample_t *DataBus::alloc(QueDataType_t topic)
+{
+  uint32_t used = s_pool_used.load(std::memory_order_relaxed);
+  for (;;)
+  {
+    const uint32_t free_mask = ~used & kPoolMask;
+    if (!free_mask)
+    {
+      s_dropped[topic].fetch_add(1, std::memory_order_relaxed);
+      ESP_LOGW(TAG, "Sample pool exhausted, topic %s dropped", topic_name(topic));
+      return nullptr;
+    }
+
+    const uint32_t bit = 1UL << __builtin_ctz(free_mask);
+    if (s_pool_used.compare_exchange_weak(used, used | bit, std::memory_order_acquire, std::memory_order_relaxed))
+    {
+      BusSample_t *sample = &s_pool[__builtin_ctz(bit)];
+      sample->refs.store(1, std::memory_order_relaxed);
+      sample->topic = topic;
+      sample->seq = 0;
+      sample->source = 0;
+      sample->stamp = sample_stamp_now();
+      return sample;
+    }
+  }
+}
+
+bool DataBus::publish(BusSample_t *sample)
+{
+  if (!sample)
+    return false;
+
+  const QueDataType_t topic = sample->topic;
+  sample->seq = s_published[topic].fetch_add(1, std::memory_order_relaxed) + 1;
+
+  const uint8_t listeners = s_listener_count.load(std::memory_order_acquire);
+  for (uint8_t i = 0; i < listeners; ++i)
+    s_listeners[i](*sample);
+
+  const uint8_t count = s_sub_count[topic].load(std::memory_order_acquire);
+  for (uint8_t i = 0; i < count; ++i)
+  {
+    sample->refs.fetch_add(1, std::memory_order_relaxed);
+    if (s_subs[topic][i]->push(sample))
+      s_delivered[topic].fetch_add(1, std::memory_order_relaxed);
+    else
+    {
+      sample->refs.fetch_sub(1, std::memory_order_relaxed);
+      s_dropped[topic].fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  release(sample); // ссылка производителя
+  return true;
+}
+
+bool DataBus::publish_string(QueDataType_t topic, const char *str)
+{
+  BusSample_t *sample = alloc(topic);
+  if (!sample)
+    return false;
+  char *dst = reinterpret_cast<char *>(sample->payload);
+  strncpy(dst, str ? str : "", BUS_CITY_NAME_LEN - 1);
+  dst[BUS_CITY_NAME_LEN - 1] = '\0';
+  return publish(sample);
+}
+
+void DataBus::release(BusSample_t *sample)
+{
+  if (!sample)
+    return;
+  if (sample->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    s_pool_used.fetch_and(~(1UL << (sample - s_pool)), std::memory_order_release);
+}
+
+bool DataBus::subscribe(QueDataType_t topic, BusInbox_t *inbox)
+{
+  bool ok = false;
+  portENTER_CRITICAL(&s_sub_mux);
+  const uint8_t count = s_sub_count[topic].load(std::memory_order_relaxed);
+  if (count < BUS_MAX_SUBSCRIBERS)
+  {
+    s_subs[topic][count] = inbox;
+    s_sub_count[topic].store(count + 1, std::memory_order_release);
+    ok = true;
+  }
+  portEXIT_CRITICAL(&s_sub_mux);
+
+  if (!ok)
+    ESP_LOGE(TAG, "Too many subscribers for topic %s", topic_name(topic));
+  return ok;
+}
+
+bool DataBus::add_listener(BusListener_t listener)
+{
+  bool ok = false;
+  portENTER_CRITICAL(&s_sub_mux);
+  const uint8_t count = s_listener_count.load(std::memory_order_relaxed);
+  if (count < BUS_MAX_LISTENERS)
+  {
+    s_listeners[count] = listener;
+    s_listener_count.store(count + 1, std::memory_order_release);
+    ok = true;
+  }
+  portEXIT_CRITICAL(&s_sub_mux);
+  return ok;
+}
+
+ChannelPolicy_t DataBus::default_policy(QueDataType_t topic)
+{
+  switch (topic)
+  {
+  case QUE_DATATYPE_IN_SENSOR_DATA:
+    return CHANNEL_POLICY_COALESCE_LATEST;
+  case QUE_DATATYPE_OUT_SENSOR_DATA: // несколько узлов: "последнее" потеряло бы образцы других узлов
+  case QUE_DATATYPE_METEO:
+  case QUE_DATATYPE_GEOMAGNETIC:
+  case QUE_DATATYPE_CITYNAME:
+  default:
+    return CHANNEL_POLICY_DROP_OLDEST;
+  }
+}
+
+void DataBus::get_stats(QueDataType_t topic, BusTopicStats_t &stats)
+{
+  stats.published = s_published[topic].load(std::memory_order_relaxed);
+  stats.delivered = s_delivered[topic].load(std::memory_order_relaxed);
+  stats.dropped = s_dropped[topic].load(std::memory_order_relaxed);
+}
+
+bool DataBus::get_inbox_stats(QueDataType_t topic, uint8_t index, ChannelStats_t &stats)
+{
+  if (index >= s_sub_count[topic].load(std::memory_order_acquire))
+    return false;
+  s_subs[topic][index]->get_stats(stats);
+  return true;
+}
+
+void DataBus::log_stats()
+{
+  for (int t = 0; t < _QUE_DATATYPE_NUM_; ++t)
+  {
+    BusTopicStats_t st;
+    get_stats(static_cast<QueDataType_t>(t), st);
+    ESP_LOGI(TAG, "[%s] subs=%u published=%u delivered=%u dropped=%u",
+             topic_name(static_cast<QueDataType_t>(t)), s_sub_count[t].load(std::memory_order_relaxed),
+             st.published, st.delivered, st.dropped);
+
+    ChannelStats_t cs;
+    for (uint8_t i = 0; get_inbox_stats(static_cast<QueDataType_t>(t), i, cs); ++i)
+      ESP_LOGI(TAG, "  inbox %u (%s): pushes=%u drops=%u hwm=%u/%u blocked=%ums",
+               i, policy_name(s_subs[t][i]->get_policy()), cs.pushes, cs.drops, cs.high_watermark,
+               BUS_INBOX_SIZE, cs.blocked_ticks * portTICK_PERIOD_MS);
+  }
+  ESP_LOGI(TAG, "Pool usage: %d/%d", __builtin_popcount(s_pool_used.load(std::memory_order_relaxed)), BUS_POOL_SIZE);
+}
+
+bool DataBus::to_json(char *buf, size_t size)
+{
+  int pos = snprintf(buf, size, "{\"pool\":%d", __builtin_popcount(s_pool_used.load(std::memory_order_relaxed)));
+  for (int t = 0; t < _QUE_DATATYPE_NUM_ && pos > 0 && static_cast<size_t>(pos) < size; ++t)
+  {
+    BusTopicStats_t st;
+    get_stats(static_cast<QueDataType_t>(t), st);
+    pos += snprintf(&buf[pos], size - pos, ",\"%s\":{\"pub\":%u,\"del\":%u,\"drop\":%u,\"inbox\":[",
+                    topic_name(static_cast<QueDataType_t>(t)), st.published, st.delivered, st.dropped);
+    ChannelStats_t cs;
+    for (uint8_t i = 0; get_inbox_stats(static_cast<QueDataType_t>(t), i, cs) && pos > 0 && static_cast<size_t>(pos) < size; ++i)
+      pos += snprintf(&buf[pos], size - pos, "%s{\"drops\":%u,\"hwm\":%u}", i ? "," : "", cs.drops, cs.high_watermark);
+    if (pos > 0 && static_cast<size_t>(pos) < size)
+      pos += snprintf(&buf[pos], size - pos, "]}");
+  }
+  if (pos > 0 && static_cast<size_t>(pos) < size)
+    pos += snprintf(&buf[pos], size - pos, "}");
+  return pos > 0 && static_cast<size_t>(pos) < size;
+}
+
+// ---------------------------------------------------------------------------
+bool BusSubscriber::subscribe(QueDataType_t topic)
+{
+  return subscribe(topic, DataBus::default_policy(topic));
+}
+
+bool BusSubscriber::subscribe(QueDataType_t topic, ChannelPolicy_t policy)
+{
+  inbox[topic].set_policy(policy);
+  inbox[topic].set_disposer(inbox_dispose);
+  inbox[topic].attach_consumer(xTaskGetCurrentTaskHandle(), BUS_NOTIFY_BIT(topic));
+  if (!DataBus::subscribe(topic, &inbox[topic]))
+    return false;
+  mask |= BUS_NOTIFY_BIT(topic);
+  return true;
+}
+
+bool BusSubscriber::receive(BusSampleRef &ref)
+{
+  for (int t = 0; t < _QUE_DATATYPE_NUM_; ++t)
+  {
+    if (!(mask & BUS_NOTIFY_BIT(t)))
+      continue;
+    BusSample_t *sample = nullptr;
+    if (inbox[t].pop(sample))
+    {
+      ref.reset(sample);
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,149 @@
+#include "flatbuf.h"
+#include <string.h>
+
+// Чтение little-endian без требований к выравниванию
+static uint16_t rd_u16(const uint8_t *p)
+{
+  uint16_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static uint32_t rd_u32(const uint8_t *p)
+{
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+FbTable::FbTable(const uint8_t *buf, uint32_t size, uint32_t pos)
+    : buf(nullptr), size(size), pos(pos), vt(0), vt_size(0), tsize(0)
+{
+  if (pos < 4 || static_cast<uint64_t>(pos) + 4 > size)
+    return;
+  // vtable: pos - soffset_t; длина vtable, длина таблицы, смещения полей
+  const int64_t vt_pos = static_cast<int64_t>(pos) - static_cast<int32_t>(rd_u32(buf + pos));
+  if (vt_pos < 0 || vt_pos + 4 > size)
+    return;
+  const uint16_t vsize = rd_u16(buf + vt_pos);
+  const uint16_t tlen = rd_u16(buf + vt_pos + 2);
+  if (vsize < 4 || (vsize & 1) || vt_pos + vsize > size || tlen < 4 || static_cast<uint64_t>(pos) + tlen > size)
+    return;
+  this->buf = buf;
+  vt = static_cast<uint32_t>(vt_pos);
+  vt_size = vsize;
+  tsize = tlen;
+}
+
+FbTable FbTable::root(const uint8_t *data, size_t len)
+{
+  if (!data || len < 8)
+    return FbTable();
+  return FbTable(data, static_cast<uint32_t>(len), rd_u32(data));
+}
+
+FbTable FbTable::size_prefixed_root(const uint8_t *data, size_t len, size_t *used)
+{
+  if (used)
+    *used = 0;
+  if (!data || len < 4)
+    return FbTable();
+  const uint32_t n = rd_u32(data);
+  if (static_cast<uint64_t>(n) + 4 > len)
+    return FbTable();
+  if (used)
+    *used = static_cast<size_t>(n) + 4;
+  return root(data + 4, n);
+}
+
+uint32_t FbTable::field_pos(uint16_t field, uint32_t bytes) const
+{
+  const uint32_t slot = 4 + 2u * field;
+  if (!buf || slot + 2 > vt_size)
+    return 0;
+  const uint16_t off = rd_u16(buf + vt + slot);
+  if (!off || off + bytes > tsize)
+    return 0;
+  return pos + off;
+}
+
+uint32_t FbTable::deref(uint32_t at) const
+{
+  if (!at || static_cast<uint64_t>(at) + 4 > size)
+    return 0;
+  const uint64_t target = static_cast<uint64_t>(at) + rd_u32(buf + at);
+  return target < size ? static_cast<uint32_t>(target) : 0;
+}
+
+uint32_t FbTable::vector(uint16_t field, uint32_t elem_size, uint32_t &count) const
+{
+  count = 0;
+  const uint32_t v = deref(field_pos(field, 4));
+  if (!v || static_cast<uint64_t>(v) + 4 > size)
+    return 0;
+  const uint32_t n = rd_u32(buf + v);
+  if (static_cast<uint64_t>(v) + 4 + static_cast<uint64_t>(n) * elem_size > size)
+    return 0;
+  count = n;
+  return v + 4;
+}
+
+int32_t FbTable::get_i32(uint16_t field, int32_t def) const
+{
+  const uint32_t p = field_pos(field, sizeof(int32_t));
+  return p ? static_cast<int32_t>(rd_u32(buf + p)) : def;
+}
+
+int64_t FbTable::get_i64(uint16_t field, int64_t def) const
+{
+  const uint32_t p = field_pos(field, sizeof(int64_t));
+  if (!p)
+    return def;
+  int64_t v;
+  memcpy(&v, buf + p, sizeof(v));
+  return v;
+}
+
+float FbTable::get_f32(uint16_t field, float def) const
+{
+  const uint32_t p = field_pos(field, sizeof(float));
+  if (!p)
+    return def;
+  float v;
+  memcpy(&v, buf + p, sizeof(v));
+  return v;
+}
+
+FbTable FbTable::table(uint16_t field) const
+{
+  const uint32_t t = deref(field_pos(field, 4));
+  return t ? FbTable(buf, size, t) : FbTable();
+}
+
+uint32_t FbTable::vector_size(uint16_t field) const
+{
+  uint32_t count;
+  vector(field, 4, count);
+  return count;
+}
+
+FbTable FbTable::vector_table(uint16_t field, uint32_t index) const
+{
+  uint32_t count;
+  const uint32_t elems = vector(field, 4, count);
+  if (!elems || index >= count)
+    return FbTable();
+  const uint32_t t = deref(elems + 4 * index);
+  return t ? FbTable(buf, size, t) : FbTable();
+}
+
+float FbTable::vector_f32(uint16_t field, uint32_t index, float def) const
+{
+  uint32_t count;
+  const uint32_t elems = vector(field, sizeof(float), count);
+  if (!elems || index >= count)
+    return def;
+  float v;
+  memcpy(&v, buf + elems + 4 * index, sizeof(v));
+  return v;
+}
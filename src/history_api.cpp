@@ -0,0 +1,292 @@
+#include "history_api.h"
+#include "rollup.h"
+#include "tslog.h"
+#include <esp_http_server.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const char *TAG = "HISTORY_API";
+
+#define HISTORY_RES_RAW 0 // разрешение raw в двоичном заголовке; агрегаты — уровень Rollup + 1
+
+/// @brief канал в запросе и в CSV
+struct HistoryChannel_t
+{
+  const char *name; // имя в параметре metrics и в заголовке CSV
+  float scale;      // множитель фиксированной точки журнала
+};
+
+static const HistoryChannel_t kChannels[TSLOG_CHANNELS] = {
+    {"in_t", 10.0f}, {"in_h", 1.0f}, {"in_p", 10.0f}, {"out_t", 10.0f}, {"out_h", 1.0f}, {"out_p", 10.0f}};
+
+static const char *const kResolutions[] = {"raw", "minute", "hour", "day"};
+
+/// @brief потоковая выдача ответа фрагментами
+struct HistoryStream_t
+{
+  httpd_req_t *req;
+  uint8_t mask;     // выбранные каналы (бит = TsChannel_t)
+  bool binary;      // формат bin
+  bool failed;      // клиент отключился — чтение прекращается
+  size_t len;       // занято в буфере
+  uint32_t records; // выдано записей
+  char buf[HISTORY_API_CHUNK_SIZE];
+};
+
+static httpd_handle_t s_server = nullptr;
+
+// Отправить накопленное фрагментом
+static void stream_flush(HistoryStream_t &st)
+{
+  if (st.len && !st.failed && httpd_resp_send_chunk(st.req, st.buf, st.len) != ESP_OK)
+    st.failed = true;
+  st.len = 0;
+}
+
+static void stream_put(HistoryStream_t &st, const void *data, size_t size)
+{
+  if (st.len + size > sizeof(st.buf))
+    stream_flush(st);
+  memcpy(st.buf + st.len, data, size);
+  st.len += size;
+}
+
+// Значение канала в единицах измерения для CSV (",21.5")
+static int csv_value(char *out, size_t size, uint8_t channel, float value)
+{
+  return snprintf(out, size, ",%.*f", kChannels[channel].scale > 1.0f ? 1 : 0, value / kChannels[channel].scale);
+}
+
+static void stream_header(HistoryStream_t &st, uint8_t res)
+{
+  if (st.binary)
+  {
+    uint8_t size = 4;
+    for (uint8_t c = 0; c < TSLOG_CHANNELS; ++c)
+    {
+      if (st.mask & (1u << c))
+        size += res == HISTORY_RES_RAW ? 2 : 10;
+    }
+    const uint32_t magic = HISTORY_API_MAGIC;
+    const uint8_t head[4] = {HISTORY_API_VERSION, res, st.mask, size};
+    stream_put(st, &magic, sizeof(magic));
+    stream_put(st, head, sizeof(head));
+    return;
+  }
+  char line[128];
+  int n = snprintf(line, sizeof(line), "time");
+  for (uint8_t c = 0; c < TSLOG_CHANNELS; ++c)
+  {
+    if (!(st.mask & (1u << c)))
+      continue;
+    const char *name = kChannels[c].name;
+    if (res == HISTORY_RES_RAW)
+      n += snprintf(line + n, sizeof(line) - n, ",%s", name);
+    else
+      n += snprintf(line + n, sizeof(line) - n, ",%s_min,%s_avg,%s_max", name, name, name);
+  }
+  n += snprintf(line + n, sizeof(line) - n, "\n");
+  stream_put(st, line, n);
+}
+
+// Запись журнала → строка ответа
+static bool stream_record(const TsRecord_t &rec, void *ctx)
+{
+  HistoryStream_t &st = *static_cast<HistoryStream_t *>(ctx);
+  if (st.binary)
+  {
+    stream_put(st, &rec.time, sizeof(rec.time));
+    for (uint8_t c = 0; c < TSLOG_CHANNELS; ++c)
+    {
+      if (st.mask & (1u << c))
+        stream_put(st, &rec.value[c], sizeof(rec.value[c]));
+    }
+  }
+  else
+  {
+    char line[96];
+    int n = snprintf(line, sizeof(line), "%u", rec.time);
+    for (uint8_t c = 0; c < TSLOG_CHANNELS; ++c)
+    {
+      if (!(st.mask & (1u << c)))
+        continue;
+      if (rec.value[c] == TSLOG_NO_VALUE)
+        n += snprintf(line + n, sizeof(line) - n, ",");
+      else
+        n += csv_value(line + n, sizeof(line) - n, c, rec.value[c]);
+    }
+    n += snprintf(line + n, sizeof(line) - n, "\n");
+    stream_put(st, line, n);
+  }
+  st.records++;
+  return !st.failed;
+}
+
+// Интервал агрегатов → строка ответа
+static void stream_slot(HistoryStream_t &st, const RollupSlot_t &slot)
+{
+  if (st.binary)
+  {
+    stream_put(st, &slot.start, sizeof(slot.start));
+    for (uint8_t c = 0; c < TSLOG_CHANNELS; ++c)
+    {
+      if (!(st.mask & (1u << c)))
+        continue;
+      const RollupAgg_t &a = slot.ch[c];
+      stream_put(st, &a.min, sizeof(a.min));
+      stream_put(st, &a.max, sizeof(a.max));
+      stream_put(st, &a.sum, sizeof(a.sum));
+      stream_put(st, &a.count, sizeof(a.count));
+    }
+  }
+  else
+  {
+    char line[192];
+    int n = snprintf(line, sizeof(line), "%u", slot.start);
+    for (uint8_t c = 0; c < TSLOG_CHANNELS; ++c)
+    {
+      if (!(st.mask & (1u << c)))
+        continue;
+      const RollupAgg_t &a = slot.ch[c];
+      if (!a.count)
+      {
+        n += snprintf(line + n, sizeof(line) - n, ",,,");
+        continue;
+      }
+      n += csv_value(line + n, sizeof(line) - n, c, a.min);
+      n += csv_value(line + n, sizeof(line) - n, c, static_cast<float>(a.sum) / a.count);
+      n += csv_value(line + n, sizeof(line) - n, c, a.max);
+    }
+    n += snprintf(line + n, sizeof(line) - n, "\n");
+    stream_put(st, line, n);
+  }
+  st.records++;
+}
+
+// Выдать интервалы уровня порциями: в памяти — не больше HISTORY_API_ROLLUP_BATCH интервалов
+static void stream_rollup(HistoryStream_t &st, RollupLevel_t level, uint32_t from, uint32_t to)
+{
+  RollupSlot_t batch[HISTORY_API_ROLLUP_BATCH];
+  uint32_t cursor = from;
+  while (!st.failed)
+  {
+    const size_t n = Rollup::query(level, cursor, to, batch, HISTORY_API_ROLLUP_BATCH);
+    for (size_t i = 0; i < n; ++i)
+      stream_slot(st, batch[i]);
+    if (n < HISTORY_API_ROLLUP_BATCH)
+      break;
+    cursor = batch[n - 1].start + Rollup::period(level);
+  }
+}
+
+// Маска каналов из списка имён через запятую; 0 — неизвестное имя
+static uint8_t parse_metrics(const char *list)
+{
+  uint8_t mask = 0;
+  while (*list)
+  {
+    const char *end = strchr(list, ',');
+    const size_t len = end ? static_cast<size_t>(end - list) : strlen(list);
+    uint8_t c = 0;
+    while (c < TSLOG_CHANNELS && (strlen(kChannels[c].name) != len || strncmp(kChannels[c].name, list, len) != 0))
+      c++;
+    if (c == TSLOG_CHANNELS)
+      return 0;
+    mask |= 1u << c;
+    list += end ? len + 1 : len;
+  }
+  return mask;
+}
+
+static esp_err_t history_get_handler(httpd_req_t *req)
+{
+  // Параметры запроса
+  char query[160] = "";
+  char value[64];
+  httpd_req_get_url_query_str(req, query, sizeof(query));
+  const uint32_t now = static_cast<uint32_t>(time(NULL));
+  uint32_t to = httpd_query_key_value(query, "to", value, sizeof(value)) == ESP_OK ? strtoul(value, nullptr, 10) : now;
+  uint32_t from = httpd_query_key_value(query, "from", value, sizeof(value)) == ESP_OK ? strtoul(value, nullptr, 10)
+                                                                                       : (to > 86400 ? to - 86400 : 0);
+  uint8_t mask = (1u << TSLOG_CHANNELS) - 1;
+  if (httpd_query_key_value(query, "metrics", value, sizeof(value)) == ESP_OK)
+    mask = parse_metrics(value);
+  uint8_t res = HISTORY_RES_RAW;
+  if (httpd_query_key_value(query, "res", value, sizeof(value)) == ESP_OK)
+  {
+    while (res < sizeof(kResolutions) / sizeof(kResolutions[0]) && strcmp(value, kResolutions[res]) != 0)
+      res++;
+  }
+  bool binary = false;
+  if (httpd_query_key_value(query, "format", value, sizeof(value)) == ESP_OK)
+    binary = strcmp(value, "bin") == 0;
+
+  if (from >= to || !mask || res >= sizeof(kResolutions) / sizeof(kResolutions[0]))
+  {
+    httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Expected from<to, metrics=in_t,in_h,in_p,out_t,out_h,out_p, "
+                                                    "res=raw|minute|hour|day, format=csv|bin");
+    return ESP_FAIL;
+  }
+
+  // Буфер фрагмента — в куче: стек задачи сервера нужен чтению журнала
+  HistoryStream_t *st = static_cast<HistoryStream_t *>(malloc(sizeof(HistoryStream_t)));
+  if (!st)
+  {
+    httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Out of memory");
+    return ESP_FAIL;
+  }
+  st->req = req;
+  st->mask = mask;
+  st->binary = binary;
+  st->failed = false;
+  st->len = 0;
+  st->records = 0;
+
+  const int64_t started = esp_timer_get_time();
+  httpd_resp_set_type(req, binary ? "application/octet-stream" : "text/csv");
+  stream_header(*st, res);
+  if (res == HISTORY_RES_RAW)
+    TsLog::read(from, to - 1, stream_record, st); // журнал читает включительно
+  else
+    stream_rollup(*st, static_cast<RollupLevel_t>(res - 1), from, to);
+  stream_flush(*st);
+  const bool failed = st->failed;
+  ESP_LOGI(TAG, "%s %u..%u mask=0x%02x: %u records in %lld ms%s", kResolutions[res], from, to, mask, st->records,
+           (esp_timer_get_time() - started) / 1000, failed ? " (client gone)" : "");
+  free(st);
+
+  if (failed)
+    return ESP_FAIL; // сервер закроет соединение
+  return httpd_resp_send_chunk(req, nullptr, 0); // конец ответа
+}
+
+bool HistoryApi::start()
+{
+  if (s_server)
+    return true;
+  httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+  config.server_port = HISTORY_API_PORT;
+  config.stack_size = HISTORY_API_STACK_SIZE;
+  config.max_open_sockets = 3;
+  config.lru_purge_enable = true;
+  if (httpd_start(&s_server, &config) != ESP_OK)
+  {
+    ESP_LOGE(TAG, "HTTP server start failed");
+    s_server = nullptr;
+    return false;
+  }
+
+  static const httpd_uri_t uri = {"/api/history", HTTP_GET, history_get_handler, nullptr};
+  httpd_register_uri_handler(s_server, &uri);
+  ESP_LOGI(TAG, "Listening on port %u: GET /api/history", HISTORY_API_PORT);
+  return true;
+}
+
+httpd_handle_t HistoryApi::server()
+{
+  return s_server;
+}
@@ -2,6 +2,7 @@
 #include <HTTPClient.h>
 #include <WiFi.h>
 #include <WiFiClientSecure.h>
+#include <algorithm>
 #include <esp_log.h>
 
 static const char *TAG = "HTTP_HELPERS";
@@ -72,3 +73,102 @@ String send_HTTPS_GET_request(const char *serverName, const char *ca_cert, const
   http.end();
   return payload;
 }
+
+HttpBodyReader::HttpBodyReader(WiFiClient &client, int content_length)
+    : client(client), remaining(content_length), pos(0), len(0), total(0)
+{
+}
+
+bool HttpBodyReader::fill()
+{
+  if (remaining == 0)
+    return false;
+  const uint32_t start = millis();
+  for (;;)
+  {
+    const int avail = client.available();
+    if (avail > 0)
+    {
+      size_t want = std::min(static_cast<size_t>(avail), sizeof(buf));
+      if (remaining > 0)
+        want = std::min(want, static_cast<size_t>(remaining));
+      const int n = client.read(buf, want);
+      if (n > 0)
+      {
+        pos = 0;
+        len = n;
+        total += n;
+        if (remaining > 0)
+          remaining -= n;
+        return true;
+      }
+    }
+    else if (!client.connected())
+      return false;
+    if (millis() - start >= HTTP_BODY_TIMEOUT_MS)
+    {
+      ESP_LOGW(TAG, "HTTP body: no data for %u ms after %u bytes", HTTP_BODY_TIMEOUT_MS, total);
+      return false;
+    }
+    vTaskDelay(pdMS_TO_TICKS(5));
+  }
+}
+
+int HttpBodyReader::read()
+{
+  if (pos == len && !fill())
+    return -1;
+  return buf[pos++];
+}
+
+size_t HttpBodyReader::readBytes(char *buffer, size_t length)
+{
+  size_t done = 0;
+  while (done < length && (pos < len || fill()))
+  {
+    const size_t n = std::min(length - done, len - pos);
+    memcpy(buffer + done, buf + pos, n);
+    pos += n;
+    done += n;
+  }
+  return done;
+}
+
+bool send_HTTPS_GET_stream(const char *serverName, const char *ca_cert, HttpBodyHandler_t handler, void *ctx,
+                           const String &user_agent)
+{
+  if (WiFi.status() != WL_CONNECTED)
+  {
+    ESP_LOGW(TAG, "HTTPS GET: WiFi not connected");
+    return false;
+  }
+
+  WiFiClientSecure client;
+  HTTPClient http;
+
+  if (ca_cert && strlen(ca_cert) > 0)
+    client.setCACert(ca_cert);
+  else
+    client.setInsecure();
+
+  http.useHTTP10(true); // тело без chunked-кодирования
+  http.begin(client, serverName);
+
+  if (!user_agent.isEmpty())
+    http.addHeader("User-Agent", user_agent);
+
+  const int httpResponseCode = http.GET();
+  ESP_LOGI(TAG, "HTTPS request: %s", serverName);
+  ESP_LOGI(TAG, "HTTPS Response code: %d", httpResponseCode);
+
+  bool ok = false;
+  if (httpResponseCode == HTTP_CODE_OK)
+  {
+    // тело читается прямо из сокета; getStream() — тот же клиент, через который шёл запрос
+    HttpBodyReader body(http.getStream(), http.getSize());
+    ok = handler(body, ctx);
+  }
+
+  http.end();
+  return ok;
+}
@@ -0,0 +1,164 @@
+#include "i2c_engine.h"
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <freertos/queue.h>
+#include <string.h>
+
+static const char *TAG = "I2C";
+
+// Очередь транзакций (несколько производителей — задачи датчиков, один потребитель — задача I2C)
+static StaticQueue_t s_queue_buf;
+static uint8_t s_queue_storage[I2C_ENGINE_QUEUE_LEN * sizeof(I2cTransaction_t)];
+static QueueHandle_t s_queue = nullptr;
+static i2c_port_t s_port = I2C_NUM_0;
+
+// Счётчики (изменяются под спинлоком, 64-битное время не атомарно)
+static I2cEngineStats_t s_stats;
+static portMUX_TYPE s_stats_mux = portMUX_INITIALIZER_UNLOCKED;
+
+bool I2cEngine::init(i2c_port_t port)
+{
+  s_port = port;
+  memset(&s_stats, 0, sizeof(s_stats));
+  s_queue = xQueueCreateStatic(I2C_ENGINE_QUEUE_LEN, sizeof(I2cTransaction_t), s_queue_storage, &s_queue_buf);
+  return s_queue != nullptr;
+}
+
+bool I2cEngine::submit(const I2cTransaction_t &t, TickType_t wait)
+{
+  if (!s_queue || t.tx_len > I2C_ENGINE_TX_MAX)
+    return false;
+
+  const bool ok = xQueueSend(s_queue, &t, wait) == pdTRUE;
+  const uint32_t depth = uxQueueMessagesWaiting(s_queue);
+
+  portENTER_CRITICAL(&s_stats_mux);
+  if (ok)
+    s_stats.submitted++;
+  else
+    s_stats.rejected++;
+  if (depth > s_stats.queue_hwm)
+    s_stats.queue_hwm = depth;
+  portEXIT_CRITICAL(&s_stats_mux);
+  return ok;
+}
+
+esp_err_t I2cEngine::transfer(uint8_t addr, const uint8_t *tx, uint8_t tx_len, uint8_t *rx, size_t rx_len)
+{
+  volatile esp_err_t result = ESP_FAIL;
+  I2cTransaction_t t = {};
+  t.addr = addr;
+  if (tx_len > I2C_ENGINE_TX_MAX)
+    return ESP_ERR_INVALID_SIZE;
+  if (tx_len)
+    memcpy(t.tx, tx, tx_len);
+  t.tx_len = tx_len;
+  t.rx = rx;
+  t.rx_len = rx_len;
+  t.notify_task = xTaskGetCurrentTaskHandle();
+  t.notify_bit = NOTIFY_BIT_I2C;
+  t.result = &result;
+
+  if (!submit(t, pdMS_TO_TICKS(I2C_ENGINE_TIMEOUT_MS * I2C_ENGINE_QUEUE_LEN)))
+    return ESP_ERR_NO_MEM;
+
+  // ждать именно бит завершения I2C; прочие биты вернуть задаче после ожидания
+  uint32_t other = 0;
+  for (;;)
+  {
+    uint32_t bits = 0;
+    xTaskNotifyWait(0, ULONG_MAX, &bits, portMAX_DELAY);
+    other |= bits & ~NOTIFY_BIT_I2C;
+    if (bits & NOTIFY_BIT_I2C)
+      break;
+  }
+  if (other)
+    xTaskNotify(xTaskGetCurrentTaskHandle(), other, eSetBits);
+  return result;
+}
+
+esp_err_t I2cEngine::write_reg(uint8_t addr, uint8_t reg, uint8_t value)
+{
+  const uint8_t tx[2] = {reg, value};
+  return transfer(addr, tx, sizeof(tx), nullptr, 0);
+}
+
+esp_err_t I2cEngine::read_regs(uint8_t addr, uint8_t reg, uint8_t *buf, size_t len)
+{
+  return transfer(addr, &reg, 1, buf, len);
+}
+
+// Выполнить транзакцию через командную последовательность драйвера (обмен ведёт ISR контроллера)
+static esp_err_t execute(const I2cTransaction_t &t)
+{
+  uint8_t link_buf[I2C_LINK_RECOMMENDED_SIZE(3)];
+  i2c_cmd_handle_t cmd = i2c_cmd_link_create_static(link_buf, sizeof(link_buf));
+  if (!cmd)
+    return ESP_ERR_NO_MEM;
+
+  if (t.tx_len)
+  {
+    i2c_master_start(cmd);
+    i2c_master_write_byte(cmd, static_cast<uint8_t>((t.addr << 1) | I2C_MASTER_WRITE), true);
+    i2c_master_write(cmd, t.tx, t.tx_len, true);
+  }
+  if (t.rx_len)
+  {
+    i2c_master_start(cmd); // повторный START после записи адреса регистра
+    i2c_master_write_byte(cmd, static_cast<uint8_t>((t.addr << 1) | I2C_MASTER_READ), true);
+    i2c_master_read(cmd, t.rx, t.rx_len, I2C_MASTER_LAST_NACK);
+  }
+  i2c_master_stop(cmd);
+
+  const esp_err_t err = i2c_master_cmd_begin(s_port, cmd, pdMS_TO_TICKS(I2C_ENGINE_TIMEOUT_MS));
+  i2c_cmd_link_delete_static(cmd);
+  return err;
+}
+
+void I2cEngine::run()
+{
+  for (;;)
+  {
+    I2cTransaction_t t;
+    if (xQueueReceive(s_queue, &t, portMAX_DELAY) != pdTRUE)
+      continue;
+
+    const int64_t start = esp_timer_get_time();
+    const esp_err_t err = execute(t);
+    const int64_t busy = esp_timer_get_time() - start;
+
+    portENTER_CRITICAL(&s_stats_mux);
+    if (err == ESP_OK)
+      s_stats.completed++;
+    else
+      s_stats.failed++;
+    s_stats.bus_busy_us += static_cast<uint64_t>(busy);
+    portEXIT_CRITICAL(&s_stats_mux);
+
+    if (err != ESP_OK)
+      ESP_LOGD(TAG, "Transaction to 0x%02X failed: %s", t.addr, esp_err_to_name(err));
+
+    if (t.result)
+      *t.result = err;
+    if (t.callback)
+      t.callback(t, err);
+    if (t.notify_task)
+      xTaskNotify(t.notify_task, t.notify_bit, eSetBits);
+  }
+}
+
+void I2cEngine::get_stats(I2cEngineStats_t &stats)
+{
+  portENTER_CRITICAL(&s_stats_mux);
+  stats = s_stats;
+  portEXIT_CRITICAL(&s_stats_mux);
+}
+
+void I2cEngine::log_stats()
+{
+  I2cEngineStats_t st;
+  get_stats(st);
+  ESP_LOGI(TAG, "submitted=%u completed=%u failed=%u rejected=%u queue_hwm=%u/%u bus_busy=%llums",
+           st.submitted, st.completed, st.failed, st.rejected, st.queue_hwm, I2C_ENGINE_QUEUE_LEN,
+           static_cast<unsigned long long>(st.bus_busy_us / 1000));
+}
@@ -0,0 +1,121 @@
+#include "latency_trace.h"
+#include "clock_service.h"
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <string.h>
+#include <time.h>
+
+static const char *TAG = "LATENCY";
+
+static LatencyHistogram s_hist[_LATENCY_POINT_NUM_];
+
+static const char *point_name(LatencyPoint_t point)
+{
+  switch (point)
+  {
+  case LATENCY_POINT_TFT:
+    return "TFT";
+  case LATENCY_POINT_MQTT:
+    return "MQTT";
+  case LATENCY_POINT_NARODMON:
+    return "NARODMON";
+  case LATENCY_POINT_NRF_RX:
+    return "NRF_RX";
+  default:
+    return "?";
+  }
+}
+
+SampleStamp_t sample_stamp_now()
+{
+  SampleStamp_t stamp;
+  stamp.mono_us = esp_timer_get_time();
+  stamp.wall = time(nullptr);
+  if (stamp.wall < CLOCK_MIN_VALID_EPOCH)
+    stamp.wall = 0;
+  return stamp;
+}
+
+LatencyHistogram::LatencyHistogram() : mux(portMUX_INITIALIZER_UNLOCKED)
+{
+  reset();
+}
+
+void LatencyHistogram::record(uint32_t us)
+{
+  uint32_t b = us ? (31 - __builtin_clz(us)) : 0;
+  if (b >= LATENCY_BUCKETS)
+    b = LATENCY_BUCKETS - 1;
+
+  portENTER_CRITICAL(&mux);
+  data.buckets[b]++;
+  data.count++;
+  data.sum_us += us;
+  if (us < data.min_us)
+    data.min_us = us;
+  if (us > data.max_us)
+    data.max_us = us;
+  portEXIT_CRITICAL(&mux);
+}
+
+void LatencyHistogram::get_stats(LatencyStats_t &stats)
+{
+  portENTER_CRITICAL(&mux);
+  stats = data;
+  portEXIT_CRITICAL(&mux);
+}
+
+void LatencyHistogram::reset()
+{
+  portENTER_CRITICAL(&mux);
+  memset(&data, 0, sizeof(data));
+  data.min_us = UINT32_MAX;
+  portEXIT_CRITICAL(&mux);
+}
+
+uint32_t LatencyHistogram::percentile(const LatencyStats_t &stats, uint8_t p)
+{
+  if (!stats.count)
+    return 0;
+  const uint64_t target = ((uint64_t)stats.count * p + 99) / 100;
+  uint64_t acc = 0;
+  for (int b = 0; b < LATENCY_BUCKETS; ++b)
+  {
+    acc += stats.buckets[b];
+    if (acc >= target && stats.buckets[b])
+      return (b == LATENCY_BUCKETS - 1) ? stats.max_us : ((2UL << b) - 1);
+  }
+  return stats.max_us;
+}
+
+void LatencyTrace::record(LatencyPoint_t point, const SampleStamp_t &stamp)
+{
+  if (point >= _LATENCY_POINT_NUM_ || stamp.mono_us == 0)
+    return;
+  const int64_t delta = esp_timer_get_time() - stamp.mono_us;
+  s_hist[point].record(delta <= 0 ? 0 : (delta >= UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(delta)));
+}
+
+void LatencyTrace::get_stats(LatencyPoint_t point, LatencyStats_t &stats)
+{
+  s_hist[point].get_stats(stats);
+}
+
+void LatencyTrace::log_stats()
+{
+  for (int i = 0; i < _LATENCY_POINT_NUM_; ++i)
+  {
+    LatencyStats_t st;
+    get_stats(static_cast<LatencyPoint_t>(i), st);
+    if (!st.count)
+    {
+      ESP_LOGI(TAG, "[%s] no samples", point_name(static_cast<LatencyPoint_t>(i)));
+      continue;
+    }
+    ESP_LOGI(TAG, "[%s] n=%u min=%uus avg=%uus p50<=%uus p90<=%uus p99<=%uus max=%uus",
+             point_name(static_cast<LatencyPoint_t>(i)), st.count, st.min_us,
+             static_cast<uint32_t>(st.sum_us / st.count),
+             LatencyHistogram::percentile(st, 50), LatencyHistogram::percentile(st, 90),
+             LatencyHistogram::percentile(st, 99), st.max_us);
+  }
+}
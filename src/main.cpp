@@ -1,4 +1,3 @@
-#include <Adafruit_BME280.h>
 #include <LittleFS.h>
 #include <LovyanGFX.hpp>
 #include <RF24.h>
@@ -9,13 +8,21 @@
 #include <stdio.h>
 #include <time.h>
 
+#include "boot_cache.h"
+#include "clock_service.h"
 #include "common.h"
+#include "config_service.h"
+#include "i2c_engine.h"
 #include "meteowidgets.h"
 #include "netprocessor.h"
 #include "openmeteo.h"
+#include "rollup.h"
+#include "station_state.h"
 #include "webportal.h"
 
+#include "task_history.h"
 #include "task_home_sensor.h"
+#include "task_i2c.h"
 #include "task_networking.h"
 #include "task_nrf24.h"
 #include "task_ota.h"
@@ -32,12 +39,8 @@ StackType_t xTaskStack_PROTASK_NETWORKING[PROTASK_NETWORKING_STACK_SIZE];
 StackType_t xTaskStack_PROTASK_HOME_SENSOR[PROTASK_HOME_SENSOR_STACK_SIZE];
 StackType_t xTaskStack_PROTASK_NRF_RECEIVER[PROTASK_NRF_RECEIVER_STACK_SIZE];
 StackType_t xTaskStack_PROTASK_OTA[PROTASK_OTA_STACK_SIZE];
-// Дескрипторы очередей данных
-QueueHandle_t xQueue[_PROTASK_NUM_];
-// буфер очереди данных
-StaticQueue_t xQueueBuffer[_PROTASK_NUM_];
-// хранилище очереди
-uint8_t xQueueStorage[_PROTASK_NUM_][DATA_QUEUE_SIZE * DATA_QUEUE_ITEM_SIZE];
+StackType_t xTaskStack_PROTASK_I2C[PROTASK_I2C_STACK_SIZE];
+StackType_t xTaskStack_PROTASK_HISTORY[PROTASK_HISTORY_STACK_SIZE];
 
 // Статический буфер и дескриптор группы событий состояния системы
 StaticEventGroup_t xEventGroupBuffer;
@@ -67,6 +70,13 @@ void setup(void)
     vTaskDelay(pdMS_TO_TICKS(3000));
     ESP.restart();
   }
+  // Очередь асинхронных транзакций I2C (драйвер порта установлен Wire.begin())
+  if (!I2cEngine::init(I2C_NUM_0))
+  {
+    ESP_LOGE("MAIN", "I2C engine initialization failed, restart ESP...");
+    vTaskDelay(pdMS_TO_TICKS(3000));
+    ESP.restart();
+  }
 
   // Создание мьютекса для синхронизации доступа к LittleFS
   xLittleFSMutex = xSemaphoreCreateMutex();
@@ -87,20 +97,34 @@ void setup(void)
     ESP.restart();
   }
 
-  // создание очередей (по одной для каждой задачи) — ДО создания задач!
-  ESP_LOGI("MAIN", "Create queues ...");
-  for (auto i = 0; i < _PROTASK_NUM_; i++)
+  // Конфигурация: один раз из NVS (после мьютекса LittleFS — миграция config.json), далее чтение из памяти
+  ConfigService::init();
+  // Подключение хранилища состояния станции к шине данных (до появления производителей)
+  StationState::init();
+  // Агрегаты по минутам/часам/суткам — после StationState (по нему выбирается основной наружный узел)
+  Rollup::init();
+  // Последнее известное состояние — на экран сразу после запуска, с пометкой "устарело"
+  BootCache::restore();
+  // Служба времени: события смены минуты/часа/даты для задач
+  ClockService::init();
+
+  ESP_LOGI("MAIN", "Create tasks ...");
+  // создание задачи-исполнителя транзакций I2C (до задач датчиков)
+  xHandles[PROTASK_I2C] = xTaskCreateStatic(
+      task_i2c_exec,
+      "I2C",
+      PROTASK_I2C_STACK_SIZE,
+      nullptr,
+      tskIDLE_PRIORITY + 2, // выше задач-клиентов, чтобы транзакции не простаивали в очереди
+      xTaskStack_PROTASK_I2C,
+      &xTaskBuffer[PROTASK_I2C]);
+  if (xHandles[PROTASK_I2C] == NULL)
   {
-    xQueue[i] = xQueueCreateStatic(DATA_QUEUE_SIZE, DATA_QUEUE_ITEM_SIZE, &xQueueStorage[i][0], &xQueueBuffer[i]);
-    if (!xQueue[i])
-    {
-      ESP_LOGE("MAIN", "Queue %d is not created, restart ESP...", i);
-      vTaskDelay(pdMS_TO_TICKS(5000));
-      ESP.restart();
-    }
+    ESP_LOGE("MAIN", "I2C Task is not created, restart ESP...");
+    vTaskDelay(pdMS_TO_TICKS(5000));
+    ESP.restart();
   }
 
-  ESP_LOGI("MAIN", "Create tasks ...");
   // создание задачи обновления часов на TFT (статическая инициализация)
   xHandles[PROTASK_TFT] = xTaskCreateStatic(
       task_tft_exec,            // функция задачи
@@ -187,6 +211,22 @@ void setup(void)
     ESP.restart();
   }
 
+  // создание задачи журнала показаний (запись страниц во флеш-память в фоне)
+  xHandles[PROTASK_HISTORY] = xTaskCreateStatic(
+      task_history_exec,
+      "HISTORY",
+      PROTASK_HISTORY_STACK_SIZE,
+      nullptr,
+      tskIDLE_PRIORITY + 1,
+      xTaskStack_PROTASK_HISTORY,
+      &xTaskBuffer[PROTASK_HISTORY]);
+  if (xHandles[PROTASK_HISTORY] == NULL)
+  {
+    ESP_LOGE("MAIN", "HISTORY Task is not created, restart ESP...");
+    vTaskDelay(pdMS_TO_TICKS(5000));
+    ESP.restart();
+  }
+
   ESP_LOGI("MAIN", "Initialization complete...");
 }
 
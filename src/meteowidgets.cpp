@@ -1180,6 +1180,18 @@ bool MeteoWidgets::draw_battery_level_widget(uint8_t level)
   return ok;
 }
 
+bool MeteoWidgets::draw_stale_mark(int scr_x_pos, int scr_y_pos)
+{
+  // Кружок с "часовой стрелкой" в левом верхнем углу виджета
+  const int cx = scr_x_pos + STALE_MARK_R + 3;
+  const int cy = scr_y_pos + STALE_MARK_R + 3;
+  tft.fillCircle(cx, cy, STALE_MARK_R, STALE_MARK_COLOR);
+  tft.drawCircle(cx, cy, STALE_MARK_R, TFT_BLACK);
+  tft.drawFastVLine(cx, cy - STALE_MARK_R + 2, STALE_MARK_R - 1, TFT_BLACK);
+  tft.drawFastHLine(cx, cy, STALE_MARK_R - 2, TFT_BLACK);
+  return true;
+}
+
 bool MeteoWidgets::draw_update_processing_widget()
 {
   // Fill entire screen with background color first
@@ -1,4 +1,6 @@
 #include "mqttsender.h"
+#include "latency_trace.h"
+#include "nrf_link.h"
 #include "tasks_common.h"
 #include <esp_log.h>
 #include <esp_system.h>
@@ -14,9 +16,10 @@ static void mqtt_callback(char *topic, byte *payload, unsigned int length)
   ESP_LOGI(TAG, "MQTT msg on %s, len=%u", topic, length);
 }
 
-MqttSender::MqttSender(QueueHandle_t (&queue_array_ref)[_PROTASK_NUM_])
-    : xQueues(queue_array_ref), wifiClient(), mqttClient(wifiClient), lastConnectAttemptMs(0)
+MqttSender::MqttSender()
+    : wifiClient(), mqttClient(wifiClient), lastConnectAttemptMs(0)
 {
+  mqttClient.setBufferSize(MQTT_BUFFER_SIZE);
   ESP_LOGI(TAG, "MqttSender constructed");
 }
 
@@ -65,9 +68,9 @@ void MqttSender::loop(const PrjCfgData &cfg)
     {
       lastConnectAttemptMs = nowMs;
       if (connect(cfg))
-        xEventGroupSetBits(xEventGroup, BIT_MQTT_STATE_UP);
+        system_bits_set(BIT_MQTT_STATE_UP);
       else
-        xEventGroupClearBits(xEventGroup, BIT_MQTT_STATE_UP);
+        system_bits_clear(BIT_MQTT_STATE_UP);
     }
   }
   else
@@ -76,6 +79,14 @@ void MqttSender::loop(const PrjCfgData &cfg)
   }
 }
 
+void MqttSender::reconnect()
+{
+  if (mqttClient.connected())
+    mqttClient.disconnect();
+  lastConnectAttemptMs = 0; // без ожидания интервала повторного подключения
+  system_bits_clear(BIT_MQTT_STATE_UP);
+}
+
 bool MqttSender::connected()
 {
   return mqttClient.connected();
@@ -88,52 +99,75 @@ bool MqttSender::publish(const char *topic, const String &payload)
   return mqttClient.publish(topic, payload.c_str());
 }
 
-void MqttSender::processing(const PrjCfgData &cfg, QueDataItem_t &qitem)
+void MqttSender::processing(const PrjCfgData &cfg, const BusSample_t &sample)
 {
   if (mqttClient.connected())
   {
-    if (qitem.type == QUE_DATATYPE_IN_SENSOR_DATA)
+    if (sample.topic == QUE_DATATYPE_IN_SENSOR_DATA)
     {
-      HomeSensorData_t *p = static_cast<HomeSensorData_t *>(qitem.data);
-      if (p)
+      const HomeSensorData_t *p = &sample.as<HomeSensorData_t>();
+      char topic[64];
+      char payload[128];
+      snprintf(topic, sizeof(topic), "%s/%s/in", cfg.mqtt_user, cfg.mqtt_prefix);
+      snprintf(payload, sizeof(payload), "{\"t\":%.1f,\"p\":%.0f,\"h\":%u}",
+               p->temperature_in, p->pressure_in, p->humidity_in);
+      if (!publish(topic, payload))
+        ESP_LOGW(TAG, "Failed publish to %s", topic);
+      else
       {
-        char topic[64];
-        char payload[128];
-        snprintf(topic, sizeof(topic), "%s/%s/in", cfg.mqtt_user, cfg.mqtt_prefix);
-        snprintf(payload, sizeof(payload), "{\"t\":%.1f,\"p\":%.0f,\"h\":%u}",
-                 p->temperature_in, p->pressure_in, p->humidity_in);
-        if (!publish(topic, payload))
-          ESP_LOGW(TAG, "Failed publish to %s", topic);
-        else
-          ESP_LOGI(TAG, "Published IN -> %s", topic);
-
-        delete p; // free memory after publishing
+        LatencyTrace::record(LATENCY_POINT_MQTT, sample.stamp);
+        ESP_LOGI(TAG, "Published IN -> %s", topic);
       }
     }
-    else if (qitem.type == QUE_DATATYPE_OUT_SENSOR_DATA)
+    else if (sample.topic == QUE_DATATYPE_OUT_SENSOR_DATA)
     {
-      OutSensorData_t *p = static_cast<OutSensorData_t *>(qitem.data);
-      if (p)
-      {
-        char topic[64];
-        char payload[128];
+      const OutSensorData_t *p = &sample.as<OutSensorData_t>();
+      char topic[64];
+      char payload[128];
+      // узел 0 — прежний топик .../out, остальные узлы — .../out/<номер узла>
+      if (sample.source == 0)
         snprintf(topic, sizeof(topic), "%s/%s/out", cfg.mqtt_user, cfg.mqtt_prefix);
-        snprintf(payload, sizeof(payload), "{\"t\":%.1f,\"p\":%u,\"h\":%.0f,\"bat\":%u}",
-                 p->temperature, p->pressure, p->humidity, p->bat_charge);
-        if (!publish(topic, payload))
-          ESP_LOGW(TAG, "Failed publish to %s", topic);
-        else
-          ESP_LOGI(TAG, "Published OUT -> %s", topic);
-
-        delete p; // free memory after publishing
+      else
+        snprintf(topic, sizeof(topic), "%s/%s/out/%u", cfg.mqtt_user, cfg.mqtt_prefix, sample.source);
+      snprintf(payload, sizeof(payload), "{\"t\":%.1f,\"p\":%u,\"h\":%.0f,\"bat\":%u,\"node\":%u}",
+               p->temperature, p->pressure, p->humidity, p->bat_charge, sample.source);
+      if (!publish(topic, payload))
+        ESP_LOGW(TAG, "Failed publish to %s", topic);
+      else
+      {
+        LatencyTrace::record(LATENCY_POINT_MQTT, sample.stamp);
+        ESP_LOGI(TAG, "Published OUT -> %s", topic);
       }
     }
     else
     {
-      ESP_LOGW(TAG, "Unknown QueDataType_t %d in MQTT processing", static_cast<int>(qitem.type));
-      // Unknown data type; just free the data pointer
-      if (qitem.data)
-        delete static_cast<uint8_t *>(qitem.data);
+      ESP_LOGW(TAG, "Unknown QueDataType_t %d in MQTT processing", static_cast<int>(sample.topic));
     }
   }
 }
+
+void MqttSender::publishLink(const PrjCfgData &cfg)
+{
+  if (!mqttClient.connected())
+    return;
+  char topic[64];
+  char payload[256];
+  snprintf(topic, sizeof(topic), "%s/%s/link", cfg.mqtt_user, cfg.mqtt_prefix);
+  if (!NrfLink::to_json(payload, sizeof(payload)))
+    ESP_LOGW(TAG, "Link stats do not fit into MQTT payload");
+  else if (!publish(topic, payload))
+    ESP_LOGW(TAG, "Failed publish to %s", topic);
+}
+
+void MqttSender::publishBus(const PrjCfgData &cfg)
+{
+  if (!mqttClient.connected())
+    return;
+  char topic[64];
+  char payload[512];
+  snprintf(topic, sizeof(topic), "%s/%s/bus", cfg.mqtt_user, cfg.mqtt_prefix);
+  if (!DataBus::to_json(payload, sizeof(payload)))
+    ESP_LOGW(TAG, "Bus stats do not fit into MQTT payload");
+  else if (!publish(topic, payload))
+    ESP_LOGW(TAG, "Failed publish to %s", topic);
+}
@@ -1,13 +1,14 @@
 #include "netprocessor.h"
 #include "certs.h"
+#include "databus.h"
 #include "http_helpers.h"
 #include <WiFi.h>
 #include <esp_log.h>
 
 // Global NetProcessor instance is owned/constructed by main(); no singletons here.
 
-NetProcessor::NetProcessor(QueueHandle_t (&queue_array_ref)[_PROTASK_NUM_], const String &latitude, const String &longitude)
-    : xQueues(queue_array_ref), wm(), webConfig(wm), openMeteo(latitude, longitude, PROTASK_TFT, queue_array_ref), mqttSender(queue_array_ref)
+NetProcessor::NetProcessor(const String &latitude, const String &longitude)
+    : wm(), webConfig(wm), openMeteo(latitude, longitude), mqttSender()
 {
   ESP_LOGI("NETWORKING", "NetProcessor constructed");
 }
@@ -27,14 +28,6 @@ NetProcessor::~NetProcessor()
  */
 bool NetProcessor::sendNarodMon(const OutSensorData_t &data)
 {
-  PrjCfgData cfg;
-  bool configOk = webConfig.get_config(cfg);
-  if (!configOk)
-  {
-    ESP_LOGW("NETWORKING", "Cannot send to NarodMon: failed to get config");
-    return false;
-  }
-
   String mac = WiFi.macAddress();
   mac.toUpperCase();
 
@@ -109,21 +102,9 @@ void NetProcessor::NearestCityProcessing()
   double lat = atof(cfg.latitude);
   double lon = atof(cfg.longitude);
   String city = openMeteo.getNearestCityName(lat, lon);
-  // Send to TFT queue (String* allocated on heap)
-  String *payload = new String(city);
-  if (payload)
-  {
-    QueDataItem_t qitem;
-    qitem.type = QUE_DATATYPE_CITYNAME;
-    qitem.data = payload;
-    if (pdPASS != xQueueSend(xQueues[PROTASK_TFT], &qitem, pdMS_TO_TICKS(200)))
-    {
-      ESP_LOGW("NETWORKING", "Failed to send city name to TFT queue");
-      delete payload;
-    }
-    else
-    {
-      ESP_LOGI("NETWORKING", "Sent city name to TFT: %s", city.c_str());
-    }
-  }
+  // Publish to the data bus (TFT and any other subscribers)
+  if (!DataBus::publish_string(QUE_DATATYPE_CITYNAME, city.c_str()))
+    ESP_LOGW("NETWORKING", "Failed to publish city name");
+  else
+    ESP_LOGI("NETWORKING", "Published city name: %s", city.c_str());
 }
@@ -0,0 +1,433 @@
+#include "nrf_link.h"
+#include "nrf_nodes.h"
+#include "rolling_stats.h"
+#include <esp_log.h>
+#include <stdio.h>
+
+static const char *TAG = "NRF_LINK";
+
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+static Ewma<uint32_t, 4> s_noise[NRF_SCAN_CHANNELS]; // занятость радиоканалов сетки (‰, EWMA 1/16)
+static uint8_t s_channel = RADIO_HOME_CHANNEL;       // текущий радиоканал
+static uint8_t s_target = RADIO_HOME_CHANNEL;        // радиоканал объявленного перехода
+static NrfLinkState_t s_state = NRF_LINK_STABLE;     // состояние выбора радиоканала
+static TickType_t s_switch_tick = 0;                 // момент перехода (объявленного или выполненного)
+static uint16_t s_expect = 0;                        // узлы, ожидаемые на новом радиоканале (битовая маска)
+static uint8_t s_holdoff_channel = 0;                // радиоканал, переход на который не удался
+static TickType_t s_holdoff_until = 0;               // до этого момента s_holdoff_channel не выбирается
+static TickType_t s_last_scan = 0;                   // момент последнего прохода сканирования
+static TickType_t s_last_eval = 0;                   // момент последней оценки радиоканала
+static uint32_t s_eval_packets = 0;                  // принято пакетов на момент последней оценки
+static uint32_t s_eval_lost = 0;                     // потеряно пакетов на момент последней оценки
+static uint32_t s_interval_ms = 60000;               // период передачи узлов
+static uint32_t s_scans = 0, s_switches = 0, s_fallbacks = 0, s_announces = 0;
+
+static const char *const STATE_NAMES[] = {"stable", "announce", "verify"};
+
+// Прошедшее время в мс (отрицательное — момент since ещё не наступил); корректно при переполнении тиков
+static inline int32_t elapsed_ms(TickType_t now, TickType_t since)
+{
+  return static_cast<int32_t>(now - since) * static_cast<int32_t>(portTICK_PERIOD_MS);
+}
+
+// Учесть момент at в ближайшем сроке wait (прошедший момент — срок 0)
+static void earliest(TickType_t now, TickType_t at, TickType_t &wait)
+{
+  const int32_t ticks = static_cast<int32_t>(at - now);
+  const TickType_t left = ticks > 0 ? static_cast<TickType_t>(ticks) : 0;
+  if (left < wait)
+    wait = left;
+}
+
+static int channel_index(uint8_t channel)
+{
+  if (channel < NRF_SCAN_FIRST_CHANNEL || (channel - NRF_SCAN_FIRST_CHANNEL) % NRF_SCAN_CHANNEL_STEP)
+    return -1;
+  const int idx = (channel - NRF_SCAN_FIRST_CHANNEL) / NRF_SCAN_CHANNEL_STEP;
+  return idx < NRF_SCAN_CHANNELS ? idx : -1;
+}
+
+// Тишина узла, после которой он считается потерянным на текущем радиоканале
+static int32_t silence_limit_ms(const NrfNode_t &n)
+{
+  const int32_t limit = static_cast<int32_t>(n.interval_ewma.value() * NRF_LINK_FALLBACK_INTERVALS);
+  return limit > NRF_LINK_MIN_SILENCE_MS ? limit : NRF_LINK_MIN_SILENCE_MS;
+}
+
+// Возврат на домашний канал; неудачный радиоканал не выбирается NRF_LINK_HOLDOFF_MS
+static void fallback_home(TickType_t now, const char *reason)
+{
+  ESP_LOGW(TAG, "Channel %u: %s, returning to home channel %u", s_channel, reason, RADIO_HOME_CHANNEL);
+  portENTER_CRITICAL(&s_mux);
+  s_holdoff_channel = s_channel;
+  s_holdoff_until = now + pdMS_TO_TICKS(NRF_LINK_HOLDOFF_MS);
+  s_channel = RADIO_HOME_CHANNEL;
+  s_target = RADIO_HOME_CHANNEL;
+  s_state = NRF_LINK_STABLE;
+  s_expect = 0;
+  s_fallbacks++;
+  portEXIT_CRITICAL(&s_mux);
+  s_switch_tick = now;
+  s_last_eval = now;
+}
+
+// Оценка радиоканала по потерям и занятости; при необходимости — объявление перехода
+static void evaluate(TickType_t now, bool ack_payloads)
+{
+  uint32_t packets = 0, lost = 0, max_interval = 0;
+  uint16_t live = 0;
+  bool legacy = false;
+  for (uint8_t i = 0; i < NRF_MAX_NODES; ++i)
+  {
+    NrfNode_t n;
+    if (!NrfNodes::get(i, n))
+      continue;
+    packets += n.packets;
+    lost += n.lost;
+    if (elapsed_ms(now, n.last_tick) > silence_limit_ms(n))
+      continue;
+    live |= static_cast<uint16_t>(1u << i);
+    legacy |= n.version < RADIO_VERSION;
+    if (n.interval_ewma.value() > max_interval)
+      max_interval = n.interval_ewma.value();
+  }
+
+  // потери за период оценки (узлы версии 1 порядкового номера не передают и в потери не входят)
+  const uint32_t d_packets = packets - s_eval_packets, d_lost = lost - s_eval_lost;
+  s_eval_packets = packets;
+  s_eval_lost = lost;
+  const uint32_t loss_pct = (d_packets + d_lost) ? 100 * d_lost / (d_packets + d_lost) : 0;
+
+  if (s_scans < NRF_LINK_MIN_SCANS)
+    return;
+
+  const int cur_idx = channel_index(s_channel);
+  const uint32_t cur = cur_idx >= 0 ? s_noise[cur_idx].value() : 0;
+  int best_idx = -1;
+  uint32_t best = UINT32_MAX;
+  const bool holdoff = static_cast<int32_t>(s_holdoff_until - now) > 0;
+  for (int i = 0; i < NRF_SCAN_CHANNELS; ++i)
+  {
+    const uint8_t ch = NrfLink::scan_channel(i);
+    if (i == cur_idx || (holdoff && ch == s_holdoff_channel) || !s_noise[i].valid())
+      continue;
+    if (s_noise[i].value() < best)
+    {
+      best = s_noise[i].value();
+      best_idx = i;
+    }
+  }
+
+  ESP_LOGI(TAG, "Channel %u: busy %u permille, loss %u%% (%u/%u); cleanest %d (%u permille)",
+           s_channel, cur, loss_pct, d_lost, d_packets + d_lost,
+           best_idx >= 0 ? NrfLink::scan_channel(best_idx) : -1, best_idx >= 0 ? best : 0);
+
+  if (best_idx < 0 || (loss_pct < NRF_LINK_LOSS_PCT && cur < NRF_LINK_NOISY_PERMILLE) ||
+      cur < best + NRF_LINK_MIN_GAIN_PERMILLE)
+    return;
+
+  // перейти можно только вместе со всеми узлами: нужен обратный канал и формат версии 2
+  if (!ack_payloads || legacy || !live)
+  {
+    ESP_LOGW(TAG, "Channel %u is worse than %u, but nodes cannot be switched (%s)", s_channel,
+             NrfLink::scan_channel(best_idx), !ack_payloads ? "ACK payloads disabled" : legacy ? "legacy nodes" : "no live nodes");
+    return;
+  }
+
+  // каждый узел должен успеть получить команду хотя бы в одном подтверждении
+  uint32_t lead_ms = max_interval * NRF_LINK_LEAD_INTERVALS + NRF_SCAN_GUARD_MS;
+  if (lead_ms > NRF_LINK_MAX_LEAD_MS)
+    lead_ms = NRF_LINK_MAX_LEAD_MS;
+
+  portENTER_CRITICAL(&s_mux);
+  s_target = NrfLink::scan_channel(best_idx);
+  s_state = NRF_LINK_ANNOUNCE;
+  s_expect = live;
+  portEXIT_CRITICAL(&s_mux);
+  s_switch_tick = now + pdMS_TO_TICKS(lead_ms);
+  ESP_LOGW(TAG, "Announcing switch %u -> %u in %us to nodes 0x%04x", s_channel, s_target, lead_ms / 1000, live);
+}
+
+// Момент, с которого можно сканировать (не раньше now): период сканирования истёк и момент
+// не попадает в окно ожидаемого пакета узла — от NRF_SCAN_GUARD_MS до него и до четверти
+// интервала после (опоздавший узел). false — узлов с известным периодом нет, сканировать незачем
+static bool scan_tick(TickType_t now, TickType_t &at)
+{
+  at = now;
+  if (s_scans && elapsed_ms(now, s_last_scan) < NRF_SCAN_PERIOD_MS)
+    at = s_last_scan + pdMS_TO_TICKS(NRF_SCAN_PERIOD_MS);
+
+  bool known = false;
+  for (uint8_t pass = 0; pass < NRF_MAX_NODES; ++pass)
+  {
+    bool moved = false;
+    for (uint8_t i = 0; i < NRF_MAX_NODES; ++i)
+    {
+      NrfNode_t n;
+      if (!NrfNodes::get(i, n) || !n.interval_ewma.valid())
+        continue;
+      known = true;
+      const int32_t interval = static_cast<int32_t>(n.interval_ewma.value());
+      const int32_t since = elapsed_ms(at, n.last_tick);
+      if (since > interval - NRF_SCAN_GUARD_MS && since < interval + interval / 4)
+      {
+        at = n.last_tick + pdMS_TO_TICKS(interval + interval / 4) + 1;
+        moved = true;
+      }
+    }
+    if (!moved)
+      break;
+  }
+  return known;
+}
+
+uint8_t NrfLink::channel()
+{
+  portENTER_CRITICAL(&s_mux);
+  const uint8_t ch = s_channel;
+  portEXIT_CRITICAL(&s_mux);
+  return ch;
+}
+
+bool NrfLink::scan_due(TickType_t now)
+{
+  // во время перехода не сканируем: занятость меряется на устоявшемся радиоканале, а команды
+  // перехода не должны задерживаться повторной загрузкой
+  if (s_state != NRF_LINK_STABLE)
+    return false;
+  TickType_t at;
+  return scan_tick(now, at) && at == now;
+}
+
+TickType_t NrfLink::next_wait(TickType_t now)
+{
+  TickType_t wait = portMAX_DELAY;
+  switch (s_state)
+  {
+  case NRF_LINK_STABLE:
+  {
+    bool nodes = false;
+    for (uint8_t i = 0; i < NRF_MAX_NODES; ++i)
+    {
+      NrfNode_t n;
+      if (!NrfNodes::get(i, n))
+        continue;
+      nodes = true;
+      // узел, слышимый на этом радиоканале, замолчит — возврат на домашний канал
+      if (s_channel != RADIO_HOME_CHANNEL && elapsed_ms(n.last_tick, s_switch_tick) > 0)
+        earliest(now, n.last_tick + pdMS_TO_TICKS(silence_limit_ms(n)) + 1, wait);
+    }
+    if (nodes)
+      earliest(now, s_last_eval + pdMS_TO_TICKS(NRF_LINK_EVAL_MS), wait);
+    TickType_t at;
+    if (scan_tick(now, at))
+      earliest(now, at, wait);
+    break;
+  }
+
+  case NRF_LINK_ANNOUNCE:
+    earliest(now, s_switch_tick, wait);
+    break;
+
+  case NRF_LINK_VERIFY:
+    for (uint8_t i = 0; i < NRF_MAX_NODES; ++i)
+    {
+      NrfNode_t n;
+      if ((s_expect & (1u << i)) && NrfNodes::get(i, n) && elapsed_ms(n.last_tick, s_switch_tick) <= 0)
+        earliest(now, s_switch_tick + pdMS_TO_TICKS(silence_limit_ms(n)) + 1, wait);
+    }
+    break;
+  }
+  return wait;
+}
+
+void NrfLink::record_scan(const bool busy[NRF_SCAN_CHANNELS], TickType_t now)
+{
+  portENTER_CRITICAL(&s_mux);
+  for (int i = 0; i < NRF_SCAN_CHANNELS; ++i)
+    s_noise[i].push(busy[i] ? 1000 : 0);
+  s_scans++;
+  portEXIT_CRITICAL(&s_mux);
+  s_last_scan = now;
+}
+
+void NrfLink::set_interval_s(uint16_t interval_s)
+{
+  s_interval_ms = (interval_s < NRF_INTERVAL_FLOOR_S ? NRF_INTERVAL_FLOOR_S : interval_s) * 1000u;
+}
+
+uint16_t NrfLink::interval_s()
+{
+  return static_cast<uint16_t>(s_interval_ms / 1000);
+}
+
+void NrfLink::downlink(uint8_t node, uint16_t ref_seq, int64_t rx_mono_us, int64_t rx_utc_ms, TickType_t now,
+                       RadioDownlink_t &out)
+{
+  out = RadioDownlink_t();
+  out.node = node;
+  out.ref_seq = ref_seq;
+  out.flags = RADIO_DL_SLOT | RADIO_DL_INTERVAL;
+  out.interval_s = interval_s();
+
+  if (rx_utc_ms > 0)
+  {
+    out.flags |= RADIO_DL_TIME;
+    out.ref_time = static_cast<uint32_t>(rx_utc_ms / 1000);
+    out.ref_ms = static_cast<uint16_t>(rx_utc_ms % 1000);
+  }
+
+  // Слот узла — фаза node/NRF_MAX_NODES периода, не раньше полутора периодов после ref_seq
+  out.slot_ms = RadioProto::slot_delay_ms(s_interval_ms, node, NRF_MAX_NODES, rx_mono_us / 1000);
+
+  if (s_state == NRF_LINK_ANNOUNCE)
+  {
+    const int32_t left_ms = elapsed_ms(s_switch_tick, now);
+    out.flags |= RADIO_DL_CHANNEL;
+    out.channel = s_target;
+    out.switch_in_s = static_cast<uint16_t>(left_ms <= 0 ? 0 : left_ms / 1000 > UINT16_MAX ? UINT16_MAX : left_ms / 1000);
+    portENTER_CRITICAL(&s_mux);
+    s_announces++;
+    portEXIT_CRITICAL(&s_mux);
+  }
+}
+
+bool NrfLink::service(TickType_t now, bool ack_payloads)
+{
+  switch (s_state)
+  {
+  case NRF_LINK_STABLE:
+    if (s_channel != RADIO_HOME_CHANNEL)
+    {
+      // узел, слышимый на этом радиоканале и замолчавший, вернулся на домашний канал
+      for (uint8_t i = 0; i < NRF_MAX_NODES; ++i)
+      {
+        NrfNode_t n;
+        if (NrfNodes::get(i, n) && elapsed_ms(n.last_tick, s_switch_tick) > 0 &&
+            elapsed_ms(now, n.last_tick) > silence_limit_ms(n))
+        {
+          fallback_home(now, "node went silent");
+          return true;
+        }
+      }
+    }
+    if (elapsed_ms(now, s_last_eval) >= NRF_LINK_EVAL_MS)
+    {
+      s_last_eval = now;
+      evaluate(now, ack_payloads);
+    }
+    return false;
+
+  case NRF_LINK_ANNOUNCE:
+    if (elapsed_ms(now, s_switch_tick) < 0)
+      return false;
+    ESP_LOGW(TAG, "Switching channel %u -> %u", s_channel, s_target);
+    portENTER_CRITICAL(&s_mux);
+    s_channel = s_target;
+    s_state = NRF_LINK_VERIFY;
+    portEXIT_CRITICAL(&s_mux);
+    s_switch_tick = now;
+    return true;
+
+  case NRF_LINK_VERIFY:
+  {
+    bool missing = false;
+    uint16_t expect = s_expect;
+    for (uint8_t i = 0; i < NRF_MAX_NODES; ++i)
+    {
+      NrfNode_t n;
+      if (!(expect & (1u << i)) || !NrfNodes::get(i, n))
+        continue;
+      if (elapsed_ms(n.last_tick, s_switch_tick) > 0)
+        expect &= static_cast<uint16_t>(~(1u << i));
+      else if (elapsed_ms(now, s_switch_tick) > silence_limit_ms(n))
+        missing = true;
+    }
+    portENTER_CRITICAL(&s_mux);
+    s_expect = expect;
+    portEXIT_CRITICAL(&s_mux);
+
+    if (missing)
+    {
+      fallback_home(now, "node missing after switch");
+      return true;
+    }
+    if (!expect)
+    {
+      ESP_LOGI(TAG, "All nodes heard on channel %u", s_channel);
+      portENTER_CRITICAL(&s_mux);
+      s_state = NRF_LINK_STABLE;
+      s_switches++;
+      portEXIT_CRITICAL(&s_mux);
+      s_last_eval = now;
+    }
+    return false;
+  }
+  }
+  return false;
+}
+
+void NrfLink::get_stats(NrfLinkStats_t &out)
+{
+  portENTER_CRITICAL(&s_mux);
+  out.channel = s_channel;
+  out.target = s_target;
+  out.state = s_state;
+  out.scans = s_scans;
+  out.switches = s_switches;
+  out.fallbacks = s_fallbacks;
+  out.announces = s_announces;
+  for (int i = 0; i < NRF_SCAN_CHANNELS; ++i)
+    out.noise[i] = static_cast<uint16_t>(s_noise[i].valid() ? s_noise[i].value() : 0);
+  portEXIT_CRITICAL(&s_mux);
+
+  out.packets = out.lost = out.duplicates = out.retries = out.rpd_strong = 0;
+  for (uint8_t i = 0; i < NRF_MAX_NODES; ++i)
+  {
+    NrfNode_t n;
+    if (!NrfNodes::get(i, n))
+      continue;
+    out.packets += n.packets;
+    out.lost += n.lost;
+    out.duplicates += n.duplicates;
+    out.retries += n.retries;
+    out.rpd_strong += n.rpd_strong;
+  }
+}
+
+void NrfLink::log_stats()
+{
+  NrfLinkStats_t st;
+  get_stats(st);
+  const uint32_t sent = st.packets + st.lost;
+  ESP_LOGI(TAG, "channel=%u state=%s target=%u switches=%u fallbacks=%u announces=%u scans=%u interval=%us",
+           st.channel, STATE_NAMES[st.state], st.target, st.switches, st.fallbacks, st.announces, st.scans,
+           interval_s());
+  ESP_LOGI(TAG, "packets=%u lost=%u (%.1f%%) dup=%u retries=%u rpd=%u%%", st.packets, st.lost,
+           sent ? 100.0f * st.lost / sent : 0.0f, st.duplicates, st.retries,
+           st.packets ? 100 * st.rpd_strong / st.packets : 0);
+
+  char line[NRF_SCAN_CHANNELS * 10];
+  size_t pos = 0;
+  for (int i = 0; i < NRF_SCAN_CHANNELS && pos < sizeof(line); ++i)
+    pos += snprintf(&line[pos], sizeof(line) - pos, " %u:%u", scan_channel(i), st.noise[i]);
+  ESP_LOGI(TAG, "busy, permille:%s", line);
+}
+
+bool NrfLink::to_json(char *buf, size_t size)
+{
+  NrfLinkStats_t st;
+  get_stats(st);
+  const uint32_t sent = st.packets + st.lost;
+  int pos = snprintf(buf, size,
+                     "{\"ch\":%u,\"state\":\"%s\",\"switches\":%u,\"fallbacks\":%u,\"rx\":%u,\"lost\":%u,"
+                     "\"loss\":%.1f,\"dup\":%u,\"retries\":%u,\"rpd\":%u,\"noise\":[",
+                     st.channel, STATE_NAMES[st.state], st.switches, st.fallbacks, st.packets, st.lost,
+                     sent ? 100.0f * st.lost / sent : 0.0f, st.duplicates, st.retries,
+                     st.packets ? 100 * st.rpd_strong / st.packets : 0);
+  for (int i = 0; i < NRF_SCAN_CHANNELS && pos > 0 && static_cast<size_t>(pos) < size; ++i)
+    pos += snprintf(&buf[pos], size - pos, "%s%u", i ? "," : "", st.noise[i]);
+  if (pos > 0 && static_cast<size_t>(pos) < size)
+    pos += snprintf(&buf[pos], size - pos, "]}");
+  return pos > 0 && static_cast<size_t>(pos) < size;
+}
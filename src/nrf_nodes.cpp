@@ -0,0 +1,108 @@
+#include "nrf_nodes.h"
+#include <esp_log.h>
+#include <freertos/task.h>
+
+static const char *TAG = "NRF_NODES";
+
+static NrfNode_t s_nodes[NRF_MAX_NODES];
+static uint8_t s_active = 0;
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+
+uint64_t NrfNodes::pipe_address(uint8_t pipe)
+{
+  if (pipe == 0)
+    return NRF_PIPE0_ADDR;
+  // pipe 2..5 разделяют с pipe 1 старшие 4 байта адреса, различается только младший
+  return (NRF_PIPE1_ADDR & ~0xFFULL) | ((NRF_PIPE1_ADDR + pipe - 1) & 0xFFULL);
+}
+
+NrfUpdate_t NrfNodes::update(const RadioFrame_t &frame, uint8_t pipe, const OutSensorData_t &data,
+                             const SampleStamp_t &stamp, bool rpd)
+{
+  const uint8_t node = frame.node;
+  if (node >= NRF_MAX_NODES)
+    return NRF_UPDATE_BAD_NODE;
+
+  const TickType_t now = xTaskGetTickCount();
+  portENTER_CRITICAL(&s_mux);
+  NrfNode_t &n = s_nodes[node];
+  if (n.active && n.has_seq && frame.has_seq)
+  {
+    // беззнаковая разность порядковых номеров корректна и при переполнении
+    const uint16_t gap = static_cast<uint16_t>(frame.seq - n.last_seq);
+    if (gap == 0)
+    {
+      // узел не получил подтверждение и повторил пакет: интервал и данные не меняются
+      n.duplicates++;
+      portEXIT_CRITICAL(&s_mux);
+      return NRF_UPDATE_DUPLICATE;
+    }
+    if (gap <= NRF_SEQ_MAX_GAP)
+      n.lost += gap - 1;
+    else
+      n.restarts++;
+  }
+  if (n.active)
+  {
+    n.interval_ms = (now - n.last_tick) * portTICK_PERIOD_MS; // беззнаковая разность корректна и при переполнении
+    n.interval_ewma.push(n.interval_ms);
+    if (n.interval_ms > n.max_interval)
+      n.max_interval = n.interval_ms;
+  }
+  else
+  {
+    n.active = true;
+    s_active++;
+  }
+  n.last = data;
+  n.stamp = stamp;
+  n.last_tick = now;
+  n.pipe = pipe;
+  n.version = frame.version;
+  n.last_seq = frame.seq;
+  n.has_seq = frame.has_seq;
+  n.packets++;
+  n.samples += frame.count;
+  n.retries += frame.retries;
+  if (rpd)
+    n.rpd_strong++;
+  portEXIT_CRITICAL(&s_mux);
+  return NRF_UPDATE_OK;
+}
+
+bool NrfNodes::get(uint8_t node, NrfNode_t &out)
+{
+  if (node >= NRF_MAX_NODES)
+    return false;
+  portENTER_CRITICAL(&s_mux);
+  out = s_nodes[node];
+  portEXIT_CRITICAL(&s_mux);
+  return out.active;
+}
+
+uint8_t NrfNodes::active_count()
+{
+  portENTER_CRITICAL(&s_mux);
+  const uint8_t count = s_active;
+  portEXIT_CRITICAL(&s_mux);
+  return count;
+}
+
+void NrfNodes::log_stats()
+{
+  const TickType_t now = xTaskGetTickCount();
+  ESP_LOGI(TAG, "active nodes: %u/%u", active_count(), NRF_MAX_NODES);
+  for (uint8_t i = 0; i < NRF_MAX_NODES; ++i)
+  {
+    NrfNode_t n;
+    if (!get(i, n))
+      continue;
+    ESP_LOGI(TAG, "[node %u] pipe=%u v%u seq=%d packets=%u samples=%u age=%us interval=%ums ewma=%ums max=%ums T=%.2f H=%.1f bat=%u%%",
+             i, n.pipe, n.version, n.has_seq ? n.last_seq : -1, n.packets, n.samples, static_cast<unsigned>((now - n.last_tick) * portTICK_PERIOD_MS / 1000),
+             n.interval_ms, n.interval_ewma.value(), n.max_interval, n.last.temperature, n.last.humidity, n.last.bat_charge);
+    const uint32_t sent = n.packets + n.lost;
+    ESP_LOGI(TAG, "[node %u] link: lost=%u (%.1f%%) dup=%u restarts=%u retries=%u rpd=%u%%",
+             i, n.lost, sent ? 100.0f * n.lost / sent : 0.0f, n.duplicates, n.restarts, n.retries,
+             n.packets ? 100 * n.rpd_strong / n.packets : 0);
+  }
+}
@@ -27,6 +27,9 @@ static constexpr const char *kKeyBotChatId = "bot_chat_id";
 static constexpr const char *kKeyLatitude = "latitude";
 static constexpr const char *kKeyLongitude = "longitude";
 static constexpr const char *kKeyGmtOffset = "gmt_offset";
+static constexpr const char *kKeySampleMin = "smp_min_sec";
+static constexpr const char *kKeySampleMax = "smp_max_sec";
+static constexpr const char *kKeyOutInterval = "out_intv_sec";
 
 // ---------------------------------------------------------------------------
 bool NvsCfg::load(PrjCfgData &cfg)
@@ -67,6 +70,9 @@ bool NvsCfg::load(PrjCfgData &cfg)
   readStr(kKeyLatitude, cfg.latitude, sizeof(cfg.latitude));
   readStr(kKeyLongitude, cfg.longitude, sizeof(cfg.longitude));
   readStr(kKeyGmtOffset, cfg.gmt_offset_sec, sizeof(cfg.gmt_offset_sec));
+  readStr(kKeySampleMin, cfg.sample_min_sec, sizeof(cfg.sample_min_sec));
+  readStr(kKeySampleMax, cfg.sample_max_sec, sizeof(cfg.sample_max_sec));
+  readStr(kKeyOutInterval, cfg.out_interval_sec, sizeof(cfg.out_interval_sec));
 
   prefs.end();
   ESP_LOGI(TAG, "Config loaded from NVS OK");
@@ -93,6 +99,9 @@ bool NvsCfg::save(const PrjCfgData &cfg)
   prefs.putString(kKeyLatitude, cfg.latitude);
   prefs.putString(kKeyLongitude, cfg.longitude);
   prefs.putString(kKeyGmtOffset, cfg.gmt_offset_sec);
+  prefs.putString(kKeySampleMin, cfg.sample_min_sec);
+  prefs.putString(kKeySampleMax, cfg.sample_max_sec);
+  prefs.putString(kKeyOutInterval, cfg.out_interval_sec);
 
   prefs.end();
   ESP_LOGI(TAG, "Config saved to NVS OK");
@@ -1,10 +1,14 @@
 #include "openmeteo.h"
 #include "certs.h"
+#include "databus.h"
 #include "http_helpers.h"
 #include "netprocessor.h"
+#include "openmeteo_fb.h"
+#include "openmeteo_json.h"
 #include <ArduinoJson.h>
 #include <WiFi.h>
 #include <esp_log.h>
+#include <esp_timer.h>
 #include <type_traits>
 
 #define TAG "WEATHER"
@@ -13,9 +17,8 @@
 const char *ca_amazon_root = CERT_AMAZON_ROOT_CA1;
 const char *isrg_ca = CERT_ISRG_ROOT_X1;
 
-OpenMeteo::OpenMeteo(const String &latitude, const String &longitude,
-                     ProjectTasks_t send_to, QueueHandle_t (&queue_array_ref)[_PROTASK_NUM_])
-    : lat(latitude), lon(longitude), task_to_send(send_to), xQueues(queue_array_ref)
+OpenMeteo::OpenMeteo(const String &latitude, const String &longitude)
+    : lat(latitude), lon(longitude), use_flatbuffers(OPENMETEO_FLATBUFFERS)
 {
 }
 
@@ -24,46 +27,100 @@ OpenMeteo::~OpenMeteo()
   // nothing special to cleanup
 }
 
+/// @brief разбор ответа прогноза из потока
+struct MeteoParse_t
+{
+  OpenMeteoData *out;         // записи результата
+  DeserializationError error; // результат разбора
+  size_t body;                // получено байт тела
+  size_t peak;                // наибольший объём документа, байт
+};
+
+static bool meteo_body_handler(HttpBodyReader &body, void *ctx)
+{
+  MeteoParse_t &parse = *static_cast<MeteoParse_t *>(ctx);
+  PeakAllocator alloc;
+  JsonDocument json(&alloc);
+  parse.error = deserializeJson(json, body, DeserializationOption::Filter(meteo_filter()));
+  parse.body = body.received();
+  parse.peak = alloc.peak_bytes();
+  if (parse.error)
+    return false;
+  meteo_fill(json, parse.out);
+  return true;
+}
+
+/// @brief ответ FlatBuffers (одно сообщение с префиксом длины) целиком в куче
+struct MeteoFbBody_t
+{
+  uint8_t *data; // сообщение вместе с префиксом длины
+  size_t len;    // получено байт
+};
+
+// Сообщение небольшое: принимается целиком, значения затем читаются из него на месте
+static bool meteo_fb_body_handler(HttpBodyReader &body, void *ctx)
+{
+  MeteoFbBody_t &fb = *static_cast<MeteoFbBody_t *>(ctx);
+  uint32_t n = 0;
+  if (body.readBytes(reinterpret_cast<char *>(&n), sizeof(n)) != sizeof(n) || n < 8 || n > OPENMETEO_FB_MAX_SIZE)
+    return false;
+  fb.data = static_cast<uint8_t *>(malloc(sizeof(n) + n));
+  if (!fb.data)
+    return false;
+  memcpy(fb.data, &n, sizeof(n));
+  fb.len = sizeof(n) + body.readBytes(reinterpret_cast<char *>(fb.data) + sizeof(n), n);
+  return fb.len == sizeof(n) + n;
+}
+
 bool OpenMeteo::process_meteo_data()
 {
-  bool ret = false;
-  bool http_error = false;
   size_t sent_cnt = 0; // счетчик успешно отправленных записей
-  JsonDocument json;
-  auto deserializeError = deserializeJson(json, "{}"); // инициализация пустым JSON
+  // Use a function-local static buffer to avoid heap fragmentation
+  static OpenMeteoData tmp_buf[_METEO_DATA_NUM_];
+  OpenMeteoData *tmp = tmp_buf;
+  MeteoParse_t parse = {tmp, DeserializationError::Ok, 0, 0};
+  bool ok = false;
 
   if (1) // для экономии стека
   {
-#if 0
-    String serverPath = "http://api.open-meteo.com/v1/forecast?latitude=" + lat + "&longitude=" + lon + "&current=weather_code,temperature_2m,precipitation,wind_speed_10m,wind_direction_10m,relative_humidity_2m,surface_pressure&daily=temperature_2m_max,temperature_2m_min,precipitation_sum,precipitation_probability_max,wind_speed_10m_max,wind_direction_10m_dominant,weather_code&forecast_days=3&wind_speed_unit=ms&timezone=Europe/Moscow&models=icon_seamless";
-    tring weather_str = send_HTTP_GET_request(serverPath.c_str());
-#else
-    String serverPath = "https://api.open-meteo.com/v1/forecast?latitude=" + lat + "&longitude=" + lon + "&current=weather_code,temperature_2m,precipitation,wind_speed_10m,wind_direction_10m,relative_humidity_2m,surface_pressure&daily=temperature_2m_max,temperature_2m_min,precipitation_sum,precipitation_probability_max,wind_speed_10m_max,wind_direction_10m_dominant,weather_code&forecast_days=3&wind_speed_unit=ms&timezone=Europe/Moscow&models=icon_seamless";
-    String weather_str = "{}";
-    weather_str = send_HTTPS_GET_request(serverPath.c_str(), isrg_ca);
-#endif
-    http_error = weather_str.equals("{}");
-    deserializeError = deserializeJson(json, weather_str);
+    const String serverPath = "https://api.open-meteo.com/v1/forecast?latitude=" + lat + "&longitude=" + lon + OPENMETEO_FORECAST_QUERY;
+    bool fb_failed = false;
+    if (use_flatbuffers)
+    {
+      // Двоичный ответ: меньше байт через TLS, значения читаются из буфера без разбора
+      MeteoFbBody_t fb = {nullptr, 0};
+      const int64_t started = esp_timer_get_time();
+      const bool received =
+          send_HTTPS_GET_stream((serverPath + "&format=flatbuffers").c_str(), isrg_ca, meteo_fb_body_handler, &fb);
+      const int64_t decoded = esp_timer_get_time();
+      ok = received && meteo_fb_fill(fb.data, fb.len, tmp);
+      ESP_LOGI(TAG, "Meteo FlatBuffers response %u B received in %lld ms, decoded in %lld us%s", fb.len,
+               (decoded - started) / 1000, esp_timer_get_time() - decoded, ok ? "" : " (failed)");
+      free(fb.data);
+      fb_failed = !ok;
+    }
+    if (!ok)
+    {
+      // Ответ разбирается прямо из сокета: ни тело целиком, ни полный документ в памяти не держатся
+      const int64_t started = esp_timer_get_time();
+      ok = send_HTTPS_GET_stream(serverPath.c_str(), isrg_ca, meteo_body_handler, &parse);
+      ESP_LOGI(TAG, "Meteo response %u B received and parsed in %lld ms, JSON document peak %u B", parse.body,
+               (esp_timer_get_time() - started) / 1000, parse.peak);
+    }
+    // JSON получен, а двоичный ответ нет — сервис не отдаёт FlatBuffers или схема изменилась
+    if (fb_failed && ok)
+    {
+      ESP_LOGW(TAG, "FlatBuffers response unusable, switching to JSON until restart");
+      use_flatbuffers = false;
+    }
   }
 
-  if (!deserializeError && !http_error)
+  if (ok)
   {
-    // Use a function-local static buffer to avoid heap fragmentation
-    static OpenMeteoData tmp_buf[_METEO_DATA_NUM_];
-    OpenMeteoData *tmp = tmp_buf;
-    // Fill temporary array while JSON still available
     for (auto i = 0; i < _METEO_DATA_NUM_; ++i)
     {
       if (i == METEO_DATA_CURRENT)
       {
-        tmp[i].index = METEO_DATA_CURRENT;
-        tmp[i].weather_code = json["current"]["weather_code"].as<int>();
-        tmp[i].temperature = json["current"]["temperature_2m"].as<float>();
-        tmp[i].pressure = json["current"]["surface_pressure"].as<int>();
-        tmp[i].relative_humidity = json["current"]["relative_humidity_2m"].as<int>();
-        tmp[i].wind_speed = json["current"]["wind_speed_10m"].as<float>();
-        tmp[i].wind_direction = json["current"]["wind_direction_10m"].as<int>();
-
         ESP_LOGI(TAG, "Tmp CURRENT: index=%d", tmp[i].index);
         ESP_LOGI(TAG, "Tmp CURRENT: weather_code=%d", tmp[i].weather_code);
         ESP_LOGI(TAG, "Tmp CURRENT: temperature=%.2f", tmp[i].temperature);
@@ -78,30 +135,6 @@ bool OpenMeteo::process_meteo_data()
       }
       else
       {
-        tmp[i].index = static_cast<OpenMeteoDataIndex_t>(i);
-        tmp[i].weather_code = json["daily"]["weather_code"][i - 1].as<int>();
-        tmp[i].temperature = json["daily"]["temperature_2m_max"][i - 1].as<float>();
-        tmp[i].temperature_max = json["daily"]["temperature_2m_max"][i - 1].as<float>();
-        tmp[i].temperature_min = json["daily"]["temperature_2m_min"][i - 1].as<float>();
-        tmp[i].precipitation = json["daily"]["precipitation_sum"][i - 1].as<float>();
-        tmp[i].wind_speed = json["daily"]["wind_speed_10m_max"][i - 1].as<float>();
-        tmp[i].wind_direction = json["daily"]["wind_direction_10m_dominant"][i - 1].as<int>();
-        const char *srcDate = json["daily"]["time"][i - 1].as<const char *>();
-        if (srcDate && strlen(srcDate) >= 10)
-        {
-          char dateChars[11] = {0};
-          int year = atoi(srcDate);
-          int month = atoi(srcDate + 5);
-          int day = atoi(srcDate + 8);
-          snprintf(dateChars, sizeof(dateChars), "%02d-%02d-%04d", day, month, year);
-          strncpy(tmp[i].date, dateChars, sizeof(tmp[i].date) - 1);
-          tmp[i].date[sizeof(tmp[i].date) - 1] = '\0';
-        }
-        else
-        {
-          tmp[i].date[0] = '\0';
-        }
-
         ESP_LOGI(TAG, "Tmp DAILY[%d]: index=%d", static_cast<int>(tmp[i].index), static_cast<int>(tmp[i].index));
         ESP_LOGI(TAG, "Tmp DAILY[%d]: date=%s", static_cast<int>(tmp[i].index), (tmp[i].date[0] ? tmp[i].date : "N/A"));
         ESP_LOGI(TAG, "Tmp DAILY[%d]: weather_code=%d", static_cast<int>(tmp[i].index), tmp[i].weather_code);
@@ -116,45 +149,24 @@ bool OpenMeteo::process_meteo_data()
       }
     }
 
-    // Free JSON resources before sending to queue to reduce memory usage
-    json.clear();
-
-    // Now send items to the queue — create individual heap copies for the receiver
+    // Now publish items to the data bus — one pooled sample per record for all subscribers
     for (auto i = 0; i < _METEO_DATA_NUM_; ++i)
     {
-      OpenMeteoData *payload = new (std::nothrow) OpenMeteoData;
-      if (!payload)
-      {
-        ESP_LOGE(TAG, "Failed to allocate OpenMeteoData for queue item %d", i);
-        continue;
-      }
-
-      *payload = tmp[i];
-
-      QueDataItem_t qitem;
-      qitem.type = QUE_DATATYPE_METEO;
-      qitem.data = payload;
-
-      // ESP_LOGI(TAG, "   Heap largest free block before send: %d", heap_caps_get_largest_free_block(MALLOC_CAP_8BIT));
-
-      if (pdPASS == xQueueSend(this->xQueues[task_to_send], &qitem, pdMS_TO_TICKS(100)))
+      if (DataBus::publish(QUE_DATATYPE_METEO, tmp[i]))
       {
         ++sent_cnt;
-        ESP_LOGI(TAG, "Meteo data has been sent to queue [task %d]...", task_to_send);
+        ESP_LOGI(TAG, "Meteo data [%d] has been published...", i);
       }
       else
-      {
-        ESP_LOGE(TAG, "Failed to add meteo data to queue [task %d]!", task_to_send);
-        delete payload;
-      }
+        ESP_LOGE(TAG, "Failed to publish meteo data [%d]!", i);
     }
   }
   else
   {
-    if (http_error)
-      ESP_LOGE(TAG, "HTTP error when getting OpenMeteo data");
+    if (parse.error)
+      ESP_LOGE(TAG, "Failed to parse OpenMeteo JSON response: %s", parse.error.c_str());
     else
-      ESP_LOGE(TAG, "Failed to parse OpenMeteo JSON response: %s", deserializeError.c_str());
+      ESP_LOGE(TAG, "HTTP error when getting OpenMeteo data");
   }
 
   return (_METEO_DATA_NUM_ == sent_cnt) ? true : false;
@@ -241,34 +253,16 @@ bool OpenMeteo::process_geomagnetic_data()
 
   if (!http_error)
   {
-    GeoMagneticKpMax *payload = new GeoMagneticKpMax(); // !!! TODO удалить после обработки в получателе
+    ESP_LOGI(TAG, "Kp1: %f Kp2: %f Kp3: %f", kp.kpmax_today, kp.kpmax_tomorrow, kp.kpmax_tomorrow2);
+    ESP_LOGI(TAG, "Max free heap block after geomag fetch: %d", heap_caps_get_largest_free_block(MALLOC_CAP_8BIT));
 
-    if (payload)
+    if (DataBus::publish(QUE_DATATYPE_GEOMAGNETIC, kp))
     {
-      ESP_LOGI(TAG, "Kp1: %f Kp2: %f Kp3: %f", kp.kpmax_today, kp.kpmax_tomorrow, kp.kpmax_tomorrow2);
-      ESP_LOGI(TAG, "Max free heap block after geomag fetch: %d", heap_caps_get_largest_free_block(MALLOC_CAP_8BIT));
-
-      payload->kpmax_today = kp.kpmax_today;
-      payload->kpmax_tomorrow = kp.kpmax_tomorrow;
-      payload->kpmax_tomorrow2 = kp.kpmax_tomorrow2;
-
-      QueDataItem_t qitem;
-      qitem.type = QUE_DATATYPE_GEOMAGNETIC;
-      qitem.data = payload;
-
-      if (pdPASS == xQueueSend(this->xQueues[PROTASK_TFT], &qitem, pdMS_TO_TICKS(100)))
-      {
-        ESP_LOGI(TAG, "Geomagnetic data has been sent to queue [task %d]...", PROTASK_TFT);
-        ret = true;
-      }
-      else
-      {
-        ESP_LOGE(TAG, "Failed to add geomagnetic data to queue [task %d]!", PROTASK_TFT);
-        delete payload;
-      }
+      ESP_LOGI(TAG, "Geomagnetic data has been published...");
+      ret = true;
     }
     else
-      ESP_LOGE(TAG, "Failed to allocate GeoMagneticKpMax");
+      ESP_LOGE(TAG, "Failed to publish geomagnetic data!");
   }
   else
     ESP_LOGE(TAG, "HTTP error when getting geomagnetic data");
@@ -0,0 +1,60 @@
+#include "openmeteo_fb.h"
+#include "flatbuf.h"
+#include <time.h>
+
+// Номера полей схемы ответа Open-Meteo (weather_api.fbs)
+#define OM_FB_UTC_OFFSET 6 // WeatherApiResponse.utc_offset_seconds: int32
+#define OM_FB_CURRENT 9    // WeatherApiResponse.current: VariablesWithTime
+#define OM_FB_DAILY 10     // WeatherApiResponse.daily: VariablesWithTime
+#define OM_FB_TIME 0       // VariablesWithTime.time: int64, начало первого интервала (UTC)
+#define OM_FB_INTERVAL 2   // VariablesWithTime.interval: int32, шаг, с
+#define OM_FB_VARIABLES 3  // VariablesWithTime.variables: [VariableWithValues]
+#define OM_FB_VALUE 2      // VariableWithValues.value: float (current)
+#define OM_FB_VALUES 3     // VariableWithValues.values: [float] (daily)
+
+bool meteo_fb_fill(const uint8_t *data, size_t len, OpenMeteoData *out)
+{
+  const FbTable resp = FbTable::size_prefixed_root(data, len);
+  const FbTable current = resp.table(OM_FB_CURRENT);
+  const FbTable daily = resp.table(OM_FB_DAILY);
+  if (current.vector_size(OM_FB_VARIABLES) != _METEO_CUR_NUM_ || daily.vector_size(OM_FB_VARIABLES) != _METEO_DAY_NUM_)
+    return false;
+  for (uint8_t v = 0; v < _METEO_DAY_NUM_; ++v)
+  {
+    if (daily.vector_table(OM_FB_VARIABLES, v).vector_size(OM_FB_VALUES) < _METEO_DATA_NUM_ - 1)
+      return false;
+  }
+
+  auto cur = [&current](MeteoCurrentVar_t v)
+  { return current.vector_table(OM_FB_VARIABLES, v).get_f32(OM_FB_VALUE); };
+  auto day = [&daily](MeteoDailyVar_t v, int i)
+  { return daily.vector_table(OM_FB_VARIABLES, v).vector_f32(OM_FB_VALUES, i); };
+
+  out[METEO_DATA_CURRENT].index = METEO_DATA_CURRENT;
+  out[METEO_DATA_CURRENT].weather_code = static_cast<int>(cur(METEO_CUR_WEATHER_CODE));
+  out[METEO_DATA_CURRENT].temperature = cur(METEO_CUR_TEMPERATURE);
+  out[METEO_DATA_CURRENT].pressure = static_cast<int>(cur(METEO_CUR_PRESSURE));
+  out[METEO_DATA_CURRENT].relative_humidity = static_cast<int>(cur(METEO_CUR_HUMIDITY));
+  out[METEO_DATA_CURRENT].wind_speed = cur(METEO_CUR_WIND_SPEED);
+  out[METEO_DATA_CURRENT].wind_direction = static_cast<int>(cur(METEO_CUR_WIND_DIRECTION));
+
+  // Время суток — начало местных суток в UTC; дата — по местному времени
+  const int64_t first_day = daily.get_i64(OM_FB_TIME) + resp.get_i32(OM_FB_UTC_OFFSET);
+  const int32_t interval = daily.get_i32(OM_FB_INTERVAL, 86400);
+  for (int i = METEO_DATA_FORECAST_TODAY; i < _METEO_DATA_NUM_; ++i)
+  {
+    out[i].index = static_cast<OpenMeteoDataIndex_t>(i);
+    out[i].weather_code = static_cast<int>(day(METEO_DAY_WEATHER_CODE, i - 1));
+    out[i].temperature = day(METEO_DAY_TEMPERATURE_MAX, i - 1);
+    out[i].temperature_max = day(METEO_DAY_TEMPERATURE_MAX, i - 1);
+    out[i].temperature_min = day(METEO_DAY_TEMPERATURE_MIN, i - 1);
+    out[i].precipitation = day(METEO_DAY_PRECIPITATION, i - 1);
+    out[i].wind_speed = day(METEO_DAY_WIND_SPEED, i - 1);
+    out[i].wind_direction = static_cast<int>(day(METEO_DAY_WIND_DIRECTION, i - 1));
+    const time_t t = static_cast<time_t>(first_day + static_cast<int64_t>(interval) * (i - 1));
+    struct tm tm;
+    gmtime_r(&t, &tm);
+    strftime(out[i].date, sizeof(out[i].date), "%d-%m-%Y", &tm);
+  }
+  return true;
+}
@@ -0,0 +1,116 @@
+#include "openmeteo_json.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void *PeakAllocator::allocate(size_t size)
+{
+  Header_t *h = static_cast<Header_t *>(malloc(sizeof(Header_t) + size));
+  if (!h)
+    return nullptr;
+  h->size = size;
+  account(0, size);
+  return h + 1;
+}
+
+void PeakAllocator::deallocate(void *ptr)
+{
+  if (!ptr)
+    return;
+  Header_t *h = static_cast<Header_t *>(ptr) - 1;
+  current -= h->size;
+  free(h);
+}
+
+void *PeakAllocator::reallocate(void *ptr, size_t new_size)
+{
+  if (!ptr)
+    return allocate(new_size);
+  Header_t *h = static_cast<Header_t *>(ptr) - 1;
+  const size_t old_size = h->size;
+  h = static_cast<Header_t *>(realloc(h, sizeof(Header_t) + new_size));
+  if (!h)
+    return nullptr;
+  h->size = new_size;
+  account(old_size, new_size);
+  return h + 1;
+}
+
+void PeakAllocator::account(size_t old_size, size_t new_size)
+{
+  current = current - old_size + new_size;
+  if (current > peak)
+    peak = current;
+}
+
+const JsonDocument &meteo_filter()
+{
+  static JsonDocument filter;
+  if (filter.isNull())
+  {
+    JsonObject current = filter["current"].to<JsonObject>();
+    current["weather_code"] = true;
+    current["temperature_2m"] = true;
+    current["surface_pressure"] = true;
+    current["relative_humidity_2m"] = true;
+    current["wind_speed_10m"] = true;
+    current["wind_direction_10m"] = true;
+    JsonObject daily = filter["daily"].to<JsonObject>();
+    daily["time"] = true;
+    daily["weather_code"] = true;
+    daily["temperature_2m_max"] = true;
+    daily["temperature_2m_min"] = true;
+    daily["precipitation_sum"] = true;
+    daily["wind_speed_10m_max"] = true;
+    daily["wind_direction_10m_dominant"] = true;
+  }
+  return filter;
+}
+
+// Каждый массив и объект ищется в документе один раз
+void meteo_fill(const JsonDocument &json, OpenMeteoData *tmp)
+{
+  JsonObjectConst current = json["current"];
+  tmp[METEO_DATA_CURRENT].index = METEO_DATA_CURRENT;
+  tmp[METEO_DATA_CURRENT].weather_code = current["weather_code"].as<int>();
+  tmp[METEO_DATA_CURRENT].temperature = current["temperature_2m"].as<float>();
+  tmp[METEO_DATA_CURRENT].pressure = current["surface_pressure"].as<int>();
+  tmp[METEO_DATA_CURRENT].relative_humidity = current["relative_humidity_2m"].as<int>();
+  tmp[METEO_DATA_CURRENT].wind_speed = current["wind_speed_10m"].as<float>();
+  tmp[METEO_DATA_CURRENT].wind_direction = current["wind_direction_10m"].as<int>();
+
+  JsonObjectConst daily = json["daily"];
+  JsonArrayConst time = daily["time"];
+  JsonArrayConst weather_code = daily["weather_code"];
+  JsonArrayConst temperature_max = daily["temperature_2m_max"];
+  JsonArrayConst temperature_min = daily["temperature_2m_min"];
+  JsonArrayConst precipitation = daily["precipitation_sum"];
+  JsonArrayConst wind_speed = daily["wind_speed_10m_max"];
+  JsonArrayConst wind_direction = daily["wind_direction_10m_dominant"];
+  for (int i = METEO_DATA_FORECAST_TODAY; i < _METEO_DATA_NUM_; ++i)
+  {
+    tmp[i].index = static_cast<OpenMeteoDataIndex_t>(i);
+    tmp[i].weather_code = weather_code[i - 1].as<int>();
+    tmp[i].temperature = temperature_max[i - 1].as<float>();
+    tmp[i].temperature_max = temperature_max[i - 1].as<float>();
+    tmp[i].temperature_min = temperature_min[i - 1].as<float>();
+    tmp[i].precipitation = precipitation[i - 1].as<float>();
+    tmp[i].wind_speed = wind_speed[i - 1].as<float>();
+    tmp[i].wind_direction = wind_direction[i - 1].as<int>();
+    const char *srcDate = time[i - 1].as<const char *>();
+    if (srcDate && strlen(srcDate) >= 10)
+    {
+      char dateChars[11] = {0};
+      int year = atoi(srcDate);
+      int month = atoi(srcDate + 5);
+      int day = atoi(srcDate + 8);
+      snprintf(dateChars, sizeof(dateChars), "%02d-%02d-%04d", day, month, year);
+      strncpy(tmp[i].date, dateChars, sizeof(tmp[i].date) - 1);
+      tmp[i].date[sizeof(tmp[i].date) - 1] = '\0';
+    }
+    else
+    {
+      tmp[i].date[0] = '\0';
+    }
+  }
+}
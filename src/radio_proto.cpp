@@ -0,0 +1,167 @@
+#include "radio_proto.h"
+#include <math.h>
+#include <string.h>
+
+static_assert(RADIO_HEADER_SIZE + RADIO_MAX_SAMPLES * RADIO_SAMPLE_SIZE + 1 == RADIO_PAYLOAD_SIZE,
+              "Radio frame layout must fill the 32-byte payload exactly");
+
+static inline uint16_t get_u16(const uint8_t *p)
+{
+  return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+static inline void put_u16(uint8_t *p, uint16_t v)
+{
+  p[0] = static_cast<uint8_t>(v);
+  p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+static inline uint32_t get_u32(const uint8_t *p)
+{
+  return static_cast<uint32_t>(get_u16(p)) | (static_cast<uint32_t>(get_u16(p + 2)) << 16);
+}
+
+static inline void put_u32(uint8_t *p, uint32_t v)
+{
+  put_u16(p, static_cast<uint16_t>(v));
+  put_u16(p + 2, static_cast<uint16_t>(v >> 16));
+}
+
+// Округление с насыщением до диапазона целевого типа
+static inline int32_t round_clamp(float v, int32_t lo, int32_t hi)
+{
+  const float r = roundf(v);
+  return (r < lo) ? lo : (r > hi) ? hi : static_cast<int32_t>(r);
+}
+
+uint8_t RadioProto::crc8(const uint8_t *data, size_t len)
+{
+  uint8_t crc = 0x00;
+  for (size_t i = 0; i < len; ++i)
+  {
+    crc ^= data[i];
+    for (int b = 0; b < 8; ++b)
+      crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ 0x07) : static_cast<uint8_t>(crc << 1);
+  }
+  return crc;
+}
+
+bool RadioProto::encode(const RadioFrame_t &frame, uint8_t out[RADIO_PAYLOAD_SIZE])
+{
+  if (frame.count == 0 || frame.count > RADIO_MAX_SAMPLES)
+    return false;
+
+  memset(out, 0, RADIO_PAYLOAD_SIZE);
+  out[0] = RADIO_MAGIC;
+  out[1] = RADIO_VERSION;
+  out[2] = frame.node;
+  put_u16(&out[3], frame.seq);
+  out[5] = frame.battery;
+  out[6] = static_cast<uint8_t>(frame.count | ((frame.retries > RADIO_MAX_RETRIES ? RADIO_MAX_RETRIES : frame.retries) << 4));
+  for (uint8_t i = 0; i < frame.count; ++i)
+  {
+    uint8_t *p = &out[RADIO_HEADER_SIZE + i * RADIO_SAMPLE_SIZE];
+    const RadioSample_t &s = frame.samples[i];
+    put_u16(&p[0], s.age_s);
+    put_u16(&p[2], static_cast<uint16_t>(s.temperature_centi));
+    put_u16(&p[4], s.humidity_centi);
+    put_u16(&p[6], s.pressure_dhpa);
+  }
+  out[RADIO_PAYLOAD_SIZE - 1] = crc8(out, RADIO_PAYLOAD_SIZE - 1);
+  return true;
+}
+
+RadioDecode_t RadioProto::decode(const uint8_t *buf, size_t len, uint8_t legacy_node, RadioFrame_t &out)
+{
+  memset(&out, 0, sizeof(out));
+
+  // Версия 2: magic, версия и CRC
+  if (len >= RADIO_PAYLOAD_SIZE && buf[0] == RADIO_MAGIC && buf[1] == RADIO_VERSION)
+  {
+    if (crc8(buf, RADIO_PAYLOAD_SIZE - 1) != buf[RADIO_PAYLOAD_SIZE - 1])
+      return RADIO_DECODE_BAD_CRC;
+    out.version = RADIO_VERSION;
+    out.node = buf[2];
+    out.seq = get_u16(&buf[3]);
+    out.has_seq = true;
+    out.battery = buf[5];
+    out.count = buf[6] & 0x0F;
+    out.retries = buf[6] >> 4;
+    if (out.count == 0 || out.count > RADIO_MAX_SAMPLES)
+      return RADIO_DECODE_BAD_COUNT;
+    for (uint8_t i = 0; i < out.count; ++i)
+    {
+      const uint8_t *p = &buf[RADIO_HEADER_SIZE + i * RADIO_SAMPLE_SIZE];
+      RadioSample_t &s = out.samples[i];
+      s.age_s = get_u16(&p[0]);
+      s.temperature_centi = static_cast<int16_t>(get_u16(&p[2]));
+      s.humidity_centi = get_u16(&p[4]);
+      s.pressure_dhpa = get_u16(&p[6]);
+    }
+    return RADIO_DECODE_OK;
+  }
+
+  // Версия 1: float температура, float влажность, uint16 давление (гПа), uint16 заряд
+  if (len < RADIO_LEGACY_SIZE)
+    return RADIO_DECODE_SHORT;
+
+  float temperature, humidity;
+  memcpy(&temperature, &buf[0], sizeof(temperature));
+  memcpy(&humidity, &buf[4], sizeof(humidity));
+  if (!isfinite(temperature) || !isfinite(humidity) || fabsf(temperature) > 300.0f || humidity < -1.0f || humidity > 200.0f)
+    return RADIO_DECODE_BAD_VALUE;
+
+  out.version = 1;
+  out.node = legacy_node;
+  out.battery = static_cast<uint8_t>(get_u16(&buf[10]) > 255 ? 255 : get_u16(&buf[10]));
+  out.count = 1;
+  RadioSample_t &s = out.samples[0];
+  s.temperature_centi = static_cast<int16_t>(round_clamp(temperature * 100.0f, INT16_MIN, INT16_MAX));
+  s.humidity_centi = static_cast<uint16_t>(round_clamp(humidity * 100.0f, 0, UINT16_MAX));
+  s.pressure_dhpa = static_cast<uint16_t>(get_u16(&buf[8]) > 6553 ? UINT16_MAX : get_u16(&buf[8]) * 10);
+  return RADIO_DECODE_OK;
+}
+
+void RadioProto::encode_downlink(const RadioDownlink_t &dl, uint8_t out[RADIO_DL_SIZE])
+{
+  out[0] = RADIO_DL_MAGIC;
+  out[1] = RADIO_VERSION;
+  out[2] = dl.node;
+  out[3] = dl.flags;
+  out[4] = dl.channel;
+  put_u16(&out[5], dl.switch_in_s);
+  put_u16(&out[7], dl.ref_seq);
+  put_u32(&out[9], dl.ref_time);
+  put_u16(&out[13], dl.ref_ms);
+  put_u32(&out[15], dl.slot_ms);
+  put_u16(&out[19], dl.interval_s);
+  out[RADIO_DL_SIZE - 1] = crc8(out, RADIO_DL_SIZE - 1);
+}
+
+RadioDecode_t RadioProto::decode_downlink(const uint8_t *buf, size_t len, RadioDownlink_t &out)
+{
+  memset(&out, 0, sizeof(out));
+  if (len < RADIO_DL_SIZE || buf[0] != RADIO_DL_MAGIC || buf[1] != RADIO_VERSION)
+    return RADIO_DECODE_SHORT;
+  if (crc8(buf, RADIO_DL_SIZE - 1) != buf[RADIO_DL_SIZE - 1])
+    return RADIO_DECODE_BAD_CRC;
+  out.node = buf[2];
+  out.flags = buf[3];
+  out.channel = buf[4];
+  out.switch_in_s = get_u16(&buf[5]);
+  out.ref_seq = get_u16(&buf[7]);
+  out.ref_time = get_u32(&buf[9]);
+  out.ref_ms = get_u16(&buf[13]);
+  out.slot_ms = get_u32(&buf[15]);
+  out.interval_s = get_u16(&buf[19]);
+  return RADIO_DECODE_OK;
+}
+
+uint32_t RadioProto::slot_delay_ms(uint32_t interval_ms, uint8_t node, uint8_t slots, int64_t rx_ms)
+{
+  const int64_t interval = interval_ms;
+  const int64_t phase = interval * node / slots;
+  const int64_t earliest = rx_ms + interval + interval / 2;
+  const int64_t slot = phase + (earliest - phase + interval - 1) / interval * interval;
+  return static_cast<uint32_t>(slot - rx_ms);
+}
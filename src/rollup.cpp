@@ -0,0 +1,298 @@
+#include "rollup.h"
+#include "databus.h"
+#include "station_state.h"
+#include "tasks_common.h"
+#include <LittleFS.h>
+#include <esp_heap_caps.h>
+#include <esp_log.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const char *TAG = "ROLLUP";
+
+#define ROLLUP_CHUNK_SLOTS 32 // интервалов за одно копирование при сохранении (короткая критическая секция)
+
+// Длительность интервала и количество ячеек уровней
+static const uint32_t kPeriod[ROLLUP_LEVELS] = {60, 3600, 86400};
+static const uint32_t kSlots[ROLLUP_LEVELS] = {ROLLUP_MINUTE_SLOTS, ROLLUP_HOUR_SLOTS, ROLLUP_DAY_SLOTS};
+
+/// @brief заголовок файла уровня (за ним — ячейки, в конце — CRC-32 ячеек)
+struct RollupFileHeader_t
+{
+  uint32_t magic;   // ROLLUP_FILE_MAGIC
+  uint16_t version; // ROLLUP_FILE_VERSION
+  uint8_t channels; // TSLOG_CHANNELS
+  uint8_t level;    // уровень
+  uint32_t period;  // длительность интервала, с
+  uint32_t slots;   // количество ячеек
+};
+
+static RollupTier s_tiers[ROLLUP_LEVELS];
+static const RollupTier *const s_tier_ptrs[ROLLUP_LEVELS] = {&s_tiers[0], &s_tiers[1], &s_tiers[2]};
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED; // производители работают в разных задачах и на разных ядрах
+static bool s_ready = false;                               // уровни загружены, образцы учитываются
+static RollupStats_t s_stats{};
+
+// Образец шины → значения каналов (основной наружный узел выбирает StationState, он подключён раньше)
+static void rollup_bus_listener(const BusSample_t &sample)
+{
+  if (sample.topic != QUE_DATATYPE_IN_SENSOR_DATA && sample.topic != QUE_DATATYPE_OUT_SENSOR_DATA)
+    return;
+  if (!sample.stamp.wall)
+  {
+    portENTER_CRITICAL(&s_mux);
+    s_stats.no_time++;
+    portEXIT_CRITICAL(&s_mux);
+    return;
+  }
+  const uint32_t time = static_cast<uint32_t>(sample.stamp.wall);
+  if (sample.topic == QUE_DATATYPE_IN_SENSOR_DATA)
+  {
+    const HomeSensorData_t &d = sample.as<HomeSensorData_t>();
+    Rollup::add(time, TSLOG_IN_T, tslog_fixed(d.temperature_in, 10.0f));
+    Rollup::add(time, TSLOG_IN_H, d.humidity_in);
+    Rollup::add(time, TSLOG_IN_P, tslog_fixed(d.pressure_in, 10.0f));
+  }
+  else if (sample.source == StationState::out_node())
+  {
+    const OutSensorData_t &d = sample.as<OutSensorData_t>();
+    Rollup::add(time, TSLOG_OUT_T, tslog_fixed(d.temperature, 10.0f));
+    Rollup::add(time, TSLOG_OUT_H, tslog_fixed(d.humidity, 1.0f));
+    if (d.pressure)
+      Rollup::add(time, TSLOG_OUT_P, tslog_fixed(d.pressure, 10.0f));
+  }
+}
+
+static void rollup_path(uint8_t level, char *buf, size_t size, const char *ext)
+{
+  snprintf(buf, size, ROLLUP_DIR "/level%u.%s", level, ext);
+}
+
+bool Rollup::init()
+{
+  for (uint8_t i = 0; i < ROLLUP_LEVELS; ++i)
+  {
+    // ~170 КБ на все уровни — только PSRAM
+    RollupSlot_t *mem = static_cast<RollupSlot_t *>(heap_caps_malloc(sizeof(RollupSlot_t) * kSlots[i], MALLOC_CAP_SPIRAM));
+    if (!mem)
+    {
+      ESP_LOGE(TAG, "No PSRAM for level %u (%u bytes), rollups disabled", i, sizeof(RollupSlot_t) * kSlots[i]);
+      return false;
+    }
+    s_tiers[i].init(kPeriod[i], kSlots[i], mem);
+  }
+  if (!DataBus::add_listener(rollup_bus_listener))
+  {
+    ESP_LOGE(TAG, "Failed to attach rollups to data bus");
+    return false;
+  }
+  return true;
+}
+
+// Прочитать уровень из файла; false — файла нет, он другого формата или повреждён
+static bool rollup_load_level(uint8_t level)
+{
+  char path[32];
+  rollup_path(level, path, sizeof(path), "bin");
+  File f = LittleFS.open(path, "r");
+  if (!f)
+    return false;
+
+  RollupTier &tier = s_tiers[level];
+  RollupFileHeader_t h;
+  const size_t bytes = sizeof(RollupSlot_t) * tier.size();
+  uint32_t crc = 0;
+  bool ok = f.read(reinterpret_cast<uint8_t *>(&h), sizeof(h)) == sizeof(h) && h.magic == ROLLUP_FILE_MAGIC &&
+            h.version == ROLLUP_FILE_VERSION && h.channels == TSLOG_CHANNELS && h.level == level &&
+            h.period == tier.period() && h.slots == tier.size() &&
+            f.read(reinterpret_cast<uint8_t *>(tier.data()), bytes) == bytes &&
+            f.read(reinterpret_cast<uint8_t *>(&crc), sizeof(crc)) == sizeof(crc) &&
+            crc == tslog_crc32(0, reinterpret_cast<const uint8_t *>(tier.data()), bytes);
+  f.close();
+  if (!ok)
+  {
+    memset(tier.data(), 0, bytes);
+    ESP_LOGW(TAG, "Level %u file %s is invalid, starting empty", level, path);
+  }
+  tier.rescan();
+  return ok;
+}
+
+void Rollup::load()
+{
+  if (!s_tiers[0].data())
+    return;
+  bool loaded = true;
+  LITTLEFS_LOCK();
+  for (uint8_t i = 0; i < ROLLUP_LEVELS; ++i)
+    loaded = rollup_load_level(i) && loaded;
+  LITTLEFS_UNLOCK();
+
+  portENTER_CRITICAL(&s_mux);
+  s_stats.loaded = loaded;
+  s_ready = true;
+  portEXIT_CRITICAL(&s_mux);
+  ESP_LOGI(TAG, "Levels %s", loaded ? "restored" : "started empty");
+}
+
+// Записать уровень во временный файл порциями (копия порции — под критической секцией) и заменить им прежний
+static bool rollup_save_level(uint8_t level, RollupSlot_t *chunk)
+{
+  char tmp[32], path[32];
+  rollup_path(level, tmp, sizeof(tmp), "tmp");
+  rollup_path(level, path, sizeof(path), "bin");
+  File f = LittleFS.open(tmp, "w");
+  if (!f)
+    return false;
+
+  RollupTier &tier = s_tiers[level];
+  const RollupFileHeader_t h = {ROLLUP_FILE_MAGIC, ROLLUP_FILE_VERSION, TSLOG_CHANNELS, level, tier.period(), tier.size()};
+  bool ok = f.write(reinterpret_cast<const uint8_t *>(&h), sizeof(h)) == sizeof(h);
+  uint32_t crc = 0;
+  for (uint32_t i = 0; ok && i < tier.size(); i += ROLLUP_CHUNK_SLOTS)
+  {
+    const uint32_t n = tier.size() - i < ROLLUP_CHUNK_SLOTS ? tier.size() - i : ROLLUP_CHUNK_SLOTS;
+    portENTER_CRITICAL(&s_mux);
+    memcpy(chunk, tier.data() + i, sizeof(RollupSlot_t) * n);
+    portEXIT_CRITICAL(&s_mux);
+    const size_t bytes = sizeof(RollupSlot_t) * n;
+    crc = tslog_crc32(crc, reinterpret_cast<const uint8_t *>(chunk), bytes);
+    ok = f.write(reinterpret_cast<const uint8_t *>(chunk), bytes) == bytes;
+  }
+  ok = ok && f.write(reinterpret_cast<const uint8_t *>(&crc), sizeof(crc)) == sizeof(crc);
+  f.close();
+  if (!ok)
+  {
+    LittleFS.remove(tmp);
+    return false;
+  }
+  // прерванное сохранение оставляет прежний файл целым
+  LittleFS.remove(path);
+  return LittleFS.rename(tmp, path);
+}
+
+bool Rollup::save()
+{
+  if (!s_ready)
+    return false;
+  RollupSlot_t *chunk = static_cast<RollupSlot_t *>(malloc(sizeof(RollupSlot_t) * ROLLUP_CHUNK_SLOTS));
+  if (!chunk)
+    return false;
+
+  bool ok = true;
+  LITTLEFS_LOCK();
+  if (!LittleFS.exists(ROLLUP_DIR))
+    LittleFS.mkdir(ROLLUP_DIR);
+  for (uint8_t i = 0; i < ROLLUP_LEVELS; ++i)
+    ok = rollup_save_level(i, chunk) && ok;
+  LITTLEFS_UNLOCK();
+  free(chunk);
+
+  portENTER_CRITICAL(&s_mux);
+  if (ok)
+    s_stats.saves++;
+  else
+    s_stats.save_errors++;
+  portEXIT_CRITICAL(&s_mux);
+  if (!ok)
+    ESP_LOGE(TAG, "Failed to save levels to LittleFS");
+  return ok;
+}
+
+void Rollup::add(uint32_t time, uint8_t channel, int16_t value)
+{
+  if (channel >= TSLOG_CHANNELS || value == TSLOG_NO_VALUE)
+    return;
+  portENTER_CRITICAL(&s_mux);
+  if (s_ready)
+  {
+    s_stats.samples++;
+    for (uint8_t i = 0; i < ROLLUP_LEVELS; ++i)
+    {
+      if (!s_tiers[i].add(time, channel, value))
+        s_stats.stale++;
+    }
+  }
+  portEXIT_CRITICAL(&s_mux);
+}
+
+uint32_t Rollup::period(RollupLevel_t level)
+{
+  return level < ROLLUP_LEVELS ? kPeriod[level] : 0;
+}
+
+size_t Rollup::query(RollupLevel_t level, uint32_t from, uint32_t to, RollupSlot_t *out, size_t max)
+{
+  if (level >= ROLLUP_LEVELS || !s_tiers[level].data())
+    return 0;
+  const RollupTier &tier = s_tiers[level];
+  const uint32_t period = tier.period();
+  portENTER_CRITICAL(&s_mux);
+  const uint32_t last = tier.last();
+  portEXIT_CRITICAL(&s_mux);
+  if (!last)
+    return 0;
+
+  // перебираются только интервалы, которые ещё могут быть в кольце
+  const uint32_t oldest = last > (tier.size() - 1) * period ? last - (tier.size() - 1) * period : 0;
+  uint32_t t = from < oldest ? oldest : from - from % period;
+  size_t n = 0;
+  for (; t < to && t <= last && n < max; t += period)
+  {
+    portENTER_CRITICAL(&s_mux);
+    const RollupSlot_t *slot = tier.find(t);
+    if (slot)
+      out[n++] = *slot;
+    portEXIT_CRITICAL(&s_mux);
+  }
+  return n;
+}
+
+// Уровни захватываются на чтение одного интервала, как в query(): обход длинного диапазона
+// не держит производителей на другом ядре
+static void rollup_lock(bool lock)
+{
+  if (lock)
+    portENTER_CRITICAL(&s_mux);
+  else
+    portEXIT_CRITICAL(&s_mux);
+}
+
+void Rollup::summary(uint32_t from, uint32_t to, RollupSlot_t &out, uint32_t *reads)
+{
+  if (!s_tiers[0].data())
+  {
+    memset(&out, 0, sizeof(out));
+    return;
+  }
+  const uint32_t n = rollup_summary(s_tier_ptrs, ROLLUP_LEVELS, from, to, out, rollup_lock);
+  if (reads)
+    *reads = n;
+}
+
+void Rollup::get_stats(RollupStats_t &out)
+{
+  portENTER_CRITICAL(&s_mux);
+  out = s_stats;
+  portEXIT_CRITICAL(&s_mux);
+}
+
+void Rollup::log_stats()
+{
+  RollupStats_t st;
+  get_stats(st);
+  ESP_LOGI(TAG, "samples=%u no_time=%u stale=%u saves=%u errors=%u%s", st.samples, st.no_time, st.stale, st.saves,
+           st.save_errors, st.loaded ? " (restored)" : "");
+
+  // сводка за последние сутки по наружной температуре — пример запроса по уровням
+  const uint32_t now = static_cast<uint32_t>(time(NULL));
+  RollupSlot_t day;
+  uint32_t reads = 0;
+  summary(now - 86400, now, day, &reads);
+  const RollupAgg_t &t = day.ch[TSLOG_OUT_T];
+  if (t.count)
+    ESP_LOGI(TAG, "Out T 24h: min=%.1f max=%.1f avg=%.1f (%u values, %u aggregates read)", t.min / 10.0f,
+             t.max / 10.0f, t.sum / 10.0f / t.count, t.count, reads);
+}
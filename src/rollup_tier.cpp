@@ -0,0 +1,126 @@
+#include "rollup_tier.h"
+#include <string.h>
+
+void rollup_add(RollupAgg_t &agg, int16_t value)
+{
+  if (agg.count == UINT16_MAX)
+    return; // насыщение: среднее остаётся верным
+  if (agg.count == 0 || value < agg.min)
+    agg.min = value;
+  if (agg.count == 0 || value > agg.max)
+    agg.max = value;
+  agg.sum += value;
+  agg.count++;
+}
+
+void rollup_merge(RollupAgg_t &into, const RollupAgg_t &from)
+{
+  if (!from.count)
+    return;
+  if (!into.count || from.min < into.min)
+    into.min = from.min;
+  if (!into.count || from.max > into.max)
+    into.max = from.max;
+  const uint32_t count = static_cast<uint32_t>(into.count) + from.count;
+  if (count > UINT16_MAX)
+  {
+    // насыщение счётчика: сумма масштабируется, чтобы среднее не исказилось
+    const int64_t sum = static_cast<int64_t>(into.sum) + from.sum;
+    into.sum = static_cast<int32_t>(sum * UINT16_MAX / static_cast<int64_t>(count));
+    into.count = UINT16_MAX;
+    return;
+  }
+  into.sum += from.sum;
+  into.count = static_cast<uint16_t>(count);
+}
+
+void RollupTier::init(uint32_t period, uint32_t count, RollupSlot_t *mem)
+{
+  period_s = period;
+  slots = count;
+  storage = mem;
+  memset(storage, 0, sizeof(RollupSlot_t) * slots);
+  newest = 0;
+}
+
+void RollupTier::rescan()
+{
+  newest = 0;
+  for (uint32_t i = 0; i < slots; ++i)
+  {
+    if (storage[i].start > newest)
+      newest = storage[i].start;
+  }
+}
+
+bool RollupTier::holds(uint32_t time) const
+{
+  return newest && time + (slots - 1) * period_s >= newest;
+}
+
+bool RollupTier::add(uint32_t time, uint8_t channel, int16_t value)
+{
+  const uint32_t start = time - time % period_s;
+  RollupSlot_t &slot = storage[(time / period_s) % slots];
+  if (slot.start != start)
+  {
+    if (start < slot.start)
+      return false;
+    memset(&slot, 0, sizeof(slot));
+    slot.start = start;
+    if (start > newest)
+      newest = start;
+  }
+  rollup_add(slot.ch[channel], value);
+  return true;
+}
+
+const RollupSlot_t *RollupTier::find(uint32_t time) const
+{
+  const uint32_t start = time - time % period_s;
+  const RollupSlot_t &slot = storage[(time / period_s) % slots];
+  return slot.start == start && start ? &slot : nullptr;
+}
+
+uint32_t rollup_summary(const RollupTier *const *tiers, size_t count, uint32_t from, uint32_t to, RollupSlot_t &out,
+                        RollupLock_t lock)
+{
+  memset(&out, 0, sizeof(out));
+  out.start = from;
+  uint32_t reads = 0;
+  const uint32_t base = tiers[0]->period();
+  for (uint32_t t = from - from % base; t < to;)
+  {
+    if (lock)
+      lock(true);
+    // самый крупный уровень, интервал которого начинается в t и целиком внутри [from, to)
+    size_t level = count;
+    while (--level > 0)
+    {
+      const uint32_t p = tiers[level]->period();
+      if (t % p == 0 && t >= from && to - t >= p)
+        break;
+    }
+    // интервал вытеснен из кольца мелкого уровня — край берётся из более крупного уровня целиком
+    while (level + 1 < count && !tiers[level]->holds(t))
+      level++;
+    const RollupSlot_t *found = tiers[level]->find(t);
+    RollupSlot_t slot;
+    if (found)
+      slot = *found; // копия: ячейку может обновить производитель после освобождения
+    if (lock)
+      lock(false);
+    reads++;
+    if (found)
+    {
+      for (uint8_t c = 0; c < TSLOG_CHANNELS; ++c)
+        rollup_merge(out.ch[c], slot.ch[c]);
+    }
+    const uint32_t p = tiers[level]->period();
+    const uint32_t start = t - t % p;
+    if (start > UINT32_MAX - p)
+      break;
+    t = start + p;
+  }
+  return reads;
+}
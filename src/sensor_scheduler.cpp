@@ -0,0 +1,209 @@
+#include "sensor_scheduler.h"
+#include "latency_trace.h"
+#include "stack_monitor.h"
+#include "wakeup_monitor.h"
+#include <atomic>
+#include <esp_log.h>
+
+static const char *TAG = "SENSORS";
+
+/// @brief состояние драйвера в планировщике
+struct SensorSlot_t
+{
+  SensorDriver *driver;      // драйвер датчика
+  TickType_t due;            // срок следующего запуска (до run() — задержка первого измерения)
+  TickType_t started_due;    // срок, по которому запущено текущее преобразование
+  TickType_t ready;          // момент чтения результата запущенного преобразования
+  uint8_t busy_left;         // оставшиеся дочитывания незавершённого преобразования
+  bool converting;           // идёт преобразование
+  uint32_t hour_base;        // значение stats.samples в начале текущего часа
+  SensorDriverStats_t stats; // счётчики (пишет только задача планировщика, поля 32-битные)
+};
+
+static SensorSlot_t s_slots[SENSOR_SCHED_MAX_DRIVERS];
+static std::atomic<uint8_t> s_count{0};
+
+// Момент t наступил к моменту now (с учётом переполнения счётчика тиков)
+static inline bool tick_reached(TickType_t now, TickType_t t)
+{
+  return static_cast<int32_t>(now - t) >= 0;
+}
+
+bool SensorScheduler::add(SensorDriver &driver, uint32_t first_delay_ms)
+{
+  const uint8_t count = s_count.load(std::memory_order_relaxed);
+  if (count >= SENSOR_SCHED_MAX_DRIVERS)
+  {
+    ESP_LOGE(TAG, "Too many sensor drivers, %s not added", driver.name());
+    return false;
+  }
+  SensorSlot_t &slot = s_slots[count];
+  slot = SensorSlot_t();
+  slot.driver = &driver;
+  slot.due = pdMS_TO_TICKS(first_delay_ms);
+  s_count.store(count + 1, std::memory_order_release);
+  return true;
+}
+
+// Следующий срок — от срока текущего измерения по действующему периоду драйвера;
+// при отставании больше периода — от текущего момента
+static void schedule_next(SensorSlot_t &slot, TickType_t now)
+{
+  const TickType_t period = pdMS_TO_TICKS(slot.driver->period_ms());
+  slot.due = slot.started_due + period;
+  if (tick_reached(now, slot.due))
+    slot.due = now + period;
+}
+
+// Прочитать результат преобразования; незавершённое преобразование дочитывается через тик
+static void collect_slot(SensorSlot_t &slot, TickType_t now)
+{
+  const SampleStamp_t stamp = sample_stamp_now(); // момент получения образца
+  switch (slot.driver->collect(stamp))
+  {
+  case SENSOR_OK:
+    slot.stats.samples++;
+    slot.converting = false;
+    schedule_next(slot, now);
+    return;
+  case SENSOR_BUSY:
+    if (slot.busy_left)
+    {
+      slot.busy_left--;
+      slot.stats.busy++;
+      slot.ready = now + 1;
+      return;
+    }
+    break; // преобразование не завершилось за отведённое время — считать ошибкой
+  default:
+    break;
+  }
+  slot.stats.failures++;
+  slot.stats.present = false;
+  slot.converting = false;
+  slot.due = now + pdMS_TO_TICKS(SENSOR_SCHED_RETRY_MS);
+  ESP_LOGW(TAG, "%s read failed; will re-initialize", slot.driver->name());
+}
+
+// Найти отсутствующий датчик; false — повторить через SENSOR_SCHED_RETRY_MS
+static bool probe_slot(SensorSlot_t &slot, TickType_t now)
+{
+  slot.stats.probes++;
+  if (slot.driver->probe())
+  {
+    slot.stats.present = true;
+    ESP_LOGI(TAG, "%s initialized", slot.driver->name());
+    return true;
+  }
+  if (slot.stats.probes == 1)
+    ESP_LOGW(TAG, "%s not found; will retry periodically", slot.driver->name());
+  slot.due = now + pdMS_TO_TICKS(SENSOR_SCHED_RETRY_MS);
+  return false;
+}
+
+void SensorScheduler::run(const char *tag, uint16_t stack_size)
+{
+  StackMonitor_t stackMon;
+  stack_monitor_init(&stackMon, tag);
+  WakeupMonitor_t wakeMon;
+  wakeup_monitor_init(&wakeMon, tag);
+
+  const uint8_t count = s_count.load(std::memory_order_acquire);
+  TickType_t now = xTaskGetTickCount();
+  for (uint8_t i = 0; i < count; ++i)
+    s_slots[i].due += now;
+  TickType_t hour_start = now;
+
+  for (;;)
+  {
+    stack_monitor_sample(&stackMon, stack_size);
+    wakeup_monitor_tick(&wakeMon);
+    now = xTaskGetTickCount();
+
+    // Количество измерений за час
+    if (tick_reached(now, hour_start + pdMS_TO_TICKS(3600000)))
+    {
+      hour_start = now;
+      for (uint8_t i = 0; i < count; ++i)
+      {
+        s_slots[i].stats.last_hour = s_slots[i].stats.samples - s_slots[i].hour_base;
+        s_slots[i].hour_base = s_slots[i].stats.samples;
+      }
+    }
+
+    // Результаты завершённых преобразований читаются одной серией
+    for (uint8_t i = 0; i < count; ++i)
+      if (s_slots[i].converting && tick_reached(now, s_slots[i].ready))
+        collect_slot(s_slots[i], now);
+
+    // Запуск пачки: все датчики, срок которых наступает в пределах окна
+    const TickType_t batch_end = now + pdMS_TO_TICKS(SENSOR_SCHED_BATCH_MS);
+    TickType_t batch_ready = now;
+    uint32_t batch = 0; // маска датчиков, запущенных в этой пачке
+    for (uint8_t i = 0; i < count; ++i)
+    {
+      SensorSlot_t &slot = s_slots[i];
+      if (slot.converting || !tick_reached(batch_end, slot.due))
+        continue;
+      if (!slot.stats.present && !probe_slot(slot, now))
+        continue;
+
+      if (tick_reached(now, slot.due))
+      {
+        const uint32_t late_ms = (now - slot.due) * portTICK_PERIOD_MS;
+        if (late_ms > slot.stats.max_late_ms)
+          slot.stats.max_late_ms = late_ms;
+      }
+
+      slot.started_due = slot.due;
+      if (!slot.driver->start())
+      {
+        slot.stats.failures++;
+        slot.stats.present = false;
+        slot.due = now + pdMS_TO_TICKS(SENSOR_SCHED_RETRY_MS);
+        ESP_LOGW(TAG, "%s start failed; will re-initialize", slot.driver->name());
+        continue;
+      }
+      slot.converting = true;
+      slot.busy_left = SENSOR_SCHED_BUSY_RETRIES;
+      const TickType_t ready = now + pdMS_TO_TICKS(slot.driver->conversion_ms()) + 1;
+      if (!batch || tick_reached(ready, batch_ready))
+        batch_ready = ready;
+      batch |= 1UL << i;
+    }
+    // вся пачка читается после самого долгого преобразования — одно пробуждение на пачку
+    for (uint8_t i = 0; i < count; ++i)
+      if (batch & (1UL << i))
+        s_slots[i].ready = batch_ready;
+
+    // Сон до ближайшего события: чтения результата, срока запуска или конца часа
+    now = xTaskGetTickCount();
+    const TickType_t hour_end = hour_start + pdMS_TO_TICKS(3600000);
+    TickType_t wait = tick_reached(now, hour_end) ? 0 : hour_end - now;
+    for (uint8_t i = 0; i < count; ++i)
+    {
+      const TickType_t at = s_slots[i].converting ? s_slots[i].ready : s_slots[i].due;
+      const TickType_t left = tick_reached(now, at) ? 0 : at - now;
+      if (left < wait)
+        wait = left;
+    }
+    vTaskDelay(wait);
+  }
+}
+
+bool SensorScheduler::get_stats(uint8_t index, SensorDriverStats_t &stats)
+{
+  if (index >= s_count.load(std::memory_order_acquire))
+    return false;
+  stats = s_slots[index].stats;
+  return true;
+}
+
+void SensorScheduler::log_stats()
+{
+  SensorDriverStats_t st;
+  for (uint8_t i = 0; get_stats(i, st); ++i)
+    ESP_LOGI(TAG, "[%s] %s period=%ums samples=%u (%u/h) busy=%u failures=%u probes=%u max_late=%ums",
+             s_slots[i].driver->name(), st.present ? "present" : "absent", s_slots[i].driver->period_ms(),
+             st.samples, st.last_hour, st.busy, st.failures, st.probes, st.max_late_ms);
+}
@@ -0,0 +1,206 @@
+#include "station_state.h"
+#include <atomic>
+#include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <string.h>
+
+static const char *TAG = "STATE";
+
+// Состояние станции и его sequence lock (нечётное значение — идёт запись)
+static StationSnapshot_t s_state{};
+static std::atomic<uint32_t> s_seq{0};
+// Сериализация писателей (производители работают в разных задачах и на разных ядрах)
+static portMUX_TYPE s_write_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// Задачи, уведомляемые об обновлении состояния
+static TaskHandle_t s_watchers[STATE_MAX_WATCHERS];
+static std::atomic<uint8_t> s_watcher_count{0};
+
+static void state_bus_listener(const BusSample_t &sample)
+{
+  StationState::apply(sample);
+}
+
+void StationState::init()
+{
+  if (!DataBus::add_listener(state_bus_listener))
+    ESP_LOGE(TAG, "Failed to attach station state to data bus");
+}
+
+void StationState::apply(const BusSample_t &sample)
+{
+  StateField_t field;
+  switch (sample.topic)
+  {
+  case QUE_DATATYPE_METEO:
+    if (sample.as<OpenMeteoData>().index < 0 || sample.as<OpenMeteoData>().index >= _METEO_DATA_NUM_)
+      return;
+    field = STATE_FIELD_METEO;
+    break;
+  case QUE_DATATYPE_GEOMAGNETIC:
+    field = STATE_FIELD_GEOMAGNETIC;
+    break;
+  case QUE_DATATYPE_IN_SENSOR_DATA:
+    field = STATE_FIELD_IN_SENSOR;
+    break;
+  case QUE_DATATYPE_OUT_SENSOR_DATA:
+    field = STATE_FIELD_OUT_SENSOR;
+    break;
+  case QUE_DATATYPE_CITYNAME:
+    field = STATE_FIELD_CITYNAME;
+    break;
+  default:
+    return;
+  }
+
+  const TickType_t now = xTaskGetTickCount();
+
+  portENTER_CRITICAL(&s_write_mux);
+  // наружный датчик: узел с большим номером не вытесняет живой основной узел
+  if (field == STATE_FIELD_OUT_SENSOR && s_state.version[field] != 0 && !(s_state.restored & (1u << field)) &&
+      sample.source > s_state.out_node &&
+      (now - s_state.updated_tick[field]) < pdMS_TO_TICKS(STATE_OUT_NODE_STALE_MS))
+  {
+    portEXIT_CRITICAL(&s_write_mux);
+    return;
+  }
+  s_seq.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  switch (field)
+  {
+  case STATE_FIELD_METEO:
+  {
+    const OpenMeteoData &d = sample.as<OpenMeteoData>();
+    s_state.meteo[d.index] = d;
+    s_state.meteo_mask |= static_cast<uint8_t>(1u << d.index);
+    break;
+  }
+  case STATE_FIELD_GEOMAGNETIC:
+    s_state.geomag = sample.as<GeoMagneticKpMax>();
+    break;
+  case STATE_FIELD_IN_SENSOR:
+    s_state.in = sample.as<HomeSensorData_t>();
+    break;
+  case STATE_FIELD_OUT_SENSOR:
+    s_state.out = sample.as<OutSensorData_t>();
+    s_state.out_node = sample.source;
+    break;
+  case STATE_FIELD_CITYNAME:
+    memcpy(s_state.city, sample.c_str(), sizeof(s_state.city));
+    break;
+  default:
+    break;
+  }
+  s_state.version[field]++;
+  s_state.updated_tick[field] = now;
+  s_state.stamp[field] = sample.stamp;
+  s_state.restored &= static_cast<uint8_t>(~(1u << field));
+
+  s_seq.fetch_add(1, std::memory_order_release);
+  portEXIT_CRITICAL(&s_write_mux);
+
+  const uint8_t watchers = s_watcher_count.load(std::memory_order_acquire);
+  for (uint8_t i = 0; i < watchers; ++i)
+    xTaskNotify(s_watchers[i], NOTIFY_BIT_STATE, eSetBits);
+}
+
+void StationState::restore(const StationSnapshot_t &saved, uint8_t fields)
+{
+  const TickType_t now = xTaskGetTickCount();
+
+  portENTER_CRITICAL(&s_write_mux);
+  s_seq.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  for (uint8_t f = 0; f < _STATE_FIELD_NUM_; ++f)
+  {
+    if (!(fields & (1u << f)) || s_state.version[f] != 0) // свежие данные не заменяются
+      continue;
+    switch (f)
+    {
+    case STATE_FIELD_METEO:
+      memcpy(s_state.meteo, saved.meteo, sizeof(s_state.meteo));
+      s_state.meteo_mask = saved.meteo_mask;
+      break;
+    case STATE_FIELD_GEOMAGNETIC:
+      s_state.geomag = saved.geomag;
+      break;
+    case STATE_FIELD_IN_SENSOR:
+      s_state.in = saved.in;
+      break;
+    case STATE_FIELD_OUT_SENSOR:
+      s_state.out = saved.out;
+      s_state.out_node = saved.out_node;
+      break;
+    case STATE_FIELD_CITYNAME:
+      memcpy(s_state.city, saved.city, sizeof(s_state.city));
+      s_state.city[sizeof(s_state.city) - 1] = '\0';
+      break;
+    default:
+      break;
+    }
+    s_state.version[f] = 1;
+    s_state.updated_tick[f] = now;
+    s_state.stamp[f] = {0, saved.stamp[f].wall}; // монотонное время прошлой загрузки не имеет смысла
+    s_state.restored |= static_cast<uint8_t>(1u << f);
+  }
+  s_seq.fetch_add(1, std::memory_order_release);
+  portEXIT_CRITICAL(&s_write_mux);
+}
+
+void StationState::snapshot(StationSnapshot_t &out)
+{
+  for (;;)
+  {
+    const uint32_t begin = s_seq.load(std::memory_order_acquire);
+    if (begin & 1u)
+    {
+      taskYIELD(); // писатель в процессе обновления
+      continue;
+    }
+    memcpy(&out, &s_state, sizeof(out));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (s_seq.load(std::memory_order_relaxed) == begin)
+      return;
+  }
+}
+
+uint32_t StationState::version(StateField_t field)
+{
+  for (;;)
+  {
+    const uint32_t begin = s_seq.load(std::memory_order_acquire);
+    const uint32_t v = s_state.version[field];
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (!(begin & 1u) && s_seq.load(std::memory_order_relaxed) == begin)
+      return v;
+  }
+}
+
+uint8_t StationState::out_node()
+{
+  for (;;)
+  {
+    const uint32_t begin = s_seq.load(std::memory_order_acquire);
+    const uint8_t node = s_state.out_node;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (!(begin & 1u) && s_seq.load(std::memory_order_relaxed) == begin)
+      return node;
+  }
+}
+
+bool StationState::watch(TaskHandle_t task)
+{
+  bool ok = false;
+  portENTER_CRITICAL(&s_write_mux);
+  const uint8_t count = s_watcher_count.load(std::memory_order_relaxed);
+  if (count < STATE_MAX_WATCHERS)
+  {
+    s_watchers[count] = task;
+    s_watcher_count.store(count + 1, std::memory_order_release);
+    ok = true;
+  }
+  portEXIT_CRITICAL(&s_write_mux);
+  return ok;
+}
@@ -0,0 +1,86 @@
+#include "task_history.h"
+#include "clock_service.h"
+#include "boot_cache.h"
+#include "common.h"
+#include "rollup.h"
+#include "stack_monitor.h"
+#include "station_state.h"
+#include "tasks_common.h"
+#include "tslog.h"
+#include <esp_log.h>
+#include <time.h>
+
+static const char *TAG = "HISTORY";
+
+// Поле снимка получено и не устарело
+static bool history_fresh(const StationSnapshot_t &state, StateField_t field, TickType_t now)
+{
+  return state.version[field] != 0 && !(state.restored & (1u << field)) &&
+         now - state.updated_tick[field] < pdMS_TO_TICKS(MAX_METEO_VALID_INTERVAL_MS);
+}
+
+// Запись журнала из снимка состояния станции; молчащий датчик — TSLOG_NO_VALUE
+static void history_record(const StationSnapshot_t &state, uint32_t time, TsRecord_t &rec)
+{
+  const TickType_t now = xTaskGetTickCount();
+  rec.time = time;
+  for (uint8_t c = 0; c < TSLOG_CHANNELS; ++c)
+    rec.value[c] = TSLOG_NO_VALUE;
+  if (history_fresh(state, STATE_FIELD_IN_SENSOR, now))
+  {
+    rec.value[TSLOG_IN_T] = tslog_fixed(state.in.temperature_in, 10.0f);
+    rec.value[TSLOG_IN_H] = state.in.humidity_in;
+    rec.value[TSLOG_IN_P] = tslog_fixed(state.in.pressure_in, 10.0f);
+  }
+  if (history_fresh(state, STATE_FIELD_OUT_SENSOR, now))
+  {
+    rec.value[TSLOG_OUT_T] = tslog_fixed(state.out.temperature, 10.0f);
+    rec.value[TSLOG_OUT_H] = tslog_fixed(state.out.humidity, 1.0f);
+    rec.value[TSLOG_OUT_P] = state.out.pressure ? tslog_fixed(state.out.pressure, 10.0f) : TSLOG_NO_VALUE;
+  }
+}
+
+void task_history_exec(void *pvParameters)
+{
+  (void)pvParameters;
+
+  // Агрегаты восстанавливаются до первых образцов и сохраняются раз в час даже без журнала
+  Rollup::load();
+  const bool log_ok = TsLog::begin();
+  if (!log_ok)
+    ESP_LOGE(TAG, "History log is not available (no '%s' partition)", TSLOG_PARTITION_LABEL);
+
+  // Запись раз в минуту на границе минуты; без синхронизированного времени журнал не ведётся
+  ClockService::subscribe(xTaskGetCurrentTaskHandle(), NOTIFY_BIT_MINUTE | NOTIFY_BIT_HOUR);
+  // Каждое изменение состояния станции сохраняется для мгновенного показа после перезапуска
+  StationState::watch(xTaskGetCurrentTaskHandle());
+
+  StackMonitor_t stackMon;
+  stack_monitor_init(&stackMon, TAG);
+  static StationSnapshot_t state; // static — снимок крупный, не держим его на стеке задачи
+  for (;;)
+  {
+    uint32_t notified = 0;
+    xTaskNotifyWait(0, NOTIFY_BIT_MINUTE | NOTIFY_BIT_HOUR | NOTIFY_BIT_STATE, &notified, portMAX_DELAY);
+    stack_monitor_sample(&stackMon, PROTASK_HISTORY_STACK_SIZE);
+
+    if (notified & NOTIFY_BIT_STATE)
+      BootCache::capture();
+
+    if (log_ok && (notified & NOTIFY_BIT_MINUTE) && ClockService::is_synced())
+    {
+      StationState::snapshot(state);
+      TsRecord_t rec;
+      history_record(state, static_cast<uint32_t>((time(NULL) + 30) / 60 * 60), rec); // граница минуты
+      if (!TsLog::append(rec))
+        ESP_LOGW(TAG, "Record %u rejected (time did not advance)", rec.time);
+    }
+    if (notified & NOTIFY_BIT_HOUR)
+    {
+      if (log_ok)
+        TsLog::log_stats();
+      Rollup::save();
+      Rollup::log_stats();
+    }
+  }
+}
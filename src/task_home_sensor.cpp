@@ -1,142 +1,226 @@
 #include "task_home_sensor.h"
-#include "stack_monitor.h"
+#include "adaptive_sampler.h"
+#include "bme280.h"
+#include "config_service.h"
+#include "latency_trace.h"
+#include "sensor_scheduler.h"
 #include "tasks_common.h"
-#include <Adafruit_BME280.h>
+#include "virtual_source.h"
+#include <algorithm>
 #include <esp_log.h>
 
-Adafruit_BME280 bme; // датчик BME280 (температура, давление, влажность, I2C)
-
-void task_home_sensor_exec(void *pvParameters)
+static const char *TAG = "HOME_SENSOR";
+
+Bme280 bme; // датчик BME280 (температура, давление, влажность, I2C)
+
+// Настройки измерения: сглаживание аппаратным IIR-фильтром (T, P) и передискретизацией
+// вместо программного усреднения; фильтр x4 соответствует усреднению примерно
+// по 5 последним измерениям (скачок виден сразу на четверть, чего хватает адаптивному интервалу)
+#define HOME_SENSOR_OSRS_T BME280_OSRS_X2
+#define HOME_SENSOR_OSRS_P BME280_OSRS_X4
+#define HOME_SENSOR_OSRS_H BME280_OSRS_X4
+#define HOME_SENSOR_FILTER BME280_FILTER_X4
+
+#define HOME_SENSOR_PERIOD_MS 60000                                      // начальный период опроса BME280 (далее — адаптивный)
+#define HOME_SENSOR_START_DELAY_MS 2000                                  // задержка до первого измерения после запуска (BME280 готов через 2 мс)
+#define HOME_SENSOR_INTERVAL_FLOOR_S 10                                  // нижняя граница настраиваемого интервала, с
+#define HOME_SENSOR_INTERVAL_CEIL_S (MAX_METEO_VALID_INTERVAL_MS / 2000) // верхняя граница интервала, с (вдвое меньше срока устаревания данных на экране)
+
+// Пороги адаптивного интервала опроса: зона нечувствительности, быстрое изменение
+// (интервал сокращается), стабильность (интервал растёт). Величины — в единицах отсчёта.
+static const AdaptiveChannel_t kHomeAdaptive[] = {
+    {3, 100, 20}, // температура, 0.01 °C: быстро от 1 °C/ч, стабильно ниже 0.2 °C/ч
+    {5, 100, 30}, // давление, Па: быстро от 1 гПа/ч (шторм), стабильно ниже 0.3 гПа/ч
+    {5, 50, 10},  // влажность, 0.1 %: быстро от 5 %/ч, стабильно ниже 1 %/ч
+};
+static const char *const kHomeAdaptiveNames[] = {"T", "P", "H"};
+
+/**
+ * @brief Комнатный датчик BME280 в планировщике датчиков: принудительное измерение,
+ * публикация в топик QUE_DATATYPE_IN_SENSOR_DATA и адаптивный интервал опроса
+ */
+class HomeBme280Driver : public SensorDriver
 {
-  (void)pvParameters;
-  const char *TAG = "HOME_SENSOR";
-
-  // Попытаться инициализировать BME280 (обычно адрес 0x76 или 0x77)
-  bool found = false;
-  if (bme.begin(0x76))
-    found = true;
-  else if (bme.begin(0x77))
-    found = true;
+public:
+  HomeBme280Driver()
+      : SensorDriver("BME280", HOME_SENSOR_PERIOD_MS),
+        sampler(kHomeAdaptive, HOME_SENSOR_PERIOD_MS, HOME_SENSOR_PERIOD_MS, HOME_SENSOR_PERIOD_MS)
+  {
+  }
 
-  if (!found)
-    ESP_LOGW(TAG, "BME280 not found at 0x76/0x77; will retry periodically");
+  /** @brief Границы адаптивного интервала из конфигурации (sample_min_sec / sample_max_sec) */
+  void configure()
+  {
+    PrjCfgData cfg;
+    ConfigService::get(cfg, &cfg_version); // при первом запуске — значения по умолчанию
+    uint32_t min_s = strtoul(cfg.sample_min_sec, NULL, 10);
+    uint32_t max_s = strtoul(cfg.sample_max_sec, NULL, 10);
+    min_s = std::min<uint32_t>(std::max<uint32_t>(min_s, HOME_SENSOR_INTERVAL_FLOOR_S), HOME_SENSOR_INTERVAL_CEIL_S);
+    max_s = std::min<uint32_t>(std::max<uint32_t>(max_s, min_s), HOME_SENSOR_INTERVAL_CEIL_S);
+    sampler.set_limits(min_s * 1000, max_s * 1000);
+    set_period_ms(sampler.interval_ms());
+    ESP_LOGI(TAG, "Adaptive interval %u..%u s, start %u s", min_s, max_s, sampler.interval_ms() / 1000);
+  }
 
-  TickType_t xLastWakeTime = xTaskGetTickCount();
-  StackMonitor_t stackMon;
-  stack_monitor_init(&stackMon, TAG);
+  bool probe() override
+  {
+    // обычно адрес 0x76 или 0x77
+    bme.configure(HOME_SENSOR_OSRS_T, HOME_SENSOR_OSRS_P, HOME_SENSOR_OSRS_H, HOME_SENSOR_FILTER);
+    return bme.begin(BME280_ADDR_PRIMARY) || bme.begin(BME280_ADDR_SECONDARY);
+  }
 
-  vTaskDelay(20000 / portTICK_PERIOD_MS); // небольшая задержка перед началом работы
+  bool start() override
+  {
+    return bme.start();
+  }
 
-  for (;;)
+  uint32_t conversion_ms() const override
   {
-    // Sample stack high-water mark and handle logging via helper
-    stack_monitor_sample(&stackMon, PROTASK_HOME_SENSOR_STACK_SIZE);
+    return bme.measure_time_ms();
+  }
 
-    if (!found)
+  SensorResult_t collect(const SampleStamp_t &stamp) override
+  {
+    // статус и данные читаются одной транзакцией; read() == false и при незавершённом преобразовании
+    Bme280Reading_t reading;
+    if (!bme.read(reading))
+      return SENSOR_BUSY;
+
+    // Конфигурация сохранена после прошлого измерения — новые границы учитываются этим отсчётом
+    if (ConfigService::version() != cfg_version)
+      configure();
+
+    HomeSensorData_t payload;
+    payload.temperature_in = reading.temperature_c();
+    payload.pressure_in = reading.pressure_hpa();
+    payload.humidity_in = static_cast<uint8_t>((reading.humidity_q22_10 + 512) >> 10);
+
+    ESP_LOGI(TAG, "BME280 T=%.2f C P=%.2f hPa H=%u%% (filtered)",
+             payload.temperature_in, payload.pressure_in, payload.humidity_in);
+
+    // Адаптивный интервал: следующий срок планировщик посчитает по новому периоду
+    const int32_t values[] = {reading.temperature_centi, static_cast<int32_t>(reading.pressure_q24_8 >> 8),
+                              static_cast<int32_t>((reading.humidity_q22_10 * 10 + 512) >> 10)};
+    const uint32_t prev_ms = period_ms();
+    set_period_ms(sampler.update(values, stamp.mono_us));
+    if (period_ms() != prev_ms)
     {
-      // попытка повторной инициализации
-      if (bme.begin(0x76) || bme.begin(0x77))
-      {
-        found = true;
-        ESP_LOGI(TAG, "BME280 initialized");
-      }
-      else
-      {
-        vTaskDelay(pdMS_TO_TICKS(5000));
-        continue;
-      }
+      const int trig = sampler.triggered_by();
+      ESP_LOGI(TAG, "Interval %u s -> %u s (%s%s, dT=%d.%02d C/h dP=%d Pa/h dH=%d.%d %%/h)",
+               prev_ms / 1000, period_ms() / 1000, trig >= 0 ? "fast " : "stable",
+               trig >= 0 ? kHomeAdaptiveNames[trig] : "", sampler.rate_per_hour(0) / 100,
+               sampler.rate_per_hour(0) % 100, sampler.rate_per_hour(1), sampler.rate_per_hour(2) / 10,
+               sampler.rate_per_hour(2) % 10);
     }
 
-    // Буферы для усреднения последних HOME_SENSOR_AVG_SAMPLES измерений
-    static float temp_buf[HOME_SENSOR_AVG_SAMPLES] = {0.0f};
-    static float press_buf[HOME_SENSOR_AVG_SAMPLES] = {0.0f};
-    static uint8_t hum_buf[HOME_SENSOR_AVG_SAMPLES] = {0};
-    static int buf_pos = 0;
-    static int buf_count = 0;
-    static float sum_temp = 0.0f;
-    static float sum_press = 0.0f;
-    static int sum_hum = 0;
-
-    // Считывание с BME280 (текущее измерение)
-    float cur_t = bme.readTemperature();                              // C
-    float cur_p = bme.readPressure() / 100.0F;                        // hPa
-    uint8_t cur_h = static_cast<uint8_t>(roundf(bme.readHumidity())); // %
-
-    // Обновление сумм и буфера (циклический буфер длины 6)
-    if (buf_count < HOME_SENSOR_AVG_SAMPLES)
-    {
-      temp_buf[buf_pos] = cur_t;
-      press_buf[buf_pos] = cur_p;
-      hum_buf[buf_pos] = cur_h;
-      sum_temp += cur_t;
-      sum_press += cur_p;
-      sum_hum += cur_h;
-      buf_count++;
-    }
-    else
-    {
-      // вычесть старое, записать новое
-      sum_temp -= temp_buf[buf_pos];
-      sum_press -= press_buf[buf_pos];
-      sum_hum -= hum_buf[buf_pos];
-      temp_buf[buf_pos] = cur_t;
-      press_buf[buf_pos] = cur_p;
-      hum_buf[buf_pos] = cur_h;
-      sum_temp += cur_t;
-      sum_press += cur_p;
-      sum_hum += cur_h;
-    }
-    buf_pos = (buf_pos + 1) % HOME_SENSOR_AVG_SAMPLES;
+    // Публикуем значения в шину данных (один образец на всех подписчиков)
+    if (!DataBus::publish(QUE_DATATYPE_IN_SENSOR_DATA, payload, stamp))
+      ESP_LOGE(TAG, "Failed to publish home sensor data");
+    return SENSOR_OK;
+  }
 
-    // Вычислить усреднённые значения (за buf_count измерений, до 6)
-    float avg_t = sum_temp / (buf_count ? buf_count : 1);
-    float avg_p = sum_press / (buf_count ? buf_count : 1);
-    uint8_t avg_h = static_cast<uint8_t>(roundf(static_cast<float>(sum_hum) / (buf_count ? buf_count : 1)));
+private:
+  AdaptiveSampler<3> sampler; // адаптивный интервал по скорости изменения T, P, H
+  uint32_t cfg_version = 0;   // версия конфигурации, из которой взяты границы интервала
+};
 
-    ESP_LOGI(TAG, "BME280 cur T=%.2f C P=%.2f hPa H=%d%% avg(T,P,H) = %.2f C / %.2f hPa / %d%%",
-             cur_t, cur_p, cur_h, avg_t, avg_p, avg_h);
+static HomeBme280Driver home_bme; // комнатный BME280
 
-    // Формируем payload с усреднёнными значениями и отправляем в очередь
-    HomeSensorData_t *payload = new HomeSensorData_t(); // TODO удалить после приема !!!
-    if (!payload)
-    {
-      ESP_LOGE(TAG, "Failed to allocate HomeSensorData_t");
-      vTaskDelay(pdMS_TO_TICKS(5000));
-      continue;
-    }
-    payload->temperature_in = avg_t;
-    payload->pressure_in = avg_p;
-    payload->humidity_in = avg_h;
+#if VIRTUAL_SENSORS
+/**
+ * @brief Комнатный датчик из трассы (VIRTUAL_IN_TRACE, без файла — синтетическая трасса):
+ * публикация в тот же топик, период опроса — шаг трассы с учётом ускорения
+ */
+class VirtualHomeDriver : public SensorDriver
+{
+public:
+  VirtualHomeDriver()
+      : SensorDriver("virtual", HOME_SENSOR_PERIOD_MS),
+        synth(1, HOME_SENSOR_PERIOD_MS, 0, VIRTUAL_SYNTH_SEED), source(&synth), pending{}, has_pending(false)
+  {
+  }
 
-    QueDataItem_t qitem;
-    qitem.type = QUE_DATATYPE_IN_SENSOR_DATA;
-    qitem.data = payload;
+  bool probe() override
+  {
+    // файл открывается в задаче: к её запуску LittleFS смонтирована
+    LITTLEFS_LOCK();
+    static VirtualFileSource file(VIRTUAL_IN_TRACE);
+    LITTLEFS_UNLOCK();
+    if (file.ok())
+      source = &file;
+    ESP_LOGW(TAG, "Virtual home sensor: %s, speedup x%u", file.ok() ? VIRTUAL_IN_TRACE : "synthetic",
+             VIRTUAL_SPEEDUP);
+    return true;
+  }
 
-    if (pdPASS != xQueueSend(xQueue[PROTASK_TFT], &qitem, pdMS_TO_TICKS(100)))
-    {
-      ESP_LOGE(TAG, "Failed to send averaged home sensor data to TFT queue");
-      delete payload;
-    }
-    else
+  bool start() override
+  {
+    return true;
+  }
+
+  uint32_t conversion_ms() const override
+  {
+    return 0;
+  }
+
+  SensorResult_t collect(const SampleStamp_t &stamp) override
+  {
+    if (!has_pending && !next(pending))
+      return SENSOR_FAIL;
+    const VirtualSample_t s = pending;
+    has_pending = next(pending);
+    if (has_pending && pending.t_ms > s.t_ms)
+      set_period_ms(std::max<uint32_t>((pending.t_ms - s.t_ms) / VIRTUAL_SPEEDUP, 1));
+
+    HomeSensorData_t payload;
+    payload.temperature_in = s.temperature;
+    payload.pressure_in = s.pressure;
+    payload.humidity_in = static_cast<uint8_t>(std::min(std::max(s.humidity + 0.5f, 0.0f), 100.0f));
+    ESP_LOGI(TAG, "Virtual T=%.2f C P=%.2f hPa H=%u%%", payload.temperature_in, payload.pressure_in,
+             payload.humidity_in);
+    if (!DataBus::publish(QUE_DATATYPE_IN_SENSOR_DATA, payload, stamp))
+      ESP_LOGE(TAG, "Failed to publish home sensor data");
+    return SENSOR_OK;
+  }
+
+private:
+  // Следующее измерение трассы; в конце трассы — воспроизведение по кругу
+  bool next(VirtualSample_t &out)
+  {
+    LITTLEFS_LOCK();
+    bool ok = source->next(out);
+    if (!ok)
     {
-      // Also send a copy to MQTT publisher queue if present
-      HomeSensorData_t *payload_mqtt = new HomeSensorData_t();
-      if (payload_mqtt)
-      {
-        *payload_mqtt = *payload;
-        QueDataItem_t qitem_m;
-        qitem_m.type = QUE_DATATYPE_IN_SENSOR_DATA;
-        qitem_m.data = payload_mqtt;
-        if (pdPASS != xQueueSend(xQueue[PROTASK_NETWORKING], &qitem_m, pdMS_TO_TICKS(100)))
-        {
-          delete payload_mqtt;
-        }
-      }
+      source->rewind();
+      ok = source->next(out);
     }
-
-    // Интервал опроса 60 секунд
-    vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(60000));
+    LITTLEFS_UNLOCK();
+    return ok;
   }
 
+  VirtualSynthSource synth; // источник без файла трассы
+  VirtualSource *source;    // текущий источник
+  VirtualSample_t pending;  // следующее измерение (шаг трассы задаёт период опроса)
+  bool has_pending;         // pending прочитано
+};
+
+static VirtualHomeDriver home_virtual; // комнатный датчик из трассы
+#endif
+
+void task_home_sensor_exec(void *pvParameters)
+{
+  (void)pvParameters;
+
+  home_bme.configure();
+
+  // Все датчики опрашиваются планировщиком в этой задаче: новый датчик — это драйвер
+  // (SensorDriver), добавленный здесь, а не отдельная задача со своим стеком
+#if VIRTUAL_SENSORS
+  SensorScheduler::add(home_virtual, HOME_SENSOR_START_DELAY_MS);
+#else
+  SensorScheduler::add(home_bme, HOME_SENSOR_START_DELAY_MS);
+#endif
+  SensorScheduler::run(TAG, PROTASK_HOME_SENSOR_STACK_SIZE);
+
   vTaskDelete(NULL);
 }
@@ -0,0 +1,9 @@
+#include "task_i2c.h"
+#include "i2c_engine.h"
+
+void task_i2c_exec(void *pvParameters)
+{
+  (void)pvParameters;
+  I2cEngine::run(); // не возвращает управление
+  vTaskDelete(NULL);
+}
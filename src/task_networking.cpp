@@ -1,24 +1,42 @@
 #include "task_networking.h"
+#include "clock_service.h"
 #include "common.h"
+#include "config_api.h"
+#include "config_service.h"
+#include "history_api.h"
+#include "i2c_engine.h"
+#include "latency_trace.h"
 #include "netprocessor.h"
 #include "openmeteo.h"
+#include "sensor_scheduler.h"
 #include "stack_monitor.h"
+#include "station_state.h"
+#include "task_nrf24.h"
 #include "tasks_common.h"
+#include "wakeup_monitor.h"
 #include "webportal.h"
 #include <WiFi.h>
+#include <algorithm>
 #include <esp_log.h>
 #include <time.h>
 
-static NetProcessor net(xQueue); // объект NetProcessor, владеющий WebConfig, OpenMeteo и MqttSender
+static NetProcessor net; // объект NetProcessor, владеющий WebConfig, OpenMeteo и MqttSender
 
 static const char *TAG = "NETWORKING";
 
 // Interval for sending data to NarodMon (milliseconds)
 #define NARODMON_INTERVAL_MS (5 * 60 * 1000)
-// Last received OUT sensor data and timestamp (millis)
-static OutSensorData_t g_lastOutData{};
-static uint32_t g_lastOutDataMillis = 0;
+// Maximum sleep between MQTT client service calls (keep-alive, reconnect) (milliseconds)
+#define MQTT_LOOP_INTERVAL_MS 1000
 static TickType_t g_lastNarodmonTick = 0;
+static BusSubscriber g_busSub; // подписка задачи на данные датчиков (MQTT)
+
+// Сколько тиков осталось до истечения интервала, отсчитанного от `since` (0 — уже истёк)
+static TickType_t ticks_until(TickType_t since, TickType_t interval)
+{
+  const TickType_t elapsed = xTaskGetTickCount() - since;
+  return (elapsed >= interval) ? 0 : (interval - elapsed);
+}
 
 void task_networking_exec(void *pvParameters)
 {
@@ -38,8 +56,10 @@ void task_networking_exec(void *pvParameters)
     webConfig->process_autoconnect_or_config(false); // false = обычный режим, true = принудительный портал
   }
 
-  PrjCfgData cfg;
-  webConfig->get_config(cfg);
+  // Копия конфигурации задачи; при смене версии ConfigService перечитывается в основном цикле
+  static PrjCfgData cfg; // MqttSender хранит указатель на mqtt_server — копия живёт всё время работы задачи
+  uint32_t cfg_version = 0;
+  ConfigService::get(cfg, &cfg_version);
 
   // реализовать вычитывание конфигурации и установку координат в OpenMeteo
   if (1) // для освобождения стека
@@ -58,31 +78,39 @@ void task_networking_exec(void *pvParameters)
     net.NearestCityProcessing();
   }
 
-  TickType_t xLastWakeTime = xTaskGetTickCount();
+  // Локальный HTTP API выгрузки истории (сервер работает в своей задаче и переживает переподключения WiFi)
+  HistoryApi::start();
+  ConfigApi::attach(HistoryApi::server()); // изменение настроек без портала и перезагрузки
+
+  // Подписка на данные датчиков после подключения к сети
+  g_busSub.subscribe(QUE_DATATYPE_IN_SENSOR_DATA);
+  g_busSub.subscribe(QUE_DATATYPE_OUT_SENSOR_DATA);
+
   // Для логирования минимального остатка стека (high-water mark)
   TickType_t xLastStackLog = xTaskGetTickCount();
   StackMonitor_t stackMon;
   stack_monitor_init(&stackMon, "NETWORKING");
+  WakeupMonitor_t wakeMon;
+  wakeup_monitor_init(&wakeMon, "NETWORKING");
   // Установить время последнего запроса метео в прошлом, чтобы первый вызов произошёл немедленно
   TickType_t xLastMeteoTime = xTaskGetTickCount() - pdMS_TO_TICKS(METEO_POLL_INTERVAL_MS);
 
-  // Предыдущее локальное время для детекции смены даты (если время меняется — отправить запрос)
-  struct tm prev_timeinfo;
-  if (!getLocalTime(&prev_timeinfo))
-  {
-    // Если получить локальное время не удалось — обнулить структуру, сравнения будут работать позже
-    memset(&prev_timeinfo, 0, sizeof(prev_timeinfo));
-  }
+  // Смена даты приходит событием службы времени (если дата меняется — отправить запрос)
+  ClockService::subscribe(xTaskGetCurrentTaskHandle(), NOTIFY_BIT_DATE);
+  // Сохранение конфигурации будит задачу: новые параметры применяются без перезагрузки
+  ConfigService::subscribe(xTaskGetCurrentTaskHandle());
+  uint32_t notified = 0; // биты уведомлений, полученные при последнем пробуждении
 
   while (1)
   {
     // Sample stack high-water mark and handle logging via helper
     stack_monitor_sample(&stackMon, PROTASK_NETWORKING_STACK_SIZE);
+    wakeup_monitor_tick(&wakeMon);
 
     // Проверка подключения к WiFi и установка битов состояния
     if (WiFi.status() != WL_CONNECTED)
     {
-      xEventGroupClearBits(xEventGroup, BIT_WIFI_STATE_UP);
+      system_bits_clear(BIT_WIFI_STATE_UP);
       ESP_LOGW("NET", "WiFi is not connected. Attempting reconnect ...");
 
       // Попробовать восстановить соединение (non-blocking)
@@ -92,49 +120,44 @@ void task_networking_exec(void *pvParameters)
       continue; // повторить попытку на следующей итерации
     }
     else
-      xEventGroupSetBits(xEventGroup, BIT_WIFI_STATE_UP | BIT_NARODMON_UP);
+      system_bits_set(BIT_WIFI_STATE_UP | BIT_NARODMON_UP);
+
+    // Новая конфигурация: применяются только изменившиеся группы параметров
+    if (ConfigService::version() != cfg_version)
+    {
+      static PrjCfgData fresh;
+      ConfigService::get(fresh, &cfg_version);
+      const uint32_t changed = ConfigService::diff(cfg, fresh);
+      cfg = fresh;
+      ESP_LOGI(TAG, "Config version %u applied (changed 0x%02x)", cfg_version, changed);
+      if (changed & CONFIG_CHANGED_MQTT)
+        net.mqttSender.reconnect();
+      if (changed & CONFIG_CHANGED_TIMEZONE)
+        net.configureNTPFromConfig();
+      if (changed & CONFIG_CHANGED_LOCATION)
+      {
+        openMeteo->set_config(cfg.latitude, cfg.longitude);
+        net.NearestCityProcessing();
+        xLastMeteoTime = xTaskGetTickCount() - pdMS_TO_TICKS(METEO_POLL_INTERVAL_MS); // прогноз для новых координат
+      }
+    }
 
     // MQTT: ensure connection and process any queued sensor data forwarded to networking
     if (WiFi.status() == WL_CONNECTED)
     {
       net.mqttSender.loop(cfg);
 
-      // Try to receive messages destined for networking (home sensor / nRF)
-      QueDataItem_t qitem;
-      if (xQueueReceive(xQueue[PROTASK_NETWORKING], &qitem, pdMS_TO_TICKS(50)) == pdPASS)
-      {
-        // If this is OUT sensor data - cache the last value + timestamp
-        if (qitem.type == QUE_DATATYPE_OUT_SENSOR_DATA)
-        {
-          OutSensorData_t *p = static_cast<OutSensorData_t *>(qitem.data);
-          if (p)
-          {
-            g_lastOutData = *p;
-            g_lastOutDataMillis = millis();
-            ESP_LOGI("NETWORKING", "Cached OUT for NarodMon: T=%.2f H=%.2f P=%u BAT=%u",
-                     g_lastOutData.temperature, g_lastOutData.humidity, g_lastOutData.pressure, g_lastOutData.bat_charge);
-          }
-        }
-
-        // Forward to MQTT processing as before (it will free qitem.data)
-        net.mqttSender.processing(cfg, qitem);
-      }
+      // Drain everything the bus delivered (home sensor / nRF) since the last wakeup
+      BusSampleRef sample;
+      while (g_busSub.receive(sample))
+        net.mqttSender.processing(cfg, *sample);
     }
 
     // Вызов обработки метео-данных каждые METEO_POLL_INTERVAL_MS или при смене даты
-    bool dateChanged = false;
-    struct tm timeinfo;
-    if (getLocalTime(&timeinfo))
-    {
-      if (timeinfo.tm_mday != prev_timeinfo.tm_mday ||
-          timeinfo.tm_mon != prev_timeinfo.tm_mon ||
-          timeinfo.tm_year != prev_timeinfo.tm_year)
-      {
-        dateChanged = true;
-        prev_timeinfo = timeinfo; // обновить предыдущее время
-        ESP_LOGI("NETWORKING", "Date change detected — forcing meteo request");
-      }
-    }
+    const bool dateChanged = (notified & NOTIFY_BIT_DATE) != 0;
+    notified = 0;
+    if (dateChanged)
+      ESP_LOGI("NETWORKING", "Date change detected — forcing meteo request");
 
     if ((xTaskGetTickCount() - xLastMeteoTime) >= pdMS_TO_TICKS(METEO_POLL_INTERVAL_MS) || dateChanged)
     {
@@ -142,10 +165,17 @@ void task_networking_exec(void *pvParameters)
       {
         bool GeoMagOk = openMeteo->process_geomagnetic_data(); // должен быть вызван до обработки метео-данных
         bool meteoOk = openMeteo->process_meteo_data();
+        DataBus::log_stats();
+        LatencyTrace::log_stats();
+        I2cEngine::log_stats();
+        SensorScheduler::log_stats();
+        task_nrf24_log_stats();
+        net.mqttSender.publishLink(cfg);
+        net.mqttSender.publishBus(cfg);
         if (meteoOk)
-          xEventGroupSetBits(xEventGroup, BIT_OPEN_METEO_UP);
+          system_bits_set(BIT_OPEN_METEO_UP);
         else
-          xEventGroupClearBits(xEventGroup, BIT_OPEN_METEO_UP);
+          system_bits_clear(BIT_OPEN_METEO_UP);
       }
       xLastMeteoTime = xTaskGetTickCount();
     }
@@ -159,40 +189,44 @@ void task_networking_exec(void *pvParameters)
       // advance the tick regardless of whether we will send (reset interval)
       g_lastNarodmonTick = xTaskGetTickCount();
 
-      // If we have received data within the last interval, send it
-      if (g_lastOutDataMillis != 0)
+      // If we have received data within the last interval, send it (latest value from station state)
+      static StationSnapshot_t state;
+      StationState::snapshot(state);
+      if (state.version[STATE_FIELD_OUT_SENSOR] != 0 && !(state.restored & (1u << STATE_FIELD_OUT_SENSOR)))
       {
-        uint32_t now_ms = millis();
-        uint32_t delta_ms = 0;
-        if (now_ms >= g_lastOutDataMillis)
-          delta_ms = now_ms - g_lastOutDataMillis;
-        else
-          delta_ms = (UINT32_MAX - g_lastOutDataMillis) + now_ms + 1; // wrap safety
+        const uint32_t delta_ms = (xTaskGetTickCount() - state.updated_tick[STATE_FIELD_OUT_SENSOR]) * portTICK_PERIOD_MS;
 
         if (delta_ms <= NARODMON_INTERVAL_MS)
         {
           // Build NarodMon GET request
           // Use NetProcessor helper to send NarodMon GET
-          if (!net.sendNarodMon(g_lastOutData))
+          if (!net.sendNarodMon(state.out))
             ESP_LOGW("NETWORKING", "NetProcessor::sendNarodMon failed");
           else
-            xEventGroupSetBits(xEventGroup, BIT_NARODMON_UP);
+          {
+            LatencyTrace::record(LATENCY_POINT_NARODMON, state.stamp[STATE_FIELD_OUT_SENSOR]);
+            system_bits_set(BIT_NARODMON_UP);
+          }
         }
         else
         {
           ESP_LOGI("NETWORKING", "No recent OUT data (%.0fs ago), skipping NarodMon send",
                    (double)delta_ms / 1000.0);
-          xEventGroupClearBits(xEventGroup, BIT_NARODMON_UP);
+          system_bits_clear(BIT_NARODMON_UP);
         }
       }
       else
       {
         ESP_LOGI("NETWORKING", "No OUT data cached, skipping NarodMon send");
         // set EventGroup bit to indicate NarodMon not sent?
-        xEventGroupClearBits(xEventGroup, BIT_NARODMON_UP);
+        system_bits_clear(BIT_NARODMON_UP);
       }
     }
 
-    vTaskDelayUntil(&xLastWakeTime, 10 / portTICK_PERIOD_MS); // раз в 10 мс
+    // Спать до уведомления шины (данные датчиков) или до ближайшего срока периодических работ
+    TickType_t wait = pdMS_TO_TICKS(MQTT_LOOP_INTERVAL_MS);
+    wait = std::min(wait, ticks_until(xLastMeteoTime, pdMS_TO_TICKS(METEO_POLL_INTERVAL_MS)));
+    wait = std::min(wait, ticks_until(g_lastNarodmonTick, pdMS_TO_TICKS(NARODMON_INTERVAL_MS)));
+    xTaskNotifyWait(0, ULONG_MAX, &notified, wait);
   }
 }
@@ -1,24 +1,375 @@
 #include "task_nrf24.h"
 #include "common.h"
+#include "config_service.h"
+#include "latency_trace.h"
+#include "nrf_link.h"
+#include "nrf_nodes.h"
+#include "radio_proto.h"
 #include "stack_monitor.h"
 #include "tasks_common.h"
+#include "virtual_source.h"
+#include "wakeup_monitor.h"
 #include <Arduino.h>
 #include <RF24.h>
 #include <SPI.h>
+#include <atomic>
 #include <esp_log.h>
+#include <esp_timer.h>
+#include <math.h>
+#include <sys/time.h>
+
+#define NRF_INTERVAL_CEIL_S (MAX_METEO_VALID_INTERVAL_MS / 2000) // верхняя граница периода узлов, с (вдвое меньше срока устаревания данных на экране)
 
 RF24 radio(NRF_CE_PIN, NRF_CSN_PIN); // радиоприемник nRF24L01+
 
-// Временные метрики приёмов: разница, максимум, сумма для среднего и счётчик
-static uint32_t nrf_last_recv_ms = 0;
-static uint32_t nrf_max_delta_ms = 0;
-static uint64_t nrf_sum_deltas_ms = 0;
-static uint32_t nrf_recv_count = 0;
+// Момент последнего прерывания IRQ (монотонное время, мкс) и счётчики приёма
+static int64_t s_irq_us = 0;
+static portMUX_TYPE s_irq_mux = portMUX_INITIALIZER_UNLOCKED; // 64-битная метка не атомарна
+static std::atomic<uint32_t> s_irq_count{0};    // прерываний IRQ
+static std::atomic<uint32_t> s_packets{0};      // прочитанных пакетов
+static std::atomic<uint32_t> s_fifo_full{0};    // пробуждений с заполненным RX FIFO (новые пакеты теряются)
+static std::atomic<uint32_t> s_max_burst{0};    // максимум пакетов за одно пробуждение
+static std::atomic<uint32_t> s_empty_wakes{0};  // пробуждений без пакетов (помеха на линии IRQ, другие флаги)
+static std::atomic<uint32_t> s_bad_frames{0};   // отброшенных пакетов (ошибка формата, CRC, номер узла)
+static std::atomic<uint32_t> s_legacy{0};       // пакетов прежнего формата (версия 1)
+static std::atomic<uint32_t> s_ack_flush{0};    // сбросов TX FIFO для загрузки ACK payload
+static std::atomic<uint32_t> s_dl_delivered{0}; // пакетов обратного канала, ушедших в подтверждении пакета адресата
+static std::atomic<uint32_t> s_dl_lost{0};      // пакетов обратного канала, сброшенных или ушедших другому узлу pipe
+static std::atomic<uint32_t> s_dl_reloads{0};   // пакетов обратного канала, загруженных повторно после сканирования
+
+#if NRF_ACK_PAYLOADS
+/// @brief пакет обратного канала, загруженный в TX FIFO для pipe
+struct NrfAck_t
+{
+  bool loaded;                // payload в TX FIFO, ждёт пакета по этому pipe
+  uint8_t node;               // узел-адресат
+  uint8_t buf[RADIO_DL_SIZE]; // закодированный пакет (для повторной загрузки)
+};
+static NrfAck_t s_acks[NRF_PIPES]; // загруженные ACK payload (только задача приёма)
+#endif
+
+#if NRF_IRQ_PIN >= 0
+// Спад линии IRQ: данные в RX FIFO (прерывания TX_DS и MAX_RT замаскированы)
+static void IRAM_ATTR nrf_irq_isr()
+{
+  const int64_t now_us = esp_timer_get_time();
+  portENTER_CRITICAL_ISR(&s_irq_mux);
+  s_irq_us = now_us;
+  portEXIT_CRITICAL_ISR(&s_irq_mux);
+  s_irq_count.fetch_add(1, std::memory_order_relaxed);
+  BaseType_t woken = pdFALSE;
+  if (xHandles[PROTASK_NRF_RECEIVER])
+    xTaskNotifyFromISR(xHandles[PROTASK_NRF_RECEIVER], NOTIFY_BIT_NRF_IRQ, eSetBits, &woken);
+  portYIELD_FROM_ISR(woken);
+}
+#endif
+
+// Измерение пакета в формате шины
+static OutSensorData_t nrf_sample_data(const RadioFrame_t &frame, const RadioSample_t &s)
+{
+  OutSensorData_t data{};
+  data.temperature = s.temperature_centi / 100.0f;
+  data.humidity = s.humidity_centi / 100.0f;
+  data.pressure = static_cast<uint16_t>((s.pressure_dhpa + 5) / 10);
+  data.bat_charge = frame.battery;
+  return data;
+}
+
+// Метка измерения: момент приёма пакета, сдвинутый на возраст измерения
+static SampleStamp_t nrf_sample_stamp(const SampleStamp_t &rx, const RadioSample_t &s)
+{
+  SampleStamp_t stamp = rx;
+  stamp.mono_us -= static_cast<int64_t>(s.age_s) * 1000000;
+  if (stamp.wall)
+    stamp.wall -= s.age_s;
+  return stamp;
+}
+
+// Разобрать пакет, обновить таблицу узлов и опубликовать измерения; false — пакет отброшен
+static bool nrf_process_packet(const uint8_t *buf, uint8_t len, uint8_t pipe, const SampleStamp_t &stamp, bool rpd,
+                               RadioFrame_t &frame)
+{
+  // Пакет прежнего формата номера узла не несёт: узел — канал приёма
+  const RadioDecode_t rc = RadioProto::decode(buf, len, pipe, frame);
+  if (rc != RADIO_DECODE_OK || frame.node >= NRF_MAX_NODES)
+  {
+    s_bad_frames.fetch_add(1, std::memory_order_relaxed);
+    ESP_LOGW("NRF24", "Dropped packet on pipe %u: decode=%d node=%u", pipe, rc, frame.node);
+    return false;
+  }
+  if (frame.version < RADIO_VERSION)
+    s_legacy.fetch_add(1, std::memory_order_relaxed);
+
+  const RadioSample_t &newest = frame.samples[frame.count - 1];
+  const OutSensorData_t data = nrf_sample_data(frame, newest);
+  if (NrfNodes::update(frame, pipe, data, nrf_sample_stamp(stamp, newest), rpd) == NRF_UPDATE_DUPLICATE)
+  {
+    ESP_LOGD("NRF24", "Duplicate packet from node %u (seq %u)", frame.node, frame.seq);
+    return true;
+  }
+
+  ESP_LOGI("NRF24", "Received v%u packet from node %u (seq %d, %u samples, rpd %d): T=%.2f, H=%.2f, P=%u, BAT=%u",
+           frame.version, frame.node, frame.has_seq ? frame.seq : -1, frame.count, rpd,
+           data.temperature, data.humidity, data.pressure, data.bat_charge);
+
+  // Измерения пакета — от старого к новому, метка каждого сдвинута на его возраст.
+  // Publish received data once for all bus subscribers (TFT, networking, ...)
+  for (uint8_t i = 0; i < frame.count; ++i)
+  {
+    if (!DataBus::publish(QUE_DATATYPE_OUT_SENSOR_DATA, nrf_sample_data(frame, frame.samples[i]),
+                          nrf_sample_stamp(stamp, frame.samples[i]), frame.node))
+      ESP_LOGE("NRF24", "Failed to publish OutSensorData");
+  }
+  return true;
+}
+
+#if NRF_ACK_PAYLOADS
+// Время UTC приёма пакета, мс (0 — часы не синхронизированы)
+static int64_t nrf_rx_utc_ms(const SampleStamp_t &rx)
+{
+  if (!rx.wall)
+    return 0;
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  const int64_t since_rx_us = esp_timer_get_time() - rx.mono_us;
+  return static_cast<int64_t>(tv.tv_sec) * 1000 + tv.tv_usec / 1000 - since_rx_us / 1000;
+}
+
+// Загруженные payload сброшены из TX FIFO
+static void nrf_drop_acks()
+{
+  for (uint8_t pipe = 0; pipe < NRF_PIPES; ++pipe)
+  {
+    if (s_acks[pipe].loaded)
+      s_dl_lost.fetch_add(1, std::memory_order_relaxed);
+    s_acks[pipe].loaded = false;
+  }
+}
+
+// Подтверждение пакета, принятого по pipe, унесло загруженный payload (если был);
+// node — отправитель пакета (NRF_MAX_NODES — неизвестен)
+static void nrf_ack_consumed(uint8_t pipe, uint8_t node)
+{
+  NrfAck_t &ack = s_acks[pipe];
+  if (!ack.loaded)
+    return;
+  ack.loaded = false;
+  (node == ack.node ? s_dl_delivered : s_dl_lost).fetch_add(1, std::memory_order_relaxed);
+}
+
+// Загрузить пакет обратного канала: он уйдёт в подтверждении следующего пакета узла по тому же pipe
+static void nrf_load_ack(const RadioFrame_t &frame, uint8_t pipe, const SampleStamp_t &rx)
+{
+  RadioDownlink_t dl;
+  NrfLink::downlink(frame.node, frame.seq, rx.mono_us, nrf_rx_utc_ms(rx), xTaskGetTickCount(), dl);
+  NrfAck_t &ack = s_acks[pipe];
+  RadioProto::encode_downlink(dl, ack.buf);
+  // TX FIFO на три payload: занят командами узлов, которые больше не передают, — сбросить
+  if (!radio.writeAckPayload(pipe, ack.buf, sizeof(ack.buf)))
+  {
+    s_ack_flush.fetch_add(1, std::memory_order_relaxed);
+    radio.flush_tx();
+    nrf_drop_acks();
+    radio.writeAckPayload(pipe, ack.buf, sizeof(ack.buf));
+  }
+  ack.node = frame.node;
+  ack.loaded = true;
+}
+
+// Загрузить заново payload, сброшенные stopListening() (при включённых ACK payload он очищает TX FIFO).
+// Моменты в командах отсчитаны от приёма ref_seq и остаются верными
+static void nrf_reload_acks()
+{
+  for (uint8_t pipe = 0; pipe < NRF_PIPES; ++pipe)
+  {
+    if (!s_acks[pipe].loaded)
+      continue;
+    radio.writeAckPayload(pipe, s_acks[pipe].buf, sizeof(s_acks[pipe].buf));
+    s_dl_reloads.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+#endif
+
+// Прочитать все пакеты из RX FIFO и опубликовать их; возвращает количество пакетов
+static uint32_t nrf_drain_fifo()
+{
+  uint32_t count = 0;
+  for (;;)
+  {
+    // флаги сбрасываются до чтения FIFO: пакет, пришедший во время чтения, даст новый спад IRQ
+    bool tx_ok, tx_fail, rx_ready;
+    radio.whatHappened(tx_ok, tx_fail, rx_ready);
+    if (!radio.available())
+      break;
+
+    if (radio.rxFifoFull())
+      s_fifo_full.fetch_add(1, std::memory_order_relaxed);
+
+    uint8_t pipe = 0;
+    while (radio.available(&pipe))
+    {
+      uint8_t buf[RADIO_PAYLOAD_SIZE] = {};
+#if NRF_ACK_PAYLOADS
+      const uint8_t len = radio.getDynamicPayloadSize(); // 0 — недопустимая длина, RX FIFO сброшен
+      if (!len)
+      {
+        s_bad_frames.fetch_add(1, std::memory_order_relaxed);
+        continue;
+      }
+#else
+      const uint8_t len = RADIO_PAYLOAD_SIZE;
+#endif
+      radio.read(buf, len);
+      const bool rpd = radio.testRPD(); // уровень принятого пакета выше -64 дБм
+      count++;
+
+      // момент приёма — прерывание (без IRQ — момент чтения)
+      SampleStamp_t stamp = sample_stamp_now();
+#if NRF_IRQ_PIN >= 0
+      portENTER_CRITICAL(&s_irq_mux);
+      const int64_t irq_us = s_irq_us;
+      portEXIT_CRITICAL(&s_irq_mux);
+      if (irq_us && irq_us <= stamp.mono_us)
+        stamp.mono_us = irq_us;
+#endif
+      LatencyTrace::record(LATENCY_POINT_NRF_RX, stamp);
+
+      RadioFrame_t frame;
+      const bool ok = nrf_process_packet(buf, len, pipe, stamp, rpd, frame);
+#if NRF_ACK_PAYLOADS
+      nrf_ack_consumed(pipe, ok ? frame.node : NRF_MAX_NODES);
+#endif
+      if (!ok)
+        continue;
+#if NRF_ACK_PAYLOADS
+      // подтверждение этого пакета унесло загруженный payload (если был) — загрузить следующий,
+      // привязанный к моменту приёма этого пакета
+      if (frame.version == RADIO_VERSION)
+        nrf_load_ack(frame, pipe, stamp);
+#endif
+    }
+  }
+
+  s_packets.fetch_add(count, std::memory_order_relaxed);
+  if (count > s_max_burst.load(std::memory_order_relaxed))
+    s_max_burst.store(count, std::memory_order_relaxed);
+  return count;
+}
+
+// Проход сканирования сетки радиоканалов (RPD); узел, передавший в это время, повторит
+// пакет (автоповтор перекрывает проход), пакет на рабочем радиоканале попадёт в RX FIFO
+static void nrf_scan()
+{
+  bool busy[NRF_SCAN_CHANNELS];
+  radio.stopListening();
+  for (uint8_t i = 0; i < NRF_SCAN_CHANNELS; ++i)
+  {
+    radio.setChannel(NrfLink::scan_channel(i));
+    radio.startListening();
+    delayMicroseconds(NRF_SCAN_DWELL_US);
+    busy[i] = radio.testRPD();
+    radio.stopListening();
+  }
+  radio.setChannel(NrfLink::channel());
+  radio.startListening();
+#if NRF_ACK_PAYLOADS
+  nrf_reload_acks();
+#endif
+  NrfLink::record_scan(busy, xTaskGetTickCount());
+}
+
+#if VIRTUAL_SENSORS
+// Воспроизведение трассы наружных узлов вместо радиоприёма: измерение собирается в пакет
+// версии 2 и проходит тот же разбор, таблицу узлов и публикацию, что и пакет из эфира
+static void nrf_virtual_loop()
+{
+  LITTLEFS_LOCK();
+  VirtualFileSource file(VIRTUAL_OUT_TRACE);
+  LITTLEFS_UNLOCK();
+  VirtualSynthSource synth(VIRTUAL_SYNTH_NODES, VIRTUAL_SYNTH_INTERVAL_MS, VIRTUAL_SYNTH_BURST_EVERY, VIRTUAL_SYNTH_SEED);
+  VirtualSource &source = file.ok() ? static_cast<VirtualSource &>(file) : synth;
+  ESP_LOGW("NRF24", "Virtual outdoor nodes: %s, speedup x%u", file.ok() ? VIRTUAL_OUT_TRACE : "synthetic",
+           VIRTUAL_SPEEDUP);
+
+  StackMonitor_t stackMon;
+  stack_monitor_init(&stackMon, "NRF24");
+  VirtualPacer pacer(VIRTUAL_SPEEDUP);
+  uint16_t seq[NRF_MAX_NODES] = {}; // порядковые номера пакетов узлов
+  uint32_t pass = 0;                // проходов трассы
+  uint32_t pass_packets = 0;        // пакетов в текущем проходе
+  int64_t pass_start_us = esp_timer_get_time();
+  for (;;)
+  {
+    stack_monitor_sample(&stackMon, PROTASK_NRF_RECEIVER_STACK_SIZE);
+
+    VirtualSample_t s;
+    LITTLEFS_LOCK();
+    const bool more = source.next(s);
+    LITTLEFS_UNLOCK();
+    if (!more)
+    {
+      // трасса закончилась — сводка прохода и воспроизведение по кругу
+      ESP_LOGI("NRF24", "Virtual pass %u: %u packets in %lld ms", ++pass, pass_packets,
+               (esp_timer_get_time() - pass_start_us) / 1000);
+      task_nrf24_log_stats();
+      LITTLEFS_LOCK();
+      source.rewind();
+      LITTLEFS_UNLOCK();
+      pacer.restart();
+      if (!pass_packets)
+        vTaskDelay(pdMS_TO_TICKS(NRF_POLL_INTERVAL_MS)); // пустая трасса
+      pass_packets = 0;
+      pass_start_us = esp_timer_get_time();
+      continue;
+    }
+
+    const uint32_t wait_ms = pacer.delay_ms(s.t_ms, esp_timer_get_time() / 1000);
+    if (wait_ms)
+      vTaskDelay(pdMS_TO_TICKS(wait_ms));
+
+    RadioFrame_t frame{};
+    frame.node = s.node;
+    frame.seq = s.node < NRF_MAX_NODES ? seq[s.node]++ : 0;
+    frame.battery = s.battery;
+    frame.count = 1;
+    frame.samples[0].temperature_centi = static_cast<int16_t>(lroundf(s.temperature * 100.0f));
+    frame.samples[0].humidity_centi = static_cast<uint16_t>(lroundf(s.humidity * 100.0f));
+    frame.samples[0].pressure_dhpa = static_cast<uint16_t>(lroundf(s.pressure * 10.0f));
+    uint8_t buf[RADIO_PAYLOAD_SIZE];
+    RadioProto::encode(frame, buf);
+
+    const SampleStamp_t stamp = sample_stamp_now();
+    LatencyTrace::record(LATENCY_POINT_NRF_RX, stamp);
+    nrf_process_packet(buf, sizeof(buf), s.node % NRF_PIPES, stamp, false, frame);
+    s_packets.fetch_add(1, std::memory_order_relaxed);
+    pass_packets++;
+  }
+}
+#endif
+
+// Период передачи узлов из конфигурации (передаётся им через обратный канал); результат — версия конфигурации
+static uint32_t nrf_apply_interval()
+{
+  PrjCfgData cfg;
+  uint32_t version = 0;
+  ConfigService::get(cfg, &version); // при первом запуске — значения по умолчанию
+  uint32_t interval_s = strtoul(cfg.out_interval_sec, NULL, 10);
+  if (interval_s > NRF_INTERVAL_CEIL_S)
+    interval_s = NRF_INTERVAL_CEIL_S;
+  NrfLink::set_interval_s(static_cast<uint16_t>(interval_s));
+  ESP_LOGI("NRF24", "Outdoor nodes report interval %u s", NrfLink::interval_s());
+  return version;
+}
 
 void task_nrf24_exec(void *pvParameters)
 {
   (void)pvParameters;
-  // Task handle not needed for polling mode
+
+  uint32_t cfg_version = nrf_apply_interval();
+
+#if VIRTUAL_SENSORS
+  nrf_virtual_loop(); // радиомодуль не используется
+#endif
 
   // Initialize SPI for nRF24 and radio
   SPI.begin(NRF_SCK_PIN, NRF_MISO_PIN, NRF_MOSI_PIN, NRF_CSN_PIN);
@@ -42,99 +393,90 @@ void task_nrf24_exec(void *pvParameters)
 
   // Configure radio for simple reception
   // Set channel, data rate, power level and address (pipe)
-  radio.setChannel(103);                  // channel 103
+  radio.setChannel(NrfLink::channel());   // домашний канал RADIO_HOME_CHANNEL
   radio.setDataRate(RF24_250KBPS);        // 250kbps
   radio.setPALevel(RF24_PA_HIGH);         // high power
   radio.setAutoAck(true);                 // enable auto acknowledgment
-  uint64_t pipeAddress = 0xA337D135B1ULL; // expected pipe address
-  radio.openReadingPipe(0, pipeAddress);
+#if NRF_ACK_PAYLOADS
+  radio.enableDynamicPayloads(); // обратный канал требует динамической длины payload
+  radio.enableAckPayload();
+#endif
+  // все шесть каналов приёма: pipe 0 — исходный адрес, pipe 1..5 — общий префикс и младший байт C1..C5
+  for (uint8_t pipe = 0; pipe < NRF_PIPES; ++pipe)
+    radio.openReadingPipe(pipe, NrfNodes::pipe_address(pipe));
+  radio.maskIRQ(true, true, false); // на линию IRQ выводится только RX_DR (данные приняты)
+
+#if NRF_IRQ_PIN >= 0
+  pinMode(NRF_IRQ_PIN, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(NRF_IRQ_PIN), nrf_irq_isr, FALLING);
+#endif
+  ConfigService::subscribe(xTaskGetCurrentTaskHandle()); // новый период узлов без опроса версии
   radio.startListening();
 
   radio.printDetails();
 
-  // Polling mode: no hardware IRQs or ISR installed
-
   StackMonitor_t stackMon;
 
-  ESP_LOGI("NRF24", "nRF24 receiver task started, waiting for data...");
+  ESP_LOGI("NRF24", "nRF24 receiver task started (%s), waiting for data...", NRF_IRQ_PIN >= 0 ? "IRQ" : "polling");
 
   stack_monitor_init(&stackMon, "NRF24");
+  WakeupMonitor_t wakeMon;
+  wakeup_monitor_init(&wakeMon, "NRF24");
+  bool notified = true; // первый проход — пакеты, принятые до подключения обработчика
   for (;;)
   {
     stack_monitor_sample(&stackMon, PROTASK_NRF_RECEIVER_STACK_SIZE);
+    wakeup_monitor_tick(&wakeMon);
 
-    if (radio.available())
+    // Пакеты, принятые до подключения обработчика или пока задача читала FIFO, вычитываются сразу
+    if (!nrf_drain_fifo() && (notified || NRF_IRQ_PIN < 0))
     {
-      // Read all available payloads and update last-received time
-      while (radio.available())
-      {
-        OutSensorData_t data{};
-        size_t len = sizeof(data);
-        radio.read(&data, len);
-        // Время приёма и статистика интервалов
-        uint32_t now_ms = millis();
-        uint32_t delta_ms = 0;
-        if (nrf_last_recv_ms != 0)
-        {
-          if (now_ms >= nrf_last_recv_ms)
-            delta_ms = now_ms - nrf_last_recv_ms;
-          else
-            delta_ms = (UINT32_MAX - nrf_last_recv_ms) + now_ms + 1; // millis() wrap-around safety
-
-          nrf_sum_deltas_ms += delta_ms;
-          nrf_recv_count++;
-          if (delta_ms > nrf_max_delta_ms)
-            nrf_max_delta_ms = delta_ms;
-        }
-        nrf_last_recv_ms = now_ms;
-
-        float avg_ms = nrf_recv_count ? (float)nrf_sum_deltas_ms / nrf_recv_count : 0.0f;
-
-        ESP_LOGI("NRF24", "Received OutSensorData: T=%.2f, H=%.2f, P=%u, BAT=%u",
-                 data.temperature, data.humidity, data.pressure, data.bat_charge);
-        ESP_LOGI("NRF24", "Inter-receive: %ums, max=%ums, avg=%.2fms",
-                 delta_ms, nrf_max_delta_ms, avg_ms);
-
-        // Send received data to TFT task queue for drawing
-        OutSensorData_t *payload = new OutSensorData_t();
-        if (!payload)
-        {
-          ESP_LOGE("NRF24", "Failed to allocate OutSensorData_t for TFT queue");
-        }
-        else
-        {
-          *payload = data;
-          QueDataItem_t qitem;
-          qitem.type = QUE_DATATYPE_OUT_SENSOR_DATA;
-          qitem.data = payload;
-          if (pdPASS != xQueueSend(xQueue[PROTASK_TFT], &qitem, pdMS_TO_TICKS(100)))
-          {
-            ESP_LOGE("NRF24", "Failed to send OutSensorData to TFT queue");
-            delete payload;
-          }
-          else
-          {
-            // Also send a copy to MQTT publisher queue
-            OutSensorData_t *payload_mqtt = new OutSensorData_t();
-            if (payload_mqtt)
-            {
-              *payload_mqtt = *payload;
-              QueDataItem_t qitem_m;
-              qitem_m.type = QUE_DATATYPE_OUT_SENSOR_DATA;
-              qitem_m.data = payload_mqtt;
-              if (pdPASS != xQueueSend(xQueue[PROTASK_NETWORKING], &qitem_m, pdMS_TO_TICKS(100)))
-              {
-                delete payload_mqtt;
-              }
-            }
-          }
-        }
-      }
+      s_empty_wakes.fetch_add(1, std::memory_order_relaxed);
+      if (!radio.isChipConnected())
+        ESP_LOGW("NRF24", "Radio chip not responding (isChipConnected() == false)");
+    }
+
+    // Новый период узлов из сохранённой конфигурации (бит NOTIFY_BIT_CONFIG; проверка версии — без чтения NVS)
+    if (ConfigService::version() != cfg_version)
+      cfg_version = nrf_apply_interval();
+
+    const TickType_t now = xTaskGetTickCount();
+    if (NrfLink::service(now, NRF_ACK_PAYLOADS))
+    {
+      radio.stopListening();
+      radio.setChannel(NrfLink::channel());
+      radio.startListening();
+#if NRF_ACK_PAYLOADS
+      nrf_drop_acks(); // команды с прежнего радиоканала устарели (могли объявлять отменённый переход)
+#endif
     }
+    else if (NrfLink::scan_due(now))
+      nrf_scan();
 
-    if (!radio.isChipConnected())
-      ESP_LOGW("NRF24", "Radio chip not responding (isChipConnected() == false)");
-    // Wait 5 seconds before next poll
-    vTaskDelay(pdMS_TO_TICKS(5000));
+    // Ожидание прерывания или изменения конфигурации — до ближайшего сканирования или срока
+    // монитора радиолинии (без узлов и перехода — без ограничения; без линии IRQ — не дольше
+    // интервала опроса). Спад IRQ во время чтения FIFO оставляет уведомление взведённым,
+    // и ожидание сразу завершится
+    TickType_t wait = NrfLink::next_wait(xTaskGetTickCount());
+#if NRF_IRQ_PIN < 0
+    if (wait > pdMS_TO_TICKS(NRF_POLL_INTERVAL_MS))
+      wait = pdMS_TO_TICKS(NRF_POLL_INTERVAL_MS);
+#endif
+    uint32_t bits = 0;
+    notified = xTaskNotifyWait(0, NOTIFY_BIT_NRF_IRQ | NOTIFY_BIT_CONFIG, &bits, wait) == pdTRUE &&
+               (bits & NOTIFY_BIT_NRF_IRQ);
   }
 }
+
+void task_nrf24_log_stats()
+{
+  ESP_LOGI("NRF24", "irq=%u packets=%u fifo_full=%u max_burst=%u empty_wakes=%u bad=%u legacy=%u ack_flush=%u",
+           s_irq_count.load(std::memory_order_relaxed), s_packets.load(std::memory_order_relaxed),
+           s_fifo_full.load(std::memory_order_relaxed), s_max_burst.load(std::memory_order_relaxed),
+           s_empty_wakes.load(std::memory_order_relaxed), s_bad_frames.load(std::memory_order_relaxed),
+           s_legacy.load(std::memory_order_relaxed), s_ack_flush.load(std::memory_order_relaxed));
+  ESP_LOGI("NRF24", "downlinks: delivered=%u lost=%u reloaded=%u", s_dl_delivered.load(std::memory_order_relaxed),
+           s_dl_lost.load(std::memory_order_relaxed), s_dl_reloads.load(std::memory_order_relaxed));
+  NrfNodes::log_stats();
+  NrfLink::log_stats();
+}
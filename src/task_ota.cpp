@@ -104,8 +104,7 @@ void task_ota_exec(void *pvParameters)
       {
         ESP_LOGI(TAG, "New firmware available! Starting OTA update...");
         // Signal other tasks (TFT) that OTA update processing starts
-        if (xEventGroup)
-          xEventGroupSetBits(xEventGroup, BIT_OTA_UPDATE_BIT);
+        system_bits_set(BIT_OTA_UPDATE_BIT);
         // Сохраняем версию новой прошивки в NVS до перезагрузки
         {
           char newVersion[32] = {0};
@@ -117,8 +116,7 @@ void task_ota_exec(void *pvParameters)
         }
         fota.execOTA();
         // If execOTA returned, update didn't complete — clear OTA bit so UI returns to normal
-        if (xEventGroup)
-          xEventGroupClearBits(xEventGroup, BIT_OTA_UPDATE_BIT);
+        system_bits_clear(BIT_OTA_UPDATE_BIT);
         // После успешного обновления ESP автоматически перезагрузится.
         // Если execOTA вернул управление — произошла ошибка.
         ESP_LOGE(TAG, "OTA update failed, will retry after next interval");
@@ -1,33 +1,29 @@
 #include "task_tft.h"
+#include "boot_cache.h"
+#include "boot_timeline.h"
+#include "latency_trace.h"
+#include "clock_service.h"
 #include "meteowidgets.h"
 #include "openmeteo.h"
 #include "stack_monitor.h"
+#include "station_state.h"
 #include "tasks_common.h"
+#include "wakeup_monitor.h"
+#include <algorithm>
 #include <esp_heap_caps.h>
 #include <esp_log.h>
 #include <time.h>
 
-// Helper macro for LittleFS mutex protection
-#define LITTLEFS_LOCK()                              \
-  do                                                 \
-  {                                                  \
-    if (xLittleFSMutex)                              \
-      xSemaphoreTake(xLittleFSMutex, portMAX_DELAY); \
-  } while (0)
-
-#define LITTLEFS_UNLOCK()             \
-  do                                  \
-  {                                   \
-    if (xLittleFSMutex)               \
-      xSemaphoreGive(xLittleFSMutex); \
-  } while (0)
-
 LGFX tft; // Создать экземпляр LovyanGFX (драйвер дисплея)
 
 void task_tft_exec(void *pvParameters)
 {
   MeteoWidgets *meteo_widgets = MeteoWidgets::createInstance(tft); // Создать или получить единственный экземпляр MeteoWidgets
-  GeoMagneticKpMax geomag{0, 0, 0};                                // прогноз геомагнитной обстановки
+
+  // Уведомления об обновлении состояния станции (все отображаемые данные берутся из снимка)
+  StationState::watch(xTaskGetCurrentTaskHandle());
+  // Уведомления о смене минуты/даты и синхронизации времени (часы перерисовываются точно на границе)
+  ClockService::subscribe(xTaskGetCurrentTaskHandle(), NOTIFY_BIT_MINUTE | NOTIFY_BIT_DATE | NOTIFY_BIT_TIME_SYNC);
 
   // настройки tft
   if (!tft.init())
@@ -47,43 +43,35 @@ void task_tft_exec(void *pvParameters)
   else
     meteo_widgets->init(); // инициализация виджетов TFT
 
-  TickType_t xLastWakeTime = xTaskGetTickCount();
   // Для логирования минимального остатка стека (high-water mark)
   TickType_t xLastStackLog = xTaskGetTickCount();
   StackMonitor_t stackMon;
   stack_monitor_init(&stackMon, "TFT");
+  WakeupMonitor_t wakeMon;
+  wakeup_monitor_init(&wakeMon, "TFT");
 
-  // Буфер для последних полученных данных от OpenMeteo
-  OpenMeteoData latestMeteo[_METEO_DATA_NUM_];
-  bool haveMeteo[_METEO_DATA_NUM_] = {false, false, false, false};
-  TickType_t lastMeteoUpdateTick = 0; // время последнего обновления данных
-  bool prevMeteoValid = true;         // предыдущее состояние valid (для детекции перехода в stale)
-
-  // Буферы для хранения данных домашнего и наружнего датчиков
-  HomeSensorData_t inSensorData = {0.0f, 0, 0.0f};
-  OutSensorData_t outSensorData{}; // используем default initialization (поля уже инициализированы в структуре)
-  bool inSensorValid = false;      // флаг валидности данных комнатного (in) датчика
-  bool outSensorValid = false;     // флаг валидности данных наружнего датчика
-  // Время последнего получения данных от датчиков (для timeout)
-  TickType_t lastInSensorTick = 0;
-  TickType_t lastOutSensorTick = 0;
+  // Снимок состояния станции и версии полей, уже выведенные на экран
+  static StationSnapshot_t state; // static — снимок крупный, не держим его на стеке задачи
+  uint32_t drawnVersion[_STATE_FIELD_NUM_] = {0};
+  bool prevMeteoValid = true; // предыдущее состояние valid (для детекции перехода в stale)
+
+  bool inSensorShown = false;  // показания комнатного (in) датчика на экране (свежие или восстановленные)
+  bool outSensorShown = false; // показания наружнего датчика на экране
+  bool clockEstimated = false; // часы показывают оценку времени (не синхронизированы)
   bool f_first = true;
   bool f_ota_widget_is_drawn = false;
-  // Хранение наименования населённого пункта; пока пустая строка
-  String cityName = String("");
-  // Placeholder external sensor battery level (0..100). Update from NRF handler when available.
-  uint8_t externalBatteryLevel = 100;
 
   struct tm prev_timeinfo; // предыдущее время для детекции смены даты
-  getLocalTime(&prev_timeinfo);
-
-  vTaskDelay(10000 / portTICK_PERIOD_MS); // задержка перед началом работы (для "стабилизации" LittleFS и TFT)
+  if (!ClockService::local_time(prev_timeinfo))
+    memset(&prev_timeinfo, 0, sizeof(prev_timeinfo));
+  uint32_t notified = 0; // биты уведомлений, полученные при последнем пробуждении
 
   // бесконечный цикл
   while (1)
   {
     // Sample stack high-water mark and handle logging via helper
     stack_monitor_sample(&stackMon, PROTASK_TFT_STACK_SIZE);
+    wakeup_monitor_tick(&wakeMon);
 
     // If OTA update is in progress, display only the update-processing widget
     EventBits_t evt_bits_now = xEventGroupGetBits(xEventGroup);
@@ -92,13 +80,20 @@ void task_tft_exec(void *pvParameters)
       if (!f_ota_widget_is_drawn)
         meteo_widgets->draw_update_processing_widget();
       f_ota_widget_is_drawn = true; // Set flag to avoid redrawing the OTA widget repeatedly
-      vTaskDelayUntil(&xLastWakeTime, 1000 / portTICK_PERIOD_MS);
+      // the OTA task notifies (NOTIFY_BIT_SYSTEM) when the update bit is cleared
+      xTaskNotifyWait(0, ULONG_MAX, nullptr, portMAX_DELAY);
       continue; // skip normal updates while OTA is running
     }
 
     // Получение текущего времени и обновление виджетов часов/ даты на TFT
-    struct tm timeinfo;
-    if (getLocalTime(&timeinfo))
+    // (до синхронизации — оценка по сохранённому времени, с пометкой "устарело")
+    struct tm timeinfo = {}; // без часов и оценки остаётся нулевым
+    const bool clockValid = ClockService::local_time(timeinfo);
+    const bool clockEstimate = !clockValid && BootCache::clock_estimate(timeinfo);
+    if (clockEstimated && !clockEstimate)
+      f_first = true; // оценка сменилась точным временем — перерисовать без пометки
+    clockEstimated = clockEstimate;
+    if (clockValid || clockEstimate)
     {
       // Обновляем виджет часов только при изменении минут
       uint8_t hh = static_cast<uint8_t>(timeinfo.tm_hour);
@@ -120,12 +115,14 @@ void task_tft_exec(void *pvParameters)
       }
 
       prev_timeinfo = timeinfo; // сохранить текущее время как предыдущее для следующей итерации
+      if (clockEstimate && (ret1 || ret2))
+        meteo_widgets->draw_stale_mark(padding, padding);
       if (ret1 && ret2)
         f_first = false;
     }
     else
     {
-      ESP_LOGW("TFT", "getLocalTime() failed — skipping clock update");
+      ESP_LOGW("TFT", "Time is not synchronized yet — skipping clock update");
     }
 
     // Неблокирующее чтение группы событий и отрисовка виджета состояния подключения
@@ -140,208 +137,117 @@ void task_tft_exec(void *pvParameters)
 
       // up = meteoUp (OpenMeteo данные получены), down = тот же статус, wifi = wifiUp
       meteo_widgets->draw_connection_state_widget(linkUp, linkDown, wifiUp);
+      BootTimeline::mark(BOOT_PHASE_FIRST_PIXEL);
     }
 
-    // Неблокирующий опрос очереди данных и обновление виджетов при поступлении новых данных
-    bool meteoDataReceived = false; // флаг: были ли получены новые метеоданные в этой итерации
-    QueDataItem_t qitem;
-    while (xQueueReceive(xQueue[PROTASK_TFT], &qitem, 0) == pdPASS) // вычитываем все доступные элементы очереди
+    // Снимок состояния станции: перерисовываются только поля, версия которых изменилась
+    StationState::snapshot(state);
+    const TickType_t now = xTaskGetTickCount();
+    auto field_changed = [&](StateField_t f)
+    { return state.version[f] != drawnVersion[f]; };
+    auto field_restored = [&](StateField_t f)
+    { return (state.restored & (1u << f)) != 0; };
+    auto field_fresh = [&](StateField_t f)
+    { return state.version[f] != 0 && !field_restored(f) &&
+             (now - state.updated_tick[f]) < pdMS_TO_TICKS(MAX_METEO_VALID_INTERVAL_MS); };
+    // восстановленные после перезапуска данные показываются до прихода свежих (с пометкой)
+    auto field_shown = [&](StateField_t f)
+    { return field_fresh(f) || field_restored(f); };
+
+    const bool meteoDataReceived = field_changed(STATE_FIELD_METEO) || field_changed(STATE_FIELD_GEOMAGNETIC);
+    const bool meteoValid = field_fresh(STATE_FIELD_METEO);
+    const bool meteoShown = field_shown(STATE_FIELD_METEO);
+
+    // Данные датчиков: новые значения или переход в stale (если не получали > MAX_METEO_VALID_INTERVAL_MS)
     {
-      if (qitem.type == QUE_DATATYPE_CITYNAME)
-      {
-        String *pname = static_cast<String *>(qitem.data);
-        if (pname)
-        {
-          ESP_LOGI("TFT", "Received CITYNAME: %s", pname->c_str());
-          cityName = *pname;
-          delete pname;
-        }
-      }
-      else if (qitem.type == QUE_DATATYPE_METEO)
-      {
-        OpenMeteoData *pdata = static_cast<OpenMeteoData *>(qitem.data);
-        if (pdata && pdata->index >= 0 && pdata->index < _METEO_DATA_NUM_)
-        {
-          ESP_LOGI("TFT", "Got data METEO[%u] from queue", pdata->index);
-          // Сохранить данные в локальный буфер
-          latestMeteo[pdata->index] = *pdata;
-          haveMeteo[pdata->index] = true;
-          lastMeteoUpdateTick = xTaskGetTickCount();
-          meteoDataReceived = true;
-          delete pdata;
-        }
-        else if (pdata)
-        {
-          delete pdata;
-        }
-      }
-      else if (qitem.type == QUE_DATATYPE_GEOMAGNETIC)
-      {
-        GeoMagneticKpMax *pdata = static_cast<GeoMagneticKpMax *>(qitem.data);
-        if (pdata)
-        {
-          ESP_LOGI("TFT", "Got data GEOMAGNETIC from queue");
-          // запоминаем геомагнитный прогноз в глобальной структуре
-          geomag.kpmax_today = pdata->kpmax_today;
-          geomag.kpmax_tomorrow = pdata->kpmax_tomorrow;
-          geomag.kpmax_tomorrow2 = pdata->kpmax_tomorrow2;
-
-          delete pdata;
-        }
-      }
-      else if (qitem.type == QUE_DATATYPE_IN_SENSOR_DATA)
-      {
-        HomeSensorData_t *pdata = static_cast<HomeSensorData_t *>(qitem.data);
-        if (pdata)
-        {
-          ESP_LOGI("TFT", "Got data IN_SENSOR from queue");
-          // Сохраняем данные домашнего датчика
-          inSensorData = *pdata;
-          inSensorValid = true;
-          lastInSensorTick = xTaskGetTickCount();
-
-          const uint8_t padding = 6;
-          int x = 0;
-          int y = MeteoWidgets::getClockDigsH() + padding;
-
-          // Перерисовываем два раздельных виджета: наружный (лево) и внутренний (право)
-          meteo_widgets->draw_home_out_data_widget(x, y,
-                                                   outSensorData.temperature, static_cast<uint8_t>(outSensorData.humidity),
-                                                   outSensorValid);
-          meteo_widgets->draw_home_in_data_widget(x, y,
-                                                  inSensorData.temperature_in, inSensorData.humidity_in,
-                                                  inSensorValid);
-          meteo_widgets->draw_city_name_widget(200, 60, cityName);
-
-          delete pdata;
-        }
-      }
-      else if (qitem.type == QUE_DATATYPE_OUT_SENSOR_DATA)
-      {
-        OutSensorData_t *pdata = static_cast<OutSensorData_t *>(qitem.data);
-        if (pdata)
-        {
-          ESP_LOGI("TFT", "Got data OUT_SENSOR from queue");
-          // Сохраняем данные наружнего датчика
-          outSensorData = *pdata;
-          outSensorValid = true;
-          lastOutSensorTick = xTaskGetTickCount();
-
-          ESP_LOGI("TFT", "Out sensor data received: temp=%.1f, hum=%.1f, charge=%u%%",
-                   outSensorData.temperature, outSensorData.humidity, outSensorData.bat_charge);
-
-          const uint8_t padding = 6;
-          int x = 0;
-          int y = MeteoWidgets::getClockDigsH() + padding;
-
-          // Перерисовываем два раздельных виджета: наружный (лево) и внутренний (право)
-          meteo_widgets->draw_home_out_data_widget(x, y,
-                                                   outSensorData.temperature, static_cast<uint8_t>(outSensorData.humidity),
-                                                   outSensorValid);
-          meteo_widgets->draw_home_in_data_widget(x, y,
-                                                  inSensorData.temperature_in, inSensorData.humidity_in,
-                                                  inSensorValid);
-          // Обновить индикатор заряда батареи внешнего датчика
-          meteo_widgets->draw_battery_level_widget(static_cast<uint8_t>(outSensorData.bat_charge));
-          meteo_widgets->draw_city_name_widget(200, 60, cityName);
-
-          delete pdata;
-        }
-      }
-      else
-      {
-        ESP_LOGW("TFT", "Received unsupported queue item type %d", static_cast<int>(qitem.type));
-      }
-    }
-
-    // Вычислить текущую валидность данных: данные устарели если прошло >= MAX_METEO_VALID_INTERVAL_MS
-    bool meteoValid = false;
-    if (lastMeteoUpdateTick != 0)
-    {
-      TickType_t now = xTaskGetTickCount();
-      TickType_t diff = (now >= lastMeteoUpdateTick) ? (now - lastMeteoUpdateTick) : portMAX_DELAY;
-      meteoValid = (diff < pdMS_TO_TICKS(MAX_METEO_VALID_INTERVAL_MS));
-    }
-
-    // Проверить таймауты для комнатного и наружнего датчиков (если не получали > MAX_METEO_VALID_INTERVAL_MS — сбросить valid)
-    {
-      TickType_t now = xTaskGetTickCount();
-      bool sensorsChanged = false;
-
-      if (inSensorValid && lastInSensorTick != 0)
-      {
-        TickType_t diff = (now >= lastInSensorTick) ? (now - lastInSensorTick) : portMAX_DELAY;
-        if (diff >= pdMS_TO_TICKS(MAX_METEO_VALID_INTERVAL_MS))
-        {
-          inSensorValid = false;
-          sensorsChanged = true;
-        }
-      }
-
-      if (outSensorValid && lastOutSensorTick != 0)
-      {
-        TickType_t diff = (now >= lastOutSensorTick) ? (now - lastOutSensorTick) : portMAX_DELAY;
-        if (diff >= pdMS_TO_TICKS(MAX_METEO_VALID_INTERVAL_MS))
-        {
-          outSensorValid = false;
-          sensorsChanged = true;
-        }
-      }
+      const bool inShown = field_shown(STATE_FIELD_IN_SENSOR);
+      const bool outShown = field_shown(STATE_FIELD_OUT_SENSOR);
+      const bool sensorsChanged = field_changed(STATE_FIELD_IN_SENSOR) || field_changed(STATE_FIELD_OUT_SENSOR) ||
+                                  field_changed(STATE_FIELD_CITYNAME) ||
+                                  inShown != inSensorShown || outShown != outSensorShown;
+      inSensorShown = inShown;
+      outSensorShown = outShown;
 
       if (sensorsChanged)
       {
-        // Перерисовать виджет с текущими флагами валидности
+        if (field_changed(STATE_FIELD_OUT_SENSOR))
+          ESP_LOGI("TFT", "Out sensor data updated: temp=%.1f, hum=%.1f, charge=%u%%",
+                   state.out.temperature, state.out.humidity, state.out.bat_charge);
+
         const uint8_t padding = 6;
         int x = 0;
         int y = MeteoWidgets::getClockDigsH() + padding;
         // Перерисовываем два раздельных виджета: наружный (лево) и внутренний (право)
         meteo_widgets->draw_home_out_data_widget(x, y,
-                                                 outSensorData.temperature, static_cast<uint8_t>(outSensorData.humidity),
-                                                 outSensorValid);
+                                                 state.out.temperature, static_cast<uint8_t>(state.out.humidity),
+                                                 outSensorShown);
         meteo_widgets->draw_home_in_data_widget(x, y,
-                                                inSensorData.temperature_in, inSensorData.humidity_in,
-                                                inSensorValid);
-        meteo_widgets->draw_city_name_widget(200, 60, cityName);
+                                                state.in.temperature_in, state.in.humidity_in,
+                                                inSensorShown);
+        if (field_restored(STATE_FIELD_OUT_SENSOR))
+          meteo_widgets->draw_stale_mark(x, y);
+        if (field_restored(STATE_FIELD_IN_SENSOR))
+          meteo_widgets->draw_stale_mark(x + MeteoWidgets::getWidgetHomeInX(), y);
+        // Обновить индикатор заряда батареи внешнего датчика
+        if (field_changed(STATE_FIELD_OUT_SENSOR))
+          meteo_widgets->draw_battery_level_widget(static_cast<uint8_t>(state.out.bat_charge));
+        meteo_widgets->draw_city_name_widget(200, 60, String(state.city));
+
+        // Задержка "измерение → пиксели" для новых показаний датчиков (у восстановленных её нет)
+        if (field_changed(STATE_FIELD_IN_SENSOR) && !field_restored(STATE_FIELD_IN_SENSOR))
+          LatencyTrace::record(LATENCY_POINT_TFT, state.stamp[STATE_FIELD_IN_SENSOR]);
+        if (field_changed(STATE_FIELD_OUT_SENSOR) && !field_restored(STATE_FIELD_OUT_SENSOR))
+          LatencyTrace::record(LATENCY_POINT_TFT, state.stamp[STATE_FIELD_OUT_SENSOR]);
+
+        drawnVersion[STATE_FIELD_IN_SENSOR] = state.version[STATE_FIELD_IN_SENSOR];
+        drawnVersion[STATE_FIELD_OUT_SENSOR] = state.version[STATE_FIELD_OUT_SENSOR];
+        drawnVersion[STATE_FIELD_CITYNAME] = state.version[STATE_FIELD_CITYNAME];
       }
     }
 
     // Определить, нужно ли перерисовать виджеты:
     // 1) Получены новые данные (meteoDataReceived) → отрисовать с valid=true
     // 2) Данные стали невалидными (переход prevMeteoValid → !meteoValid) → отрисовать с valid=false
-    bool needRedraw = meteoDataReceived || (prevMeteoValid && !meteoValid);
+    // 3) Сменилась дата (подпись "СЕГОДНЯ" у прогноза)
+    bool needRedraw = meteoDataReceived || (prevMeteoValid && !meteoShown) ||
+                      (notified & (NOTIFY_BIT_DATE | NOTIFY_BIT_TIME_SYNC)) != 0;
 
     if (needRedraw)
     {
-      bool validFlag = meteoDataReceived ? true : false; // если получены данные — valid=true, иначе false (stale)
+      bool validFlag = meteoShown; // свежие или восстановленные метеоданные — valid=true, иначе false (stale)
+      const bool meteoStale = field_restored(STATE_FIELD_METEO);
 
       // Current weather widget
-      if (haveMeteo[METEO_DATA_CURRENT])
+      if (state.meteo_mask & (1u << METEO_DATA_CURRENT))
       {
-        OpenMeteoData &d = latestMeteo[METEO_DATA_CURRENT];
+        const OpenMeteoData &d = state.meteo[METEO_DATA_CURRENT];
         meteo_widgets->draw_meteo_current_widget(MeteoWidgets::getScreenWidth() - MeteoWidgets::getWidgetCurW(), 60,
                                                  d.temperature,
                                                  static_cast<uint8_t>(d.relative_humidity),
                                                  d.wind_speed,
                                                  static_cast<uint16_t>(d.wind_direction),
                                                  static_cast<uint8_t>(d.weather_code), validFlag);
-        meteo_widgets->draw_city_name_widget(200, 60, cityName);
+        meteo_widgets->draw_city_name_widget(200, 60, String(state.city));
+        if (meteoStale)
+          meteo_widgets->draw_stale_mark(MeteoWidgets::getScreenWidth() - MeteoWidgets::getWidgetCurW(), 60);
       }
 
       // Forecast widgets (indices 1..3)
       for (int idx = 1; idx < _METEO_DATA_NUM_; ++idx)
       {
-        if (haveMeteo[idx])
+        if (state.meteo_mask & (1u << idx))
         {
-          OpenMeteoData &d = latestMeteo[idx];
+          const OpenMeteoData &d = state.meteo[idx];
           int col = idx - 1;
           int x = MeteoWidgets::getWidgetForW() * col;
           int y = MeteoWidgets::getScreenHeight() - MeteoWidgets::getWidgetForH();
 
-          // Определить отображаемую дату
-          char todayBuf[11];
-          snprintf(todayBuf, sizeof(todayBuf), "%02d-%02d-%04d", timeinfo.tm_mday, timeinfo.tm_mon + 1, timeinfo.tm_year + 1900);
+          // Определить отображаемую дату (без часов и оценки сегодняшняя дата неизвестна — сравнения нет)
+          char todayBuf[11] = "";
+          if (clockValid || clockEstimate)
+            snprintf(todayBuf, sizeof(todayBuf), "%02d-%02d-%04d", timeinfo.tm_mday, timeinfo.tm_mon + 1, timeinfo.tm_year + 1900);
           char dateDisplay[16];
-          if (d.date[0] && strcmp(d.date, todayBuf) == 0)
+          if (todayBuf[0] && d.date[0] && strcmp(d.date, todayBuf) == 0)
             strncpy(dateDisplay, "СЕГОДНЯ", sizeof(dateDisplay) - 1);
           else if (d.date[0])
             strncpy(dateDisplay, d.date, sizeof(dateDisplay) - 1);
@@ -349,9 +255,9 @@ void task_tft_exec(void *pvParameters)
             strncpy(dateDisplay, todayBuf, sizeof(dateDisplay) - 1);
           dateDisplay[sizeof(dateDisplay) - 1] = '\0';
 
-          float kp = (idx == METEO_DATA_FORECAST_TODAY)      ? geomag.kpmax_today
-                     : (idx == METEO_DATA_FORECAST_TOMORROW) ? geomag.kpmax_tomorrow
-                                                             : geomag.kpmax_tomorrow2;
+          float kp = (idx == METEO_DATA_FORECAST_TODAY)      ? state.geomag.kpmax_today
+                     : (idx == METEO_DATA_FORECAST_TOMORROW) ? state.geomag.kpmax_tomorrow
+                                                             : state.geomag.kpmax_tomorrow2;
 
           // Log heap state before forecast widget for debugging
           ESP_LOGI("HEAP", "Before forecast[%d]: Free: %u, largest block: %u, PSRAM free: %u",
@@ -368,13 +274,42 @@ void task_tft_exec(void *pvParameters)
                                                     static_cast<uint16_t>(d.precipitation),
                                                     static_cast<uint8_t>(d.weather_code),
                                                     String(dateDisplay), kp, validFlag);
+          if (meteoStale)
+            meteo_widgets->draw_stale_mark(x, y);
         }
       }
     }
 
-    // Обновить предыдущее состояние valid
-    prevMeteoValid = meteoValid;
-
-    vTaskDelayUntil(&xLastWakeTime, 1000 / portTICK_PERIOD_MS); // задержка 1 секунда
+    // Хронология загрузки: весь экран заполнен (в том числе восстановленными данными), затем — свежими
+    if (!f_first && inSensorShown && meteoShown)
+      BootTimeline::mark(BOOT_PHASE_FULL_SCREEN);
+    if (meteoValid && field_fresh(STATE_FIELD_IN_SENSOR))
+      BootTimeline::mark(BOOT_PHASE_FRESH_DATA);
+
+    // Обновить предыдущее состояние valid и выведенные версии метеоданных
+    prevMeteoValid = meteoShown;
+    drawnVersion[STATE_FIELD_METEO] = state.version[STATE_FIELD_METEO];
+    drawnVersion[STATE_FIELD_GEOMAGNETIC] = state.version[STATE_FIELD_GEOMAGNETIC];
+
+    // Спать до уведомления (состояние станции, биты системы, события часов)
+    // или ближайшего перехода отображаемых данных в stale
+    TickType_t wait = portMAX_DELAY;
+    if ((clockValid || clockEstimate) && f_first)
+      wait = pdMS_TO_TICKS(1000); // первая отрисовка часов не удалась — повторить
+    else if (clockEstimate)
+      wait = pdMS_TO_TICKS((60 - timeinfo.tm_sec) * 1000); // событий минуты без синхронизации нет
+    {
+      const StateField_t staleFields[] = {STATE_FIELD_METEO, STATE_FIELD_IN_SENSOR, STATE_FIELD_OUT_SENSOR};
+      const TickType_t validTicks = pdMS_TO_TICKS(MAX_METEO_VALID_INTERVAL_MS);
+      const TickType_t nowTicks = xTaskGetTickCount();
+      for (StateField_t f : staleFields)
+      {
+        const TickType_t age = nowTicks - state.updated_tick[f];
+        if (state.version[f] != 0 && age < validTicks)
+          wait = std::min(wait, validTicks - age + 1);
+      }
+    }
+    notified = 0;
+    xTaskNotifyWait(0, ULONG_MAX, &notified, wait);
   }
 }
@@ -0,0 +1,318 @@
+#include "tslog.h"
+#include <esp_attr.h>
+#include <esp_heap_caps.h>
+#include <esp_log.h>
+#include <esp_partition.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "TSLOG";
+
+#define TSLOG_RTC_MAGIC 0x43545254u // "TRTC": заполняемая страница в памяти RTC
+
+// Заполняемая страница в памяти RTC (не очищается при сбросе); CRC — признак целостности
+struct TsLogRtc_t
+{
+  uint32_t magic;      // TSLOG_RTC_MAGIC
+  uint32_t crc;        // CRC-32 writer
+  TsPageWriter writer; // заполняемая страница
+};
+
+static RTC_NOINIT_ATTR TsLogRtc_t s_rtc;
+
+static const esp_partition_t *s_part = nullptr; // раздел журнала
+static uint32_t s_pages = 0;                    // страниц в разделе
+static SemaphoreHandle_t s_mutex = nullptr;     // доступ к заполняемой странице и счётчикам
+static StaticSemaphore_t s_mutex_buf;
+static uint32_t s_valid_pages = 0;              // записанных страниц с верной CRC
+static uint32_t s_records = 0;                  // записей во флеш-памяти
+static uint32_t s_last_time = 0;                // время последней записи
+static uint32_t s_page_writes = 0;              // записано страниц с момента загрузки
+static uint32_t s_write_errors = 0;             // ошибок стирания/записи
+static uint32_t s_rejected = 0;                 // отброшенных записей
+static bool s_resumed = false;                  // заполняемая страница восстановлена после сброса
+
+/// @brief элемент индекса страниц: диапазон времени страницы в секторе (без чтения флеш-памяти)
+struct TsPageIndex_t
+{
+  uint32_t seq;        // порядковый номер страницы
+  uint32_t first_time; // время первой записи
+  uint32_t last_time;  // время последней записи (0 — в секторе нет целой страницы)
+};
+
+static TsPageIndex_t *s_index = nullptr; // индекс страниц по секторам (строится при запуске)
+
+static uint32_t rtc_crc()
+{
+  return tslog_crc32(0, reinterpret_cast<const uint8_t *>(&s_rtc.writer), sizeof(s_rtc.writer));
+}
+
+// Зафиксировать изменение заполняемой страницы: сброс посреди изменения даст неверную CRC
+static void rtc_commit()
+{
+  s_rtc.magic = TSLOG_RTC_MAGIC;
+  s_rtc.crc = rtc_crc();
+}
+
+// Буфер страницы для чтения раздела (PSRAM, если есть)
+static uint8_t *page_alloc()
+{
+  uint8_t *buf = static_cast<uint8_t *>(heap_caps_malloc(TSLOG_PAGE_SIZE, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+  if (!buf)
+    buf = static_cast<uint8_t *>(heap_caps_malloc(TSLOG_PAGE_SIZE, MALLOC_CAP_8BIT));
+  return buf;
+}
+
+static size_t page_offset(uint32_t seq)
+{
+  return static_cast<size_t>(seq % s_pages) * TSLOG_PAGE_SIZE;
+}
+
+// Диапазон времени страницы seq из индекса; false — в секторе другая страница или сектор пуст
+static bool index_lookup(uint32_t seq, TsPageIndex_t &out)
+{
+  out = s_index[seq % s_pages];
+  return out.last_time != 0 && out.seq == seq;
+}
+
+// Записать заполненную страницу в её сектор (стирание и запись целой страницы)
+static void write_page()
+{
+  TsPageWriter &w = s_rtc.writer;
+  w.seal();
+  rtc_commit(); // сброс во время записи: страница будет записана заново после запуска
+
+  // страница, которую заменяет новая (на оборот кольца старше), учтена, только если она цела
+  const size_t offset = page_offset(w.seq());
+  uint8_t *buf = w.seq() >= s_pages ? page_alloc() : nullptr;
+  TsPageHeader_t old;
+  if (buf && esp_partition_read(s_part, offset, buf, TSLOG_PAGE_SIZE) == ESP_OK && TsPageReader::check(buf, old) &&
+      old.seq == w.seq() - s_pages)
+  {
+    s_records -= old.count;
+    s_valid_pages--;
+  }
+  heap_caps_free(buf);
+  s_index[w.seq() % s_pages].last_time = 0; // сектор стирается: до успешной записи страницы в нём нет
+
+  esp_err_t err = esp_partition_erase_range(s_part, offset, TSLOG_PAGE_SIZE);
+  if (err == ESP_OK)
+    err = esp_partition_write(s_part, offset, w.data(), TSLOG_PAGE_SIZE);
+  if (err != ESP_OK)
+  {
+    s_write_errors++;
+    ESP_LOGE(TAG, "Page %u write failed: %s", w.seq(), esp_err_to_name(err));
+    return;
+  }
+  TsPageHeader_t h;
+  TsPageReader::peek(w.data(), h); // заголовок заполнен seal()
+  s_index[w.seq() % s_pages] = {h.seq, h.first_time, h.last_time};
+  s_records += w.count();
+  s_valid_pages++;
+  s_page_writes++;
+  ESP_LOGI(TAG, "Page %u written: %u records, %u bits", w.seq(), w.count(), w.used_bits());
+}
+
+bool TsLog::begin()
+{
+  s_part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, TSLOG_PARTITION_LABEL);
+  if (!s_part)
+  {
+    ESP_LOGE(TAG, "Partition '%s' not found", TSLOG_PARTITION_LABEL);
+    return false;
+  }
+  // повторный вызов (перезапуск журнала) строит индекс и счётчики заново
+  free(s_index);
+  s_valid_pages = s_records = s_last_time = 0;
+  s_page_writes = s_write_errors = s_rejected = 0;
+  s_pages = s_part->size / TSLOG_PAGE_SIZE;
+  s_index = static_cast<TsPageIndex_t *>(calloc(s_pages, sizeof(TsPageIndex_t)));
+  uint8_t *buf = page_alloc();
+  if (!buf || !s_index)
+  {
+    ESP_LOGE(TAG, "No memory for page buffer and index");
+    heap_caps_free(buf);
+    return false;
+  }
+  if (!s_mutex)
+    s_mutex = xSemaphoreCreateMutexStatic(&s_mutex_buf);
+
+  // Просмотр кольца: продолжение после страницы с наибольшим номером
+  bool found = false;
+  uint32_t head = 0;
+  for (uint32_t slot = 0; slot < s_pages; ++slot)
+  {
+    TsPageHeader_t h;
+    if (esp_partition_read(s_part, slot * TSLOG_PAGE_SIZE, buf, TSLOG_PAGE_SIZE) != ESP_OK ||
+        !TsPageReader::check(buf, h) || h.seq % s_pages != slot)
+      continue;
+    s_index[slot] = {h.seq, h.first_time, h.last_time};
+    s_valid_pages++;
+    s_records += h.count;
+    if (!found || h.seq > head)
+    {
+      head = h.seq;
+      s_last_time = h.last_time;
+      found = true;
+    }
+  }
+  heap_caps_free(buf);
+  const uint32_t next_seq = found ? head + 1 : 0;
+
+  // Заполняемая страница переживает сброс, если она цела и продолжает кольцо
+  s_resumed = s_rtc.magic == TSLOG_RTC_MAGIC && s_rtc.crc == rtc_crc() && s_rtc.writer.seq() == next_seq;
+  if (s_resumed)
+  {
+    if (s_rtc.writer.count())
+      s_last_time = s_rtc.writer.last_time();
+  }
+  else
+  {
+    s_rtc.writer.begin(next_seq);
+    rtc_commit();
+  }
+
+  ESP_LOGI(TAG, "%u KB, %u/%u pages valid, %u records; page %u %s (%u records)", s_part->size / 1024,
+           s_valid_pages, s_pages, s_records, next_seq, s_resumed ? "resumed" : "started", s_rtc.writer.count());
+  return true;
+}
+
+bool TsLog::append(const TsRecord_t &rec)
+{
+  if (!s_mutex)
+    return false;
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  if (rec.time <= s_last_time)
+  {
+    s_rejected++;
+    xSemaphoreGive(s_mutex);
+    return false;
+  }
+  if (!s_rtc.writer.append(rec))
+  {
+    write_page();
+    s_rtc.writer.begin(s_rtc.writer.seq() + 1);
+    s_rtc.writer.append(rec);
+  }
+  rtc_commit();
+  s_last_time = rec.time;
+  xSemaphoreGive(s_mutex);
+  return true;
+}
+
+// Передать обработчику записи страницы с временем в [from, to]; false — чтение закончено
+static bool visit_page(const uint8_t *page, uint16_t count, uint32_t from, uint32_t to, TsLogVisitor_t visit,
+                       void *ctx, size_t &visited)
+{
+  TsPageReader reader;
+  reader.open(page, count);
+  TsRecord_t rec;
+  while (reader.next(rec))
+  {
+    if (rec.time < from)
+      continue;
+    if (rec.time > to)
+      return false;
+    visited++;
+    if (!visit(rec, ctx))
+      return false;
+  }
+  return true;
+}
+
+size_t TsLog::read(uint32_t from, uint32_t to, TsLogVisitor_t visit, void *ctx)
+{
+  if (!s_mutex)
+    return 0;
+  uint8_t *buf = page_alloc();
+  if (!buf)
+    return 0;
+
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  const uint32_t head = s_rtc.writer.seq();
+  xSemaphoreGive(s_mutex);
+
+  // Страницы во флеш-памяти от старых к новым; страницы вне интервала отбрасываются по индексу,
+  // флеш-память читается только для страниц, пересекающих интервал
+  size_t visited = 0;
+  bool more = true;
+  for (uint32_t seq = head > s_pages ? head - s_pages : 0; more && seq < head; ++seq)
+  {
+    TsPageIndex_t entry;
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    const bool valid = index_lookup(seq, entry);
+    xSemaphoreGive(s_mutex);
+    if (!valid || entry.last_time < from)
+      continue;
+    if (entry.first_time > to)
+      break;
+    // сектор мог быть перезаписан после просмотра индекса — номер проверяется по странице
+    TsPageHeader_t h;
+    if (esp_partition_read(s_part, page_offset(seq), buf, TSLOG_PAGE_SIZE) != ESP_OK ||
+        !TsPageReader::check(buf, h) || h.seq != seq)
+      continue;
+    more = visit_page(buf, h.count, from, to, visit, ctx, visited);
+  }
+
+  // Заполняемая страница — копия из памяти RTC
+  if (more)
+  {
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    const uint16_t count = s_rtc.writer.seq() == head ? s_rtc.writer.count() : 0;
+    memcpy(buf, s_rtc.writer.data(), TSLOG_PAGE_SIZE);
+    xSemaphoreGive(s_mutex);
+    visit_page(buf, count, from, to, visit, ctx, visited);
+  }
+
+  heap_caps_free(buf);
+  return visited;
+}
+
+void TsLog::get_stats(TsLogStats_t &out)
+{
+  memset(&out, 0, sizeof(out));
+  if (!s_mutex)
+    return;
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  out.pages = s_pages;
+  out.valid_pages = s_valid_pages;
+  out.head_seq = s_rtc.writer.seq();
+  out.open_records = s_rtc.writer.count();
+  out.records = s_records;
+  out.last_time = s_last_time;
+  out.page_writes = s_page_writes;
+  out.write_errors = s_write_errors;
+  out.rejected = s_rejected;
+  out.resumed = s_resumed;
+  // самая старая запись — первая сохранившаяся страница кольца
+  for (uint32_t seq = out.head_seq > s_pages ? out.head_seq - s_pages : 0; seq < out.head_seq; ++seq)
+  {
+    TsPageIndex_t entry;
+    if (index_lookup(seq, entry))
+    {
+      out.first_time = entry.first_time;
+      break;
+    }
+  }
+  if (!out.first_time && out.open_records)
+  {
+    TsPageReader reader;
+    TsRecord_t rec;
+    reader.open(s_rtc.writer.data(), 1); // журнал только в заполняемой странице
+    if (reader.next(rec))
+      out.first_time = rec.time;
+  }
+  xSemaphoreGive(s_mutex);
+}
+
+void TsLog::log_stats()
+{
+  TsLogStats_t st;
+  get_stats(st);
+  const uint32_t days = st.first_time && st.last_time > st.first_time ? (st.last_time - st.first_time) / 86400 : 0;
+  ESP_LOGI(TAG, "pages=%u/%u head=%u records=%u+%u span=%u d writes=%u errors=%u rejected=%u%s", st.valid_pages,
+           st.pages, st.head_seq, st.records, st.open_records, days, st.page_writes, st.write_errors, st.rejected,
+           st.resumed ? " (resumed)" : "");
+}
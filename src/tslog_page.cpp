@@ -0,0 +1,245 @@
+#include "tslog_page.h"
+#include <string.h>
+
+// Ширины полей после префикса: разность разностей времени и разность значения канала
+static const uint8_t kTimeWidths[4] = {7, 9, 12, 32};
+static const uint8_t kValueWidths[4] = {3, 6, 10, 16};
+
+static inline uint16_t get_u16(const uint8_t *p)
+{
+  return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+static inline void put_u16(uint8_t *p, uint16_t v)
+{
+  p[0] = static_cast<uint8_t>(v);
+  p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+static inline uint32_t get_u32(const uint8_t *p)
+{
+  return static_cast<uint32_t>(get_u16(p)) | (static_cast<uint32_t>(get_u16(p + 2)) << 16);
+}
+
+static inline void put_u32(uint8_t *p, uint32_t v)
+{
+  put_u16(p, static_cast<uint16_t>(v));
+  put_u16(p + 2, static_cast<uint16_t>(v >> 16));
+}
+
+// Размер закодированного значения с префиксом длины (бит)
+static uint8_t signed_bits(int32_t value, const uint8_t *widths)
+{
+  if (value == 0)
+    return 1;
+  for (uint8_t i = 0; i < 3; ++i)
+  {
+    const int32_t half = 1 << (widths[i] - 1);
+    if (value >= -half && value < half)
+      return static_cast<uint8_t>(i + 2 + widths[i]);
+  }
+  return static_cast<uint8_t>(4 + widths[3]);
+}
+
+uint32_t tslog_crc32(uint32_t crc, const uint8_t *data, size_t len)
+{
+  // таблица на полубайт: 64 байта вместо 1 КБ
+  static const uint32_t kNibble[16] = {
+      0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+      0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C};
+  crc = ~crc;
+  for (size_t i = 0; i < len; ++i)
+  {
+    crc ^= data[i];
+    crc = (crc >> 4) ^ kNibble[crc & 0x0F];
+    crc = (crc >> 4) ^ kNibble[crc & 0x0F];
+  }
+  return ~crc;
+}
+
+// CRC страницы без поля CRC
+static uint32_t page_crc(const uint8_t *page)
+{
+  static const uint8_t kZero[4] = {0, 0, 0, 0};
+  uint32_t crc = tslog_crc32(0, page, 20);
+  crc = tslog_crc32(crc, kZero, sizeof(kZero));
+  return tslog_crc32(crc, page + TSLOG_HEADER_SIZE, TSLOG_PAGE_SIZE - TSLOG_HEADER_SIZE);
+}
+
+void TsPageWriter::begin(uint32_t seq)
+{
+  memset(page, 0, sizeof(page));
+  page_seq = seq;
+  bits = 0;
+  first_time = 0;
+  prev_delta = 0;
+  memset(&prev, 0, sizeof(prev));
+  records = 0;
+}
+
+void TsPageWriter::put(uint32_t value, uint8_t width)
+{
+  uint8_t *body = page + TSLOG_HEADER_SIZE;
+  while (width)
+  {
+    const uint8_t room = static_cast<uint8_t>(8 - (bits & 7)); // свободно бит в текущем байте
+    const uint8_t n = width < room ? width : room;
+    const uint32_t chunk = (value >> (width - n)) & ((1u << n) - 1);
+    body[bits >> 3] |= static_cast<uint8_t>(chunk << (room - n));
+    bits += n;
+    width = static_cast<uint8_t>(width - n);
+  }
+}
+
+void TsPageWriter::put_signed(int32_t value, const uint8_t *widths)
+{
+  if (value == 0)
+  {
+    put(0, 1);
+    return;
+  }
+  for (uint8_t i = 0; i < 3; ++i)
+  {
+    const int32_t half = 1 << (widths[i] - 1);
+    if (value >= -half && value < half)
+    {
+      put(((1u << (i + 1)) - 1) << 1, static_cast<uint8_t>(i + 2)); // i+1 единиц и ноль
+      put(static_cast<uint32_t>(value), widths[i]);
+      return;
+    }
+  }
+  put(0xF, 4);
+  put(static_cast<uint32_t>(value), widths[3]);
+}
+
+bool TsPageWriter::append(const TsRecord_t &rec)
+{
+  if (records == UINT16_MAX)
+    return false;
+
+  if (records == 0)
+  {
+    if (32 + 16 * TSLOG_CHANNELS > TSLOG_BODY_BITS)
+      return false;
+    put(rec.time, 32);
+    for (uint8_t c = 0; c < TSLOG_CHANNELS; ++c)
+      put(static_cast<uint16_t>(rec.value[c]), 16);
+    first_time = rec.time;
+  }
+  else
+  {
+    // арифметика по модулю 2^32 и 2^16: любые значения кодируются без переполнения
+    const int32_t delta = static_cast<int32_t>(rec.time - prev.time);
+    const int32_t dod = static_cast<int32_t>(static_cast<uint32_t>(delta) - static_cast<uint32_t>(prev_delta));
+    int16_t diff[TSLOG_CHANNELS];
+    uint32_t need = signed_bits(dod, kTimeWidths);
+    for (uint8_t c = 0; c < TSLOG_CHANNELS; ++c)
+    {
+      diff[c] = static_cast<int16_t>(static_cast<uint16_t>(rec.value[c]) - static_cast<uint16_t>(prev.value[c]));
+      need += signed_bits(diff[c], kValueWidths);
+    }
+    if (bits + need > TSLOG_BODY_BITS)
+      return false;
+
+    put_signed(dod, kTimeWidths);
+    for (uint8_t c = 0; c < TSLOG_CHANNELS; ++c)
+      put_signed(diff[c], kValueWidths);
+    prev_delta = delta;
+  }
+  prev = rec;
+  records++;
+  return true;
+}
+
+void TsPageWriter::seal()
+{
+  put_u32(&page[0], TSLOG_MAGIC);
+  put_u32(&page[4], page_seq);
+  put_u32(&page[8], first_time);
+  put_u32(&page[12], last_time());
+  put_u16(&page[16], records);
+  page[18] = TSLOG_VERSION;
+  page[19] = TSLOG_CHANNELS;
+  put_u32(&page[20], page_crc(page));
+}
+
+bool TsPageReader::peek(const uint8_t *header, TsPageHeader_t &out)
+{
+  if (get_u32(&header[0]) != TSLOG_MAGIC || header[18] != TSLOG_VERSION || header[19] != TSLOG_CHANNELS)
+    return false;
+  out.seq = get_u32(&header[4]);
+  out.first_time = get_u32(&header[8]);
+  out.last_time = get_u32(&header[12]);
+  out.count = get_u16(&header[16]);
+  return true;
+}
+
+bool TsPageReader::check(const uint8_t *page, TsPageHeader_t &out)
+{
+  return peek(page, out) && get_u32(&page[20]) == page_crc(page);
+}
+
+void TsPageReader::open(const uint8_t *data, uint16_t count)
+{
+  page = data;
+  bits = 0;
+  left = count;
+  index = 0;
+  prev_delta = 0;
+  memset(&prev, 0, sizeof(prev));
+}
+
+uint32_t TsPageReader::get(uint8_t width)
+{
+  const uint8_t *body = page + TSLOG_HEADER_SIZE;
+  uint32_t value = 0;
+  while (width)
+  {
+    const uint8_t room = static_cast<uint8_t>(8 - (bits & 7));
+    const uint8_t n = width < room ? width : room;
+    const uint32_t chunk = (body[bits >> 3] >> (room - n)) & ((1u << n) - 1);
+    value = (value << n) | chunk;
+    bits += n;
+    width = static_cast<uint8_t>(width - n);
+  }
+  return value;
+}
+
+int32_t TsPageReader::get_signed(const uint8_t *widths)
+{
+  uint8_t ones = 0;
+  while (ones < 4 && get(1))
+    ones++;
+  if (ones == 0)
+    return 0;
+  const uint8_t width = widths[ones - 1];
+  const uint32_t raw = get(width);
+  if (width == 32)
+    return static_cast<int32_t>(raw);
+  const uint32_t sign = 1u << (width - 1);
+  return static_cast<int32_t>((raw ^ sign) - sign); // расширение знака
+}
+
+bool TsPageReader::next(TsRecord_t &out)
+{
+  if (!left)
+    return false;
+  // поток не может выйти за страницу: запись проверяется на размер при добавлении
+  if (index == 0)
+  {
+    prev.time = get(32);
+    for (uint8_t c = 0; c < TSLOG_CHANNELS; ++c)
+      prev.value[c] = static_cast<int16_t>(get(16));
+  }
+  else
+  {
+    prev_delta = static_cast<int32_t>(static_cast<uint32_t>(prev_delta) + static_cast<uint32_t>(get_signed(kTimeWidths)));
+    prev.time += static_cast<uint32_t>(prev_delta);
+    for (uint8_t c = 0; c < TSLOG_CHANNELS; ++c)
+      prev.value[c] = static_cast<int16_t>(static_cast<uint16_t>(prev.value[c]) + static_cast<uint16_t>(get_signed(kValueWidths)));
+  }
+  index++;
+  left--;
+  out = prev;
+  return true;
+}
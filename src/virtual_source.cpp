@@ -0,0 +1,114 @@
+#include "virtual_source.h"
+#include <math.h>
+#include <stdlib.h>
+
+static const double kDayMs = 86400000.0;
+static const double kTwoPi = 6.283185307179586;
+
+// Разбор поля CSV: значение и следующий за ним разделитель (',' или конец строки для последнего поля)
+static bool next_field(const char *&p, bool last)
+{
+  if (last)
+    return *p == '\0' || *p == '\r' || *p == '\n';
+  if (*p != ',')
+    return false;
+  ++p;
+  return true;
+}
+
+bool VirtualSource::parse_line(const char *line, VirtualSample_t &out)
+{
+  while (*line == ' ' || *line == '\t')
+    ++line;
+  if (*line < '0' || *line > '9') // пустая строка, комментарий или заголовок
+    return false;
+
+  char *end;
+  const char *p = line;
+  out.t_ms = strtoul(p, &end, 10);
+  if (!next_field(p = end, false))
+    return false;
+  out.node = static_cast<uint8_t>(strtoul(p, &end, 10));
+  if (!next_field(p = end, false))
+    return false;
+  out.temperature = strtof(p, &end);
+  if (!next_field(p = end, false))
+    return false;
+  out.humidity = strtof(p, &end);
+  if (!next_field(p = end, false))
+    return false;
+  out.pressure = strtof(p, &end);
+  if (!next_field(p = end, false))
+    return false;
+  out.battery = static_cast<uint8_t>(strtoul(p, &end, 10));
+  return next_field(p = end, true);
+}
+
+VirtualFileSource::VirtualFileSource(const char *path) : file(fopen(path, "r"))
+{
+}
+
+VirtualFileSource::~VirtualFileSource()
+{
+  if (file)
+    fclose(file);
+}
+
+bool VirtualFileSource::next(VirtualSample_t &out)
+{
+  if (!file)
+    return false;
+  char line[96];
+  while (fgets(line, sizeof(line), file))
+  {
+    if (parse_line(line, out))
+      return true;
+  }
+  return false;
+}
+
+void VirtualFileSource::rewind()
+{
+  if (file)
+    fseek(file, 0, SEEK_SET);
+}
+
+VirtualSynthSource::VirtualSynthSource(uint8_t nodes, uint32_t interval_ms, uint32_t burst_every, uint32_t seed)
+    : nodes(nodes ? nodes : 1), interval_ms(interval_ms), burst_every(burst_every), seed(seed), state(seed), index(0)
+{
+}
+
+float VirtualSynthSource::noise(float amplitude)
+{
+  state = state * 1664525u + 1013904223u; // LCG (Numerical Recipes)
+  return amplitude * (static_cast<float>(state >> 8) / 8388608.0f - 1.0f);
+}
+
+bool VirtualSynthSource::next(VirtualSample_t &out)
+{
+  const uint32_t round = index / nodes;
+  const uint8_t node = static_cast<uint8_t>(index % nodes);
+  // трасса кончается раньше переполнения 32-битного времени (около 49 суток)
+  if (static_cast<uint64_t>(round + 1) * interval_ms > 0xF0000000ull)
+    return false;
+  index++;
+
+  // пачка: все узлы подряд с интервалом 2 мс в начале периода
+  const bool burst = burst_every && round % burst_every == burst_every - 1;
+  out.t_ms = round * interval_ms + (burst ? node * 2u : interval_ms / nodes * node);
+  out.node = node;
+
+  const double day = out.t_ms / kDayMs;
+  const double diurnal = sin(kTwoPi * (day - 0.375)); // минимум температуры около 03:00
+  out.temperature = static_cast<float>(12.0 + 6.0 * diurnal + 0.7 * node) + noise(0.05f);
+  out.humidity = static_cast<float>(65.0 - 15.0 * diurnal) + noise(0.3f);
+  out.pressure = static_cast<float>(1013.0 + 6.0 * sin(kTwoPi * day / 3.0)) + noise(0.05f);
+  out.battery = static_cast<uint8_t>(100 - (round / 1000) % 50);
+  return true;
+}
+
+void VirtualSynthSource::rewind()
+{
+  state = seed;
+  index = 0;
+}
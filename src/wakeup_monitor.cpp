@@ -0,0 +1,18 @@
+#include "wakeup_monitor.h"
+
+void wakeup_monitor_tick(WakeupMonitor_t *mon)
+{
+  if (!mon)
+    return;
+  mon->count++;
+
+  const TickType_t elapsed = xTaskGetTickCount() - mon->window_start;
+  if (elapsed >= pdMS_TO_TICKS(60000))
+  {
+    // нормировать на минуту: окно может быть длиннее, если задача спала дольше минуты
+    mon->last_rate = (uint32_t)(((uint64_t)mon->count * pdMS_TO_TICKS(60000)) / elapsed);
+    ESP_LOGI("WAKEUP", "[%s] wakeups: %u/min", mon->tag, (unsigned int)mon->last_rate);
+    mon->count = 0;
+    mon->window_start = xTaskGetTickCount();
+  }
+}
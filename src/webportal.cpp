@@ -7,7 +7,7 @@
 
 #include "webportal.h"
 #include "common.h"
-#include "nvscfg.h"
+#include "config_service.h"
 #include <WiFiUdp.h>
 #include <atomic>
 
@@ -240,7 +240,10 @@ WebConfig::WebConfig(WiFiManager &wm_ref)
       //custom_bot_chat_id("bot_chat_id", "Telegram bot chat ID"),
       custom_lat("latitude", "Latitude for Open-Meteo (e.g. \"47.2329\")"),
       custom_long("longitude", "Longitude for Open-Meteo (e.g. \"39.7075\")"),
-      custom_gmt_offset("gmt_offset_sec", "GMT offset seconds (e.g. \"10800\")")
+      custom_gmt_offset("gmt_offset_sec", "GMT offset seconds (e.g. \"10800\")"),
+      custom_sample_min("sample_min_sec", "Min indoor sensor interval, s (e.g. \"30\")"),
+      custom_sample_max("sample_max_sec", "Max indoor sensor interval, s (e.g. \"600\")"),
+      custom_out_interval("out_interval_sec", "Outdoor sensor report interval, s (e.g. \"60\")")
 {
   wm.addParameter(&custom_mqtt_server);
   wm.addParameter(&custom_mqtt_port);
@@ -252,6 +255,9 @@ WebConfig::WebConfig(WiFiManager &wm_ref)
   wm.addParameter(&custom_lat);
   wm.addParameter(&custom_long);
   wm.addParameter(&custom_gmt_offset);
+  wm.addParameter(&custom_sample_min);
+  wm.addParameter(&custom_sample_max);
+  wm.addParameter(&custom_out_interval);
 }
 
 // ---------------------------------------------------------------------------
@@ -273,9 +279,6 @@ void WebConfig::process_autoconnect_or_config(bool f_on_demand)
   if (!f_on_demand && WiFi.status() == WL_CONNECTED)
     return;
 
-  // Миграция конфигурации из LittleFS в NVS (при первом запуске после обновления)
-  NvsCfg::migrate(/*delete_old_file=*/true);
-
   // читаем конфигурацию перед запуском портала конфигурирования
   const bool configOk = get_config(cfg);
   if (configOk)
@@ -292,6 +295,9 @@ void WebConfig::process_autoconnect_or_config(bool f_on_demand)
     ESP_LOGI(TAG, "  latitude       : %s", cfg.latitude);
     ESP_LOGI(TAG, "  longitude      : %s", cfg.longitude);
     ESP_LOGI(TAG, "  gmt_offset_sec : %s", cfg.gmt_offset_sec);
+    ESP_LOGI(TAG, "  sample_min_sec : %s", cfg.sample_min_sec);
+    ESP_LOGI(TAG, "  sample_max_sec : %s", cfg.sample_max_sec);
+    ESP_LOGI(TAG, "  out_interval  : %s", cfg.out_interval_sec);
   }
 
   // Обновить значения параметров WiFiManager из конфигурации
@@ -305,6 +311,9 @@ void WebConfig::process_autoconnect_or_config(bool f_on_demand)
   custom_lat.setValue(cfg.latitude, sizeof(cfg.latitude));
   custom_long.setValue(cfg.longitude, sizeof(cfg.longitude));
   custom_gmt_offset.setValue(cfg.gmt_offset_sec, sizeof(cfg.gmt_offset_sec));
+  custom_sample_min.setValue(cfg.sample_min_sec, sizeof(cfg.sample_min_sec));
+  custom_sample_max.setValue(cfg.sample_max_sec, sizeof(cfg.sample_max_sec));
+  custom_out_interval.setValue(cfg.out_interval_sec, sizeof(cfg.out_interval_sec));
 
   bool needPortal = f_on_demand || !configOk;
 
@@ -352,6 +361,9 @@ void WebConfig::process_autoconnect_or_config(bool f_on_demand)
   strncpy(cfg.latitude, custom_lat.getValue(), sizeof(cfg.latitude) - 1);
   strncpy(cfg.longitude, custom_long.getValue(), sizeof(cfg.longitude) - 1);
   strncpy(cfg.gmt_offset_sec, custom_gmt_offset.getValue(), sizeof(cfg.gmt_offset_sec) - 1);
+  strncpy(cfg.sample_min_sec, custom_sample_min.getValue(), sizeof(cfg.sample_min_sec) - 1);
+  strncpy(cfg.sample_max_sec, custom_sample_max.getValue(), sizeof(cfg.sample_max_sec) - 1);
+  strncpy(cfg.out_interval_sec, custom_out_interval.getValue(), sizeof(cfg.out_interval_sec) - 1);
 
   // Сохранить пользовательские параметры в FS
   if (shouldSaveConfig)
@@ -365,13 +377,13 @@ void WebConfig::process_autoconnect_or_config(bool f_on_demand)
 // ---------------------------------------------------------------------------
 bool WebConfig::get_config(PrjCfgData &cfg)
 {
-  return NvsCfg::load(cfg);
+  return ConfigService::get(cfg);
 }
 
 // ---------------------------------------------------------------------------
 bool WebConfig::set_config(const PrjCfgData &cfg)
 {
-  return NvsCfg::save(cfg);
+  return ConfigService::save(cfg);
 }
 
 // ---------------------------------------------------------------------------
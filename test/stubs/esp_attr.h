@@ -0,0 +1,27 @@
+#ifndef _STUB_ESP_ATTR_H_
+#define _STUB_ESP_ATTR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define IRAM_ATTR
+
+// Заглушка для сборки на хосте: память RTC — отдельная секция, чтобы тест мог имитировать
+// отключение питания (стереть секцию) и сброс посреди операции (вернуть её снимок).
+// Границы секции даёт компоновщик ELF; на других форматах секции нет (размер 0)
+#if defined(__ELF__)
+#define RTC_NOINIT_ATTR __attribute__((section("rtc_noinit_sim")))
+extern "C" uint8_t __start_rtc_noinit_sim[] __attribute__((weak));
+extern "C" uint8_t __stop_rtc_noinit_sim[] __attribute__((weak));
+inline uint8_t *rtc_noinit_begin() { return __start_rtc_noinit_sim; }
+inline size_t rtc_noinit_size()
+{
+  return __start_rtc_noinit_sim ? static_cast<size_t>(__stop_rtc_noinit_sim - __start_rtc_noinit_sim) : 0;
+}
+#else
+#define RTC_NOINIT_ATTR
+inline uint8_t *rtc_noinit_begin() { return nullptr; }
+inline size_t rtc_noinit_size() { return 0; }
+#endif
+
+#endif // _STUB_ESP_ATTR_H_
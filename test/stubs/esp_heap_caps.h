@@ -0,0 +1,14 @@
+#ifndef _STUB_ESP_HEAP_CAPS_H_
+#define _STUB_ESP_HEAP_CAPS_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+
+// Заглушка для сборки на хосте: все области памяти — куча процесса
+#define MALLOC_CAP_SPIRAM (1 << 10)
+#define MALLOC_CAP_8BIT (1 << 2)
+
+inline void *heap_caps_malloc(size_t size, uint32_t) { return malloc(size); }
+inline void heap_caps_free(void *ptr) { free(ptr); }
+
+#endif // _STUB_ESP_HEAP_CAPS_H_
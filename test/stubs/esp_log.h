@@ -0,0 +1,19 @@
+#ifndef _STUB_ESP_LOG_H_
+#define _STUB_ESP_LOG_H_
+
+#include <stdio.h>
+
+// Заглушка для сборки на хосте: предупреждения и ошибки — в stdout, остальное отбрасывается
+#define ESP_LOGE(tag, fmt, ...) printf("E %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) printf("W %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOG_DISCARD(tag, fmt, ...)                                                                              \
+  do                                                                                                                   \
+  {                                                                                                                    \
+    if (0)                                                                                                             \
+      printf("%s: " fmt, tag, ##__VA_ARGS__);                                                                          \
+  } while (0)
+#define ESP_LOGI(tag, fmt, ...) ESP_LOG_DISCARD(tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) ESP_LOG_DISCARD(tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGV(tag, fmt, ...) ESP_LOG_DISCARD(tag, fmt, ##__VA_ARGS__)
+
+#endif // _STUB_ESP_LOG_H_
@@ -0,0 +1,112 @@
+#ifndef _STUB_ESP_PARTITION_H_
+#define _STUB_ESP_PARTITION_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Заглушка для сборки на хосте: раздел флеш-памяти в ОЗУ с поведением NOR-флеш
+// (стирание в 0xFF, запись только сбрасывает биты) и имитацией прерванной записи
+
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_INVALID_ARG 0x102
+#define ESP_ERR_INVALID_SIZE 0x104
+
+typedef enum
+{
+  ESP_PARTITION_TYPE_APP = 0x00,
+  ESP_PARTITION_TYPE_DATA = 0x01,
+} esp_partition_type_t;
+
+typedef enum
+{
+  ESP_PARTITION_SUBTYPE_ANY = 0xff,
+} esp_partition_subtype_t;
+
+typedef struct
+{
+  esp_partition_type_t type;
+  uint32_t address;
+  uint32_t size;
+  char label[17];
+} esp_partition_t;
+
+/// @brief раздел в ОЗУ, который видит код под тестом
+struct FakePartition_t
+{
+  esp_partition_t part; // описание раздела (label задаёт тест)
+  uint8_t *data;        // содержимое (nullptr — раздела нет)
+  size_t torn_write;    // >0: следующая запись обрывается после стольких байт и возвращает ESP_FAIL
+  uint32_t erases;      // выполнено стираний
+  uint32_t writes;      // выполнено записей
+};
+
+inline FakePartition_t &fake_partition()
+{
+  static FakePartition_t p;
+  return p;
+}
+
+/** @brief Создать чистый (стёртый) раздел `label` размером `size` байт */
+inline void fake_partition_create(const char *label, uint32_t size)
+{
+  FakePartition_t &p = fake_partition();
+  free(p.data);
+  memset(&p, 0, sizeof(p));
+  p.part.type = ESP_PARTITION_TYPE_DATA;
+  p.part.size = size;
+  strncpy(p.part.label, label, sizeof(p.part.label) - 1);
+  p.data = static_cast<uint8_t *>(malloc(size));
+  memset(p.data, 0xFF, size);
+}
+
+inline const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t,
+                                                       const char *label)
+{
+  const FakePartition_t &p = fake_partition();
+  if (!p.data || p.part.type != type || (label && strcmp(label, p.part.label) != 0))
+    return nullptr;
+  return &p.part;
+}
+
+inline esp_err_t esp_partition_read(const esp_partition_t *part, size_t offset, void *dst, size_t size)
+{
+  if (offset + size > part->size)
+    return ESP_ERR_INVALID_SIZE;
+  memcpy(dst, fake_partition().data + offset, size);
+  return ESP_OK;
+}
+
+inline esp_err_t esp_partition_erase_range(const esp_partition_t *part, size_t offset, size_t size)
+{
+  if (offset + size > part->size || offset % 4096 || size % 4096)
+    return ESP_ERR_INVALID_ARG;
+  memset(fake_partition().data + offset, 0xFF, size);
+  fake_partition().erases++;
+  return ESP_OK;
+}
+
+inline esp_err_t esp_partition_write(const esp_partition_t *part, size_t offset, const void *src, size_t size)
+{
+  if (offset + size > part->size)
+    return ESP_ERR_INVALID_SIZE;
+  FakePartition_t &p = fake_partition();
+  const uint8_t *s = static_cast<const uint8_t *>(src);
+  const size_t n = p.torn_write && p.torn_write < size ? p.torn_write : size;
+  for (size_t i = 0; i < n; ++i)
+    p.data[offset + i] &= s[i];
+  p.writes++;
+  if (p.torn_write)
+  {
+    p.torn_write = 0;
+    return ESP_FAIL;
+  }
+  return ESP_OK;
+}
+
+inline const char *esp_err_to_name(esp_err_t err) { return err == ESP_OK ? "ESP_OK" : "ESP_FAIL"; }
+
+#endif // _STUB_ESP_PARTITION_H_
@@ -0,0 +1,34 @@
+#ifndef _STUB_SEMPHR_H_
+#define _STUB_SEMPHR_H_
+
+#include "FreeRTOS.h"
+
+// Заглушка для сборки на хосте: мьютекс в одном потоке всегда свободен
+
+typedef struct
+{
+  int taken;
+} StaticSemaphore_t;
+typedef StaticSemaphore_t *SemaphoreHandle_t;
+
+inline SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t *buf)
+{
+  buf->taken = 0;
+  return buf;
+}
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t)
+{
+  if (sem->taken)
+    return pdFALSE;
+  sem->taken = 1;
+  return pdTRUE;
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+  sem->taken = 0;
+  return pdTRUE;
+}
+
+#endif // _STUB_SEMPHR_H_
@@ -0,0 +1,78 @@
+#ifndef _STUB_TASK_H_
+#define _STUB_TASK_H_
+
+#include "FreeRTOS.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Заглушка для сборки на хосте: задача — поток std::thread, тик — миллисекунда,
+// уведомления — биты, ожидание которых построено на условной переменной
+
+typedef enum
+{
+  eNoAction = 0,
+  eSetBits,
+  eIncrement,
+  eSetValueWithOverwrite,
+  eSetValueWithoutOverwrite,
+} eNotifyAction;
+
+/// @brief состояние уведомлений задачи (TaskHandle_t указывает на него)
+struct tskTaskControlBlock
+{
+  std::mutex lock;
+  std::condition_variable cv;
+  uint32_t value = 0;   // значение уведомления
+  bool pending = false; // уведомление не прочитано
+};
+typedef tskTaskControlBlock *TaskHandle_t;
+
+inline TickType_t xTaskGetTickCount()
+{
+  static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  return static_cast<TickType_t>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+inline void vTaskDelay(TickType_t ticks)
+{
+  std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+inline BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action)
+{
+  {
+    std::lock_guard<std::mutex> g(task->lock);
+    if (action == eSetBits)
+      task->value |= value;
+    else if (action == eIncrement)
+      task->value++;
+    else if (action != eNoAction)
+      task->value = value;
+    task->pending = true;
+  }
+  task->cv.notify_one();
+  return pdPASS;
+}
+
+/** @brief Ожидание уведомления задачей `task` (на хосте дескриптор передаётся явно) */
+inline BaseType_t stub_task_notify_wait(TaskHandle_t task, uint32_t clear_on_entry, uint32_t clear_on_exit,
+                                        uint32_t *value, TickType_t ticks)
+{
+  std::unique_lock<std::mutex> g(task->lock);
+  if (!task->pending)
+    task->value &= ~clear_on_entry;
+  const bool got = task->cv.wait_for(g, std::chrono::milliseconds(ticks), [task] { return task->pending; });
+  if (value)
+    *value = task->value;
+  if (!got)
+    return pdFALSE;
+  task->pending = false;
+  task->value &= ~clear_on_exit;
+  return pdTRUE;
+}
+
+#endif // _STUB_TASK_H_
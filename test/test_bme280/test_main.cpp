@@ -0,0 +1,213 @@
+#include "bme280.h"
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <unity.h>
+
+// Регистры калибровки 0x88..0xA1 с коэффициентами примера из datasheet BME280 (раздел 8.2):
+// dig_T1 = 27504, dig_T2 = 26435, dig_T3 = -1000, dig_P1 = 36477 ... dig_P9 = 6000, dig_H1 = 75
+static const uint8_t CALIB_TP[26] = {0x70, 0x6B, 0x43, 0x67, 0x18, 0xFC, 0x7D, 0x8E, 0x43, 0xD6, 0xD0, 0x0B, 0x27,
+                                     0x0B, 0x8C, 0x00, 0xF9, 0xFF, 0x8C, 0x3C, 0xF8, 0xC6, 0x70, 0x17, 0x00, 0x4B};
+// Регистры 0xE1..0xE7: dig_H2 = 362, dig_H3 = 0, dig_H4 = 313, dig_H5 = 50, dig_H6 = 30
+static const uint8_t CALIB_H[7] = {0x6A, 0x01, 0x00, 0x13, 0x29, 0x03, 0x1E};
+// Регистры данных 0xF7..0xFE: adc_P = 415148, adc_T = 519888, adc_H = 30000
+static const uint8_t DATA_EXAMPLE[BME280_DATA_LEN] = {0x65, 0x5A, 0xC0, 0x7E, 0xED, 0x00, 0x75, 0x30};
+
+#define BENCH_ROUNDS 200000 // компенсаций в замере времени
+
+static Bme280Calib_t s_calib;
+
+void setUp(void)
+{
+  Bme280::parse_calib(CALIB_TP, CALIB_H, s_calib);
+}
+
+void tearDown(void) {}
+
+// Регистры данных из значений АЦП (20 бит давление и температура, 16 бит влажность)
+static void make_data(int32_t adc_t, int32_t adc_p, int32_t adc_h, uint8_t raw[BME280_DATA_LEN])
+{
+  raw[0] = static_cast<uint8_t>(adc_p >> 12);
+  raw[1] = static_cast<uint8_t>(adc_p >> 4);
+  raw[2] = static_cast<uint8_t>((adc_p & 0x0F) << 4);
+  raw[3] = static_cast<uint8_t>(adc_t >> 12);
+  raw[4] = static_cast<uint8_t>(adc_t >> 4);
+  raw[5] = static_cast<uint8_t>((adc_t & 0x0F) << 4);
+  raw[6] = static_cast<uint8_t>(adc_h >> 8);
+  raw[7] = static_cast<uint8_t>(adc_h);
+}
+
+/// @brief результат компенсации в плавающей точке
+struct Reference_t
+{
+  double t; // °C
+  double p; // Па
+  double h; // %
+};
+
+// Компенсация в double из datasheet (раздел 8.1) — эталон для целочисленной версии
+static Reference_t reference(const Bme280Calib_t &c, int32_t adc_t, int32_t adc_p, int32_t adc_h)
+{
+  Reference_t r;
+  double v1 = (adc_t / 16384.0 - c.dig_T1 / 1024.0) * c.dig_T2;
+  double v2 = (adc_t / 131072.0 - c.dig_T1 / 8192.0) * (adc_t / 131072.0 - c.dig_T1 / 8192.0) * c.dig_T3;
+  const double t_fine = v1 + v2;
+  r.t = t_fine / 5120.0;
+
+  v1 = t_fine / 2.0 - 64000.0;
+  v2 = v1 * v1 * c.dig_P6 / 32768.0;
+  v2 = v2 + v1 * c.dig_P5 * 2.0;
+  v2 = v2 / 4.0 + c.dig_P4 * 65536.0;
+  v1 = (c.dig_P3 * v1 * v1 / 524288.0 + c.dig_P2 * v1) / 524288.0;
+  v1 = (1.0 + v1 / 32768.0) * c.dig_P1;
+  double p = 1048576.0 - adc_p;
+  p = (p - v2 / 4096.0) * 6250.0 / v1;
+  v1 = c.dig_P9 * p * p / 2147483648.0;
+  v2 = p * c.dig_P8 / 32768.0;
+  r.p = p + (v1 + v2 + c.dig_P7) / 16.0;
+
+  double h = t_fine - 76800.0;
+  h = (adc_h - (c.dig_H4 * 64.0 + c.dig_H5 / 16384.0 * h)) *
+      (c.dig_H2 / 65536.0 * (1.0 + c.dig_H6 / 67108864.0 * h * (1.0 + c.dig_H3 / 67108864.0 * h)));
+  h = h * (1.0 - c.dig_H1 * h / 524288.0);
+  r.h = h < 0.0 ? 0.0 : h > 100.0 ? 100.0 : h;
+  return r;
+}
+
+static void test_parse_calib(void)
+{
+  TEST_ASSERT_EQUAL_UINT16(27504, s_calib.dig_T1);
+  TEST_ASSERT_EQUAL_INT16(26435, s_calib.dig_T2);
+  TEST_ASSERT_EQUAL_INT16(-1000, s_calib.dig_T3);
+  TEST_ASSERT_EQUAL_UINT16(36477, s_calib.dig_P1);
+  TEST_ASSERT_EQUAL_INT16(-10685, s_calib.dig_P2);
+  TEST_ASSERT_EQUAL_INT16(3024, s_calib.dig_P3);
+  TEST_ASSERT_EQUAL_INT16(2855, s_calib.dig_P4);
+  TEST_ASSERT_EQUAL_INT16(140, s_calib.dig_P5);
+  TEST_ASSERT_EQUAL_INT16(-7, s_calib.dig_P6);
+  TEST_ASSERT_EQUAL_INT16(15500, s_calib.dig_P7);
+  TEST_ASSERT_EQUAL_INT16(-14600, s_calib.dig_P8);
+  TEST_ASSERT_EQUAL_INT16(6000, s_calib.dig_P9);
+  TEST_ASSERT_EQUAL_UINT8(75, s_calib.dig_H1);
+  TEST_ASSERT_EQUAL_INT16(362, s_calib.dig_H2);
+  TEST_ASSERT_EQUAL_UINT8(0, s_calib.dig_H3);
+  TEST_ASSERT_EQUAL_INT16(313, s_calib.dig_H4);
+  TEST_ASSERT_EQUAL_INT16(50, s_calib.dig_H5);
+  TEST_ASSERT_EQUAL_INT8(30, s_calib.dig_H6);
+}
+
+static void test_parse_calib_negative_h4_h5(void)
+{
+  // dig_H4 = -5 (0xFFB: 0xE4 = 0xFF, 0xE5[3:0] = 0xB), dig_H5 = -300 (0xED4: 0xE6 = 0xED, 0xE5[7:4] = 0x4)
+  const uint8_t h[7] = {0x6A, 0x01, 0x00, 0xFF, 0x4B, 0xED, 0xE2};
+  Bme280Calib_t c;
+  Bme280::parse_calib(CALIB_TP, h, c);
+  TEST_ASSERT_EQUAL_INT16(-5, c.dig_H4);
+  TEST_ASSERT_EQUAL_INT16(-300, c.dig_H5);
+  TEST_ASSERT_EQUAL_INT8(-30, c.dig_H6);
+}
+
+static void test_datasheet_example(void)
+{
+  // datasheet, раздел 8.2: 25.08 °C, 100653.27 Па; целочисленная процедура даёт 25767233 в Q24.8 (100653.25 Па)
+  Bme280Reading_t r;
+  Bme280::compensate(s_calib, DATA_EXAMPLE, r);
+  TEST_ASSERT_EQUAL_INT32(2508, r.temperature_centi);
+  TEST_ASSERT_EQUAL_UINT32(25767233, r.pressure_q24_8);
+  TEST_ASSERT_FLOAT_WITHIN(0.05f, 100653.27f, r.pressure_q24_8 / 256.0f);
+  const Reference_t ref = reference(s_calib, 519888, 415148, 30000);
+  TEST_ASSERT_FLOAT_WITHIN(0.05f, static_cast<float>(ref.h), r.humidity_pct());
+}
+
+static void test_matches_double_reference(void)
+{
+  // от -20 до +50 °C, от 700 до 1100 гПа, влажность во всём диапазоне АЦП
+  for (int32_t adc_t = 440000; adc_t <= 600000; adc_t += 8000)
+    for (int32_t adc_p = 250000; adc_p <= 500000; adc_p += 25000)
+      for (int32_t adc_h = 20000; adc_h <= 50000; adc_h += 5000)
+      {
+        uint8_t raw[BME280_DATA_LEN];
+        make_data(adc_t, adc_p, adc_h, raw);
+        Bme280Reading_t r;
+        Bme280::compensate(s_calib, raw, r);
+        const Reference_t ref = reference(s_calib, adc_t, adc_p, adc_h);
+        TEST_ASSERT_FLOAT_WITHIN(0.01f, static_cast<float>(ref.t), r.temperature_c());
+        TEST_ASSERT_FLOAT_WITHIN(1.0f, static_cast<float>(ref.p), r.pressure_q24_8 / 256.0f);
+        TEST_ASSERT_FLOAT_WITHIN(0.05f, static_cast<float>(ref.h), r.humidity_pct());
+      }
+}
+
+static void test_skipped_measurements(void)
+{
+  // отключённое измерение давления/влажности возвращает 0x80000/0x8000
+  uint8_t raw[BME280_DATA_LEN];
+  make_data(519888, 0x80000, 0x8000, raw);
+  Bme280Reading_t r;
+  Bme280::compensate(s_calib, raw, r);
+  TEST_ASSERT_EQUAL_INT32(2508, r.temperature_centi);
+  TEST_ASSERT_EQUAL_UINT32(0, r.pressure_q24_8);
+  TEST_ASSERT_EQUAL_UINT32(0, r.humidity_q22_10);
+}
+
+static void test_humidity_clamped(void)
+{
+  uint8_t raw[BME280_DATA_LEN];
+  Bme280Reading_t r;
+  make_data(519888, 415148, 0, raw);
+  Bme280::compensate(s_calib, raw, r);
+  TEST_ASSERT_EQUAL_UINT32(0, r.humidity_q22_10);
+  make_data(519888, 415148, 0xFFFF, raw);
+  Bme280::compensate(s_calib, raw, r);
+  TEST_ASSERT_EQUAL_UINT32(100 * 1024, r.humidity_q22_10);
+}
+
+// Замер: целочисленная компенсация драйвера против эталона в double на тех же регистрах.
+// Время на хосте, не на ESP32-S3 (у него нет FPU двойной точности — там разница больше)
+static void test_benchmark_compensate(void)
+{
+  static uint8_t raw[64][BME280_DATA_LEN];
+  for (int i = 0; i < 64; ++i)
+    make_data(480000 + i * 1500, 300000 + i * 3000, 25000 + i * 300, raw[i]);
+
+  uint32_t sum = 0;
+  const auto t0 = std::chrono::steady_clock::now();
+  for (int n = 0; n < BENCH_ROUNDS; ++n)
+  {
+    Bme280Reading_t r;
+    Bme280::compensate(s_calib, raw[n & 63], r);
+    sum += r.pressure_q24_8 + r.humidity_q22_10 + static_cast<uint32_t>(r.temperature_centi);
+  }
+  const auto t1 = std::chrono::steady_clock::now();
+  double ref_sum = 0.0;
+  for (int n = 0; n < BENCH_ROUNDS; ++n)
+  {
+    const uint8_t *d = raw[n & 63];
+    const int32_t adc_p = (d[0] << 12) | (d[1] << 4) | (d[2] >> 4);
+    const int32_t adc_t = (d[3] << 12) | (d[4] << 4) | (d[5] >> 4);
+    const int32_t adc_h = (d[6] << 8) | d[7];
+    const Reference_t ref = reference(s_calib, adc_t, adc_p, adc_h);
+    ref_sum += ref.t + ref.p + ref.h;
+  }
+  const auto t2 = std::chrono::steady_clock::now();
+
+  const double int_ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / BENCH_ROUNDS;
+  const double dbl_ns = std::chrono::duration<double, std::nano>(t2 - t1).count() / BENCH_ROUNDS;
+  char msg[128];
+  snprintf(msg, sizeof(msg), "compensate: int %.1f ns, double %.1f ns per measurement (checksum %u %.0f)", int_ns,
+           dbl_ns, sum, ref_sum);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_NOT_EQUAL(0, sum);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_parse_calib);
+  RUN_TEST(test_parse_calib_negative_h4_h5);
+  RUN_TEST(test_datasheet_example);
+  RUN_TEST(test_matches_double_reference);
+  RUN_TEST(test_skipped_measurements);
+  RUN_TEST(test_humidity_clamped);
+  RUN_TEST(test_benchmark_compensate);
+  return UNITY_END();
+}
@@ -0,0 +1,172 @@
+#include "spsc_channel.h"
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <freertos/queue.h>
+#include <unity.h>
+
+// Замер на плате (pio test -e esp32-s3-wroom-1-N16R8): SpscChannel с уведомлением задачи
+// против xQueue между задачами на разных ядрах — пропускная способность потока элементов
+// и задержка пробуждения потребителя
+
+#define BENCH_BIT (1u << 0) // бит уведомления потребителя
+#define BENCH_DEPTH 16      // ёмкость канала и очереди
+#define STREAM_ITEMS 100000 // элементов в замере пропускной способности
+#define LATENCY_ITEMS 1000  // элементов в замере задержки (по одному на тик)
+#define BENCH_STACK 4096    // стек задачи-потребителя
+#define BENCH_PRIO 5        // приоритет задачи-потребителя
+
+/// @brief итог замера в задаче-потребителе
+struct BenchResult_t
+{
+  uint32_t received;   // получено элементов
+  uint32_t errors;     // элементов не по порядку
+  int64_t elapsed_us;  // время получения всех элементов
+  int64_t latency_sum; // сумма задержек, мкс
+  int64_t latency_max; // наибольшая задержка, мкс
+};
+
+/// @brief параметры задачи замера
+struct BenchArgs_t
+{
+  bool latency;           // элементы — метки времени отправки (иначе — порядковые номера)
+  uint32_t count;         // элементов
+  SemaphoreHandle_t done; // выдаётся при готовности и по завершении потребителя
+  BenchResult_t result;   // итог (заполняет потребитель)
+};
+
+static SpscChannel<int64_t, BENCH_DEPTH> s_channel;
+static QueueHandle_t s_queue;
+
+static void account(BenchArgs_t &a, uint32_t i, int64_t v, int64_t start)
+{
+  BenchResult_t &r = a.result;
+  if (a.latency)
+  {
+    const int64_t d = esp_timer_get_time() - v;
+    r.latency_sum += d;
+    r.latency_max = d > r.latency_max ? d : r.latency_max;
+  }
+  else if (v != static_cast<int64_t>(i))
+    r.errors++;
+  r.received++;
+  r.elapsed_us = esp_timer_get_time() - start;
+}
+
+static void spsc_consumer(void *arg)
+{
+  BenchArgs_t &a = *static_cast<BenchArgs_t *>(arg);
+  s_channel.attach_consumer(xTaskGetCurrentTaskHandle(), BENCH_BIT);
+  xSemaphoreGive(a.done); // потребитель готов
+  const int64_t start = esp_timer_get_time();
+  uint32_t i = 0;
+  while (i < a.count)
+  {
+    int64_t v;
+    while (i < a.count && s_channel.pop(v))
+      account(a, i++, v, start);
+    if (i < a.count)
+      xTaskNotifyWait(0, BENCH_BIT, nullptr, portMAX_DELAY);
+  }
+  xSemaphoreGive(a.done);
+  vTaskDelete(nullptr);
+}
+
+static void queue_consumer(void *arg)
+{
+  BenchArgs_t &a = *static_cast<BenchArgs_t *>(arg);
+  xSemaphoreGive(a.done);
+  const int64_t start = esp_timer_get_time();
+  for (uint32_t i = 0; i < a.count; ++i)
+  {
+    int64_t v;
+    xQueueReceive(s_queue, &v, portMAX_DELAY);
+    account(a, i, v, start);
+  }
+  xSemaphoreGive(a.done);
+  vTaskDelete(nullptr);
+}
+
+// Производитель — задача Arduino (loopTask, ядро 1), потребитель — отдельная задача на ядре 0
+static BenchResult_t run(bool spsc, bool latency, uint32_t count)
+{
+  BenchArgs_t a{};
+  a.latency = latency;
+  a.count = count;
+  a.done = xSemaphoreCreateBinary();
+  xTaskCreatePinnedToCore(spsc ? spsc_consumer : queue_consumer, "bench", BENCH_STACK, &a, BENCH_PRIO, nullptr, 0);
+  xSemaphoreTake(a.done, portMAX_DELAY);
+
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    if (latency)
+      vTaskDelay(1); // потребитель успевает уснуть: измеряется пробуждение
+    const int64_t v = latency ? esp_timer_get_time() : static_cast<int64_t>(i);
+    if (spsc)
+    {
+      while (s_channel.size() == s_channel.capacity())
+        taskYIELD();
+      s_channel.push(v);
+    }
+    else
+      xQueueSend(s_queue, &v, portMAX_DELAY);
+  }
+  xSemaphoreTake(a.done, portMAX_DELAY);
+  vSemaphoreDelete(a.done);
+  return a.result;
+}
+
+static void report_stream(const char *name, const BenchResult_t &r)
+{
+  TEST_ASSERT_EQUAL_UINT32(STREAM_ITEMS, r.received);
+  TEST_ASSERT_EQUAL_UINT32(0, r.errors);
+  char msg[96];
+  snprintf(msg, sizeof(msg), "%s stream: %lld us, %.0f items/s", name, static_cast<long long>(r.elapsed_us),
+           STREAM_ITEMS * 1e6 / r.elapsed_us);
+  TEST_MESSAGE(msg);
+}
+
+static void report_latency(const char *name, const BenchResult_t &r)
+{
+  TEST_ASSERT_EQUAL_UINT32(LATENCY_ITEMS, r.received);
+  char msg[96];
+  snprintf(msg, sizeof(msg), "%s wakeup latency: mean %.1f us, max %lld us", name,
+           static_cast<double>(r.latency_sum) / r.received, static_cast<long long>(r.latency_max));
+  TEST_MESSAGE(msg);
+}
+
+static void test_stream_spsc(void)
+{
+  report_stream("SpscChannel", run(true, false, STREAM_ITEMS));
+}
+
+static void test_stream_xqueue(void)
+{
+  report_stream("xQueue", run(false, false, STREAM_ITEMS));
+}
+
+static void test_latency_spsc(void)
+{
+  report_latency("SpscChannel", run(true, true, LATENCY_ITEMS));
+}
+
+static void test_latency_xqueue(void)
+{
+  report_latency("xQueue", run(false, true, LATENCY_ITEMS));
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void setup()
+{
+  delay(2000); // монитор порта успевает подключиться
+  s_queue = xQueueCreate(BENCH_DEPTH, sizeof(int64_t));
+  UNITY_BEGIN();
+  RUN_TEST(test_stream_spsc);
+  RUN_TEST(test_stream_xqueue);
+  RUN_TEST(test_latency_spsc);
+  RUN_TEST(test_latency_xqueue);
+  UNITY_END();
+}
+
+void loop() {}
@@ -0,0 +1,129 @@
+#ifndef _METEO_RESPONSE_H_
+#define _METEO_RESPONSE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Ответ прогноза в формате Open-Meteo с переменными запроса OpenMeteo::process_meteo_data
+// (3 дня, Europe/Moscow): JSON и FlatBuffers.
+// Значения — набор проверок теста: текущая погода 21.4 °C, 1003.6 гПа, 63 %, 3.2 м/с, 214°, код 3;
+// сутки 2025-10-10..12: max 22.5/19.1/17.0, min 12.3/10.0/9.4, осадки 0.0/1.2/4.5,
+// ветер 4.1/6.3/7.7 м/с, 200/250/270°, коды 3/61/63
+static const char METEO_RESPONSE_JSON[] =
+    "{\"latitude\":55.75,\"longitude\":37.625,\"generationtime_ms\":0.0519,\"utc_offset_seconds\":10800,"
+    "\"timezone\":\"Europe/Moscow\",\"timezone_abbreviation\":\"GMT+3\",\"elevation\":141.0,\"current_units\":{\"time\":\"iso8601\","
+    "\"interval\":\"seconds\",\"weather_code\":\"wmo code\",\"temperature_2m\":\"°C\",\"precipitation\":\"mm\",\"wind_speed_10m\":\"m/s\","
+    "\"wind_direction_10m\":\"°\",\"relative_humidity_2m\":\"%\",\"surface_pressure\":\"hPa\"},\"current\":{\"time\":\"2025-10-10T14:00\","
+    "\"interval\":900,\"weather_code\":3,\"temperature_2m\":21.4,\"precipitation\":0.0,\"wind_speed_10m\":3.2,"
+    "\"wind_direction_10m\":214,\"relative_humidity_2m\":63,\"surface_pressure\":1003.6},\"daily_units\":{\"time\":\"iso8601\","
+    "\"temperature_2m_max\":\"°C\",\"temperature_2m_min\":\"°C\",\"precipitation_sum\":\"mm\",\"precipitation_probability_max\":\"%\","
+    "\"wind_speed_10m_max\":\"m/s\",\"wind_direction_10m_dominant\":\"°\",\"weather_code\":\"wmo code\"},\"daily\":{\"time\":[\"2025-10-10\","
+    "\"2025-10-11\",\"2025-10-12\"],\"temperature_2m_max\":[22.5,19.1,17.0],\"temperature_2m_min\":[12.3,"
+    "10.0,9.4],\"precipitation_sum\":[0.0,1.2,4.5],\"precipitation_probability_max\":[5,40,80],\"wind_speed_10m_max\":[4.1,"
+    "6.3,7.7],\"wind_direction_10m_dominant\":[200,250,270],\"weather_code\":[3,61,63]}}";
+
+// Тот же ответ в формате FlatBuffers (&format=flatbuffers): сообщение WeatherApiResponse
+// с префиксом длины, переменные в порядке OPENMETEO_FORECAST_QUERY
+static const uint8_t METEO_RESPONSE_FB[] = {
+    0x00, 0x03, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x1a, 0x00, 0x2c, 0x00, 0x04, 0x00, 0x08, 0x00,
+    0x0c, 0x00, 0x10, 0x00, 0x00, 0x00, 0x28, 0x00, 0x14, 0x00, 0x18, 0x00, 0x1c, 0x00, 0x20, 0x00,
+    0x24, 0x00, 0x00, 0x00, 0x1c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5f, 0x42, 0x00, 0x80, 0x16, 0x42,
+    0x00, 0x00, 0x0d, 0x43, 0xcd, 0xcc, 0x4c, 0x3d, 0x30, 0x2a, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00,
+    0x24, 0x00, 0x00, 0x00, 0x3c, 0x00, 0x00, 0x00, 0x30, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x0d, 0x00, 0x00, 0x00, 0x45, 0x75, 0x72, 0x6f, 0x70, 0x65, 0x2f, 0x4d, 0x6f, 0x73, 0x63, 0x6f,
+    0x77, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x47, 0x4d, 0x54, 0x2b, 0x33, 0x00, 0x00, 0x00,
+    0x0c, 0x00, 0x1c, 0x00, 0x04, 0x00, 0x0c, 0x00, 0x14, 0x00, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x10, 0x00, 0x00, 0x00, 0x30, 0xe7, 0xe8, 0x68, 0x00, 0x00, 0x00, 0x00, 0xb4, 0xea, 0xe8, 0x68,
+    0x00, 0x00, 0x00, 0x00, 0x84, 0x03, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00,
+    0x28, 0x00, 0x00, 0x00, 0x3c, 0x00, 0x00, 0x00, 0x50, 0x00, 0x00, 0x00, 0x64, 0x00, 0x00, 0x00,
+    0x78, 0x00, 0x00, 0x00, 0x8c, 0x00, 0x00, 0x00, 0xa0, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x0c, 0x00,
+    0x08, 0x00, 0x09, 0x00, 0x04, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x40,
+    0x38, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x0c, 0x00, 0x08, 0x00, 0x09, 0x00, 0x04, 0x00, 0x00, 0x00,
+    0x0c, 0x00, 0x00, 0x00, 0x33, 0x33, 0xab, 0x41, 0x2f, 0x01, 0x00, 0x00, 0x0a, 0x00, 0x0c, 0x00,
+    0x08, 0x00, 0x09, 0x00, 0x04, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x18, 0x03, 0x00, 0x00, 0x0a, 0x00, 0x0c, 0x00, 0x08, 0x00, 0x09, 0x00, 0x04, 0x00, 0x00, 0x00,
+    0x0c, 0x00, 0x00, 0x00, 0xcd, 0xcc, 0x4c, 0x40, 0x3b, 0x05, 0x00, 0x00, 0x0a, 0x00, 0x0c, 0x00,
+    0x08, 0x00, 0x09, 0x00, 0x04, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x56, 0x43,
+    0x39, 0x06, 0x00, 0x00, 0x0a, 0x00, 0x0c, 0x00, 0x08, 0x00, 0x09, 0x00, 0x04, 0x00, 0x00, 0x00,
+    0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7c, 0x42, 0x1d, 0x07, 0x00, 0x00, 0x0a, 0x00, 0x0c, 0x00,
+    0x08, 0x00, 0x09, 0x00, 0x04, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x66, 0xe6, 0x7a, 0x44,
+    0x2d, 0x08, 0x00, 0x00, 0x0c, 0x00, 0x1c, 0x00, 0x04, 0x00, 0x0c, 0x00, 0x14, 0x00, 0x18, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x50, 0x22, 0xe8, 0x68,
+    0x00, 0x00, 0x00, 0x00, 0xd0, 0x16, 0xec, 0x68, 0x00, 0x00, 0x00, 0x00, 0x80, 0x51, 0x01, 0x00,
+    0x04, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x30, 0x00, 0x00, 0x00, 0x5c, 0x00, 0x00, 0x00,
+    0x88, 0x00, 0x00, 0x00, 0xb4, 0x00, 0x00, 0x00, 0xe0, 0x00, 0x00, 0x00, 0x0c, 0x01, 0x00, 0x00,
+    0x38, 0x01, 0x00, 0x00, 0x12, 0x00, 0x0c, 0x00, 0x08, 0x00, 0x09, 0x00, 0x00, 0x00, 0x04, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+    0x2f, 0x01, 0x02, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0xb4, 0x41, 0xcd, 0xcc, 0x98, 0x41,
+    0x00, 0x00, 0x88, 0x41, 0x12, 0x00, 0x0c, 0x00, 0x08, 0x00, 0x09, 0x00, 0x00, 0x00, 0x04, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+    0x2f, 0x01, 0x03, 0x00, 0x03, 0x00, 0x00, 0x00, 0xcd, 0xcc, 0x44, 0x41, 0x00, 0x00, 0x20, 0x41,
+    0x66, 0x66, 0x16, 0x41, 0x12, 0x00, 0x0c, 0x00, 0x08, 0x00, 0x09, 0x00, 0x00, 0x00, 0x04, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+    0x18, 0x03, 0x01, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x9a, 0x99, 0x99, 0x3f,
+    0x00, 0x00, 0x90, 0x40, 0x12, 0x00, 0x0c, 0x00, 0x08, 0x00, 0x09, 0x00, 0x00, 0x00, 0x04, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+    0x1a, 0x07, 0x02, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0xa0, 0x40, 0x00, 0x00, 0x20, 0x42,
+    0x00, 0x00, 0xa0, 0x42, 0x12, 0x00, 0x0c, 0x00, 0x08, 0x00, 0x09, 0x00, 0x00, 0x00, 0x04, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+    0x3b, 0x05, 0x02, 0x00, 0x03, 0x00, 0x00, 0x00, 0x33, 0x33, 0x83, 0x40, 0x9a, 0x99, 0xc9, 0x40,
+    0x66, 0x66, 0xf6, 0x40, 0x12, 0x00, 0x0c, 0x00, 0x08, 0x00, 0x09, 0x00, 0x00, 0x00, 0x04, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+    0x39, 0x06, 0x04, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x43, 0x00, 0x00, 0x7a, 0x43,
+    0x00, 0x00, 0x87, 0x43, 0x12, 0x00, 0x0c, 0x00, 0x08, 0x00, 0x09, 0x00, 0x00, 0x00, 0x04, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+    0x38, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x40, 0x00, 0x00, 0x74, 0x42,
+    0x00, 0x00, 0x7c, 0x42,
+};
+
+// Ответ на запрос без precipitation_probability_max (6 суточных переменных вместо 7):
+// порядок переменных не совпадает с MeteoDailyVar_t
+static const uint8_t METEO_RESPONSE_FB_OLD_QUERY[] = {
+    0xcc, 0x02, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x1a, 0x00, 0x2c, 0x00, 0x04, 0x00, 0x08, 0x00,
+    0x0c, 0x00, 0x10, 0x00, 0x00, 0x00, 0x28, 0x00, 0x14, 0x00, 0x18, 0x00, 0x1c, 0x00, 0x20, 0x00,
+    0x24, 0x00, 0x00, 0x00, 0x1c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5f, 0x42, 0x00, 0x80, 0x16, 0x42,
+    0x00, 0x00, 0x0d, 0x43, 0xcd, 0xcc, 0x4c, 0x3d, 0x30, 0x2a, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00,
+    0x24, 0x00, 0x00, 0x00, 0x3c, 0x00, 0x00, 0x00, 0x30, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x0d, 0x00, 0x00, 0x00, 0x45, 0x75, 0x72, 0x6f, 0x70, 0x65, 0x2f, 0x4d, 0x6f, 0x73, 0x63, 0x6f,
+    0x77, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x47, 0x4d, 0x54, 0x2b, 0x33, 0x00, 0x00, 0x00,
+    0x0c, 0x00, 0x1c, 0x00, 0x04, 0x00, 0x0c, 0x00, 0x14, 0x00, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x10, 0x00, 0x00, 0x00, 0x30, 0xe7, 0xe8, 0x68, 0x00, 0x00, 0x00, 0x00, 0xb4, 0xea, 0xe8, 0x68,
+    0x00, 0x00, 0x00, 0x00, 0x84, 0x03, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00,
+    0x28, 0x00, 0x00, 0x00, 0x3c, 0x00, 0x00, 0x00, 0x50, 0x00, 0x00, 0x00, 0x64, 0x00, 0x00, 0x00,
+    0x78, 0x00, 0x00, 0x00, 0x8c, 0x00, 0x00, 0x00, 0xa0, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x0c, 0x00,
+    0x08, 0x00, 0x09, 0x00, 0x04, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x40,
+    0x38, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x0c, 0x00, 0x08, 0x00, 0x09, 0x00, 0x04, 0x00, 0x00, 0x00,
+    0x0c, 0x00, 0x00, 0x00, 0x33, 0x33, 0xab, 0x41, 0x2f, 0x01, 0x00, 0x00, 0x0a, 0x00, 0x0c, 0x00,
+    0x08, 0x00, 0x09, 0x00, 0x04, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x18, 0x03, 0x00, 0x00, 0x0a, 0x00, 0x0c, 0x00, 0x08, 0x00, 0x09, 0x00, 0x04, 0x00, 0x00, 0x00,
+    0x0c, 0x00, 0x00, 0x00, 0xcd, 0xcc, 0x4c, 0x40, 0x3b, 0x05, 0x00, 0x00, 0x0a, 0x00, 0x0c, 0x00,
+    0x08, 0x00, 0x09, 0x00, 0x04, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x56, 0x43,
+    0x39, 0x06, 0x00, 0x00, 0x0a, 0x00, 0x0c, 0x00, 0x08, 0x00, 0x09, 0x00, 0x04, 0x00, 0x00, 0x00,
+    0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7c, 0x42, 0x1d, 0x07, 0x00, 0x00, 0x0a, 0x00, 0x0c, 0x00,
+    0x08, 0x00, 0x09, 0x00, 0x04, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x66, 0xe6, 0x7a, 0x44,
+    0x2d, 0x08, 0x00, 0x00, 0x0c, 0x00, 0x1c, 0x00, 0x04, 0x00, 0x0c, 0x00, 0x14, 0x00, 0x18, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x50, 0x22, 0xe8, 0x68,
+    0x00, 0x00, 0x00, 0x00, 0xd0, 0x16, 0xec, 0x68, 0x00, 0x00, 0x00, 0x00, 0x80, 0x51, 0x01, 0x00,
+    0x04, 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x2c, 0x00, 0x00, 0x00, 0x58, 0x00, 0x00, 0x00,
+    0x84, 0x00, 0x00, 0x00, 0xb0, 0x00, 0x00, 0x00, 0xdc, 0x00, 0x00, 0x00, 0x08, 0x01, 0x00, 0x00,
+    0x12, 0x00, 0x0c, 0x00, 0x08, 0x00, 0x09, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x0a, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x2f, 0x01, 0x02, 0x00,
+    0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0xb4, 0x41, 0xcd, 0xcc, 0x98, 0x41, 0x00, 0x00, 0x88, 0x41,
+    0x12, 0x00, 0x0c, 0x00, 0x08, 0x00, 0x09, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x0a, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x2f, 0x01, 0x03, 0x00,
+    0x03, 0x00, 0x00, 0x00, 0xcd, 0xcc, 0x44, 0x41, 0x00, 0x00, 0x20, 0x41, 0x66, 0x66, 0x16, 0x41,
+    0x12, 0x00, 0x0c, 0x00, 0x08, 0x00, 0x09, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x0a, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x18, 0x03, 0x01, 0x00,
+    0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x9a, 0x99, 0x99, 0x3f, 0x00, 0x00, 0x90, 0x40,
+    0x12, 0x00, 0x0c, 0x00, 0x08, 0x00, 0x09, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x0a, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x3b, 0x05, 0x02, 0x00,
+    0x03, 0x00, 0x00, 0x00, 0x33, 0x33, 0x83, 0x40, 0x9a, 0x99, 0xc9, 0x40, 0x66, 0x66, 0xf6, 0x40,
+    0x12, 0x00, 0x0c, 0x00, 0x08, 0x00, 0x09, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x0a, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x39, 0x06, 0x04, 0x00,
+    0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x43, 0x00, 0x00, 0x7a, 0x43, 0x00, 0x00, 0x87, 0x43,
+    0x12, 0x00, 0x0c, 0x00, 0x08, 0x00, 0x09, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x0a, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x38, 0x00, 0x00, 0x00,
+    0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x40, 0x00, 0x00, 0x74, 0x42, 0x00, 0x00, 0x7c, 0x42,
+};
+
+#endif // _METEO_RESPONSE_H_
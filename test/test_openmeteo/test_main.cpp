@@ -0,0 +1,281 @@
+#include "meteo_response.h"
+#include "openmeteo_fb.h"
+#include "openmeteo_json.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <unity.h>
+
+#define BENCH_ROUNDS 20000 // разборов в замере времени
+#define STREAM_CHUNK 64    // порция чтения из «сокета»
+#define FUZZ_ROUNDS 20000  // испорченных копий ответа FlatBuffers
+
+/// @brief тело ответа, читаемое порциями, как HttpBodyReader читает сокет
+class ChunkReader
+{
+public:
+  ChunkReader(const char *data, size_t len) : data(data), len(len), pos(0) {}
+
+  int read() { return pos < len ? static_cast<uint8_t>(data[pos++]) : -1; }
+
+  size_t readBytes(char *buffer, size_t length)
+  {
+    size_t n = length < STREAM_CHUNK ? length : STREAM_CHUNK;
+    n = n < len - pos ? n : len - pos;
+    memcpy(buffer, data + pos, n);
+    pos += n;
+    return n;
+  }
+
+private:
+  const char *data;
+  size_t len;
+  size_t pos;
+};
+
+static const size_t RESPONSE_LEN = sizeof(METEO_RESPONSE_JSON) - 1;
+static const size_t RESPONSE_FB_LEN = sizeof(METEO_RESPONSE_FB);
+
+/// @brief итог разбора ответа
+struct JsonParse_t
+{
+  DeserializationError error; // результат разбора
+  size_t peak;                // наибольший объём документа, байт
+};
+
+// Разбор из потока с фильтром — как в OpenMeteo::process_meteo_data
+static JsonParse_t parse_stream(const char *data, size_t len, OpenMeteoData *out)
+{
+  PeakAllocator alloc;
+  JsonDocument json(&alloc);
+  ChunkReader body(data, len);
+  JsonParse_t r;
+  r.error = deserializeJson(json, body, DeserializationOption::Filter(meteo_filter()));
+  r.peak = alloc.peak_bytes();
+  if (!r.error)
+    meteo_fill(json, out);
+  return r;
+}
+
+// Прежний путь: тело целиком в памяти и полный документ без фильтра
+static JsonParse_t parse_whole(const char *data, size_t len, OpenMeteoData *out)
+{
+  PeakAllocator alloc;
+  JsonDocument json(&alloc);
+  JsonParse_t r;
+  r.error = deserializeJson(json, data, len);
+  r.peak = alloc.peak_bytes();
+  if (!r.error)
+    meteo_fill(json, out);
+  return r;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void check_response(const OpenMeteoData *d)
+{
+  TEST_ASSERT_EQUAL(METEO_DATA_CURRENT, d[0].index);
+  TEST_ASSERT_EQUAL_INT(3, d[0].weather_code);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 21.4f, d[0].temperature);
+  TEST_ASSERT_EQUAL_INT(1003, d[0].pressure);
+  TEST_ASSERT_EQUAL_INT(63, d[0].relative_humidity);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 3.2f, d[0].wind_speed);
+  TEST_ASSERT_EQUAL_INT(214, d[0].wind_direction);
+
+  static const char *const dates[] = {"10-10-2025", "11-10-2025", "12-10-2025"};
+  static const float t_max[] = {22.5f, 19.1f, 17.0f};
+  static const float t_min[] = {12.3f, 10.0f, 9.4f};
+  static const float precipitation[] = {0.0f, 1.2f, 4.5f};
+  static const float wind_speed[] = {4.1f, 6.3f, 7.7f};
+  static const int wind_direction[] = {200, 250, 270};
+  static const int weather_code[] = {3, 61, 63};
+  for (int i = 0; i < 3; ++i)
+  {
+    const OpenMeteoData &day = d[METEO_DATA_FORECAST_TODAY + i];
+    TEST_ASSERT_EQUAL(METEO_DATA_FORECAST_TODAY + i, day.index);
+    TEST_ASSERT_EQUAL_STRING(dates[i], day.date);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, t_max[i], day.temperature);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, t_max[i], day.temperature_max);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, t_min[i], day.temperature_min);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, precipitation[i], day.precipitation);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, wind_speed[i], day.wind_speed);
+    TEST_ASSERT_EQUAL_INT(wind_direction[i], day.wind_direction);
+    TEST_ASSERT_EQUAL_INT(weather_code[i], day.weather_code);
+  }
+}
+
+static void test_json_stream_fills_records(void)
+{
+  OpenMeteoData d[_METEO_DATA_NUM_];
+  const JsonParse_t r = parse_stream(METEO_RESPONSE_JSON, RESPONSE_LEN, d);
+  TEST_ASSERT_TRUE(r.error == DeserializationError::Ok);
+  check_response(d);
+}
+
+static void test_json_filter_keeps_only_needed_fields(void)
+{
+  JsonDocument json;
+  TEST_ASSERT_TRUE(deserializeJson(json, METEO_RESPONSE_JSON, RESPONSE_LEN,
+                                   DeserializationOption::Filter(meteo_filter())) == DeserializationError::Ok);
+  TEST_ASSERT_FALSE(json["latitude"].is<float>());
+  TEST_ASSERT_FALSE(json["current_units"].is<JsonObject>());
+  TEST_ASSERT_FALSE(json["daily_units"].is<JsonObject>());
+  TEST_ASSERT_FALSE(json["current"]["precipitation"].is<float>());
+  TEST_ASSERT_FALSE(json["daily"]["precipitation_probability_max"].is<JsonArray>());
+  TEST_ASSERT_TRUE(json["daily"]["precipitation_sum"].is<JsonArray>());
+  TEST_ASSERT_EQUAL(3, json["daily"]["time"].size());
+}
+
+static void test_json_truncated_response_rejected(void)
+{
+  OpenMeteoData d[_METEO_DATA_NUM_];
+  for (size_t len = 0; len < RESPONSE_LEN; len += 7)
+  {
+    const JsonParse_t r = parse_stream(METEO_RESPONSE_JSON, len, d);
+    TEST_ASSERT_TRUE(r.error != DeserializationError::Ok);
+  }
+}
+
+static void test_json_missing_fields_default_to_zero(void)
+{
+  static const char partial[] = "{\"current\":{\"temperature_2m\":-3.5},\"daily\":{\"time\":[\"2025-01-02\"]}}";
+  OpenMeteoData d[_METEO_DATA_NUM_];
+  const JsonParse_t r = parse_stream(partial, sizeof(partial) - 1, d);
+  TEST_ASSERT_TRUE(r.error == DeserializationError::Ok);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, -3.5f, d[0].temperature);
+  TEST_ASSERT_EQUAL_INT(0, d[0].pressure);
+  TEST_ASSERT_EQUAL_STRING("02-01-2025", d[METEO_DATA_FORECAST_TODAY].date);
+  TEST_ASSERT_EQUAL_STRING("", d[METEO_DATA_FORECAST_TOMORROW].date); // дня нет в ответе
+  TEST_ASSERT_EQUAL_INT(0, d[METEO_DATA_FORECAST_TOMORROW].weather_code);
+}
+
+static void test_fb_fills_records(void)
+{
+  OpenMeteoData d[_METEO_DATA_NUM_];
+  TEST_ASSERT_TRUE(meteo_fb_fill(METEO_RESPONSE_FB, RESPONSE_FB_LEN, d));
+  check_response(d);
+}
+
+static void test_fb_truncated_response_rejected(void)
+{
+  OpenMeteoData d[_METEO_DATA_NUM_];
+  for (size_t len = 0; len < RESPONSE_FB_LEN; ++len)
+  {
+    // копия точной длины: чтение за её пределами увидит санитайзер
+    std::vector<uint8_t> part(METEO_RESPONSE_FB, METEO_RESPONSE_FB + len);
+    TEST_ASSERT_FALSE(meteo_fb_fill(part.data(), part.size(), d));
+  }
+}
+
+static void test_fb_size_prefix_beyond_data_rejected(void)
+{
+  std::vector<uint8_t> buf(METEO_RESPONSE_FB, METEO_RESPONSE_FB + RESPONSE_FB_LEN);
+  const uint32_t n = RESPONSE_FB_LEN; // на 4 байта больше сообщения
+  memcpy(buf.data(), &n, sizeof(n));
+  OpenMeteoData d[_METEO_DATA_NUM_];
+  TEST_ASSERT_FALSE(meteo_fb_fill(buf.data(), buf.size(), d));
+}
+
+// Другой набор переменных (запрос изменён, схема разошлась) отклоняется —
+// OpenMeteo::process_meteo_data в этом случае повторяет запрос в JSON
+static void test_fb_other_query_rejected(void)
+{
+  OpenMeteoData d[_METEO_DATA_NUM_];
+  TEST_ASSERT_FALSE(meteo_fb_fill(METEO_RESPONSE_FB_OLD_QUERY, sizeof(METEO_RESPONSE_FB_OLD_QUERY), d));
+}
+
+// Испорченные биты (значения, смещения, vtable): разбор не выходит за буфер и не падает
+static void test_fb_corrupted_response_stays_in_bounds(void)
+{
+  OpenMeteoData d[_METEO_DATA_NUM_];
+  unsigned accepted = 0;
+  srand(1);
+  for (int i = 0; i < FUZZ_ROUNDS; ++i)
+  {
+    std::vector<uint8_t> buf(METEO_RESPONSE_FB, METEO_RESPONSE_FB + RESPONSE_FB_LEN);
+    for (int flips = 1 + rand() % 4; flips > 0; --flips)
+      buf[rand() % buf.size()] ^= static_cast<uint8_t>(1u << (rand() % 8));
+    accepted += meteo_fb_fill(buf.data(), buf.size(), d);
+  }
+  char msg[80];
+  snprintf(msg, sizeof(msg), "corrupted responses accepted: %u of %d", accepted, FUZZ_ROUNDS);
+  TEST_MESSAGE(msg);
+}
+
+// Замер: пиковая память и время разбора записанного ответа. Прежний путь держал
+// тело ответа (String) и полный документ одновременно; потоковый — только документ по фильтру
+static void test_json_memory_and_time(void)
+{
+  OpenMeteoData d[_METEO_DATA_NUM_];
+  const JsonParse_t stream = parse_stream(METEO_RESPONSE_JSON, RESPONSE_LEN, d);
+  const JsonParse_t whole = parse_whole(METEO_RESPONSE_JSON, RESPONSE_LEN, d);
+  TEST_ASSERT_TRUE(whole.error == DeserializationError::Ok);
+  check_response(d);
+  TEST_ASSERT_LESS_THAN(whole.peak, stream.peak);
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < BENCH_ROUNDS; ++i)
+    parse_stream(METEO_RESPONSE_JSON, RESPONSE_LEN, d);
+  auto t1 = std::chrono::steady_clock::now();
+  for (int i = 0; i < BENCH_ROUNDS; ++i)
+    parse_whole(METEO_RESPONSE_JSON, RESPONSE_LEN, d);
+  auto t2 = std::chrono::steady_clock::now();
+
+  char msg[200];
+  snprintf(msg, sizeof(msg),
+           "response %u B; peak: stream+filter %u B, body+full document %u B; parse: %.1f us vs %.1f us",
+           static_cast<unsigned>(RESPONSE_LEN), static_cast<unsigned>(stream.peak),
+           static_cast<unsigned>(RESPONSE_LEN + whole.peak),
+           std::chrono::duration<double, std::micro>(t1 - t0).count() / BENCH_ROUNDS,
+           std::chrono::duration<double, std::micro>(t2 - t1).count() / BENCH_ROUNDS);
+  TEST_MESSAGE(msg);
+}
+
+// Замер: объём ответа и время разбора FlatBuffers против потокового JSON с фильтром
+static void test_fb_vs_json_size_and_time(void)
+{
+  OpenMeteoData fb[_METEO_DATA_NUM_];
+  OpenMeteoData js[_METEO_DATA_NUM_];
+  TEST_ASSERT_TRUE(meteo_fb_fill(METEO_RESPONSE_FB, RESPONSE_FB_LEN, fb));
+  TEST_ASSERT_TRUE(parse_stream(METEO_RESPONSE_JSON, RESPONSE_LEN, js).error == DeserializationError::Ok);
+  check_response(fb);
+  check_response(js);
+  TEST_ASSERT_LESS_THAN(RESPONSE_LEN, RESPONSE_FB_LEN);
+
+  bool ok = true;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < BENCH_ROUNDS; ++i)
+    ok &= meteo_fb_fill(METEO_RESPONSE_FB, RESPONSE_FB_LEN, fb);
+  auto t1 = std::chrono::steady_clock::now();
+  for (int i = 0; i < BENCH_ROUNDS; ++i)
+    parse_stream(METEO_RESPONSE_JSON, RESPONSE_LEN, js);
+  auto t2 = std::chrono::steady_clock::now();
+  TEST_ASSERT_TRUE(ok);
+
+  char msg[200];
+  snprintf(msg, sizeof(msg), "response: FlatBuffers %u B, JSON %u B; decode: %.2f us vs stream+filter %.1f us",
+           static_cast<unsigned>(RESPONSE_FB_LEN), static_cast<unsigned>(RESPONSE_LEN),
+           std::chrono::duration<double, std::micro>(t1 - t0).count() / BENCH_ROUNDS,
+           std::chrono::duration<double, std::micro>(t2 - t1).count() / BENCH_ROUNDS);
+  TEST_MESSAGE(msg);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_json_stream_fills_records);
+  RUN_TEST(test_json_filter_keeps_only_needed_fields);
+  RUN_TEST(test_json_truncated_response_rejected);
+  RUN_TEST(test_json_missing_fields_default_to_zero);
+  RUN_TEST(test_json_memory_and_time);
+  RUN_TEST(test_fb_fills_records);
+  RUN_TEST(test_fb_truncated_response_rejected);
+  RUN_TEST(test_fb_size_prefix_beyond_data_rejected);
+  RUN_TEST(test_fb_other_query_rejected);
+  RUN_TEST(test_fb_corrupted_response_stays_in_bounds);
+  RUN_TEST(test_fb_vs_json_size_and_time);
+  return UNITY_END();
+}
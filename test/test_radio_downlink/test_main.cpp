@@ -0,0 +1,133 @@
+#include "radio_proto.h"
+#include <string.h>
+#include <unity.h>
+
+#define TEST_SLOTS 16 // слотов в периоде (NRF_MAX_NODES приёмника)
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static RadioDownlink_t make_downlink()
+{
+  RadioDownlink_t dl{};
+  dl.node = 5;
+  dl.flags = RADIO_DL_CHANNEL | RADIO_DL_TIME | RADIO_DL_SLOT | RADIO_DL_INTERVAL;
+  dl.channel = 107;
+  dl.switch_in_s = 1234;
+  dl.ref_seq = 0xBEEF;
+  dl.ref_time = 1760000000u;
+  dl.ref_ms = 999;
+  dl.slot_ms = 0x01020304u;
+  dl.interval_s = 600;
+  return dl;
+}
+
+static void test_downlink_round_trip(void)
+{
+  const RadioDownlink_t dl = make_downlink();
+  uint8_t buf[RADIO_DL_SIZE];
+  RadioProto::encode_downlink(dl, buf);
+  TEST_ASSERT_EQUAL_HEX8(RADIO_DL_MAGIC, buf[0]);
+  TEST_ASSERT_EQUAL_UINT8(RADIO_VERSION, buf[1]);
+  TEST_ASSERT_EQUAL_HEX8(RadioProto::crc8(buf, RADIO_DL_SIZE - 1), buf[RADIO_DL_SIZE - 1]);
+
+  RadioDownlink_t out;
+  TEST_ASSERT_EQUAL(RADIO_DECODE_OK, RadioProto::decode_downlink(buf, sizeof(buf), out));
+  TEST_ASSERT_EQUAL_UINT8(dl.node, out.node);
+  TEST_ASSERT_EQUAL_HEX8(dl.flags, out.flags);
+  TEST_ASSERT_EQUAL_UINT8(dl.channel, out.channel);
+  TEST_ASSERT_EQUAL_UINT16(dl.switch_in_s, out.switch_in_s);
+  TEST_ASSERT_EQUAL_UINT16(dl.ref_seq, out.ref_seq);
+  TEST_ASSERT_EQUAL_UINT32(dl.ref_time, out.ref_time);
+  TEST_ASSERT_EQUAL_UINT16(dl.ref_ms, out.ref_ms);
+  TEST_ASSERT_EQUAL_UINT32(dl.slot_ms, out.slot_ms);
+  TEST_ASSERT_EQUAL_UINT16(dl.interval_s, out.interval_s);
+}
+
+static void test_downlink_layout_little_endian(void)
+{
+  uint8_t buf[RADIO_DL_SIZE];
+  RadioProto::encode_downlink(make_downlink(), buf);
+  // байты 7..8 ref_seq, 15..18 slot_ms (см. формат в radio_proto.h)
+  TEST_ASSERT_EQUAL_HEX8(0xEF, buf[7]);
+  TEST_ASSERT_EQUAL_HEX8(0xBE, buf[8]);
+  TEST_ASSERT_EQUAL_HEX8(0x04, buf[15]);
+  TEST_ASSERT_EQUAL_HEX8(0x01, buf[18]);
+}
+
+static void test_downlink_bad_crc(void)
+{
+  uint8_t buf[RADIO_DL_SIZE];
+  RadioProto::encode_downlink(make_downlink(), buf);
+  RadioDownlink_t out;
+  for (size_t byte = 2; byte < RADIO_DL_SIZE; ++byte)
+  {
+    buf[byte] ^= 0x40;
+    TEST_ASSERT_EQUAL(RADIO_DECODE_BAD_CRC, RadioProto::decode_downlink(buf, sizeof(buf), out));
+    buf[byte] ^= 0x40;
+  }
+}
+
+static void test_downlink_short_or_foreign(void)
+{
+  uint8_t buf[RADIO_DL_SIZE];
+  RadioProto::encode_downlink(make_downlink(), buf);
+  RadioDownlink_t out;
+  TEST_ASSERT_EQUAL(RADIO_DECODE_SHORT, RadioProto::decode_downlink(buf, RADIO_DL_SIZE - 1, out));
+  buf[0] = RADIO_MAGIC; // пакет узла, а не обратного канала
+  TEST_ASSERT_EQUAL(RADIO_DECODE_SHORT, RadioProto::decode_downlink(buf, sizeof(buf), out));
+}
+
+static void test_slot_phase_by_node(void)
+{
+  const uint32_t interval = 60000;
+  const int64_t rx_ms = 123456789;
+  for (uint8_t node = 0; node < TEST_SLOTS; ++node)
+  {
+    const uint32_t delay = RadioProto::slot_delay_ms(interval, node, TEST_SLOTS, rx_ms);
+    // слот на фазе interval * node / 16 монотонной оси приёмника
+    TEST_ASSERT_EQUAL_INT64(static_cast<int64_t>(interval) * node / TEST_SLOTS, (rx_ms + delay) % interval);
+    // не раньше полутора периодов и не позже следующего за ними слота
+    TEST_ASSERT_GREATER_OR_EQUAL(interval + interval / 2, delay);
+    TEST_ASSERT_LESS_THAN(2 * interval + interval / 2, delay);
+  }
+}
+
+static void test_slot_spacing(void)
+{
+  // соседние узлы разнесены на interval / 16 независимо от момента приёма
+  const uint32_t interval = 16000;
+  for (int64_t rx_ms = 0; rx_ms < 2 * interval; rx_ms += 777)
+  {
+    for (uint8_t node = 0; node < TEST_SLOTS; ++node)
+    {
+      const int64_t at = rx_ms + RadioProto::slot_delay_ms(interval, node, TEST_SLOTS, rx_ms);
+      TEST_ASSERT_EQUAL_INT64(node * 1000, at % interval);
+    }
+  }
+}
+
+static void test_slot_exact_boundary(void)
+{
+  // приём ровно за полтора периода до слота — назначается этот слот
+  const uint32_t interval = 60000;
+  const uint8_t node = 4; // фаза 15000
+  const int64_t rx_ms = 10 * static_cast<int64_t>(interval) + 15000 - 90000;
+  TEST_ASSERT_EQUAL_UINT32(90000, RadioProto::slot_delay_ms(interval, node, TEST_SLOTS, rx_ms));
+  TEST_ASSERT_EQUAL_UINT32(90000 + interval - 1, RadioProto::slot_delay_ms(interval, node, TEST_SLOTS, rx_ms + 1));
+}
+
+int main(int argc, char **argv)
+{
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_downlink_round_trip);
+  RUN_TEST(test_downlink_layout_little_endian);
+  RUN_TEST(test_downlink_bad_crc);
+  RUN_TEST(test_downlink_short_or_foreign);
+  RUN_TEST(test_slot_phase_by_node);
+  RUN_TEST(test_slot_spacing);
+  RUN_TEST(test_slot_exact_boundary);
+  return UNITY_END();
+}
@@ -0,0 +1,208 @@
+#include "radio_proto.h"
+#include <math.h>
+#include <string.h>
+#include <unity.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Пакет версии 2 с count измерениями; значения различаются по номеру измерения
+static RadioFrame_t make_frame(uint8_t count)
+{
+  RadioFrame_t f{};
+  f.node = 7;
+  f.seq = 0xFFFE;
+  f.battery = 88;
+  f.retries = 3;
+  f.count = count;
+  for (uint8_t i = 0; i < count; ++i)
+  {
+    f.samples[i].age_s = static_cast<uint16_t>(300 * (count - 1 - i));
+    f.samples[i].temperature_centi = static_cast<int16_t>(-1234 + i);
+    f.samples[i].humidity_centi = static_cast<uint16_t>(6543 + i);
+    f.samples[i].pressure_dhpa = static_cast<uint16_t>(10132 + i);
+  }
+  return f;
+}
+
+// Пакет версии 1: float температура, float влажность, uint16 давление, uint16 заряд
+static void make_legacy(uint8_t *buf, float temperature, float humidity, uint16_t pressure, uint16_t battery)
+{
+  memset(buf, 0, RADIO_PAYLOAD_SIZE);
+  memcpy(&buf[0], &temperature, sizeof(temperature));
+  memcpy(&buf[4], &humidity, sizeof(humidity));
+  memcpy(&buf[8], &pressure, sizeof(pressure));
+  memcpy(&buf[10], &battery, sizeof(battery));
+}
+
+static void test_crc8_check_value(void)
+{
+  // контрольное значение CRC-8/SMBUS (полином 0x07, начальное 0x00)
+  TEST_ASSERT_EQUAL_HEX8(0xF4, RadioProto::crc8(reinterpret_cast<const uint8_t *>("123456789"), 9));
+}
+
+static void test_v2_round_trip(void)
+{
+  const RadioFrame_t f = make_frame(RADIO_MAX_SAMPLES);
+  uint8_t buf[RADIO_PAYLOAD_SIZE];
+  TEST_ASSERT_TRUE(RadioProto::encode(f, buf));
+  TEST_ASSERT_EQUAL_HEX8(RADIO_MAGIC, buf[0]);
+  TEST_ASSERT_EQUAL_UINT8(RADIO_VERSION, buf[1]);
+
+  RadioFrame_t g;
+  TEST_ASSERT_EQUAL(RADIO_DECODE_OK, RadioProto::decode(buf, sizeof(buf), 0, g));
+  TEST_ASSERT_EQUAL_UINT8(RADIO_VERSION, g.version);
+  TEST_ASSERT_EQUAL_UINT8(7, g.node);
+  TEST_ASSERT_TRUE(g.has_seq);
+  TEST_ASSERT_EQUAL_UINT16(0xFFFE, g.seq);
+  TEST_ASSERT_EQUAL_UINT8(88, g.battery);
+  TEST_ASSERT_EQUAL_UINT8(3, g.retries);
+  TEST_ASSERT_EQUAL_UINT8(RADIO_MAX_SAMPLES, g.count);
+  TEST_ASSERT_EQUAL_MEMORY(f.samples, g.samples, sizeof(f.samples));
+}
+
+static void test_v2_batches(void)
+{
+  for (uint8_t count = 1; count <= RADIO_MAX_SAMPLES; ++count)
+  {
+    const RadioFrame_t f = make_frame(count);
+    uint8_t buf[RADIO_PAYLOAD_SIZE];
+    TEST_ASSERT_TRUE(RadioProto::encode(f, buf));
+    // неиспользуемые слоты заполнены нулями
+    for (size_t i = RADIO_HEADER_SIZE + count * RADIO_SAMPLE_SIZE; i < RADIO_PAYLOAD_SIZE - 1; ++i)
+      TEST_ASSERT_EQUAL_HEX8(0, buf[i]);
+
+    RadioFrame_t g;
+    TEST_ASSERT_EQUAL(RADIO_DECODE_OK, RadioProto::decode(buf, sizeof(buf), 0, g));
+    TEST_ASSERT_EQUAL_UINT8(count, g.count);
+    for (uint8_t i = 0; i < count; ++i)
+    {
+      TEST_ASSERT_EQUAL_UINT16(f.samples[i].age_s, g.samples[i].age_s);
+      TEST_ASSERT_EQUAL_INT16(f.samples[i].temperature_centi, g.samples[i].temperature_centi);
+      TEST_ASSERT_EQUAL_UINT16(f.samples[i].humidity_centi, g.samples[i].humidity_centi);
+      TEST_ASSERT_EQUAL_UINT16(f.samples[i].pressure_dhpa, g.samples[i].pressure_dhpa);
+    }
+    // самое новое измерение — последнее
+    TEST_ASSERT_EQUAL_UINT16(0, g.samples[count - 1].age_s);
+  }
+}
+
+static void test_v2_bad_count_not_encoded(void)
+{
+  uint8_t buf[RADIO_PAYLOAD_SIZE];
+  RadioFrame_t f = make_frame(1);
+  f.count = 0;
+  TEST_ASSERT_FALSE(RadioProto::encode(f, buf));
+  f.count = RADIO_MAX_SAMPLES + 1;
+  TEST_ASSERT_FALSE(RadioProto::encode(f, buf));
+}
+
+static void test_v2_bad_count_rejected(void)
+{
+  uint8_t buf[RADIO_PAYLOAD_SIZE];
+  TEST_ASSERT_TRUE(RadioProto::encode(make_frame(2), buf));
+  buf[6] = static_cast<uint8_t>((buf[6] & 0xF0) | 4);
+  buf[RADIO_PAYLOAD_SIZE - 1] = RadioProto::crc8(buf, RADIO_PAYLOAD_SIZE - 1);
+  RadioFrame_t g;
+  TEST_ASSERT_EQUAL(RADIO_DECODE_BAD_COUNT, RadioProto::decode(buf, sizeof(buf), 0, g));
+}
+
+static void test_v2_retries_saturate(void)
+{
+  RadioFrame_t f = make_frame(2);
+  f.retries = 40;
+  uint8_t buf[RADIO_PAYLOAD_SIZE];
+  TEST_ASSERT_TRUE(RadioProto::encode(f, buf));
+  RadioFrame_t g;
+  TEST_ASSERT_EQUAL(RADIO_DECODE_OK, RadioProto::decode(buf, sizeof(buf), 0, g));
+  TEST_ASSERT_EQUAL_UINT8(RADIO_MAX_RETRIES, g.retries);
+  TEST_ASSERT_EQUAL_UINT8(2, g.count);
+}
+
+static void test_v2_crc_rejects_every_bit_flip(void)
+{
+  uint8_t buf[RADIO_PAYLOAD_SIZE];
+  TEST_ASSERT_TRUE(RadioProto::encode(make_frame(RADIO_MAX_SAMPLES), buf));
+  // заголовок (magic, версия) не трогается: иначе пакет разбирается как версия 1
+  for (size_t byte = 2; byte < RADIO_PAYLOAD_SIZE; ++byte)
+  {
+    for (uint8_t bit = 0; bit < 8; ++bit)
+    {
+      buf[byte] ^= static_cast<uint8_t>(1u << bit);
+      RadioFrame_t g;
+      TEST_ASSERT_EQUAL(RADIO_DECODE_BAD_CRC, RadioProto::decode(buf, sizeof(buf), 0, g));
+      buf[byte] ^= static_cast<uint8_t>(1u << bit);
+    }
+  }
+}
+
+static void test_legacy_decode(void)
+{
+  uint8_t buf[RADIO_PAYLOAD_SIZE];
+  make_legacy(buf, -5.25f, 65.5f, 1015, 87);
+  RadioFrame_t g;
+  TEST_ASSERT_EQUAL(RADIO_DECODE_OK, RadioProto::decode(buf, RADIO_LEGACY_SIZE, 4, g));
+  TEST_ASSERT_EQUAL_UINT8(1, g.version);
+  TEST_ASSERT_EQUAL_UINT8(4, g.node); // номер узла — канал приёма
+  TEST_ASSERT_FALSE(g.has_seq);
+  TEST_ASSERT_EQUAL_UINT8(1, g.count);
+  TEST_ASSERT_EQUAL_UINT8(87, g.battery);
+  TEST_ASSERT_EQUAL_INT16(-525, g.samples[0].temperature_centi);
+  TEST_ASSERT_EQUAL_UINT16(6550, g.samples[0].humidity_centi);
+  TEST_ASSERT_EQUAL_UINT16(10150, g.samples[0].pressure_dhpa);
+  TEST_ASSERT_EQUAL_UINT16(0, g.samples[0].age_s);
+}
+
+static void test_legacy_short(void)
+{
+  uint8_t buf[RADIO_PAYLOAD_SIZE];
+  make_legacy(buf, 20.0f, 50.0f, 1000, 100);
+  RadioFrame_t g;
+  TEST_ASSERT_EQUAL(RADIO_DECODE_SHORT, RadioProto::decode(buf, RADIO_LEGACY_SIZE - 1, 0, g));
+}
+
+static void test_legacy_range_checks(void)
+{
+  uint8_t buf[RADIO_PAYLOAD_SIZE];
+  RadioFrame_t g;
+  const float bad[][2] = {
+      {NAN, 50.0f},     // не число
+      {INFINITY, 50.0f},
+      {20.0f, NAN},
+      {301.0f, 50.0f},  // температура вне физического диапазона
+      {-301.0f, 50.0f},
+      {20.0f, -2.0f},   // влажность вне диапазона
+      {20.0f, 201.0f},
+  };
+  for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); ++i)
+  {
+    make_legacy(buf, bad[i][0], bad[i][1], 1000, 100);
+    TEST_ASSERT_EQUAL(RADIO_DECODE_BAD_VALUE, RadioProto::decode(buf, RADIO_LEGACY_SIZE, 0, g));
+  }
+
+  // границы диапазона принимаются; заряд и давление насыщаются
+  make_legacy(buf, -300.0f, 200.0f, 7000, 1000);
+  TEST_ASSERT_EQUAL(RADIO_DECODE_OK, RadioProto::decode(buf, RADIO_LEGACY_SIZE, 0, g));
+  TEST_ASSERT_EQUAL_INT16(-30000, g.samples[0].temperature_centi);
+  TEST_ASSERT_EQUAL_UINT16(20000, g.samples[0].humidity_centi);
+  TEST_ASSERT_EQUAL_UINT16(UINT16_MAX, g.samples[0].pressure_dhpa);
+  TEST_ASSERT_EQUAL_UINT8(255, g.battery);
+}
+
+int main(int argc, char **argv)
+{
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_crc8_check_value);
+  RUN_TEST(test_v2_round_trip);
+  RUN_TEST(test_v2_batches);
+  RUN_TEST(test_v2_bad_count_not_encoded);
+  RUN_TEST(test_v2_bad_count_rejected);
+  RUN_TEST(test_v2_retries_saturate);
+  RUN_TEST(test_v2_crc_rejects_every_bit_flip);
+  RUN_TEST(test_legacy_decode);
+  RUN_TEST(test_legacy_short);
+  RUN_TEST(test_legacy_range_checks);
+  return UNITY_END();
+}
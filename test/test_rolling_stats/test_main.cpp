@@ -0,0 +1,270 @@
+#include "rolling_stats.h"
+#include <chrono>
+#include <stdio.h>
+#include <unity.h>
+
+#define BENCH_SAMPLES 1000000 // отсчётов в замере времени
+
+// Детерминированный генератор отсчётов (LCG), значения в [-range, range)
+static uint32_t s_seed;
+
+static int32_t next_value(int32_t range)
+{
+  s_seed = s_seed * 1664525u + 1013904223u;
+  return static_cast<int32_t>((s_seed >> 8) % (2u * range)) - range;
+}
+
+void setUp(void)
+{
+  s_seed = 1;
+}
+
+void tearDown(void) {}
+
+// Эталон: статистика последних n отсчётов history[0..total) перебором
+struct Brute_t
+{
+  int32_t min;
+  int32_t max;
+  int64_t sum;
+  double variance;
+};
+
+static Brute_t brute(const int32_t *history, size_t total, size_t n)
+{
+  Brute_t b{history[total - n], history[total - n], 0, 0.0};
+  for (size_t i = total - n; i < total; ++i)
+  {
+    b.min = history[i] < b.min ? history[i] : b.min;
+    b.max = history[i] > b.max ? history[i] : b.max;
+    b.sum += history[i];
+  }
+  const double mean = static_cast<double>(b.sum) / n;
+  for (size_t i = total - n; n > 1 && i < total; ++i)
+    b.variance += (history[i] - mean) * (history[i] - mean) / (n - 1);
+  return b;
+}
+
+static void test_window_matches_brute_force(void)
+{
+  static int32_t history[5000];
+  RollingWindow<int32_t, 7> w;
+  for (size_t i = 0; i < 5000; ++i)
+  {
+    // участки монотонного роста и спада проверяют очереди минимума и максимума
+    history[i] = i % 500 < 100 ? static_cast<int32_t>(i % 500) : i % 500 < 200 ? static_cast<int32_t>(200 - i % 500)
+                                                                                 : next_value(1000);
+    w.push(history[i]);
+    const size_t n = i + 1 < 7 ? i + 1 : 7;
+    const Brute_t b = brute(history, i + 1, n);
+    TEST_ASSERT_EQUAL(n, w.count());
+    TEST_ASSERT_EQUAL(i + 1 >= 7, w.full());
+    TEST_ASSERT_EQUAL_INT32(b.min, w.min());
+    TEST_ASSERT_EQUAL_INT32(b.max, w.max());
+    TEST_ASSERT_EQUAL_INT64(b.sum, w.window_sum());
+    TEST_ASSERT_EQUAL_INT32(history[i + 1 - n], w.first());
+    TEST_ASSERT_EQUAL_INT32(history[i], w.last());
+    TEST_ASSERT_DOUBLE_WITHIN(1e-6 * (1.0 + b.variance), b.variance, w.variance());
+  }
+  TEST_ASSERT_EQUAL_UINT32(5000, w.pushed());
+}
+
+static void test_empty_and_reset(void)
+{
+  RollingWindow<int32_t, 4> w;
+  TEST_ASSERT_EQUAL(0, w.count());
+  TEST_ASSERT_EQUAL_INT32(0, w.mean());
+  TEST_ASSERT_EQUAL_INT32(0, w.min());
+  TEST_ASSERT_EQUAL_INT32(0, w.max());
+  TEST_ASSERT_EQUAL_DOUBLE(0.0, w.variance());
+  w.push(10);
+  TEST_ASSERT_EQUAL_DOUBLE(0.0, w.variance()); // один отсчёт — дисперсии нет
+  w.push(-10);
+  w.reset();
+  TEST_ASSERT_EQUAL(0, w.count());
+  w.push(3);
+  TEST_ASSERT_EQUAL_INT32(3, w.min());
+  TEST_ASSERT_EQUAL_INT32(3, w.max());
+  TEST_ASSERT_EQUAL_INT32(3, w.mean());
+}
+
+static void test_mean_rounds_to_nearest(void)
+{
+  RollingWindow<int32_t, 2> w;
+  w.push(1);
+  w.push(2);
+  TEST_ASSERT_EQUAL_INT32(2, w.mean()); // 1.5 -> 2
+  w.push(-1);
+  w.push(-2);
+  TEST_ASSERT_EQUAL_INT32(-2, w.mean()); // -1.5 -> -2, симметрично положительным
+  w.push(-1);
+  TEST_ASSERT_EQUAL_INT32(-2, w.mean()); // {-2, -1}
+  w.push(-1);
+  TEST_ASSERT_EQUAL_INT32(-1, w.mean());
+}
+
+static void test_unsigned_window(void)
+{
+  RollingWindow<uint32_t, 3> w;
+  const uint32_t v[] = {4000000000u, 1u, 4000000000u, 7u};
+  for (uint32_t x : v)
+    w.push(x);
+  TEST_ASSERT_EQUAL_UINT32(1, w.min());
+  TEST_ASSERT_EQUAL_UINT32(4000000000u, w.max());
+  TEST_ASSERT_EQUAL_UINT64(4000000008ull, w.window_sum());
+  TEST_ASSERT_EQUAL_UINT32(1333333336u, w.mean());
+}
+
+static void test_fixed_point_sum_does_not_drift(void)
+{
+  // давление в Па, Q24.8 (как у BME280): после миллиона вытеснений сумма окна точна;
+  // для сравнения выводится ошибка той же суммы, которую ведёт float
+  RollingWindow<int32_t, 60> fixed;
+  static int32_t ring[60];
+  float float_sum = 0.0f;
+  for (uint32_t i = 0; i < 1000000; ++i)
+  {
+    const int32_t q = FixedQ<8>::from_int(101325) + next_value(256 * 300);
+    fixed.push(q);
+    if (i >= 60)
+      float_sum -= FixedQ<8>::to_float(ring[i % 60]);
+    ring[i % 60] = q;
+    float_sum += FixedQ<8>::to_float(q);
+  }
+  int64_t exact = 0;
+  for (int i = 0; i < 60; ++i)
+    exact += ring[i];
+  TEST_ASSERT_EQUAL_INT64(exact, fixed.window_sum());
+  TEST_ASSERT_EQUAL_INT32(static_cast<int32_t>((exact + 30) / 60), fixed.mean());
+  char msg[96];
+  snprintf(msg, sizeof(msg), "float running sum error after 1e6 samples: %.2f Pa", float_sum - exact / 256.0);
+  TEST_MESSAGE(msg);
+}
+
+static void test_fixed_q_conversions(void)
+{
+  TEST_ASSERT_EQUAL_INT32(256, FixedQ<8>::from_int(1));
+  TEST_ASSERT_EQUAL_INT32(-384, FixedQ<8>::from_float(-1.5f));
+  TEST_ASSERT_EQUAL_INT32(1, FixedQ<8>::from_float(0.003f)); // округление к ближайшему шагу 1/256
+  TEST_ASSERT_EQUAL_FLOAT(2.25f, FixedQ<8>::to_float(576));
+  TEST_ASSERT_EQUAL_FLOAT(-0.5f, FixedQ<10>::to_float(-512));
+}
+
+static void test_ewma_converges_symmetrically(void)
+{
+  Ewma<int32_t, 3> pos, neg;
+  TEST_ASSERT_FALSE(pos.valid());
+  pos.push(0);
+  neg.push(0);
+  TEST_ASSERT_TRUE(pos.valid());
+  for (int i = 0; i < 300; ++i)
+  {
+    pos.push(1000);
+    neg.push(-1000);
+    TEST_ASSERT_EQUAL_INT32(-pos.value(), neg.value());
+  }
+  TEST_ASSERT_EQUAL_INT32(1000, pos.value());
+  TEST_ASSERT_EQUAL_INT32(-1000, neg.value());
+
+  Ewma<uint32_t, 4> u;
+  for (int i = 0; i < 300; ++i)
+    u.push(5);
+  TEST_ASSERT_EQUAL_UINT32(5, u.value());
+}
+
+static void test_ewma_step_response(void)
+{
+  // alpha = 1/4: после первого шага 0 -> 1024 среднее 256, после второго 448
+  Ewma<int32_t, 2> e;
+  e.push(0);
+  e.push(1024);
+  TEST_ASSERT_EQUAL_INT32(256, e.value());
+  e.push(1024);
+  TEST_ASSERT_EQUAL_INT32(448, e.value());
+  TEST_ASSERT_EQUAL_FLOAT(448.0f, e.value_f());
+  e.reset();
+  TEST_ASSERT_FALSE(e.valid());
+  e.push(-7);
+  TEST_ASSERT_EQUAL_INT32(-7, e.value()); // первый отсчёт инициализирует среднее
+}
+
+static void test_rolling_stats_combines_window_and_ewma(void)
+{
+  RollingStats<int32_t, 4, 1> s;
+  const int32_t v[] = {10, 20, 30, 40, 50};
+  for (int32_t x : v)
+    s.push(x);
+  TEST_ASSERT_EQUAL_INT32(35, s.window.mean());
+  TEST_ASSERT_EQUAL_INT32(20, s.window.min());
+  TEST_ASSERT_TRUE(s.ewma.valid());
+  s.reset();
+  TEST_ASSERT_EQUAL(0, s.window.count());
+  TEST_ASSERT_FALSE(s.ewma.valid());
+}
+
+// Замер: окно из 60 отсчётов (минута при секундном опросе) и EWMA против пересчёта окна перебором
+static void test_benchmark_push(void)
+{
+  static int32_t samples[4096];
+  for (int i = 0; i < 4096; ++i)
+    samples[i] = 2000 + next_value(300);
+
+  RollingWindow<int32_t, 60> w;
+  int64_t check = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < BENCH_SAMPLES; ++i)
+  {
+    w.push(samples[i & 4095]);
+    check += w.mean() + w.min() + w.max();
+  }
+  auto t1 = std::chrono::steady_clock::now();
+
+  Ewma<int32_t, 4> e;
+  for (int i = 0; i < BENCH_SAMPLES; ++i)
+  {
+    e.push(samples[i & 4095]);
+    check += e.value();
+  }
+  auto t2 = std::chrono::steady_clock::now();
+
+  static int32_t ring[60];
+  for (int i = 0; i < BENCH_SAMPLES; ++i)
+  {
+    ring[i % 60] = samples[i & 4095];
+    const size_t n = i + 1 < 60 ? i + 1 : 60;
+    int64_t sum = 0;
+    int32_t mn = ring[0], mx = ring[0];
+    for (size_t k = 0; k < n; ++k)
+    {
+      sum += ring[k];
+      mn = ring[k] < mn ? ring[k] : mn;
+      mx = ring[k] > mx ? ring[k] : mx;
+    }
+    check -= sum / static_cast<int64_t>(n) + mn + mx;
+  }
+  auto t3 = std::chrono::steady_clock::now();
+
+  const double window_ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / BENCH_SAMPLES;
+  const double ewma_ns = std::chrono::duration<double, std::nano>(t2 - t1).count() / BENCH_SAMPLES;
+  const double brute_ns = std::chrono::duration<double, std::nano>(t3 - t2).count() / BENCH_SAMPLES;
+  char msg[160];
+  snprintf(msg, sizeof(msg), "push+query: window<60> %.1f ns, ewma %.1f ns, brute force over 60 %.1f ns (check %lld)",
+           window_ns, ewma_ns, brute_ns, static_cast<long long>(check));
+  TEST_MESSAGE(msg);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_window_matches_brute_force);
+  RUN_TEST(test_empty_and_reset);
+  RUN_TEST(test_mean_rounds_to_nearest);
+  RUN_TEST(test_unsigned_window);
+  RUN_TEST(test_fixed_point_sum_does_not_drift);
+  RUN_TEST(test_fixed_q_conversions);
+  RUN_TEST(test_ewma_converges_symmetrically);
+  RUN_TEST(test_ewma_step_response);
+  RUN_TEST(test_rolling_stats_combines_window_and_ewma);
+  RUN_TEST(test_benchmark_push);
+  return UNITY_END();
+}
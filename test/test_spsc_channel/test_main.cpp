@@ -0,0 +1,341 @@
+#include "spsc_channel.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdio.h>
+#include <thread>
+#include <unity.h>
+
+#define TEST_BIT (1u << 3)     // бит уведомления потребителя
+#define STREAM_ITEMS 1000000   // элементов в многопоточных проверках и замере пропускной способности
+#define PING_PONG_ROUNDS 20000 // обменов в замере задержки
+
+static uint32_t s_disposed;      // элементов передано утилизатору
+static uint32_t s_last_disposed; // последний утилизированный элемент
+
+static void dispose(const uint32_t &item)
+{
+  s_disposed++;
+  s_last_disposed = item;
+}
+
+void setUp(void)
+{
+  s_disposed = 0;
+  s_last_disposed = 0;
+}
+
+void tearDown(void) {}
+
+static void test_fifo_order_and_wrap(void)
+{
+  SpscChannel<uint32_t, 8> ch;
+  TEST_ASSERT_EQUAL(8, ch.capacity());
+  TEST_ASSERT_TRUE(ch.empty());
+  uint32_t next_in = 0, next_out = 0, v;
+  // счётчики head/tail проходят кольцо много раз при разной заполненности
+  for (int round = 0; round < 100; ++round)
+  {
+    for (int i = 0; i < round % 8 + 1; ++i)
+      TEST_ASSERT_TRUE(ch.push(next_in++));
+    TEST_ASSERT_EQUAL(round % 8 + 1, ch.size());
+    while (ch.pop(v))
+      TEST_ASSERT_EQUAL_UINT32(next_out++, v);
+  }
+  TEST_ASSERT_EQUAL_UINT32(next_in, next_out);
+  TEST_ASSERT_FALSE(ch.pop(v));
+
+  ChannelStats_t st;
+  ch.get_stats(st);
+  TEST_ASSERT_EQUAL_UINT32(next_in, st.pushes);
+  TEST_ASSERT_EQUAL_UINT32(0, st.drops);
+  TEST_ASSERT_EQUAL_UINT32(8, st.high_watermark);
+}
+
+static void test_push_notifies_consumer(void)
+{
+  tskTaskControlBlock consumer;
+  consumer.value = 1u << 0; // чужой бит сохраняется
+  SpscChannel<uint32_t, 4> ch;
+  ch.push(1); // потребителя ещё нет — уведомления нет
+  TEST_ASSERT_FALSE(consumer.pending);
+  ch.attach_consumer(&consumer, TEST_BIT);
+  ch.push(2);
+  TEST_ASSERT_TRUE(consumer.pending);
+  TEST_ASSERT_EQUAL_HEX32(TEST_BIT | 1u, consumer.value);
+}
+
+static void test_drop_oldest(void)
+{
+  SpscChannel<uint32_t, 4> ch;
+  ch.set_policy(CHANNEL_POLICY_DROP_OLDEST);
+  ch.set_disposer(dispose);
+  for (uint32_t i = 0; i < 6; ++i)
+    TEST_ASSERT_TRUE(ch.push(i));
+  TEST_ASSERT_EQUAL_UINT32(2, s_disposed);
+  TEST_ASSERT_EQUAL_UINT32(1, s_last_disposed);
+  uint32_t v;
+  for (uint32_t expect = 2; expect < 6; ++expect)
+  {
+    TEST_ASSERT_TRUE(ch.pop(v));
+    TEST_ASSERT_EQUAL_UINT32(expect, v);
+  }
+  ChannelStats_t st;
+  ch.get_stats(st);
+  TEST_ASSERT_EQUAL_UINT32(6, st.pushes);
+  TEST_ASSERT_EQUAL_UINT32(2, st.drops);
+}
+
+static void test_coalesce_latest(void)
+{
+  SpscChannel<uint32_t, 4> ch;
+  ch.set_policy(CHANNEL_POLICY_COALESCE_LATEST);
+  ch.set_disposer(dispose);
+  for (uint32_t i = 10; i < 13; ++i)
+    ch.push(i);
+  TEST_ASSERT_EQUAL(1, ch.size());
+  TEST_ASSERT_EQUAL_UINT32(2, s_disposed);
+  uint32_t v;
+  TEST_ASSERT_TRUE(ch.pop(v));
+  TEST_ASSERT_EQUAL_UINT32(12, v);
+  TEST_ASSERT_TRUE(ch.empty());
+}
+
+static void test_block_times_out(void)
+{
+  SpscChannel<uint32_t, 2> ch;
+  ch.set_policy(CHANNEL_POLICY_BLOCK, 5);
+  ch.set_disposer(dispose);
+  TEST_ASSERT_TRUE(ch.push(1));
+  TEST_ASSERT_TRUE(ch.push(2));
+  TEST_ASSERT_FALSE(ch.push(3)); // места не появилось за 5 тиков
+  TEST_ASSERT_EQUAL_UINT32(0, s_disposed); // не помещённый элемент остаётся у вызывающего
+  ChannelStats_t st;
+  ch.get_stats(st);
+  TEST_ASSERT_EQUAL_UINT32(1, st.drops);
+  TEST_ASSERT_GREATER_OR_EQUAL(5, st.blocked_ticks);
+  uint32_t v;
+  TEST_ASSERT_TRUE(ch.pop(v));
+  TEST_ASSERT_EQUAL_UINT32(1, v);
+}
+
+static void test_block_waits_for_consumer(void)
+{
+  SpscChannel<uint32_t, 2> ch;
+  ch.set_policy(CHANNEL_POLICY_BLOCK, 1000);
+  ch.push(1);
+  ch.push(2);
+  std::thread consumer([&ch] {
+    vTaskDelay(10);
+    uint32_t v;
+    ch.pop(v);
+  });
+  TEST_ASSERT_TRUE(ch.push(3));
+  consumer.join();
+  uint32_t v;
+  TEST_ASSERT_TRUE(ch.pop(v));
+  TEST_ASSERT_EQUAL_UINT32(2, v);
+  TEST_ASSERT_TRUE(ch.pop(v));
+  TEST_ASSERT_EQUAL_UINT32(3, v);
+}
+
+// Производитель уступает процессор, пока канал полон: ожидание CHANNEL_POLICY_BLOCK идёт
+// шагами по тику (vTaskDelay(1)) и в потоке миллиона элементов измеряло бы тики, а не канал
+template <size_t N>
+static void produce(SpscChannel<uint32_t, N> &ch, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    while (ch.size() == ch.capacity())
+      std::this_thread::yield();
+    ch.push(i);
+  }
+}
+
+// Потребитель в отдельном потоке: ждёт уведомления, выбирает канал до пустого
+template <size_t N, typename F>
+static void consume(SpscChannel<uint32_t, N> &ch, tskTaskControlBlock &self, uint32_t last, F on_item)
+{
+  uint32_t v = 0;
+  for (;;)
+  {
+    while (ch.pop(v))
+    {
+      on_item(v);
+      if (v == last)
+        return;
+    }
+    stub_task_notify_wait(&self, 0, TEST_BIT, nullptr, 10);
+  }
+}
+
+static void test_threaded_stream_in_order(void)
+{
+  static SpscChannel<uint32_t, 64> ch;
+  tskTaskControlBlock self;
+  ch.set_policy(CHANNEL_POLICY_BLOCK, portMAX_DELAY);
+  ch.attach_consumer(&self, TEST_BIT);
+  uint32_t expect = 0, errors = 0;
+  std::thread consumer([&] { consume(ch, self, STREAM_ITEMS - 1, [&](uint32_t v) { errors += v != expect++; }); });
+  produce(ch, STREAM_ITEMS);
+  consumer.join();
+  TEST_ASSERT_EQUAL_UINT32(0, errors);
+  TEST_ASSERT_EQUAL_UINT32(STREAM_ITEMS, expect);
+}
+
+static void test_threaded_drop_oldest_accounts_every_item(void)
+{
+  // производитель вытесняет элементы, которые в тот же момент забирает потребитель:
+  // каждый элемент либо получен, либо утилизирован, порядок полученных сохраняется
+  static SpscChannel<uint32_t, 8> ch;
+  tskTaskControlBlock self;
+  ch.set_policy(CHANNEL_POLICY_DROP_OLDEST);
+  ch.set_disposer(dispose);
+  ch.attach_consumer(&self, TEST_BIT);
+  uint32_t received = 0, disorder = 0, prev = 0;
+  std::thread consumer([&] {
+    consume(ch, self, STREAM_ITEMS - 1, [&](uint32_t v) {
+      disorder += received && v <= prev;
+      prev = v;
+      received++;
+    });
+  });
+  for (uint32_t i = 0; i < STREAM_ITEMS; ++i)
+    ch.push(i);
+  consumer.join();
+  ChannelStats_t st;
+  ch.get_stats(st);
+  TEST_ASSERT_EQUAL_UINT32(0, disorder);
+  TEST_ASSERT_EQUAL_UINT32(STREAM_ITEMS, received + s_disposed);
+  TEST_ASSERT_EQUAL_UINT32(s_disposed, st.drops);
+}
+
+/**
+ * @brief Очередь с блокировкой — аналог xQueue на хосте
+ *
+ * Как и xQueueSend()/xQueueReceive(), каждая операция проходит критическую секцию,
+ * а ждущая сторона будится через список ожидания (здесь — условную переменную).
+ */
+class LockedQueue
+{
+public:
+  explicit LockedQueue(size_t capacity) : capacity(capacity) {}
+
+  void send(uint32_t v)
+  {
+    std::unique_lock<std::mutex> g(lock);
+    not_full.wait(g, [this] { return items.size() < capacity; });
+    items.push_back(v);
+    not_empty.notify_one();
+  }
+
+  uint32_t receive()
+  {
+    std::unique_lock<std::mutex> g(lock);
+    not_empty.wait(g, [this] { return !items.empty(); });
+    const uint32_t v = items.front();
+    items.pop_front();
+    not_full.notify_one();
+    return v;
+  }
+
+private:
+  const size_t capacity;
+  std::mutex lock;
+  std::condition_variable not_empty;
+  std::condition_variable not_full;
+  std::deque<uint32_t> items;
+};
+
+static double elapsed_ns(std::chrono::steady_clock::time_point since)
+{
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - since).count();
+}
+
+// Замер на хосте: поток элементов (пропускная способность) и обмен «пинг-понг» (задержка
+// пробуждения) для SpscChannel с уведомлениями и для очереди с блокировкой
+static void test_benchmark_against_locked_queue(void)
+{
+  static SpscChannel<uint32_t, 16> spsc;
+  tskTaskControlBlock spsc_consumer;
+  spsc.set_policy(CHANNEL_POLICY_BLOCK, portMAX_DELAY);
+  spsc.attach_consumer(&spsc_consumer, TEST_BIT);
+  uint64_t check = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  std::thread c1([&] { consume(spsc, spsc_consumer, STREAM_ITEMS - 1, [&](uint32_t v) { check += v; }); });
+  produce(spsc, STREAM_ITEMS);
+  c1.join();
+  const double spsc_ns = elapsed_ns(t0) / STREAM_ITEMS;
+
+  LockedQueue queue(16);
+  t0 = std::chrono::steady_clock::now();
+  std::thread c2([&] {
+    for (uint32_t i = 0; i < STREAM_ITEMS; ++i)
+      check -= queue.receive();
+  });
+  for (uint32_t i = 0; i < STREAM_ITEMS; ++i)
+    queue.send(i);
+  c2.join();
+  const double queue_ns = elapsed_ns(t0) / STREAM_ITEMS;
+  TEST_ASSERT_EQUAL_UINT64(0, check);
+
+  // пинг-понг: каждый элемент возвращается обратно, поток каждый раз засыпает и будится
+  static SpscChannel<uint32_t, 16> ping, pong;
+  tskTaskControlBlock ping_consumer, pong_consumer;
+  ping.attach_consumer(&ping_consumer, TEST_BIT);
+  pong.attach_consumer(&pong_consumer, TEST_BIT);
+  t0 = std::chrono::steady_clock::now();
+  std::thread echo([&] {
+    uint32_t v = 0;
+    while (v != PING_PONG_ROUNDS - 1)
+    {
+      while (!ping.pop(v))
+        stub_task_notify_wait(&ping_consumer, 0, TEST_BIT, nullptr, 10);
+      pong.push(v);
+    }
+  });
+  for (uint32_t i = 0; i < PING_PONG_ROUNDS; ++i)
+  {
+    uint32_t v;
+    ping.push(i);
+    while (!pong.pop(v))
+      stub_task_notify_wait(&pong_consumer, 0, TEST_BIT, nullptr, 10);
+  }
+  echo.join();
+  const double spsc_rtt_ns = elapsed_ns(t0) / PING_PONG_ROUNDS;
+
+  LockedQueue q_ping(16), q_pong(16);
+  t0 = std::chrono::steady_clock::now();
+  std::thread q_echo([&] {
+    for (uint32_t i = 0; i < PING_PONG_ROUNDS; ++i)
+      q_pong.send(q_ping.receive());
+  });
+  for (uint32_t i = 0; i < PING_PONG_ROUNDS; ++i)
+  {
+    q_ping.send(i);
+    q_pong.receive();
+  }
+  q_echo.join();
+  const double queue_rtt_ns = elapsed_ns(t0) / PING_PONG_ROUNDS;
+
+  char msg[192];
+  snprintf(msg, sizeof(msg), "stream: spsc %.1f ns/item, locked queue %.1f ns/item; round trip: spsc %.0f ns, locked queue %.0f ns",
+           spsc_ns, queue_ns, spsc_rtt_ns, queue_rtt_ns);
+  TEST_MESSAGE(msg);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_fifo_order_and_wrap);
+  RUN_TEST(test_push_notifies_consumer);
+  RUN_TEST(test_drop_oldest);
+  RUN_TEST(test_coalesce_latest);
+  RUN_TEST(test_block_times_out);
+  RUN_TEST(test_block_waits_for_consumer);
+  RUN_TEST(test_threaded_stream_in_order);
+  RUN_TEST(test_threaded_drop_oldest_accounts_every_item);
+  RUN_TEST(test_benchmark_against_locked_queue);
+  return UNITY_END();
+}
@@ -0,0 +1,309 @@
+#include "tslog.h"
+#include <esp_attr.h>
+#include <esp_partition.h>
+#include <string.h>
+#include <unity.h>
+#include <vector>
+
+#define TEST_PAGES 8        // страниц в разделе (кольцо оборачивается за 8 страниц)
+#define TEST_T0 1760000000u // время первой записи
+#define TEST_STEP_S 60      // период записей, с
+
+// Запись номер i: время растёт на TEST_STEP_S, значения меняются медленно, как у датчиков
+static TsRecord_t make_record(uint32_t i)
+{
+  TsRecord_t rec;
+  rec.time = TEST_T0 + i * TEST_STEP_S;
+  rec.value[TSLOG_IN_T] = static_cast<int16_t>(220 + (i / 7) % 30);
+  rec.value[TSLOG_IN_H] = static_cast<int16_t>(40 + (i / 13) % 10);
+  rec.value[TSLOG_IN_P] = static_cast<int16_t>(10100 + (i / 5) % 60);
+  rec.value[TSLOG_OUT_T] = i % 97 == 0 ? TSLOG_NO_VALUE : static_cast<int16_t>(-50 + (i / 3) % 120);
+  rec.value[TSLOG_OUT_H] = static_cast<int16_t>(60 + (i / 11) % 30);
+  rec.value[TSLOG_OUT_P] = TSLOG_NO_VALUE;
+  return rec;
+}
+
+static uint32_t s_next; // номер следующей записи make_record
+
+static TsLogStats_t stats()
+{
+  TsLogStats_t st;
+  TsLog::get_stats(st);
+  return st;
+}
+
+// Отключение питания: память RTC теряет содержимое
+static void power_loss()
+{
+  if (!rtc_noinit_size())
+    TEST_IGNORE_MESSAGE("RTC memory section is not available on this host");
+  memset(rtc_noinit_begin(), 0, rtc_noinit_size());
+}
+
+// Первый запуск на чистом разделе
+static void power_on_blank()
+{
+  fake_partition_create(TSLOG_PARTITION_LABEL, TEST_PAGES * TSLOG_PAGE_SIZE);
+  power_loss();
+  TEST_ASSERT_TRUE(TsLog::begin());
+  s_next = 0;
+}
+
+// Добавлять записи, пока во флеш-память не будут записаны ещё `pages` страниц
+static void append_pages(uint32_t pages)
+{
+  const uint32_t target = stats().page_writes + stats().write_errors + pages;
+  while (stats().page_writes + stats().write_errors < target)
+    TEST_ASSERT_TRUE(TsLog::append(make_record(s_next++)));
+}
+
+static void append_records(uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+    TEST_ASSERT_TRUE(TsLog::append(make_record(s_next++)));
+}
+
+static bool collect(const TsRecord_t &rec, void *ctx)
+{
+  static_cast<std::vector<TsRecord_t> *>(ctx)->push_back(rec);
+  return true;
+}
+
+static void read_all(std::vector<TsRecord_t> &out)
+{
+  out.clear();
+  const size_t n = TsLog::read(0, UINT32_MAX, collect, &out);
+  TEST_ASSERT_EQUAL(out.size(), n);
+}
+
+// Прочитанные записи совпадают с make_record, время строго растёт
+static void check_records(const std::vector<TsRecord_t> &recs)
+{
+  for (size_t k = 0; k < recs.size(); ++k)
+  {
+    if (k)
+      TEST_ASSERT_TRUE(recs[k].time > recs[k - 1].time);
+    const uint32_t i = (recs[k].time - TEST_T0) / TEST_STEP_S;
+    const TsRecord_t expect = make_record(i);
+    TEST_ASSERT_EQUAL_UINT32(expect.time, recs[k].time);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(expect.value, recs[k].value, TSLOG_CHANNELS);
+  }
+}
+
+// Номер записи make_record по её времени
+static uint32_t record_index(const TsRecord_t &rec)
+{
+  return (rec.time - TEST_T0) / TEST_STEP_S;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void test_missing_partition(void)
+{
+  fake_partition_create("other", TEST_PAGES * TSLOG_PAGE_SIZE);
+  TEST_ASSERT_FALSE(TsLog::begin());
+}
+
+static void test_round_trip_across_pages(void)
+{
+  power_on_blank();
+  append_pages(2);
+  append_records(10);
+  const TsLogStats_t st = stats();
+  TEST_ASSERT_EQUAL_UINT32(TEST_PAGES, st.pages);
+  TEST_ASSERT_EQUAL_UINT32(2, st.valid_pages);
+  TEST_ASSERT_EQUAL_UINT32(2, st.head_seq);
+  TEST_ASSERT_EQUAL_UINT32(s_next, st.records + st.open_records);
+  TEST_ASSERT_EQUAL_UINT32(TEST_T0, st.first_time);
+  TEST_ASSERT_EQUAL_UINT32(make_record(s_next - 1).time, st.last_time);
+
+  std::vector<TsRecord_t> recs;
+  read_all(recs);
+  TEST_ASSERT_EQUAL(s_next, recs.size());
+  check_records(recs);
+  TEST_ASSERT_EQUAL_UINT32(0, record_index(recs.front()));
+}
+
+static void test_read_interval(void)
+{
+  power_on_blank();
+  append_pages(3);
+  const uint32_t from = make_record(100).time, to = make_record(s_next - 5).time;
+  std::vector<TsRecord_t> recs;
+  TsLog::read(from, to, collect, &recs);
+  TEST_ASSERT_EQUAL(s_next - 5 - 100 + 1, recs.size());
+  TEST_ASSERT_EQUAL_UINT32(from, recs.front().time);
+  TEST_ASSERT_EQUAL_UINT32(to, recs.back().time);
+  check_records(recs);
+}
+
+static void test_rejects_non_increasing_time(void)
+{
+  power_on_blank();
+  append_records(3);
+  TEST_ASSERT_FALSE(TsLog::append(make_record(2)));
+  TEST_ASSERT_FALSE(TsLog::append(make_record(0)));
+  TEST_ASSERT_EQUAL_UINT32(2, stats().rejected);
+  TEST_ASSERT_EQUAL_UINT32(3, stats().open_records);
+}
+
+static void test_reset_resumes_open_page(void)
+{
+  power_on_blank();
+  append_pages(1);
+  append_records(25);
+  const TsLogStats_t before = stats();
+
+  TEST_ASSERT_TRUE(TsLog::begin()); // программный сброс: память RTC цела
+  const TsLogStats_t after = stats();
+  TEST_ASSERT_TRUE(after.resumed);
+  TEST_ASSERT_EQUAL_UINT32(before.head_seq, after.head_seq);
+  TEST_ASSERT_EQUAL_UINT32(before.open_records, after.open_records);
+  TEST_ASSERT_EQUAL_UINT32(before.records, after.records);
+  TEST_ASSERT_EQUAL_UINT32(before.last_time, after.last_time);
+
+  append_records(5);
+  std::vector<TsRecord_t> recs;
+  read_all(recs);
+  TEST_ASSERT_EQUAL(s_next, recs.size());
+  check_records(recs);
+}
+
+static void test_power_loss_keeps_written_pages(void)
+{
+  power_on_blank();
+  append_pages(2);
+  const uint32_t on_flash = stats().records;
+  append_records(40);
+
+  power_loss();
+  TEST_ASSERT_TRUE(TsLog::begin());
+  const TsLogStats_t st = stats();
+  TEST_ASSERT_FALSE(st.resumed);
+  TEST_ASSERT_EQUAL_UINT32(2, st.valid_pages);
+  TEST_ASSERT_EQUAL_UINT32(2, st.head_seq);
+  TEST_ASSERT_EQUAL_UINT32(0, st.open_records);
+  TEST_ASSERT_EQUAL_UINT32(on_flash, st.records);
+  TEST_ASSERT_EQUAL_UINT32(make_record(on_flash - 1).time, st.last_time);
+
+  // потеряна только заполнявшаяся страница; запись продолжается после неё
+  TEST_ASSERT_FALSE(TsLog::append(make_record(on_flash - 1)));
+  const uint32_t resumed_from = s_next;
+  append_records(3);
+  std::vector<TsRecord_t> recs;
+  read_all(recs);
+  TEST_ASSERT_EQUAL(on_flash + 3, recs.size());
+  check_records(recs);
+  TEST_ASSERT_EQUAL_UINT32(resumed_from, record_index(recs[on_flash]));
+}
+
+static void test_torn_write_page_skipped(void)
+{
+  power_on_blank();
+  append_pages(1);
+  const uint32_t page0 = stats().records;
+
+  fake_partition().torn_write = TSLOG_PAGE_SIZE / 2; // запись второй страницы обрывается на середине
+  append_pages(1);
+  TEST_ASSERT_EQUAL_UINT32(1, stats().write_errors);
+  TEST_ASSERT_EQUAL_UINT32(1, stats().valid_pages);
+  const uint32_t lost_from = s_next - 1; // эта запись открыла третью страницу
+  append_pages(1);
+  const uint32_t page2 = stats().records - page0;
+
+  power_loss();
+  TEST_ASSERT_TRUE(TsLog::begin());
+  const TsLogStats_t st = stats();
+  TEST_ASSERT_EQUAL_UINT32(2, st.valid_pages);
+  TEST_ASSERT_EQUAL_UINT32(3, st.head_seq);
+  TEST_ASSERT_EQUAL_UINT32(page0 + page2, st.records);
+
+  // страница с неверной CRC пропущена, остальные читаются по порядку
+  std::vector<TsRecord_t> recs;
+  read_all(recs);
+  TEST_ASSERT_EQUAL(page0 + page2, recs.size());
+  check_records(recs);
+  TEST_ASSERT_EQUAL_UINT32(page0 - 1, record_index(recs[page0 - 1]));
+  TEST_ASSERT_EQUAL_UINT32(lost_from, record_index(recs[page0]));
+}
+
+static void test_reset_during_page_write(void)
+{
+  power_on_blank();
+  append_pages(1);
+  // заполнить вторую страницу до последней записи, которая запустит её запись
+  std::vector<uint8_t> rtc;
+  uint32_t before_write = 0;
+  for (;;)
+  {
+    rtc.assign(rtc_noinit_begin(), rtc_noinit_begin() + rtc_noinit_size());
+    before_write = s_next;
+    const uint32_t writes = stats().page_writes;
+    append_records(1);
+    if (stats().page_writes != writes)
+      break;
+  }
+  // сброс посреди записи: сектор стёрт и записан наполовину, память RTC — как до записи
+  const size_t offset = TSLOG_PAGE_SIZE;
+  memset(fake_partition().data + offset + TSLOG_PAGE_SIZE / 2, 0xFF, TSLOG_PAGE_SIZE / 2);
+  memcpy(rtc_noinit_begin(), rtc.data(), rtc.size());
+
+  TEST_ASSERT_TRUE(TsLog::begin());
+  TEST_ASSERT_TRUE(stats().resumed);
+  TEST_ASSERT_EQUAL_UINT32(1, stats().valid_pages);
+  TEST_ASSERT_EQUAL_UINT32(1, stats().head_seq);
+
+  // страница из памяти RTC записывается заново, записи не теряются
+  s_next = before_write;
+  append_records(1);
+  TEST_ASSERT_EQUAL_UINT32(2, stats().valid_pages);
+  TEST_ASSERT_EQUAL_UINT32(2, stats().head_seq);
+  std::vector<TsRecord_t> recs;
+  read_all(recs);
+  TEST_ASSERT_EQUAL(s_next, recs.size());
+  check_records(recs);
+}
+
+static void test_ring_wraps(void)
+{
+  power_on_blank();
+  append_pages(TEST_PAGES + 3);
+  append_records(7);
+  const TsLogStats_t st = stats();
+  TEST_ASSERT_EQUAL_UINT32(TEST_PAGES, st.valid_pages);
+  TEST_ASSERT_EQUAL_UINT32(TEST_PAGES + 3, st.head_seq);
+  TEST_ASSERT_EQUAL_UINT32(TEST_PAGES + 3, fake_partition().erases);
+
+  // три старейшие страницы перезаписаны: чтение начинается с четвёртой
+  std::vector<TsRecord_t> recs;
+  read_all(recs);
+  TEST_ASSERT_EQUAL(st.records + st.open_records, recs.size());
+  check_records(recs);
+  TEST_ASSERT_EQUAL_UINT32(recs.front().time, st.first_time);
+  TEST_ASSERT_EQUAL_UINT32(s_next - recs.size(), record_index(recs.front()));
+  TEST_ASSERT_EQUAL_UINT32(s_next - 1, record_index(recs.back()));
+
+  // после отключения питания кольцо восстанавливается по номерам страниц
+  power_loss();
+  TEST_ASSERT_TRUE(TsLog::begin());
+  TEST_ASSERT_EQUAL_UINT32(TEST_PAGES, stats().valid_pages);
+  TEST_ASSERT_EQUAL_UINT32(TEST_PAGES + 3, stats().head_seq);
+  TEST_ASSERT_EQUAL_UINT32(st.records, stats().records);
+  TEST_ASSERT_EQUAL_UINT32(st.first_time, stats().first_time);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_missing_partition);
+  RUN_TEST(test_round_trip_across_pages);
+  RUN_TEST(test_read_interval);
+  RUN_TEST(test_rejects_non_increasing_time);
+  RUN_TEST(test_reset_resumes_open_page);
+  RUN_TEST(test_power_loss_keeps_written_pages);
+  RUN_TEST(test_torn_write_page_skipped);
+  RUN_TEST(test_reset_during_page_write);
+  RUN_TEST(test_ring_wraps);
+  return UNITY_END();
+}
@@ -0,0 +1,167 @@
+#include "virtual_source.h"
+#include <stdio.h>
+#include <unity.h>
+
+#define TRACE_FILE "test_virtual_source.csv" // временная трасса в рабочем каталоге
+
+void setUp(void) {}
+void tearDown(void)
+{
+  remove(TRACE_FILE);
+}
+
+static void test_parse_line_reads_all_fields(void)
+{
+  VirtualSample_t s;
+  TEST_ASSERT_TRUE(VirtualSource::parse_line("  120500,3,-3.25,81.5,1002.4,77\r\n", s));
+  TEST_ASSERT_EQUAL_UINT32(120500, s.t_ms);
+  TEST_ASSERT_EQUAL_UINT8(3, s.node);
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, -3.25f, s.temperature);
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 81.5f, s.humidity);
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 1002.4f, s.pressure);
+  TEST_ASSERT_EQUAL_UINT8(77, s.battery);
+}
+
+static void test_parse_line_skips_and_rejects(void)
+{
+  VirtualSample_t s;
+  TEST_ASSERT_FALSE(VirtualSource::parse_line("", s));
+  TEST_ASSERT_FALSE(VirtualSource::parse_line("\n", s));
+  TEST_ASSERT_FALSE(VirtualSource::parse_line("# комментарий", s));
+  TEST_ASSERT_FALSE(VirtualSource::parse_line("t_ms,node,temperature,humidity,pressure,battery", s));
+  TEST_ASSERT_FALSE(VirtualSource::parse_line("0,1,20.0,50.0,1000.0", s));      // нет поля
+  TEST_ASSERT_FALSE(VirtualSource::parse_line("0,1,20.0,50.0,1000.0,90,1", s)); // лишнее поле
+  TEST_ASSERT_FALSE(VirtualSource::parse_line("0;1;20.0;50.0;1000.0;90", s));   // чужой разделитель
+  TEST_ASSERT_FALSE(VirtualSource::parse_line("0,1,20.0,x,1000.0,90", s));      // не число
+}
+
+static void test_file_source_reads_and_rewinds(void)
+{
+  FILE *f = fopen(TRACE_FILE, "w");
+  TEST_ASSERT_NOT_NULL(f);
+  fputs("t_ms,node,temperature,humidity,pressure,battery\n"
+        "0,1,10.0,70.0,1001.0,90\n"
+        "# пауза\n"
+        "\n"
+        "60000,2,11.5,68.0,1001.5,89\n",
+        f);
+  fclose(f);
+
+  VirtualFileSource src(TRACE_FILE);
+  TEST_ASSERT_TRUE(src.ok());
+  VirtualSample_t s;
+  TEST_ASSERT_TRUE(src.next(s));
+  TEST_ASSERT_EQUAL_UINT8(1, s.node);
+  TEST_ASSERT_TRUE(src.next(s));
+  TEST_ASSERT_EQUAL_UINT32(60000, s.t_ms);
+  TEST_ASSERT_EQUAL_UINT8(2, s.node);
+  TEST_ASSERT_FALSE(src.next(s));
+
+  src.rewind();
+  TEST_ASSERT_TRUE(src.next(s));
+  TEST_ASSERT_EQUAL_UINT32(0, s.t_ms);
+}
+
+static void test_file_source_missing_file(void)
+{
+  VirtualFileSource src("no_such_trace.csv");
+  VirtualSample_t s;
+  TEST_ASSERT_FALSE(src.ok());
+  TEST_ASSERT_FALSE(src.next(s));
+}
+
+// Прогоны с одним seed повторяют друг друга, rewind() начинает трассу заново
+static void test_synth_is_repeatable(void)
+{
+  VirtualSynthSource a(VIRTUAL_SYNTH_NODES, VIRTUAL_SYNTH_INTERVAL_MS, VIRTUAL_SYNTH_BURST_EVERY, VIRTUAL_SYNTH_SEED);
+  VirtualSynthSource b(VIRTUAL_SYNTH_NODES, VIRTUAL_SYNTH_INTERVAL_MS, VIRTUAL_SYNTH_BURST_EVERY, VIRTUAL_SYNTH_SEED);
+  VirtualSample_t first;
+  TEST_ASSERT_TRUE(a.next(first));
+  b.next(first);
+  for (int i = 1; i < 1000; ++i)
+  {
+    VirtualSample_t sa, sb;
+    TEST_ASSERT_TRUE(a.next(sa));
+    TEST_ASSERT_TRUE(b.next(sb));
+    TEST_ASSERT_EQUAL_UINT32(sa.t_ms, sb.t_ms);
+    TEST_ASSERT_EQUAL_FLOAT(sa.temperature, sb.temperature);
+    TEST_ASSERT_EQUAL_FLOAT(sa.humidity, sb.humidity);
+  }
+
+  VirtualSample_t again;
+  a.rewind();
+  TEST_ASSERT_TRUE(a.next(again));
+  TEST_ASSERT_EQUAL_UINT32(first.t_ms, again.t_ms);
+  TEST_ASSERT_EQUAL_FLOAT(first.temperature, again.temperature);
+}
+
+// Время не убывает; узлы идут по очереди со сдвигом фазы, каждый burst_every-й период — пачкой через 2 мс
+static void test_synth_phases_and_bursts(void)
+{
+  const uint8_t nodes = 16;
+  const uint32_t interval = 60000;
+  const uint32_t burst_every = 4;
+  VirtualSynthSource src(nodes, interval, burst_every, 1);
+  uint32_t last = 0;
+  for (uint32_t round = 0; round < 3 * burst_every; ++round)
+  {
+    const bool burst = round % burst_every == burst_every - 1;
+    for (uint8_t node = 0; node < nodes; ++node)
+    {
+      VirtualSample_t s;
+      TEST_ASSERT_TRUE(src.next(s));
+      TEST_ASSERT_EQUAL_UINT8(node, s.node);
+      TEST_ASSERT_EQUAL_UINT32(round * interval + (burst ? node * 2u : interval / nodes * node), s.t_ms);
+      TEST_ASSERT_TRUE(s.t_ms >= last);
+      TEST_ASSERT_TRUE(s.temperature > -20.0f && s.temperature < 40.0f);
+      TEST_ASSERT_TRUE(s.humidity > 0.0f && s.humidity < 100.0f);
+      last = s.t_ms;
+    }
+  }
+}
+
+static void test_synth_ends_before_time_overflow(void)
+{
+  VirtualSynthSource src(1, 0x10000000u, 0, 1);
+  VirtualSample_t s;
+  int count = 0;
+  while (src.next(s))
+    ++count;
+  TEST_ASSERT_EQUAL_INT(15, count); // (round + 1) * interval ≤ 0xF0000000
+}
+
+// Первый вызов привязывает трассу к текущему моменту, дальше задержка делится на ускорение
+static void test_pacer_scales_delay(void)
+{
+  VirtualPacer pacer(10);
+  TEST_ASSERT_EQUAL_UINT32(0, pacer.delay_ms(5000, 100000));
+  TEST_ASSERT_EQUAL_UINT32(1000, pacer.delay_ms(15000, 100000));
+  TEST_ASSERT_EQUAL_UINT32(400, pacer.delay_ms(15000, 100600));
+  TEST_ASSERT_EQUAL_UINT32(0, pacer.delay_ms(15000, 102000)); // опоздание — без ожидания
+
+  pacer.restart(); // трасса пошла по кругу
+  TEST_ASSERT_EQUAL_UINT32(0, pacer.delay_ms(0, 200000));
+  TEST_ASSERT_EQUAL_UINT32(6000, pacer.delay_ms(60000, 200000));
+}
+
+static void test_pacer_zero_speedup_is_real_time(void)
+{
+  VirtualPacer pacer(0);
+  pacer.delay_ms(0, 0);
+  TEST_ASSERT_EQUAL_UINT32(60000, pacer.delay_ms(60000, 0));
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_parse_line_reads_all_fields);
+  RUN_TEST(test_parse_line_skips_and_rejects);
+  RUN_TEST(test_file_source_reads_and_rewinds);
+  RUN_TEST(test_file_source_missing_file);
+  RUN_TEST(test_synth_is_repeatable);
+  RUN_TEST(test_synth_phases_and_bursts);
+  RUN_TEST(test_synth_ends_before_time_overflow);
+  RUN_TEST(test_pacer_scales_delay);
+  RUN_TEST(test_pacer_zero_speedup_is_real_time);
+  return UNITY_END();
+}